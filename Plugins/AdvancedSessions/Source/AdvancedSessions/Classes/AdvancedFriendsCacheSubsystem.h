@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+#include "CoreMinimal.h"
+#include "BlueprintDataDefinitions.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Interfaces/OnlineFriendsInterface.h"
+#include "Interfaces/OnlinePresenceInterface.h"
+
+#include "AdvancedFriendsCacheSubsystem.generated.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(AdvancedFriendsCacheLog, Log, All);
+
+DECLARE_DELEGATE_TwoParams(FOnFriendsCacheReadComplete, int32 /*LocalUserNum*/, bool /*bWasSuccessful*/);
+
+// The friends list of one local user, keyed by the string of the friends unique net id
+struct FAdvancedCachedFriendsList
+{
+	TMap<FString, FBPFriendInfo> Friends;
+
+	// Platform time of the last read that completed, successful or not
+	double LastReadTime = -DBL_MAX;
+
+	bool bHasBeenRead = false;
+	bool bReadInFlight = false;
+
+	// Set when the online subsystem tells us the list changed, the next request reads it again even if it's too soon
+	bool bDirty = false;
+
+	// Everyone waiting for the read in flight
+	TArray<FOnFriendsCacheReadComplete> PendingDelegates;
+
+	FDelegateHandle FriendsChangeHandle;
+};
+
+// Keeps the friends list of the local players so it doesn't have to be read and rebuilt every time it's needed.
+// Reads are rate limited, requests within MinReadInterval of the last read are answered from the cache,
+// and requests made while a read is in flight wait for it instead of starting another one.
+// Presence changes are applied to the cached friend as they come in, a read only adds and removes friends.
+UCLASS()
+class ADVANCEDSESSIONS_API UAdvancedFriendsCacheSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+public:
+
+	UAdvancedFriendsCacheSubsystem();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Seconds a read friends list is used before it's read again
+	UPROPERTY(BlueprintReadWrite, Category = "Online|AdvancedFriends|FriendsCache")
+	float MinReadInterval;
+
+	static UAdvancedFriendsCacheSubsystem* Get(const UObject* WorldContextObject);
+
+	// Reads the friends list of the local user if the cached one is too old, the delegate is called once it's up to date
+	void RequestFriendsList(int32 LocalUserNum, const FOnFriendsCacheReadComplete& Delegate, bool bForceRead = false);
+
+	// False until the friends list of this local user was read once
+	bool HasFriendsList(int32 LocalUserNum) const;
+
+	bool IsFriend(int32 LocalUserNum, const FUniqueNetId& UniqueNetId) const;
+
+	const FBPFriendInfo* FindFriend(int32 LocalUserNum, const FUniqueNetId& UniqueNetId) const;
+
+	void GetFriendsList(int32 LocalUserNum, TArray<FBPFriendInfo>& FriendsList) const;
+
+	// Fills the blueprint friend info from an online friend
+	static void MakeFriendInfo(const FOnlineFriend& Friend, FBPFriendInfo& FriendInfo);
+
+	static void ApplyPresence(const FOnlineUserPresence& Presence, FBPFriendInfo& FriendInfo);
+
+private:
+
+	TMap<int32, FAdvancedCachedFriendsList> CachedLists;
+
+	FDelegateHandle PresenceReceivedHandle;
+
+	void OnReadFriendsListCompleted(int32 LocalUserNum, bool bWasSuccessful, const FString& ListName, const FString& ErrorString);
+
+	void OnFriendsChange(int32 LocalUserNum);
+
+	void OnPresenceReceived(const FUniqueNetId& UserId, const TSharedRef<FOnlineUserPresence>& Presence);
+
+	void CompleteRequests(int32 LocalUserNum, bool bWasSuccessful);
+};
@@ -27,7 +27,7 @@ DECLARE_LOG_CATEGORY_EXTERN(AdvancedSessionsLog, Log, All);
 
 
 UCLASS()
-class UAdvancedSessionsLibrary : public UBlueprintFunctionLibrary
+class ADVANCEDSESSIONS_API UAdvancedSessionsLibrary : public UBlueprintFunctionLibrary
 {
 	GENERATED_BODY()
 public:
@@ -50,7 +50,7 @@ public:
 
 		// Get an array of the session settings from a session search result
 		UFUNCTION(BlueprintCallable, Category = "Online|AdvancedSessions|SessionInfo")
-		static void GetExtraSettings(FBlueprintSessionResult SessionResult, TArray<FSessionPropertyKeyPair> & ExtraSettings);
+		static void GetExtraSettings(const FBlueprintSessionResult & SessionResult, TArray<FSessionPropertyKeyPair> & ExtraSettings);
 
 		// Get the current session state
 		UFUNCTION(BlueprintCallable, Category = "Online|AdvancedSessions|SessionInfo", meta = (WorldContext = "WorldContextObject"))
@@ -132,6 +132,44 @@ public:
 		static void GetSessionPropertyFloat(const TArray<FSessionPropertyKeyPair> & ExtraSettings, FName SettingName, ESessionSettingSearchResult &SearchResult, float &SettingValue);
 
 
+		// Indexes the settings of a session result by name, for reading many of them (server browser rows)
+		// Callable, not pure: a pure node runs again for every node reading its output, and would build the index each time
+		UFUNCTION(BlueprintCallable, Category = "Online|AdvancedSessions|SessionInfo|Index")
+		static FSessionPropertyIndex MakeSessionPropertyIndex(const FBlueprintSessionResult & SessionResult);
+
+		// Indexes every session result at once, in the same order
+		UFUNCTION(BlueprintCallable, Category = "Online|AdvancedSessions|SessionInfo|Index")
+		static void MakeSessionPropertyIndices(const TArray<FBlueprintSessionResult> & SessionResults, TArray<FSessionPropertyIndex> & Indices);
+
+		// Indexes an array of settings by name, the first one wins if a name is there twice
+		UFUNCTION(BlueprintCallable, Category = "Online|AdvancedSessions|SessionInfo|Index")
+		static FSessionPropertyIndex MakeSessionPropertyIndexFromArray(const TArray<FSessionPropertyKeyPair> & ExtraSettings);
+
+		// Find session property by Name in an index
+		UFUNCTION(BlueprintCallable, Category = "Online|AdvancedSessions|SessionInfo|Index", meta = (ExpandEnumAsExecs = "Result"))
+		static void FindIndexedSessionProperty(const FSessionPropertyIndex & PropertyIndex, FName SettingName, EBlueprintResultSwitch &Result, FSessionPropertyKeyPair& OutProperty);
+
+		// Get session custom information key/value as Byte (For Enums) from an index
+		UFUNCTION(BlueprintCallable, Category = "Online|AdvancedSessions|SessionInfo|Index", meta = (ExpandEnumAsExecs = "SearchResult"))
+		static void GetIndexedSessionPropertyByte(const FSessionPropertyIndex & PropertyIndex, FName SettingName, ESessionSettingSearchResult &SearchResult, uint8 &SettingValue);
+
+		// Get session custom information key/value as Bool from an index
+		UFUNCTION(BlueprintCallable, Category = "Online|AdvancedSessions|SessionInfo|Index", meta = (ExpandEnumAsExecs = "SearchResult"))
+		static void GetIndexedSessionPropertyBool(const FSessionPropertyIndex & PropertyIndex, FName SettingName, ESessionSettingSearchResult &SearchResult, bool &SettingValue);
+
+		// Get session custom information key/value as String from an index
+		UFUNCTION(BlueprintCallable, Category = "Online|AdvancedSessions|SessionInfo|Index", meta = (ExpandEnumAsExecs = "SearchResult"))
+		static void GetIndexedSessionPropertyString(const FSessionPropertyIndex & PropertyIndex, FName SettingName, ESessionSettingSearchResult &SearchResult, FString &SettingValue);
+
+		// Get session custom information key/value as Int from an index
+		UFUNCTION(BlueprintCallable, Category = "Online|AdvancedSessions|SessionInfo|Index", meta = (ExpandEnumAsExecs = "SearchResult"))
+		static void GetIndexedSessionPropertyInt(const FSessionPropertyIndex & PropertyIndex, FName SettingName, ESessionSettingSearchResult &SearchResult, int32 &SettingValue);
+
+		// Get session custom information key/value as Float from an index
+		UFUNCTION(BlueprintCallable, Category = "Online|AdvancedSessions|SessionInfo|Index", meta = (ExpandEnumAsExecs = "SearchResult"))
+		static void GetIndexedSessionPropertyFloat(const FSessionPropertyIndex & PropertyIndex, FName SettingName, ESessionSettingSearchResult &SearchResult, float &SettingValue);
+
+
 		// Make a literal session custom information key/value pair from Byte (For Enums)
 		UFUNCTION(BlueprintPure, Category = "Online|AdvancedSessions|SessionInfo|Literals")
 		static FSessionPropertyKeyPair MakeLiteralSessionPropertyByte(FName Key, uint8 Value);
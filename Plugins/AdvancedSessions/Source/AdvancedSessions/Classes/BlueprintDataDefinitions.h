@@ -302,6 +302,16 @@ struct FSessionPropertyKeyPair
 	FVariantData Data;
 };
 
+// Session properties by name, build it once per session result and use it for every property of that result
+// The array versions have to look at every setting for every property
+USTRUCT(BlueprintType)
+struct FSessionPropertyIndex
+{
+	GENERATED_USTRUCT_BODY()
+
+	TMap<FName, FVariantData> Settings;
+};
+
 
 // Sent to the FindSessionsAdvanced to filter the end results
 USTRUCT(BlueprintType)
@@ -20,15 +20,21 @@ class UFindSessionsCallbackProxyAdvanced : public UOnlineBlueprintCallProxyBase
 	UPROPERTY(BlueprintAssignable)
 	FBlueprintFindSessionsResultDelegate OnFailure;
 
+	// Called every time one of the searches brings new sessions, with only the new ones, before OnSuccess / OnFailure
+	// Lets the server list fill up with the first search while the dedicated one still runs
+	UPROPERTY(BlueprintAssignable)
+	FBlueprintFindSessionsResultDelegate OnResultsFound;
+
 	// Searches for advertised sessions with the default online subsystem and includes an array of filters
 	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", AutoCreateRefTerm="Filters"), Category = "Online|AdvancedSessions")
-	static UFindSessionsCallbackProxyAdvanced* FindSessionsAdvanced(UObject* WorldContextObject, class APlayerController* PlayerController, int32 MaxResults, bool bUseLAN, EBPServerPresenceSearchType ServerTypeToSearch, const TArray<FSessionsSearchSetting> &Filters, bool bEmptyServersOnly = false, bool bNonEmptyServersOnly = false, bool bSecureServersOnly = false, int MinSlotsAvailable = 0);
+	static ADVANCEDSESSIONS_API UFindSessionsCallbackProxyAdvanced* FindSessionsAdvanced(UObject* WorldContextObject, class APlayerController* PlayerController, int32 MaxResults, bool bUseLAN, EBPServerPresenceSearchType ServerTypeToSearch, const TArray<FSessionsSearchSetting> &Filters, bool bEmptyServersOnly = false, bool bNonEmptyServersOnly = false, bool bSecureServersOnly = false, int MinSlotsAvailable = 0);
 
 	static bool CompareVariants(const FVariantData &A, const FVariantData &B, EOnlineComparisonOpRedux Comparator);
 	
 	// Filters an array of session results by the given search parameters, returns a new array with the filtered results
+	// Looks the settings up by name in each result, filter the whole list with one call instead of row by row
 	UFUNCTION(BluePrintCallable, meta = (Category = "Online|AdvancedSessions"))
-	static void FilterSessionResults(const TArray<FBlueprintSessionResult> &SessionResults, const TArray<FSessionsSearchSetting> &Filters, TArray<FBlueprintSessionResult> &FilteredResults);
+	static ADVANCEDSESSIONS_API void FilterSessionResults(const TArray<FBlueprintSessionResult> &SessionResults, const TArray<FSessionsSearchSetting> &Filters, TArray<FBlueprintSessionResult> &FilteredResults);
 	
 	// Removed, the default built in versions work fine in the normal FindSessionsCallbackProxy
 	/*UFUNCTION(BlueprintPure, Category = "Online|Session")
@@ -48,15 +54,35 @@ class UFindSessionsCallbackProxyAdvanced : public UOnlineBlueprintCallProxyBase
 	virtual void Activate() override;
 	// End of UOnlineBlueprintCallProxyBase interface
 
+	// Seconds from Activate to the first session found, -1 if none was found yet
+	double GetTimeToFirstResult() const { return TimeToFirstResult; }
+
 private:
 	// Internal callback when the session search completes, calls out to the public success/failure callbacks
 	void OnCompleted(bool bSuccess);
 
+	// Starts the dedicated search once the first one is done, returns false if the subsystem didn't take it
+	// Steam only runs one FindSessions at a time per session interface, so the two searches are sequential
+	bool StartDedicatedSearch(IOnlineSessionPtr Sessions, const FUniqueNetId & UserID);
+
+	// Adds the sessions we didn't have yet and sends them to OnResultsFound
+	void AddSearchResults(const TSharedPtr<FOnlineSessionSearch> & Search);
+
 	bool bRunSecondSearch;
-	bool bIsOnSecondSearch;
+	bool bSearchDone;
+	bool bDedicatedSearchStarted;
+	bool bDedicatedSearchDone;
+	bool bAnySearchSucceeded;
+	bool bFinished;
 
 	TArray<FBlueprintSessionResult> SessionSearchResults;
 
+	// Ids of the sessions we already have, a session can show up in both searches
+	TSet<FString> FoundSessionIds;
+
+	double SearchStartTime;
+	double TimeToFirstResult;
+
 private:
 	// The player controller triggering things
 	TWeakObjectPtr<APlayerController> PlayerControllerWeakPtr;
@@ -24,6 +24,7 @@ class UGetFriendsCallbackProxy : public UOnlineBlueprintCallProxyBase
 	FBlueprintGetFriendsListDelegate OnFailure;
 
 	// Gets the players list of friends from the OnlineSubsystem and returns it, can be retrieved later with GetStoredFriendsList
+	// The list is cached by the friends cache subsystem, calls within its MinReadInterval don't read it again
 	UFUNCTION(BlueprintCallable, meta=(BlueprintInternalUseOnly = "true", WorldContext="WorldContextObject"), Category = "Online|AdvancedFriends")
 	static UGetFriendsCallbackProxy* GetAndStoreFriendsList(UObject* WorldContextObject, class APlayerController* PlayerController);
 
@@ -33,6 +34,9 @@ private:
 	// Internal callback when the friends list is retrieved
 	void OnReadFriendsListCompleted(int32 LocalUserNum, bool bWasSuccessful, const FString& ListName, const FString& ErrorString);
 
+	// Internal callback when the friends cache is up to date
+	void OnFriendsCacheReadCompleted(int32 LocalUserNum, bool bWasSuccessful);
+
 	// The player controller triggering things
 	TWeakObjectPtr<APlayerController> PlayerControllerWeakPtr;
 
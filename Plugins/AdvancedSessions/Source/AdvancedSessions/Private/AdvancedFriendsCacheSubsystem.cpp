@@ -0,0 +1,287 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "AdvancedFriendsCacheSubsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "OnlineSubsystemUtils.h"
+
+//General Log
+DEFINE_LOG_CATEGORY(AdvancedFriendsCacheLog);
+
+UAdvancedFriendsCacheSubsystem::UAdvancedFriendsCacheSubsystem()
+	: MinReadInterval(30.0f)
+{
+}
+
+void UAdvancedFriendsCacheSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	IOnlinePresencePtr PresenceInterface = Online::GetPresenceInterface(GetGameInstance()->GetWorld());
+
+	if (PresenceInterface.IsValid())
+	{
+		PresenceReceivedHandle = PresenceInterface->AddOnPresenceReceivedDelegate_Handle(FOnPresenceReceivedDelegate::CreateUObject(this, &ThisClass::OnPresenceReceived));
+	}
+}
+
+void UAdvancedFriendsCacheSubsystem::Deinitialize()
+{
+	UWorld* World = GetGameInstance()->GetWorld();
+
+	IOnlinePresencePtr PresenceInterface = Online::GetPresenceInterface(World);
+
+	if (PresenceInterface.IsValid())
+	{
+		PresenceInterface->ClearOnPresenceReceivedDelegate_Handle(PresenceReceivedHandle);
+	}
+
+	IOnlineFriendsPtr FriendsInterface = Online::GetFriendsInterface(World);
+
+	if (FriendsInterface.IsValid())
+	{
+		for (TPair<int32, FAdvancedCachedFriendsList>& CachedList : CachedLists)
+		{
+			FriendsInterface->ClearOnFriendsChangeDelegate_Handle(CachedList.Key, CachedList.Value.FriendsChangeHandle);
+		}
+	}
+
+	CachedLists.Empty();
+
+	Super::Deinitialize();
+}
+
+UAdvancedFriendsCacheSubsystem* UAdvancedFriendsCacheSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+
+	return GameInstance ? GameInstance->GetSubsystem<UAdvancedFriendsCacheSubsystem>() : nullptr;
+}
+
+void UAdvancedFriendsCacheSubsystem::RequestFriendsList(int32 LocalUserNum, const FOnFriendsCacheReadComplete& Delegate, bool bForceRead)
+{
+	IOnlineFriendsPtr FriendsInterface = Online::GetFriendsInterface(GetGameInstance()->GetWorld());
+
+	if (!FriendsInterface.IsValid())
+	{
+		UE_LOG(AdvancedFriendsCacheLog, Warning, TEXT("RequestFriendsList Failed to get friends interface!"));
+		Delegate.ExecuteIfBound(LocalUserNum, false);
+		return;
+	}
+
+	FAdvancedCachedFriendsList& CachedList = CachedLists.FindOrAdd(LocalUserNum);
+
+	if (!CachedList.FriendsChangeHandle.IsValid())
+	{
+		CachedList.FriendsChangeHandle = FriendsInterface->AddOnFriendsChangeDelegate_Handle(LocalUserNum, FOnFriendsChangeDelegate::CreateUObject(this, &ThisClass::OnFriendsChange, LocalUserNum));
+	}
+
+	// Someone already asked, wait for the same read
+	if (CachedList.bReadInFlight)
+	{
+		if (Delegate.IsBound())
+		{
+			CachedList.PendingDelegates.Add(Delegate);
+		}
+		return;
+	}
+
+	const bool bTooSoon = FPlatformTime::Seconds() - CachedList.LastReadTime < MinReadInterval;
+
+	if (CachedList.bHasBeenRead && bTooSoon && !CachedList.bDirty && !bForceRead)
+	{
+		Delegate.ExecuteIfBound(LocalUserNum, true);
+		return;
+	}
+
+	if (Delegate.IsBound())
+	{
+		CachedList.PendingDelegates.Add(Delegate);
+	}
+
+	CachedList.bReadInFlight = true;
+	CachedList.bDirty = false;
+
+	// Can complete before it returns, nothing of the cached list can be used after this
+	if (!FriendsInterface->ReadFriendsList(LocalUserNum, EFriendsLists::ToString((EFriendsLists::Default)), FOnReadFriendsListComplete::CreateUObject(this, &ThisClass::OnReadFriendsListCompleted)))
+	{
+		UE_LOG(AdvancedFriendsCacheLog, Warning, TEXT("RequestFriendsList Failed to start reading the friends list!"));
+
+		FAdvancedCachedFriendsList* FailedList = CachedLists.Find(LocalUserNum);
+		if (FailedList && FailedList->bReadInFlight)
+		{
+			FailedList->bReadInFlight = false;
+			FailedList->LastReadTime = FPlatformTime::Seconds();
+			CompleteRequests(LocalUserNum, false);
+		}
+	}
+}
+
+bool UAdvancedFriendsCacheSubsystem::HasFriendsList(int32 LocalUserNum) const
+{
+	const FAdvancedCachedFriendsList* CachedList = CachedLists.Find(LocalUserNum);
+	return CachedList && CachedList->bHasBeenRead;
+}
+
+bool UAdvancedFriendsCacheSubsystem::IsFriend(int32 LocalUserNum, const FUniqueNetId& UniqueNetId) const
+{
+	return FindFriend(LocalUserNum, UniqueNetId) != nullptr;
+}
+
+const FBPFriendInfo* UAdvancedFriendsCacheSubsystem::FindFriend(int32 LocalUserNum, const FUniqueNetId& UniqueNetId) const
+{
+	const FAdvancedCachedFriendsList* CachedList = CachedLists.Find(LocalUserNum);
+	return CachedList ? CachedList->Friends.Find(UniqueNetId.ToString()) : nullptr;
+}
+
+void UAdvancedFriendsCacheSubsystem::GetFriendsList(int32 LocalUserNum, TArray<FBPFriendInfo>& FriendsList) const
+{
+	const FAdvancedCachedFriendsList* CachedList = CachedLists.Find(LocalUserNum);
+
+	if (!CachedList)
+	{
+		return;
+	}
+
+	FriendsList.Reserve(FriendsList.Num() + CachedList->Friends.Num());
+
+	for (const TPair<FString, FBPFriendInfo>& Friend : CachedList->Friends)
+	{
+		FriendsList.Add(Friend.Value);
+	}
+}
+
+void UAdvancedFriendsCacheSubsystem::MakeFriendInfo(const FOnlineFriend& Friend, FBPFriendInfo& FriendInfo)
+{
+	FriendInfo.DisplayName = Friend.GetDisplayName();
+	FriendInfo.RealName = Friend.GetRealName();
+	FriendInfo.UniqueNetId.SetUniqueNetId(Friend.GetUserId());
+
+	ApplyPresence(Friend.GetPresence(), FriendInfo);
+}
+
+void UAdvancedFriendsCacheSubsystem::ApplyPresence(const FOnlineUserPresence& Presence, FBPFriendInfo& FriendInfo)
+{
+	FriendInfo.OnlineState = ((EBPOnlinePresenceState)((int32)Presence.Status.State));
+	FriendInfo.bIsPlayingSameGame = Presence.bIsPlayingThisGame;
+
+	FriendInfo.PresenceInfo.bIsOnline = Presence.bIsOnline;
+	FriendInfo.PresenceInfo.bHasVoiceSupport = Presence.bHasVoiceSupport;
+	FriendInfo.PresenceInfo.bIsPlaying = Presence.bIsPlaying;
+	FriendInfo.PresenceInfo.PresenceState = ((EBPOnlinePresenceState)((int32)Presence.Status.State));
+	FriendInfo.PresenceInfo.StatusString = Presence.Status.StatusStr;
+	FriendInfo.PresenceInfo.bIsJoinable = Presence.bIsJoinable;
+	FriendInfo.PresenceInfo.bIsPlayingThisGame = Presence.bIsPlayingThisGame;
+}
+
+void UAdvancedFriendsCacheSubsystem::OnReadFriendsListCompleted(int32 LocalUserNum, bool bWasSuccessful, const FString& ListName, const FString& ErrorString)
+{
+	FAdvancedCachedFriendsList* CachedList = CachedLists.Find(LocalUserNum);
+
+	if (!CachedList || !CachedList->bReadInFlight)
+	{
+		return;
+	}
+
+	CachedList->bReadInFlight = false;
+	CachedList->LastReadTime = FPlatformTime::Seconds();
+
+	IOnlineFriendsPtr FriendsInterface = Online::GetFriendsInterface(GetGameInstance()->GetWorld());
+
+	if (!bWasSuccessful || !FriendsInterface.IsValid())
+	{
+		UE_LOG(AdvancedFriendsCacheLog, Warning, TEXT("Reading the friends list failed: %s"), *ErrorString);
+		CompleteRequests(LocalUserNum, false);
+		return;
+	}
+
+	TArray< TSharedRef<FOnlineFriend> > FriendList;
+	FriendsInterface->GetFriendsList(LocalUserNum, ListName, FriendList);
+
+	// Friends we already have are updated in place, only the ones that are gone are removed
+	TSet<FString> ReadFriends;
+	ReadFriends.Reserve(FriendList.Num());
+	int32 NumAdded = 0;
+
+	for (const TSharedRef<FOnlineFriend>& Friend : FriendList)
+	{
+		const FString FriendKey = Friend->GetUserId()->ToString();
+		ReadFriends.Add(FriendKey);
+
+		FBPFriendInfo* FriendInfo = CachedList->Friends.Find(FriendKey);
+		if (!FriendInfo)
+		{
+			FriendInfo = &CachedList->Friends.Add(FriendKey);
+			++NumAdded;
+		}
+
+		MakeFriendInfo(*Friend, *FriendInfo);
+	}
+
+	int32 NumRemoved = 0;
+
+	for (auto It = CachedList->Friends.CreateIterator(); It; ++It)
+	{
+		if (!ReadFriends.Contains(It.Key()))
+		{
+			It.RemoveCurrent();
+			++NumRemoved;
+		}
+	}
+
+	CachedList->bHasBeenRead = true;
+
+	UE_LOG(AdvancedFriendsCacheLog, Verbose, TEXT("Friends list of user %d read: %d friends, %d added, %d removed."), LocalUserNum, CachedList->Friends.Num(), NumAdded, NumRemoved);
+
+	CompleteRequests(LocalUserNum, true);
+}
+
+void UAdvancedFriendsCacheSubsystem::OnFriendsChange(int32 LocalUserNum)
+{
+	FAdvancedCachedFriendsList* CachedList = CachedLists.Find(LocalUserNum);
+
+	if (!CachedList)
+	{
+		return;
+	}
+
+	CachedList->bDirty = true;
+
+	// Only keep up to date the lists someone already asked for
+	if (CachedList->bHasBeenRead && !CachedList->bReadInFlight)
+	{
+		RequestFriendsList(LocalUserNum, FOnFriendsCacheReadComplete());
+	}
+}
+
+void UAdvancedFriendsCacheSubsystem::OnPresenceReceived(const FUniqueNetId& UserId, const TSharedRef<FOnlineUserPresence>& Presence)
+{
+	const FString FriendKey = UserId.ToString();
+
+	for (TPair<int32, FAdvancedCachedFriendsList>& CachedList : CachedLists)
+	{
+		if (FBPFriendInfo* FriendInfo = CachedList.Value.Friends.Find(FriendKey))
+		{
+			ApplyPresence(*Presence, *FriendInfo);
+		}
+	}
+}
+
+void UAdvancedFriendsCacheSubsystem::CompleteRequests(int32 LocalUserNum, bool bWasSuccessful)
+{
+	FAdvancedCachedFriendsList* CachedList = CachedLists.Find(LocalUserNum);
+
+	if (!CachedList)
+	{
+		return;
+	}
+
+	// The delegates can request again, so they run on a copy
+	TArray<FOnFriendsCacheReadComplete> Delegates = MoveTemp(CachedList->PendingDelegates);
+	CachedList->PendingDelegates.Reset();
+
+	for (const FOnFriendsCacheReadComplete& Delegate : Delegates)
+	{
+		Delegate.ExecuteIfBound(LocalUserNum, bWasSuccessful);
+	}
+}
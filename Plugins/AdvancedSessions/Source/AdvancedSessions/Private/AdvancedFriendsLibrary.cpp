@@ -1,5 +1,6 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 #include "AdvancedFriendsLibrary.h"
+#include "AdvancedFriendsCacheSubsystem.h"
 
 
 
@@ -135,6 +136,17 @@ void UAdvancedFriendsLibrary::GetFriend(APlayerController *PlayerController, con
 		return;
 	}
 
+	// Answered from the friends cache once it has read the list
+	UAdvancedFriendsCacheSubsystem* FriendsCache = UAdvancedFriendsCacheSubsystem::Get(PlayerController);
+	if (FriendsCache && FriendsCache->HasFriendsList(Player->GetControllerId()))
+	{
+		if (const FBPFriendInfo* CachedFriend = FriendsCache->FindFriend(Player->GetControllerId(), *FriendUniqueNetId.GetUniqueNetId()))
+		{
+			Friend = *CachedFriend;
+		}
+		return;
+	}
+
 	TSharedPtr<FOnlineFriend> fr = FriendsInterface->GetFriend(Player->GetControllerId(), *FriendUniqueNetId.GetUniqueNetId(), EFriendsLists::ToString(EFriendsLists::Default));
 	if (fr.IsValid())
 	{
@@ -185,6 +197,13 @@ void UAdvancedFriendsLibrary::IsAFriend(APlayerController *PlayerController, con
 		return;
 	}
 
+	UAdvancedFriendsCacheSubsystem* FriendsCache = UAdvancedFriendsCacheSubsystem::Get(PlayerController);
+	if (FriendsCache && FriendsCache->HasFriendsList(Player->GetControllerId()))
+	{
+		IsFriend = FriendsCache->IsFriend(Player->GetControllerId(), *UniqueNetId.GetUniqueNetId());
+		return;
+	}
+
 	IsFriend = FriendsInterface->IsFriend(Player->GetControllerId(), *UniqueNetId.GetUniqueNetId(), EFriendsLists::ToString(EFriendsLists::Default));
 }
 
@@ -246,29 +265,20 @@ void UAdvancedFriendsLibrary::GetStoredFriendsList(APlayerController *PlayerCont
 	}
 
 
+	UAdvancedFriendsCacheSubsystem* FriendsCache = UAdvancedFriendsCacheSubsystem::Get(PlayerController);
+	if (FriendsCache && FriendsCache->HasFriendsList(Player->GetControllerId()))
+	{
+		FriendsCache->GetFriendsList(Player->GetControllerId(), FriendsList);
+		return;
+	}
+
 	TArray< TSharedRef<FOnlineFriend> > FriendList;
 	FriendsInterface->GetFriendsList(Player->GetControllerId(), EFriendsLists::ToString((EFriendsLists::Default)), FriendList);
 
 	for (int32 i = 0; i < FriendList.Num(); i++)
 	{
-		TSharedRef<FOnlineFriend> Friend = FriendList[i];
 		FBPFriendInfo BPF;
-		FOnlineUserPresence pres = Friend->GetPresence();
-
-		BPF.OnlineState = ((EBPOnlinePresenceState)((int32)pres.Status.State));
-		BPF.DisplayName = Friend->GetDisplayName();
-		BPF.RealName = Friend->GetRealName();
-		BPF.UniqueNetId.SetUniqueNetId(Friend->GetUserId());
-		BPF.bIsPlayingSameGame = pres.bIsPlayingThisGame;
-
-		BPF.PresenceInfo.bIsOnline = pres.bIsOnline;
-		BPF.PresenceInfo.bHasVoiceSupport = pres.bHasVoiceSupport;
-		BPF.PresenceInfo.bIsPlaying = pres.bIsPlaying;
-		BPF.PresenceInfo.PresenceState = ((EBPOnlinePresenceState)((int32)pres.Status.State));
-		BPF.PresenceInfo.StatusString = pres.Status.StatusStr;
-		BPF.PresenceInfo.bIsJoinable = pres.bIsJoinable;
-		BPF.PresenceInfo.bIsPlayingThisGame = pres.bIsPlayingThisGame;
-
+		UAdvancedFriendsCacheSubsystem::MakeFriendInfo(*FriendList[i], BPF);
 		FriendsList.Add(BPF);
 	}
 }
\ No newline at end of file
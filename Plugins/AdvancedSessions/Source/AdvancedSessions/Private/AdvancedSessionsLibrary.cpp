@@ -126,36 +126,46 @@ void UAdvancedSessionsLibrary::FindSessionPropertyIndexByName(const TArray<FSess
 void UAdvancedSessionsLibrary::AddOrModifyExtraSettings(UPARAM(ref) TArray<FSessionPropertyKeyPair> & SettingsArray, UPARAM(ref) TArray<FSessionPropertyKeyPair> & NewOrChangedSettings, TArray<FSessionPropertyKeyPair> & ModifiedSettingsArray)
 {
 	ModifiedSettingsArray = SettingsArray;
+	ModifiedSettingsArray.Reserve(SettingsArray.Num() + NewOrChangedSettings.Num());
+
+	// Where every key is, so each new setting doesn't have to look through the whole array
+	// Multi map as a key that is in the array more than once gets all of its entries changed
+	TMultiMap<FName, int32> SettingIndices;
+	SettingIndices.Reserve(ModifiedSettingsArray.Num());
+	for (int32 i = 0; i < ModifiedSettingsArray.Num(); i++)
+	{
+		SettingIndices.Add(ModifiedSettingsArray[i].Key, i);
+	}
+
+	TArray<int32, TInlineAllocator<4>> FoundIndices;
 
-	bool bFoundSetting = false;
 	// For each new setting
 	for (const FSessionPropertyKeyPair& Setting : NewOrChangedSettings)
 	{
-		bFoundSetting = false;
+		FoundIndices.Reset();
+		SettingIndices.MultiFind(Setting.Key, FoundIndices);
 
-		for (FSessionPropertyKeyPair & itr : ModifiedSettingsArray)
+		for (int32 Index : FoundIndices)
 		{
-			// Manually comparing the keys
-			if (itr.Key == Setting.Key)
-			{
-				bFoundSetting = true;
-				itr.Data = Setting.Data;
-			}
+			ModifiedSettingsArray[Index].Data = Setting.Data;
 		}
 
 		// If it was not found, add to the array instead
-		if (!bFoundSetting)
+		if (FoundIndices.Num() == 0)
 		{
-			ModifiedSettingsArray.Add(Setting);
+			SettingIndices.Add(Setting.Key, ModifiedSettingsArray.Add(Setting));
 		}
 	}
 
 }
 
-void UAdvancedSessionsLibrary::GetExtraSettings(FBlueprintSessionResult SessionResult, TArray<FSessionPropertyKeyPair> & ExtraSettings)
+void UAdvancedSessionsLibrary::GetExtraSettings(const FBlueprintSessionResult & SessionResult, TArray<FSessionPropertyKeyPair> & ExtraSettings)
 {
+	const FOnlineKeyValuePairs<FName, FOnlineSessionSetting> & Settings = SessionResult.OnlineResult.Session.SessionSettings.Settings;
+	ExtraSettings.Reserve(ExtraSettings.Num() + Settings.Num());
+
 	FSessionPropertyKeyPair NewSetting;
-	for (auto& Elem : SessionResult.OnlineResult.Session.SessionSettings.Settings)
+	for (auto& Elem : Settings)
 	{
 		NewSetting.Key = Elem.Key;
 		NewSetting.Data = Elem.Value.Data;
@@ -282,121 +292,142 @@ FSessionPropertyKeyPair UAdvancedSessionsLibrary::MakeLiteralSessionPropertyFloa
 	return Prop;
 }
 
-void UAdvancedSessionsLibrary::GetSessionPropertyByte(const TArray<FSessionPropertyKeyPair> & ExtraSettings, FName SettingName, ESessionSettingSearchResult &SearchResult, uint8 &SettingValue)
+// The first setting with this name, null if there is none
+static const FVariantData* FindSessionPropertyData(const TArray<FSessionPropertyKeyPair> & ExtraSettings, FName SettingName)
+{
+	const FSessionPropertyKeyPair* prop = ExtraSettings.FindByPredicate([&](const FSessionPropertyKeyPair& it) {return it.Key == SettingName; });
+	return prop ? &prop->Data : nullptr;
+}
+
+// Shared by the array and the index getters, a null Data means the setting wasn't found
+template<typename ValueType>
+static void ReadSessionProperty(const FVariantData* Data, EOnlineKeyValuePairDataType::Type ExpectedType, ESessionSettingSearchResult &SearchResult, ValueType &SettingValue)
 {
-	for (FSessionPropertyKeyPair itr : ExtraSettings)
+	if (!Data)
 	{
-		if (itr.Key == SettingName)
-		{
-			if (itr.Data.GetType() == EOnlineKeyValuePairDataType::Int32)
-			{
-				int32 Val;
-				itr.Data.GetValue(Val);
-				SettingValue = (uint8)(Val);
-				SearchResult = ESessionSettingSearchResult::Found;
-			}
-			else
-			{
-				SearchResult = ESessionSettingSearchResult::WrongType;
-			}
-			return;
-		}
+		SearchResult = ESessionSettingSearchResult::NotFound;
 	}
+	else if (Data->GetType() != ExpectedType)
+	{
+		SearchResult = ESessionSettingSearchResult::WrongType;
+	}
+	else
+	{
+		Data->GetValue(SettingValue);
+		SearchResult = ESessionSettingSearchResult::Found;
+	}
+}
 
-	SearchResult = ESessionSettingSearchResult::NotFound;
-	return;
+// Bytes are stored as Int32
+static void ReadSessionPropertyByte(const FVariantData* Data, ESessionSettingSearchResult &SearchResult, uint8 &SettingValue)
+{
+	int32 Val;
+	ReadSessionProperty(Data, EOnlineKeyValuePairDataType::Int32, SearchResult, Val);
+
+	if (SearchResult == ESessionSettingSearchResult::Found)
+		SettingValue = (uint8)(Val);
+}
+
+void UAdvancedSessionsLibrary::GetSessionPropertyByte(const TArray<FSessionPropertyKeyPair> & ExtraSettings, FName SettingName, ESessionSettingSearchResult &SearchResult, uint8 &SettingValue)
+{
+	ReadSessionPropertyByte(FindSessionPropertyData(ExtraSettings, SettingName), SearchResult, SettingValue);
 }
 
 void UAdvancedSessionsLibrary::GetSessionPropertyBool(const TArray<FSessionPropertyKeyPair> & ExtraSettings, FName SettingName, ESessionSettingSearchResult &SearchResult, bool &SettingValue)
 {
-	for (FSessionPropertyKeyPair itr : ExtraSettings)
+	ReadSessionProperty(FindSessionPropertyData(ExtraSettings, SettingName), EOnlineKeyValuePairDataType::Bool, SearchResult, SettingValue);
+}
+
+void UAdvancedSessionsLibrary::GetSessionPropertyString(const TArray<FSessionPropertyKeyPair> & ExtraSettings, FName SettingName, ESessionSettingSearchResult &SearchResult, FString &SettingValue)
+{
+	ReadSessionProperty(FindSessionPropertyData(ExtraSettings, SettingName), EOnlineKeyValuePairDataType::String, SearchResult, SettingValue);
+}
+
+void UAdvancedSessionsLibrary::GetSessionPropertyInt(const TArray<FSessionPropertyKeyPair> & ExtraSettings, FName SettingName, ESessionSettingSearchResult &SearchResult, int32 &SettingValue)
+{
+	ReadSessionProperty(FindSessionPropertyData(ExtraSettings, SettingName), EOnlineKeyValuePairDataType::Int32, SearchResult, SettingValue);
+}
+
+void UAdvancedSessionsLibrary::GetSessionPropertyFloat(const TArray<FSessionPropertyKeyPair> & ExtraSettings, FName SettingName, ESessionSettingSearchResult &SearchResult, float &SettingValue)
+{
+	ReadSessionProperty(FindSessionPropertyData(ExtraSettings, SettingName), EOnlineKeyValuePairDataType::Float, SearchResult, SettingValue);
+}
+
+FSessionPropertyIndex UAdvancedSessionsLibrary::MakeSessionPropertyIndex(const FBlueprintSessionResult & SessionResult)
+{
+	FSessionPropertyIndex PropertyIndex;
+	const FOnlineKeyValuePairs<FName, FOnlineSessionSetting> & Settings = SessionResult.OnlineResult.Session.SessionSettings.Settings;
+	PropertyIndex.Settings.Reserve(Settings.Num());
+
+	for (auto& Elem : Settings)
 	{
-		if (itr.Key == SettingName)
-		{
-			if (itr.Data.GetType() == EOnlineKeyValuePairDataType::Bool)
-			{
-				itr.Data.GetValue(SettingValue);
-				SearchResult = ESessionSettingSearchResult::Found;
-			}
-			else
-			{
-				SearchResult = ESessionSettingSearchResult::WrongType;
-			}
-			return;
-		}
+		PropertyIndex.Settings.Add(Elem.Key, Elem.Value.Data);
 	}
 
-	SearchResult = ESessionSettingSearchResult::NotFound;
-	return;
+	return PropertyIndex;
 }
 
-void UAdvancedSessionsLibrary::GetSessionPropertyString(const TArray<FSessionPropertyKeyPair> & ExtraSettings, FName SettingName, ESessionSettingSearchResult &SearchResult, FString &SettingValue)
+void UAdvancedSessionsLibrary::MakeSessionPropertyIndices(const TArray<FBlueprintSessionResult> & SessionResults, TArray<FSessionPropertyIndex> & Indices)
 {
-	for (FSessionPropertyKeyPair itr : ExtraSettings)
+	Indices.Reset(SessionResults.Num());
+
+	for (const FBlueprintSessionResult & SessionResult : SessionResults)
 	{
-		if (itr.Key == SettingName)
-		{
-			if (itr.Data.GetType() == EOnlineKeyValuePairDataType::String)
-			{
-				itr.Data.GetValue(SettingValue);
-				SearchResult = ESessionSettingSearchResult::Found;
-			}
-			else
-			{
-				SearchResult = ESessionSettingSearchResult::WrongType;
-			}
-			return;
-		}
+		Indices.Add(MakeSessionPropertyIndex(SessionResult));
 	}
-
-	SearchResult = ESessionSettingSearchResult::NotFound;
-	return;
 }
 
-void UAdvancedSessionsLibrary::GetSessionPropertyInt(const TArray<FSessionPropertyKeyPair> & ExtraSettings, FName SettingName, ESessionSettingSearchResult &SearchResult, int32 &SettingValue)
+FSessionPropertyIndex UAdvancedSessionsLibrary::MakeSessionPropertyIndexFromArray(const TArray<FSessionPropertyKeyPair> & ExtraSettings)
 {
-	for (FSessionPropertyKeyPair itr : ExtraSettings)
+	FSessionPropertyIndex PropertyIndex;
+	PropertyIndex.Settings.Reserve(ExtraSettings.Num());
+
+	for (const FSessionPropertyKeyPair & Setting : ExtraSettings)
 	{
-		if (itr.Key == SettingName)
-		{
-			if (itr.Data.GetType() == EOnlineKeyValuePairDataType::Int32)
-			{
-				itr.Data.GetValue(SettingValue);
-				SearchResult = ESessionSettingSearchResult::Found;
-			}
-			else
-			{
-				SearchResult = ESessionSettingSearchResult::WrongType;
-			}
-			return;
-		}
+		// Same as the array getters, they stop at the first one
+		if (!PropertyIndex.Settings.Contains(Setting.Key))
+			PropertyIndex.Settings.Add(Setting.Key, Setting.Data);
 	}
 
-	SearchResult = ESessionSettingSearchResult::NotFound;
-	return;
+	return PropertyIndex;
 }
 
-void UAdvancedSessionsLibrary::GetSessionPropertyFloat(const TArray<FSessionPropertyKeyPair> & ExtraSettings, FName SettingName, ESessionSettingSearchResult &SearchResult, float &SettingValue)
+void UAdvancedSessionsLibrary::FindIndexedSessionProperty(const FSessionPropertyIndex & PropertyIndex, FName SettingName, EBlueprintResultSwitch &Result, FSessionPropertyKeyPair& OutProperty)
 {
-	for (FSessionPropertyKeyPair itr : ExtraSettings)
+	if (const FVariantData* Data = PropertyIndex.Settings.Find(SettingName))
 	{
-		if (itr.Key == SettingName)
-		{
-			if (itr.Data.GetType() == EOnlineKeyValuePairDataType::Float)
-			{
-				itr.Data.GetValue(SettingValue);
-				SearchResult = ESessionSettingSearchResult::Found;
-			}
-			else
-			{
-				SearchResult = ESessionSettingSearchResult::WrongType;
-			}
-			return;
-		}
+		Result = EBlueprintResultSwitch::OnSuccess;
+		OutProperty.Key = SettingName;
+		OutProperty.Data = *Data;
+		return;
 	}
 
-	SearchResult = ESessionSettingSearchResult::NotFound;
-	return;
+	Result = EBlueprintResultSwitch::OnFailure;
+}
+
+void UAdvancedSessionsLibrary::GetIndexedSessionPropertyByte(const FSessionPropertyIndex & PropertyIndex, FName SettingName, ESessionSettingSearchResult &SearchResult, uint8 &SettingValue)
+{
+	ReadSessionPropertyByte(PropertyIndex.Settings.Find(SettingName), SearchResult, SettingValue);
+}
+
+void UAdvancedSessionsLibrary::GetIndexedSessionPropertyBool(const FSessionPropertyIndex & PropertyIndex, FName SettingName, ESessionSettingSearchResult &SearchResult, bool &SettingValue)
+{
+	ReadSessionProperty(PropertyIndex.Settings.Find(SettingName), EOnlineKeyValuePairDataType::Bool, SearchResult, SettingValue);
+}
+
+void UAdvancedSessionsLibrary::GetIndexedSessionPropertyString(const FSessionPropertyIndex & PropertyIndex, FName SettingName, ESessionSettingSearchResult &SearchResult, FString &SettingValue)
+{
+	ReadSessionProperty(PropertyIndex.Settings.Find(SettingName), EOnlineKeyValuePairDataType::String, SearchResult, SettingValue);
+}
+
+void UAdvancedSessionsLibrary::GetIndexedSessionPropertyInt(const FSessionPropertyIndex & PropertyIndex, FName SettingName, ESessionSettingSearchResult &SearchResult, int32 &SettingValue)
+{
+	ReadSessionProperty(PropertyIndex.Settings.Find(SettingName), EOnlineKeyValuePairDataType::Int32, SearchResult, SettingValue);
+}
+
+void UAdvancedSessionsLibrary::GetIndexedSessionPropertyFloat(const FSessionPropertyIndex & PropertyIndex, FName SettingName, ESessionSettingSearchResult &SearchResult, float &SettingValue)
+{
+	ReadSessionProperty(PropertyIndex.Settings.Find(SettingName), EOnlineKeyValuePairDataType::Float, SearchResult, SettingValue);
 }
 
 
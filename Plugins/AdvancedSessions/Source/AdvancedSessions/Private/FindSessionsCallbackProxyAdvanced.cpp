@@ -1,5 +1,6 @@
 // Copyright 1998-2015 Epic Games, Inc. All Rights Reserved.
 #include "FindSessionsCallbackProxyAdvanced.h"
+#include "AdvancedSessionsLibrary.h"
 
 
 //////////////////////////////////////////////////////////////////////////
@@ -12,7 +13,13 @@ UFindSessionsCallbackProxyAdvanced::UFindSessionsCallbackProxyAdvanced(const FOb
 	, bUseLAN(false)
 {
 	bRunSecondSearch = false;
-	bIsOnSecondSearch = false;
+	bSearchDone = false;
+	bDedicatedSearchStarted = false;
+	bDedicatedSearchDone = false;
+	bAnySearchSucceeded = false;
+	bFinished = false;
+	SearchStartTime = 0.0;
+	TimeToFirstResult = -1.0;
 }
 
 UFindSessionsCallbackProxyAdvanced* UFindSessionsCallbackProxyAdvanced::FindSessionsAdvanced(UObject* WorldContextObject, class APlayerController* PlayerController, int MaxResults, bool bUseLAN, EBPServerPresenceSearchType ServerTypeToSearch, const TArray<FSessionsSearchSetting> &Filters, bool bEmptyServersOnly, bool bNonEmptyServersOnly, bool bSecureServersOnly, int MinSlotsAvailable)
@@ -43,7 +50,15 @@ void UFindSessionsCallbackProxyAdvanced::Activate()
 		{
 			// Re-initialize here, otherwise I think there might be issues with people re-calling search for some reason before it is destroyed
 			bRunSecondSearch = false;
-			bIsOnSecondSearch = false;
+			bSearchDone = false;
+			bDedicatedSearchStarted = false;
+			bDedicatedSearchDone = false;
+			bAnySearchSucceeded = false;
+			bFinished = false;
+			SessionSearchResults.Empty();
+			FoundSessionIds.Empty();
+			SearchStartTime = FPlatformTime::Seconds();
+			TimeToFirstResult = -1.0;
 
 			DelegateHandle = Sessions->AddOnFindSessionsCompleteDelegate_Handle(Delegate);
 
@@ -140,7 +155,7 @@ void UFindSessionsCallbackProxyAdvanced::Activate()
 
 			Sessions->FindSessions(*Helper.UserID, SearchObject.ToSharedRef());
 
-			// OnQueryCompleted will get called, nothing more to do now
+			// OnCompleted will get called and start the dedicated search if there is one, nothing more to do now
 			return;
 		}
 		else
@@ -158,91 +173,118 @@ void UFindSessionsCallbackProxyAdvanced::OnCompleted(bool bSuccess)
 	FOnlineSubsystemBPCallHelperAdvanced Helper(TEXT("FindSessionsCallback"), GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull));
 	Helper.QueryIDFromPlayerController(PlayerControllerWeakPtr.Get());
 
-	if (!bRunSecondSearch && Helper.IsValid())
+	// Both searches complete through the same delegate, the one that finished is the one that is done or failed
+	auto IsSearchFinished = [](const TSharedPtr<FOnlineSessionSearch> & Search)
 	{
-		auto Sessions = Helper.OnlineSub->GetSessionInterface();
-		if (Sessions.IsValid())
-		{
-			Sessions->ClearOnFindSessionsCompleteDelegate_Handle(DelegateHandle);
-		}
-	}
+		return Search.IsValid() && (Search->SearchState == EOnlineAsyncTaskState::Done || Search->SearchState == EOnlineAsyncTaskState::Failed);
+	};
 
-	if (bSuccess)
+	TSharedPtr<FOnlineSessionSearch> FinishedSearch;
+
+	if (!bSearchDone && IsSearchFinished(SearchObject))
 	{
-		if (bIsOnSecondSearch)
-		{
-			if (SearchObjectDedicated.IsValid())
-			{
-				// Just log the results for now, will need to add a blueprint-compatible search result struct
-				for (auto& Result : SearchObjectDedicated->SearchResults)
-				{
-					FString ResultText = FString::Printf(TEXT("Found a session. Ping is %d"), Result.PingInMs);
+		bSearchDone = true;
+		FinishedSearch = SearchObject;
+	}
+	else if (bDedicatedSearchStarted && !bDedicatedSearchDone && IsSearchFinished(SearchObjectDedicated))
+	{
+		bDedicatedSearchDone = true;
+		FinishedSearch = SearchObjectDedicated;
+	}
 
-					FFrame::KismetExecutionMessage(*ResultText, ELogVerbosity::Log);
+	// Someone else's search on the same session interface
+	if (!FinishedSearch.IsValid())
+		return;
 
-					FBlueprintSessionResult BPResult;
-					BPResult.OnlineResult = Result;
-					SessionSearchResults.Add(BPResult);
-				}
-				OnSuccess.Broadcast(SessionSearchResults);
-				return;
-			}
-		}
-		else
-		{
-			if (SearchObject.IsValid())
-			{
-				// Just log the results for now, will need to add a blueprint-compatible search result struct
-				for (auto& Result : SearchObject->SearchResults)
-				{
-					FString ResultText = FString::Printf(TEXT("Found a session. Ping is %d"), Result.PingInMs);
+	if (bSuccess)
+	{
+		bAnySearchSucceeded = true;
+		AddSearchResults(FinishedSearch);
+	}
 
-					FFrame::KismetExecutionMessage(*ResultText, ELogVerbosity::Log);
+	IOnlineSessionPtr Sessions;
+	if (Helper.IsValid())
+		Sessions = Helper.OnlineSub->GetSessionInterface();
 
-					FBlueprintSessionResult BPResult;
-					BPResult.OnlineResult = Result;
-					SessionSearchResults.Add(BPResult);
-				}
-				if (!bRunSecondSearch)
-				{
-					OnSuccess.Broadcast(SessionSearchResults);
-					return;
-				}
-			}
-		}
-	}
-	else
+	// The first search is done, the subsystem is free for the dedicated one
+	if (bRunSecondSearch && bSearchDone && !bDedicatedSearchStarted)
 	{
-		if (!bRunSecondSearch)
+		if (!Sessions.IsValid() || !Helper.UserID.IsValid() || !StartDedicatedSearch(Sessions, *Helper.UserID))
 		{
-			// Need to account for only one of the searches failing
-			if (SessionSearchResults.Num() > 0)
-				OnSuccess.Broadcast(SessionSearchResults);
-			else
-				OnFailure.Broadcast(SessionSearchResults);
-			return;
+			// We lost our player controller
+			bDedicatedSearchDone = true;
 		}
 	}
 
-	if (Helper.IsValid() && bRunSecondSearch && ServerSearchType == EBPServerPresenceSearchType::AllServers)
+	const bool bAllSearchesDone = bSearchDone && (!bRunSecondSearch || bDedicatedSearchDone);
+
+	// A search failing right away finishes us from inside StartDedicatedSearch
+	if (!bAllSearchesDone || bFinished)
+		return;
+
+	bFinished = true;
+
+	if (Sessions.IsValid())
 	{
-		bRunSecondSearch = false;
-		bIsOnSecondSearch = true;
-		auto Sessions = Helper.OnlineSub->GetSessionInterface();
-		Sessions->FindSessions(*Helper.UserID, SearchObjectDedicated.ToSharedRef());
+		Sessions->ClearOnFindSessionsCompleteDelegate_Handle(DelegateHandle);
 	}
-	else // We lost our player controller
+
+	UE_LOG(AdvancedSessionsLog, Log, TEXT("FindSessionsAdvanced found %d sessions in %.3f seconds, first one after %.3f seconds"), SessionSearchResults.Num(), FPlatformTime::Seconds() - SearchStartTime, TimeToFirstResult);
+
+	// Need to account for only one of the searches failing
+	if (bAnySearchSucceeded || SessionSearchResults.Num() > 0)
+		OnSuccess.Broadcast(SessionSearchResults);
+	else
+		OnFailure.Broadcast(SessionSearchResults);
+}
+
+bool UFindSessionsCallbackProxyAdvanced::StartDedicatedSearch(IOnlineSessionPtr Sessions, const FUniqueNetId & UserID)
+{
+	if (!SearchObjectDedicated.IsValid())
+		return false;
+
+	// Set before, the subsystem can fail the search right away and call OnCompleted from in here
+	bDedicatedSearchStarted = true;
+	return Sessions->FindSessions(UserID, SearchObjectDedicated.ToSharedRef());
+}
+
+void UFindSessionsCallbackProxyAdvanced::AddSearchResults(const TSharedPtr<FOnlineSessionSearch> & Search)
+{
+	TArray<FBlueprintSessionResult> NewResults;
+
+	for (auto& Result : Search->SearchResults)
 	{
-		if (bSuccess && SessionSearchResults.Num() > 0)
-			OnSuccess.Broadcast(SessionSearchResults);
-		else
-			OnFailure.Broadcast(SessionSearchResults);
+		// A listen server can show up in both searches, LAN beacons can answer more than once
+		bool bAlreadyFound = false;
+		FoundSessionIds.Add(Result.GetSessionIdStr(), &bAlreadyFound);
+
+		if (bAlreadyFound)
+			continue;
+
+		FString ResultText = FString::Printf(TEXT("Found a session. Ping is %d"), Result.PingInMs);
+
+		FFrame::KismetExecutionMessage(*ResultText, ELogVerbosity::Log);
+
+		FBlueprintSessionResult BPResult;
+		BPResult.OnlineResult = Result;
+		NewResults.Add(BPResult);
 	}
+
+	if (NewResults.Num() == 0)
+		return;
+
+	if (TimeToFirstResult < 0.0)
+		TimeToFirstResult = FPlatformTime::Seconds() - SearchStartTime;
+
+	SessionSearchResults.Append(NewResults);
+	OnResultsFound.Broadcast(NewResults);
 }
 
 
 void UFindSessionsCallbackProxyAdvanced::FilterSessionResults(const TArray<FBlueprintSessionResult> &SessionResults, const TArray<FSessionsSearchSetting> &Filters, TArray<FBlueprintSessionResult> &FilteredResults)
 {
+	FilteredResults.Reserve(FilteredResults.Num() + SessionResults.Num());
+
 	for (int j = 0; j < SessionResults.Num(); j++)
 	{
 		bool bAddResult = true;
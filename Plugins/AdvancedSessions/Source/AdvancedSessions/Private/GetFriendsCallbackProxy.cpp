@@ -1,5 +1,6 @@
 // Copyright 1998-2015 Epic Games, Inc. All Rights Reserved.
 #include "GetFriendsCallbackProxy.h"
+#include "AdvancedFriendsCacheSubsystem.h"
 
 
 //////////////////////////////////////////////////////////////////////////
@@ -31,11 +32,26 @@ void UGetFriendsCallbackProxy::Activate()
 		return;
 	}
 
+	ULocalPlayer* Player = Cast<ULocalPlayer>(PlayerControllerWeakPtr->Player);
+
+	if (!Player)
+	{
+		UE_LOG(AdvancedGetFriendsLog, Warning, TEXT("GetFriends Failed to get LocalPlayer!"));
+		TArray<FBPFriendInfo> EmptyArray;
+		OnFailure.Broadcast(EmptyArray);
+		return;
+	}
+
+	// The cache only reads the list again when it's too old
+	if (UAdvancedFriendsCacheSubsystem* FriendsCache = UAdvancedFriendsCacheSubsystem::Get(PlayerControllerWeakPtr.Get()))
+	{
+		FriendsCache->RequestFriendsList(Player->GetControllerId(), FOnFriendsCacheReadComplete::CreateUObject(this, &ThisClass::OnFriendsCacheReadCompleted));
+		return;
+	}
+
 	IOnlineFriendsPtr Friends = Online::GetFriendsInterface();
 	if (Friends.IsValid())
 	{	
-		ULocalPlayer* Player = Cast<ULocalPlayer>(PlayerControllerWeakPtr->Player);
-
 		Friends->ReadFriendsList(Player->GetControllerId(), EFriendsLists::ToString((EFriendsLists::Default)), FriendListReadCompleteDelegate);
 		return;
 	}
@@ -60,26 +76,12 @@ void UGetFriendsCallbackProxy::OnReadFriendsListCompleted(int32 LocalUserNum, bo
 			TArray< TSharedRef<FOnlineFriend> > FriendList;
 			Friends->GetFriendsList(LocalUserNum, ListName, FriendList);
 
+			FriendsListOut.Reserve(FriendList.Num());
+
 			for (int32 i = 0; i < FriendList.Num(); i++)
 			{
-				TSharedRef<FOnlineFriend> Friend = FriendList[i];
 				FBPFriendInfo BPF;
-				FOnlineUserPresence pres = Friend->GetPresence();
-				BPF.OnlineState = ((EBPOnlinePresenceState)((int32)pres.Status.State));
-				BPF.DisplayName = Friend->GetDisplayName();
-				BPF.RealName = Friend->GetRealName();
-				BPF.UniqueNetId.SetUniqueNetId(Friend->GetUserId());
-				BPF.bIsPlayingSameGame = pres.bIsPlayingThisGame;
-
-				BPF.PresenceInfo.bIsOnline = pres.bIsOnline;
-				BPF.PresenceInfo.bHasVoiceSupport = pres.bHasVoiceSupport;
-				BPF.PresenceInfo.bIsPlaying = pres.bIsPlaying;
-				BPF.PresenceInfo.PresenceState = ((EBPOnlinePresenceState)((int32)pres.Status.State));
-				BPF.PresenceInfo.StatusString = pres.Status.StatusStr;
-				BPF.PresenceInfo.bIsJoinable = pres.bIsJoinable;
-				BPF.PresenceInfo.bIsPlayingThisGame = pres.bIsPlayingThisGame;
-
-
+				UAdvancedFriendsCacheSubsystem::MakeFriendInfo(*FriendList[i], BPF);
 				FriendsListOut.Add(BPF);
 			}
 
@@ -92,3 +94,20 @@ void UGetFriendsCallbackProxy::OnReadFriendsListCompleted(int32 LocalUserNum, bo
 		OnFailure.Broadcast(EmptyArray);
 	}
 }
+
+void UGetFriendsCallbackProxy::OnFriendsCacheReadCompleted(int32 LocalUserNum, bool bWasSuccessful)
+{
+	UAdvancedFriendsCacheSubsystem* FriendsCache = PlayerControllerWeakPtr.IsValid() ? UAdvancedFriendsCacheSubsystem::Get(PlayerControllerWeakPtr.Get()) : nullptr;
+
+	if (bWasSuccessful && FriendsCache)
+	{
+		TArray<FBPFriendInfo> FriendsListOut;
+		FriendsCache->GetFriendsList(LocalUserNum, FriendsListOut);
+		OnSuccess.Broadcast(FriendsListOut);
+	}
+	else
+	{
+		TArray<FBPFriendInfo> EmptyArray;
+		OnFailure.Broadcast(EmptyArray);
+	}
+}
@@ -0,0 +1,97 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+#include "CoreMinimal.h"
+#include "UObject/GCObject.h"
+#include "AdvancedSteamFriendsLibrary.h"
+
+class UTexture2D;
+
+// Where the avatar cache gets its images from, the steam API unless something else is set with FAdvancedSteamAvatarCache::SetImageSource
+// Lets tests (or anything without steam running) feed the cache their own images
+class ADVANCEDSTEAMSESSIONS_API IAdvancedSteamAvatarSource
+{
+public:
+	virtual ~IAdvancedSteamAvatarSource() {}
+
+	// Returns the image handle of the users avatar, 0 if the user has no avatar and -1 if it is still being downloaded
+	// The handle changes when the user changes their avatar
+	virtual int32 GetAvatarImage(uint64 SteamID, SteamAvatarSize AvatarSize) = 0;
+
+	virtual bool GetImageSize(int32 Image, uint32 & Width, uint32 & Height) = 0;
+
+	// Copies the RGBA pixels of the image into Dest, which holds DestSize bytes
+	virtual bool GetImageRGBA(int32 Image, uint8 * Dest, int32 DestSize) = 0;
+};
+
+// Keeps the avatar textures we already built, so widgets that ask for an avatar every frame or every row get the same texture back
+// Entries are keyed by steam id, size and steam image handle, and the least recently used ones are dropped once the textures go over the memory budget
+class ADVANCEDSTEAMSESSIONS_API FAdvancedSteamAvatarCache : public FGCObject
+{
+public:
+
+	static FAdvancedSteamAvatarCache & Get();
+
+	// Returns the avatar texture, building it only if we don't have this image yet
+	UTexture2D * GetAvatar(uint64 SteamID, SteamAvatarSize AvatarSize, EBlueprintAsyncResultSwitch &Result);
+
+	// Null goes back to the steam API, clears the cache as the images of the old source mean nothing to the new one
+	void SetImageSource(TSharedPtr<IAdvancedSteamAvatarSource> NewImageSource);
+
+	// Memory the avatar textures can take before we start dropping the least recently used ones
+	void SetMemoryBudget(int64 NewMemoryBudgetBytes);
+
+	void Empty();
+
+	const FBPSteamAvatarCacheStats & GetStats() const { return Stats; }
+
+	// FGCObject
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+	virtual FString GetReferencerName() const override { return TEXT("FAdvancedSteamAvatarCache"); }
+
+private:
+
+	FAdvancedSteamAvatarCache();
+
+	struct FAvatarKey
+	{
+		uint64 SteamID;
+		SteamAvatarSize AvatarSize;
+		int32 Image;
+
+		bool operator==(const FAvatarKey & Other) const
+		{
+			return SteamID == Other.SteamID && AvatarSize == Other.AvatarSize && Image == Other.Image;
+		}
+
+		friend uint32 GetTypeHash(const FAvatarKey & Key)
+		{
+			return HashCombine(HashCombine(GetTypeHash(Key.SteamID), GetTypeHash((uint8)Key.AvatarSize)), GetTypeHash(Key.Image));
+		}
+	};
+
+	struct FAvatarEntry
+	{
+		UTexture2D * Texture;
+		int64 SizeBytes;
+
+		// Value of UseCounter the last time someone asked for this avatar
+		uint64 LastUsed;
+	};
+
+	// Builds the texture, writing the pixels straight into its mip
+	UTexture2D * CreateAvatarTexture(int32 Image);
+
+	// Drops the least recently used avatars until we fit in the budget
+	void TrimToBudget();
+
+	void RemoveEntry(const FAvatarKey & Key);
+
+	TMap<FAvatarKey, FAvatarEntry> Entries;
+	TSharedPtr<IAdvancedSteamAvatarSource> ImageSource;
+
+	int64 MemoryBudgetBytes;
+	uint64 UseCounter;
+
+	FBPSteamAvatarCacheStats Stats;
+};
@@ -305,6 +305,28 @@ public:
 
 };
 
+USTRUCT(BlueprintType, Category = "Online|AdvancedFriends|SteamAPI")
+struct FBPSteamAvatarCacheStats
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	// Avatars that were already in the cache
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Online|AdvancedFriends|SteamAPI")
+		int32 Hits = 0;
+	// Avatars we had to build a texture for
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Online|AdvancedFriends|SteamAPI")
+		int32 Misses = 0;
+	// Avatars dropped to stay in the memory budget, or because the user changed their avatar
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Online|AdvancedFriends|SteamAPI")
+		int32 Evictions = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Online|AdvancedFriends|SteamAPI")
+		int32 NumTextures = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Online|AdvancedFriends|SteamAPI")
+		int32 MemoryUsedBytes = 0;
+};
+
 UCLASS()
 class UAdvancedSteamFriendsLibrary : public UBlueprintFunctionLibrary
 {
@@ -314,10 +336,24 @@ public:
 	//********* Friend List Functions *************//
 
 	// Get a texture of a valid friends avatar, STEAM ONLY, Returns invalid texture if the subsystem hasn't loaded that size of avatar yet
+	// Textures are cached, asking again for the same avatar returns the same texture until the user changes it
 	UFUNCTION(BlueprintCallable, Category = "Online|AdvancedFriends|SteamAPI", meta = (ExpandEnumAsExecs = "Result"))
 	static UTexture2D * GetSteamFriendAvatar(const FBPUniqueNetId UniqueNetId, EBlueprintAsyncResultSwitch &Result, SteamAvatarSize AvatarSize = SteamAvatarSize::SteamAvatar_Medium);
 
+	// Gets how well the avatar cache is doing
+	UFUNCTION(BlueprintPure, Category = "Online|AdvancedFriends|SteamAPI")
+	static FBPSteamAvatarCacheStats GetSteamAvatarCacheStats();
+
+	// Sets how much memory the cached avatar textures can take, the least recently used ones are dropped past it
+	UFUNCTION(BlueprintCallable, Category = "Online|AdvancedFriends|SteamAPI")
+	static void SetSteamAvatarCacheBudget(int32 BudgetKB = 16384);
+
+	// Drops every cached avatar texture, they are built again the next time they are asked for
+	UFUNCTION(BlueprintCallable, Category = "Online|AdvancedFriends|SteamAPI")
+	static void ClearSteamAvatarCache();
+
 	// Preloads the avatar and name of a steam friend, return whether it is already available or not, STEAM ONLY, Takes time to actually load everything after this is called.
+	// For a whole player list use PrefetchSteamPlayerInfo instead, it tells you when each player is ready
 	UFUNCTION(BlueprintCallable, Category = "Online|AdvancedFriends|SteamAPI")
 	static bool RequestSteamFriendInfo(const FBPUniqueNetId UniqueNetId, bool bRequireNameOnly = false);
 
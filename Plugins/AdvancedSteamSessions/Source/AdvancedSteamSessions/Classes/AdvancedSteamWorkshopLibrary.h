@@ -221,6 +221,7 @@ public:
 		bBanned = false;
 		bAcceptedForUse = false;
 		bTagsTruncated = false;
+		WorkshopID = FBPSteamWorkshopID(0);
 	}
 
 #if PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX
@@ -241,6 +242,7 @@ public:
 		bTagsTruncated = hUGCDetails.m_bTagsTruncated;
 
 		CreatorSteamID = FString::Printf(TEXT("%llu"), hUGCDetails.m_ulSteamIDOwner);
+		WorkshopID = FBPSteamWorkshopID(hUGCDetails.m_nPublishedFileId);
 	}
 
 	FBPSteamWorkshopItemDetails(const SteamUGCDetails_t &hUGCDetails)
@@ -260,6 +262,7 @@ public:
 		bTagsTruncated = hUGCDetails.m_bTagsTruncated;
 
 		CreatorSteamID = FString::Printf(TEXT("%llu"), hUGCDetails.m_ulSteamIDOwner);
+		WorkshopID = FBPSteamWorkshopID(hUGCDetails.m_nPublishedFileId);
 	}
 #endif
 
@@ -315,8 +318,11 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Online|AdvancedSteamWorkshop")
 	FString CreatorSteamID;
 
+	// The item these details are for
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Online|AdvancedSteamWorkshop")
+	FBPSteamWorkshopID WorkshopID;
+
 	/*
-	PublishedFileId_t m_nPublishedFileId;
 	uint32 m_rtimeCreated;											// time when the published file was created
 	uint32 m_rtimeUpdated;											// time when the published file was last updated
 	uint32 m_rtimeAddedToUserList;									// time when the user added the published file to their list (not always applicable)
@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BlueprintDataDefinitions.h"
+#include "AdvancedSteamFriendsLibrary.h"
+#include "Containers/Ticker.h"
+#include "SteamPrefetchPlayerInfoCallbackProxy.generated.h"
+
+class UTexture2D;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnSteamPlayerInfoChanged, uint64 /*SteamID*/);
+
+// Where the prefetch gets the player info from, steam unless something else is set with SetBackend
+// Lets tests (or anything without steam running) answer the requests themselves, avatars come from FAdvancedSteamAvatarCache and its own image source
+class ADVANCEDSTEAMSESSIONS_API IAdvancedSteamPlayerInfoBackend
+{
+public:
+	virtual ~IAdvancedSteamPlayerInfoBackend() {}
+
+	// Asks for the name, level and avatar of the user, returns false if they are already available
+	virtual bool RequestPlayerInfo(uint64 SteamID) = 0;
+
+	virtual FString GetPersonaName(uint64 SteamID) = 0;
+
+	// -1 if it isn't known
+	virtual int32 GetSteamLevel(uint64 SteamID) = 0;
+
+	// Has to be called on the game thread when the info or the avatar of a user arrives
+	void NotifyPlayerInfoChanged(uint64 SteamID) { OnPlayerInfoChanged.Broadcast(SteamID); }
+
+	FOnSteamPlayerInfoChanged OnPlayerInfoChanged;
+
+	// The current backend, null if steam isn't running and nothing else was set
+	static TSharedPtr<IAdvancedSteamPlayerInfoBackend> Get();
+
+	// Null goes back to steam
+	static void SetBackend(TSharedPtr<IAdvancedSteamPlayerInfoBackend> NewBackend);
+
+private:
+
+	static TSharedPtr<IAdvancedSteamPlayerInfoBackend> & GetBackendStorage();
+};
+
+USTRUCT(BlueprintType, Category = "Online|AdvancedFriends|SteamAPI")
+struct FBPSteamPlayerInfo
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Online|AdvancedFriends|SteamAPI")
+		FBPUniqueNetId PlayerUniqueNetID;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Online|AdvancedFriends|SteamAPI")
+		FString PersonaName;
+	// -1 if steam doesn't know it
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Online|AdvancedFriends|SteamAPI")
+		int32 SteamLevel = -1;
+	// Null if no avatar was asked for, the user has none, or it didn't arrive in time
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Online|AdvancedFriends|SteamAPI")
+		UTexture2D * Avatar = nullptr;
+	// False if the prefetch timed out before everything arrived
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Online|AdvancedFriends|SteamAPI")
+		bool bComplete = false;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FBlueprintSteamPlayerInfoDelegate, const FBPSteamPlayerInfo &, PlayerInfo, int32, RemainingPlayers);
+
+UCLASS(MinimalAPI)
+class USteamPrefetchPlayerInfoCallbackProxy : public UOnlineBlueprintCallProxyBase
+{
+	GENERATED_UCLASS_BODY()
+
+	// Called once for every player, as soon as their info arrives. RemainingPlayers is 0 on the last one
+	UPROPERTY(BlueprintAssignable)
+	FBlueprintSteamPlayerInfoDelegate OnPlayerInfo;
+
+	// Called if steam isn't available
+	UPROPERTY(BlueprintAssignable)
+	FBlueprintSteamPlayerInfoDelegate OnFailure;
+
+	// Requests the name, level and avatar of every player at once, for scoreboards and player lists, STEAM ONLY
+	// Replaces polling GetSteamPersonaName / GetSteamFriendAvatar every frame until they stop returning AsyncLoading
+	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"), Category = "Online|AdvancedFriends|SteamAPI")
+	static USteamPrefetchPlayerInfoCallbackProxy* PrefetchSteamPlayerInfo(UObject* WorldContextObject, const TArray<FBPUniqueNetId> & PlayerUniqueNetIDs, SteamAvatarSize AvatarSize = SteamAvatarSize::SteamAvatar_Medium, float TimeoutSeconds = 10.0f);
+
+	// UOnlineBlueprintCallProxyBase interface
+	virtual void Activate() override;
+	// End of UOnlineBlueprintCallProxyBase interface
+
+private:
+
+	void OnPlayerInfoChanged(uint64 SteamID);
+
+	// Delivers the player if everything we asked for has arrived, or anyway if bTimedOut
+	void TryDeliver(uint64 SteamID, bool bTimedOut);
+
+	bool OnTimeout(float DeltaTime);
+
+	void Finish();
+
+	TArray<FBPUniqueNetId> PlayerUniqueIDs;
+	SteamAvatarSize AvatarSize;
+	float TimeoutSeconds;
+
+	// Players that didn't get their info yet
+	TMap<uint64, FBPUniqueNetId> PendingPlayers;
+
+	TSharedPtr<IAdvancedSteamPlayerInfoBackend> Backend;
+	FDelegateHandle PlayerInfoChangedHandle;
+	FDelegateHandle TimeoutHandle;
+};
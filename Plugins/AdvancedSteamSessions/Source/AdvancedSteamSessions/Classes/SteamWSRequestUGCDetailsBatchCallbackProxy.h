@@ -0,0 +1,139 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AdvancedSteamWorkshopLibrary.h"
+#include "BlueprintDataDefinitions.h"
+#include "SteamWSRequestUGCDetailsBatchCallbackProxy.generated.h"
+
+// Called on the game thread with the details steam returned, items it didn't return are missing from the array
+DECLARE_DELEGATE_TwoParams(FOnSteamUGCDetailsQueried, bool /*bWasSuccessful*/, const TArray<FBPSteamWorkshopItemDetails> & /*Details*/);
+
+// Where the batched details query gets the workshop details from, steam unless something else is set with SetBackend
+// Lets tests (or anything without steam running) answer the queries with a mock of the workshop
+class ADVANCEDSTEAMSESSIONS_API IAdvancedSteamUGCBackend
+{
+public:
+	virtual ~IAdvancedSteamUGCBackend() {}
+
+	// Most items one query can ask for
+	virtual int32 GetMaxItemsPerQuery() = 0;
+
+	// Queries the details of up to GetMaxItemsPerQuery items, returns false if the query couldn't be sent
+	// The delegate isn't called if this returns false
+	virtual bool QueryUGCDetails(const TArray<uint64> & ItemIDs, const FOnSteamUGCDetailsQueried & OnComplete) = 0;
+
+	// The current backend, null if steam isn't running and nothing else was set
+	static TSharedPtr<IAdvancedSteamUGCBackend> Get();
+
+	// Null goes back to steam
+	static void SetBackend(TSharedPtr<IAdvancedSteamUGCBackend> NewBackend);
+
+private:
+
+	static TSharedPtr<IAdvancedSteamUGCBackend> & GetBackendStorage();
+};
+
+// Keeps the workshop details we already queried on disk, so the mod list doesn't ask steam for every item on every menu load
+// Saved in Saved/AdvancedSteamSessions/UGCDetails.json, with the time each item was queried
+class ADVANCEDSTEAMSESSIONS_API FAdvancedSteamUGCDetailsCache
+{
+public:
+
+	static FAdvancedSteamUGCDetailsCache & Get();
+
+	// Finds the details of the item if they were queried less than MaxAgeSeconds ago
+	bool Find(uint64 ItemID, float MaxAgeSeconds, FBPSteamWorkshopItemDetails & OutDetails);
+
+	void Add(const FBPSteamWorkshopItemDetails & Details);
+
+	// Same as above with the unix time the details were queried at, instead of now
+	void Add(const FBPSteamWorkshopItemDetails & Details, int64 QueryTime);
+
+	void Remove(uint64 ItemID);
+
+	// Writes the cache to disk if anything was added since it was loaded or last saved
+	void Save();
+
+	void Empty();
+
+private:
+
+	FAdvancedSteamUGCDetailsCache();
+
+	void Load();
+
+	static FString GetCacheFilename();
+
+	struct FCachedDetails
+	{
+		FBPSteamWorkshopItemDetails Details;
+
+		// Unix time of the query
+		int64 QueryTime;
+	};
+
+	TMap<uint64, FCachedDetails> Entries;
+
+	bool bDirty;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FBlueprintWorkshopDetailsBatchDelegate, const TArray<FBPSteamWorkshopItemDetails>&, WorkshopDetails);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FBlueprintWorkshopDetailsProgressDelegate, int32, ItemsDone, int32, ItemsTotal);
+
+UCLASS(MinimalAPI)
+class USteamWSRequestUGCDetailsBatchCallbackProxy : public UOnlineBlueprintCallProxyBase
+{
+	GENERATED_UCLASS_BODY()
+
+	// Called after every page that comes back, cached items count as done from the start
+	UPROPERTY(BlueprintAssignable)
+	FBlueprintWorkshopDetailsProgressDelegate OnProgress;
+
+	// Called with the details of every item, in the order they were asked for
+	UPROPERTY(BlueprintAssignable)
+	FBlueprintWorkshopDetailsBatchDelegate OnSuccess;
+
+	// Called if any page failed, items without details have a ResultOfRequest of k_EResultFail
+	UPROPERTY(BlueprintAssignable)
+	FBlueprintWorkshopDetailsBatchDelegate OnFailure;
+
+	// Gets the details of many workshop items at once, for mod lists, STEAM ONLY
+	// Items are queried a full page at a time with the pages in flight together, instead of one request per item
+	// Details queried less than CacheLifetimeSeconds ago come from the disk cache, 0 always asks steam
+	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"), Category = "Online|AdvancedSteamWorkshop")
+	static USteamWSRequestUGCDetailsBatchCallbackProxy* GetWorkshopItemDetailsBatch(UObject* WorldContextObject, const TArray<FBPSteamWorkshopID> & WorkShopIDs, float CacheLifetimeSeconds = 3600.0f);
+
+	// UOnlineBlueprintCallProxyBase interface
+	virtual void Activate() override;
+	// End of UOnlineBlueprintCallProxyBase interface
+
+private:
+
+	// Sends pages until MaxPagesInFlight are out or none are left
+	void SendPages();
+
+	void OnPageQueried(bool bWasSuccessful, const TArray<FBPSteamWorkshopItemDetails> & Details, TArray<uint64> PageItemIDs);
+
+	void Finish();
+
+	// Pages out at once, steam queues the rest on its side anyway
+	static const int32 MaxPagesInFlight = 4;
+
+	TArray<FBPSteamWorkshopID> WorkShopIDs;
+	float CacheLifetimeSeconds;
+
+	TMap<uint64, FBPSteamWorkshopItemDetails> Results;
+
+	// Items still to be sent, split in pages
+	TArray<TArray<uint64>> PendingPages;
+
+	int32 PagesInFlight;
+	int32 ItemsDone;
+	int32 ItemsTotal;
+	bool bAnyPageFailed;
+	bool bSendingPages;
+	bool bFinished;
+
+	TSharedPtr<IAdvancedSteamUGCBackend> Backend;
+};
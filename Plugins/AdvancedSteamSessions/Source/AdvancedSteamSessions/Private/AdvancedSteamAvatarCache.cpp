@@ -0,0 +1,231 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "AdvancedSteamAvatarCache.h"
+#include "Engine/Texture2D.h"
+
+#if PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX
+
+// The default image source, straight from the steam API
+class FSteamAvatarSource : public IAdvancedSteamAvatarSource
+{
+public:
+
+	virtual int32 GetAvatarImage(uint64 SteamID, SteamAvatarSize AvatarSize) override
+	{
+		if (!SteamAPI_Init())
+		{
+			UE_LOG(AdvancedSteamFriendsLog, Warning, TEXT("STEAM Couldn't be verified as initialized"));
+			return 0;
+		}
+
+		switch (AvatarSize)
+		{
+		case SteamAvatarSize::SteamAvatar_Small: return SteamFriends()->GetSmallFriendAvatar(SteamID);
+		case SteamAvatarSize::SteamAvatar_Medium: return SteamFriends()->GetMediumFriendAvatar(SteamID);
+		case SteamAvatarSize::SteamAvatar_Large: return SteamFriends()->GetLargeFriendAvatar(SteamID);
+		default: return 0;
+		}
+	}
+
+	virtual bool GetImageSize(int32 Image, uint32 & Width, uint32 & Height) override
+	{
+		return SteamUtils()->GetImageSize(Image, &Width, &Height);
+	}
+
+	virtual bool GetImageRGBA(int32 Image, uint8 * Dest, int32 DestSize) override
+	{
+		return SteamUtils()->GetImageRGBA(Image, Dest, DestSize);
+	}
+};
+
+#endif
+
+FAdvancedSteamAvatarCache & FAdvancedSteamAvatarCache::Get()
+{
+	static FAdvancedSteamAvatarCache Cache;
+	return Cache;
+}
+
+FAdvancedSteamAvatarCache::FAdvancedSteamAvatarCache() :
+	MemoryBudgetBytes(16 * 1024 * 1024),
+	UseCounter(0)
+{
+#if PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX
+	ImageSource = MakeShared<FSteamAvatarSource>();
+#endif
+}
+
+UTexture2D * FAdvancedSteamAvatarCache::GetAvatar(uint64 SteamID, SteamAvatarSize AvatarSize, EBlueprintAsyncResultSwitch &Result)
+{
+	Result = EBlueprintAsyncResultSwitch::OnFailure;
+
+	if (!ImageSource.IsValid())
+		return nullptr;
+
+	// Asking steam for the handle is cheap, and it tells us if the user changed their avatar since last time
+	const int32 Image = ImageSource->GetAvatarImage(SteamID, AvatarSize);
+
+	if (Image == -1)
+	{
+		Result = EBlueprintAsyncResultSwitch::AsyncLoading;
+		return nullptr;
+	}
+
+	if (Image == 0)
+		return nullptr;
+
+	const FAvatarKey Key = { SteamID, AvatarSize, Image };
+
+	if (FAvatarEntry * Entry = Entries.Find(Key))
+	{
+		if (Entry->Texture)
+		{
+			Entry->LastUsed = ++UseCounter;
+			Stats.Hits++;
+
+			Result = EBlueprintAsyncResultSwitch::OnSuccess;
+			return Entry->Texture;
+		}
+
+		// Someone destroyed the texture from under us
+		RemoveEntry(Key);
+	}
+
+	// An older avatar of the same user is never going to be asked for again
+	TArray<FAvatarKey> OldKeys;
+	for (const TPair<FAvatarKey, FAvatarEntry> & Pair : Entries)
+	{
+		if (Pair.Key.SteamID == SteamID && Pair.Key.AvatarSize == AvatarSize)
+			OldKeys.Add(Pair.Key);
+	}
+
+	for (const FAvatarKey & OldKey : OldKeys)
+	{
+		RemoveEntry(OldKey);
+		Stats.Evictions++;
+	}
+
+	UTexture2D * Avatar = CreateAvatarTexture(Image);
+
+	if (!Avatar)
+		return nullptr;
+
+	Stats.Misses++;
+
+	FAvatarEntry & NewEntry = Entries.Add(Key);
+	NewEntry.Texture = Avatar;
+	NewEntry.SizeBytes = (int64)Avatar->GetSizeX() * Avatar->GetSizeY() * 4;
+	NewEntry.LastUsed = ++UseCounter;
+
+	Stats.NumTextures = Entries.Num();
+	Stats.MemoryUsedBytes += (int32)NewEntry.SizeBytes;
+
+	TrimToBudget();
+
+	Result = EBlueprintAsyncResultSwitch::OnSuccess;
+	return Avatar;
+}
+
+UTexture2D * FAdvancedSteamAvatarCache::CreateAvatarTexture(int32 Image)
+{
+	uint32 Width = 0;
+	uint32 Height = 0;
+
+	if (!ImageSource->GetImageSize(Image, Width, Height) || Width == 0 || Height == 0)
+	{
+		UE_LOG(AdvancedSteamFriendsLog, Warning, TEXT("Bad Height / Width with steam avatar!"));
+		return nullptr;
+	}
+
+	UTexture2D * Avatar = UTexture2D::CreateTransient(Width, Height, PF_R8G8B8A8);
+
+	if (!Avatar)
+		return nullptr;
+
+	// Steam writes the pixels straight into the mip, no intermediate buffer needed
+	const int32 SizeBytes = Width * Height * 4;
+	uint8 * MipData = (uint8*)Avatar->PlatformData->Mips[0].BulkData.Lock(LOCK_READ_WRITE);
+	const bool bGotPixels = ImageSource->GetImageRGBA(Image, MipData, SizeBytes);
+	Avatar->PlatformData->Mips[0].BulkData.Unlock();
+
+	if (!bGotPixels)
+	{
+		UE_LOG(AdvancedSteamFriendsLog, Warning, TEXT("Couldn't get the pixels of the steam avatar!"));
+		Avatar->MarkPendingKill();
+		return nullptr;
+	}
+
+	//Setting some Parameters for the Texture and finally returning it
+	Avatar->PlatformData->SetNumSlices(1);
+	Avatar->NeverStream = true;
+
+	Avatar->UpdateResource();
+
+	return Avatar;
+}
+
+void FAdvancedSteamAvatarCache::TrimToBudget()
+{
+	// A handful of avatars, a linear search for the oldest one is fine
+	while (Stats.MemoryUsedBytes > MemoryBudgetBytes && Entries.Num() > 1)
+	{
+		const FAvatarKey * OldestKey = nullptr;
+		uint64 OldestUse = MAX_uint64;
+
+		for (const TPair<FAvatarKey, FAvatarEntry> & Pair : Entries)
+		{
+			if (Pair.Value.LastUsed < OldestUse)
+			{
+				OldestUse = Pair.Value.LastUsed;
+				OldestKey = &Pair.Key;
+			}
+		}
+
+		RemoveEntry(*OldestKey);
+		Stats.Evictions++;
+	}
+}
+
+void FAdvancedSteamAvatarCache::RemoveEntry(const FAvatarKey & Key)
+{
+	// Copy it, the key could be pointing into the map
+	const FAvatarKey KeyToRemove = Key;
+
+	FAvatarEntry Entry;
+	if (Entries.RemoveAndCopyValue(KeyToRemove, Entry))
+	{
+		// The widgets that still show it keep it alive, we just stop handing it out
+		Stats.MemoryUsedBytes -= (int32)Entry.SizeBytes;
+		Stats.NumTextures = Entries.Num();
+	}
+}
+
+void FAdvancedSteamAvatarCache::SetImageSource(TSharedPtr<IAdvancedSteamAvatarSource> NewImageSource)
+{
+	Empty();
+
+#if PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX
+	ImageSource = NewImageSource.IsValid() ? NewImageSource : MakeShared<FSteamAvatarSource>();
+#else
+	ImageSource = NewImageSource;
+#endif
+}
+
+void FAdvancedSteamAvatarCache::SetMemoryBudget(int64 NewMemoryBudgetBytes)
+{
+	MemoryBudgetBytes = FMath::Max<int64>(0, NewMemoryBudgetBytes);
+	TrimToBudget();
+}
+
+void FAdvancedSteamAvatarCache::Empty()
+{
+	Entries.Empty();
+	Stats = FBPSteamAvatarCacheStats();
+}
+
+void FAdvancedSteamAvatarCache::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	for (TPair<FAvatarKey, FAvatarEntry> & Pair : Entries)
+	{
+		Collector.AddReferencedObject(Pair.Value.Texture);
+	}
+}
@@ -1,6 +1,7 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 #include "AdvancedSteamFriendsLibrary.h"
 #include "OnlineSubSystemHeader.h"
+#include "AdvancedSteamAvatarCache.h"
 
 //General Log
 DEFINE_LOG_CATEGORY(AdvancedSteamFriendsLog);
@@ -265,89 +266,28 @@ UTexture2D * UAdvancedSteamFriendsLibrary::GetSteamFriendAvatar(const FBPUniqueN
 		return nullptr;
 	}
 
-	uint32 Width = 0;
-	uint32 Height = 0;
+	uint64 id = *((uint64*)UniqueNetId.UniqueNetId->GetBytes());
 
-	if (SteamAPI_Init())
-	{
-		//Getting the PictureID from the SteamAPI and getting the Size with the ID
-		//virtual bool RequestUserInformation( CSteamID steamIDUser, bool bRequireNameOnly ) = 0;
-
-		
-		uint64 id = *((uint64*)UniqueNetId.UniqueNetId->GetBytes());
-		int Picture = 0;
-		
-		switch(AvatarSize)
-		{
-		case SteamAvatarSize::SteamAvatar_Small: Picture = SteamFriends()->GetSmallFriendAvatar(id); break;
-		case SteamAvatarSize::SteamAvatar_Medium: Picture = SteamFriends()->GetMediumFriendAvatar(id); break;
-		case SteamAvatarSize::SteamAvatar_Large: Picture = SteamFriends()->GetLargeFriendAvatar(id); break;
-		default: break;
-		}
-
-		if (Picture == -1)
-		{
-			Result = EBlueprintAsyncResultSwitch::AsyncLoading;
-			return NULL;
-		}
-
-		SteamUtils()->GetImageSize(Picture, &Width, &Height);
-
-		// STOLEN FROM ANSWERHUB :p, then fixed because answerhub wasn't releasing the memory O.o
-		// Also fixed image pixel format and switched to a memcpy instead of manual iteration.
-		// At some point I should probably reply to that answerhub post with these fixes to prevent people killing their games.....
-
-		if (Width > 0 && Height > 0)
-		{
-			//Creating the buffer "oAvatarRGBA" and then filling it with the RGBA Stream from the Steam Avatar
-			uint8 *oAvatarRGBA = new uint8[Width * Height * 4];
-
-
-			//Filling the buffer with the RGBA Stream from the Steam Avatar and creating a UTextur2D to parse the RGBA Steam in
-			SteamUtils()->GetImageRGBA(Picture, (uint8*)oAvatarRGBA, 4 * Height * Width * sizeof(char));
-
-
-			// Removed as I changed the image bit code to be RGB, I think the original author was unaware that there were different pixel formats
-			/*
-			//Swap R and B channels because for some reason the games whack
-			for (uint32 i = 0; i < (Width * Height * 4); i += 4)
-			{
-				uint8 Temp = oAvatarRGBA[i + 0];
-				oAvatarRGBA[i + 0] = oAvatarRGBA[i + 2];
-				oAvatarRGBA[i + 2] = Temp;
-			}*/
-
-			UTexture2D* Avatar = UTexture2D::CreateTransient(Width, Height, PF_R8G8B8A8);
-			// Switched to a Memcpy instead of byte by byte transer
-			uint8* MipData = (uint8*)Avatar->PlatformData->Mips[0].BulkData.Lock(LOCK_READ_WRITE);
-			FMemory::Memcpy(MipData, (void*)oAvatarRGBA, Height * Width * 4);
-			Avatar->PlatformData->Mips[0].BulkData.Unlock();
-
-			// Original implementation was missing this!!
-			// the hell man......
-			delete[] oAvatarRGBA;
-
-			//Setting some Parameters for the Texture and finally returning it
-			Avatar->PlatformData->SetNumSlices(1);
-			Avatar->NeverStream = true;
-			//Avatar->CompressionSettings = TC_EditorIcon;
-
-			Avatar->UpdateResource();
-
-			Result = EBlueprintAsyncResultSwitch::OnSuccess;
-			return Avatar;
-		}
-		else
-		{
-			UE_LOG(AdvancedSteamFriendsLog, Warning, TEXT("Bad Height / Width with steam avatar!"));
-		}
-
-		Result = EBlueprintAsyncResultSwitch::OnFailure;
-		return nullptr;
-	}
+	// The cache only builds a new texture the first time it sees this avatar, after that it hands out the same one
+	return FAdvancedSteamAvatarCache::Get().GetAvatar(id, AvatarSize, Result);
 #endif
 
 	UE_LOG(AdvancedSteamFriendsLog, Warning, TEXT("STEAM Couldn't be verified as initialized"));
 	Result = EBlueprintAsyncResultSwitch::OnFailure;
 	return nullptr;
+}
+
+FBPSteamAvatarCacheStats UAdvancedSteamFriendsLibrary::GetSteamAvatarCacheStats()
+{
+	return FAdvancedSteamAvatarCache::Get().GetStats();
+}
+
+void UAdvancedSteamFriendsLibrary::SetSteamAvatarCacheBudget(int32 BudgetKB)
+{
+	FAdvancedSteamAvatarCache::Get().SetMemoryBudget((int64)BudgetKB * 1024);
+}
+
+void UAdvancedSteamFriendsLibrary::ClearSteamAvatarCache()
+{
+	FAdvancedSteamAvatarCache::Get().Empty();
 }
\ No newline at end of file
@@ -0,0 +1,236 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SteamPrefetchPlayerInfoCallbackProxy.h"
+#include "AdvancedSteamAvatarCache.h"
+#include "OnlineSubSystemHeader.h"
+#include "Async/Async.h"
+#if PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX
+#include "steam/isteamfriends.h"
+#endif
+
+#if PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX
+
+// The default backend, straight from the steam API
+class FSteamPlayerInfoBackend : public IAdvancedSteamPlayerInfoBackend
+{
+public:
+
+	FSteamPlayerInfoBackend() :
+		PersonaStateChangeCallback(this, &FSteamPlayerInfoBackend::OnPersonaStateChange),
+		AvatarImageLoadedCallback(this, &FSteamPlayerInfoBackend::OnAvatarImageLoaded)
+	{
+	}
+
+	virtual bool RequestPlayerInfo(uint64 SteamID) override
+	{
+		return SteamFriends()->RequestUserInformation(SteamID, false);
+	}
+
+	virtual FString GetPersonaName(uint64 SteamID) override
+	{
+		return FString(UTF8_TO_TCHAR(SteamFriends()->GetFriendPersonaName(SteamID)));
+	}
+
+	virtual int32 GetSteamLevel(uint64 SteamID) override
+	{
+		const int32 SteamLevel = SteamFriends()->GetFriendSteamLevel(SteamID);
+		return SteamLevel > 0 ? SteamLevel : -1;
+	}
+
+private:
+
+	void OnPersonaStateChange(PersonaStateChange_t * pChange)
+	{
+		NotifyOnGameThread(pChange->m_ulSteamID);
+	}
+
+	// Large avatars are downloaded on their own after the persona info
+	void OnAvatarImageLoaded(AvatarImageLoaded_t * pLoaded)
+	{
+		NotifyOnGameThread(pLoaded->m_steamID.ConvertToUint64());
+	}
+
+	// Steam runs its callbacks on the online thread, the proxies live on the game thread
+	void NotifyOnGameThread(uint64 SteamID)
+	{
+		AsyncTask(ENamedThreads::GameThread, [SteamID]()
+		{
+			if (TSharedPtr<IAdvancedSteamPlayerInfoBackend> CurrentBackend = IAdvancedSteamPlayerInfoBackend::Get())
+			{
+				CurrentBackend->NotifyPlayerInfoChanged(SteamID);
+			}
+		});
+	}
+
+	CCallback<FSteamPlayerInfoBackend, PersonaStateChange_t, false> PersonaStateChangeCallback;
+	CCallback<FSteamPlayerInfoBackend, AvatarImageLoaded_t, false> AvatarImageLoadedCallback;
+};
+
+#endif
+
+TSharedPtr<IAdvancedSteamPlayerInfoBackend> & IAdvancedSteamPlayerInfoBackend::GetBackendStorage()
+{
+	static TSharedPtr<IAdvancedSteamPlayerInfoBackend> Backend;
+	return Backend;
+}
+
+TSharedPtr<IAdvancedSteamPlayerInfoBackend> IAdvancedSteamPlayerInfoBackend::Get()
+{
+	TSharedPtr<IAdvancedSteamPlayerInfoBackend> & Backend = GetBackendStorage();
+
+#if PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX
+	if (!Backend.IsValid() && SteamAPI_Init())
+	{
+		Backend = MakeShared<FSteamPlayerInfoBackend>();
+	}
+#endif
+
+	return Backend;
+}
+
+void IAdvancedSteamPlayerInfoBackend::SetBackend(TSharedPtr<IAdvancedSteamPlayerInfoBackend> NewBackend)
+{
+	// Null is filled with steam again the next time someone asks
+	GetBackendStorage() = NewBackend;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// USteamPrefetchPlayerInfoCallbackProxy
+
+USteamPrefetchPlayerInfoCallbackProxy::USteamPrefetchPlayerInfoCallbackProxy(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	AvatarSize = SteamAvatarSize::SteamAvatar_Medium;
+	TimeoutSeconds = 10.0f;
+}
+
+USteamPrefetchPlayerInfoCallbackProxy* USteamPrefetchPlayerInfoCallbackProxy::PrefetchSteamPlayerInfo(UObject* WorldContextObject, const TArray<FBPUniqueNetId> & PlayerUniqueNetIDs, SteamAvatarSize AvatarSize, float TimeoutSeconds)
+{
+	USteamPrefetchPlayerInfoCallbackProxy* Proxy = NewObject<USteamPrefetchPlayerInfoCallbackProxy>();
+
+	Proxy->PlayerUniqueIDs = PlayerUniqueNetIDs;
+	Proxy->AvatarSize = AvatarSize;
+	Proxy->TimeoutSeconds = TimeoutSeconds;
+	return Proxy;
+}
+
+void USteamPrefetchPlayerInfoCallbackProxy::Activate()
+{
+	Backend = IAdvancedSteamPlayerInfoBackend::Get();
+
+	if (!Backend.IsValid())
+	{
+		UE_LOG(AdvancedSteamFriendsLog, Warning, TEXT("PrefetchSteamPlayerInfo Couldn't init steamAPI!"));
+		OnFailure.Broadcast(FBPSteamPlayerInfo(), 0);
+		return;
+	}
+
+	for (const FBPUniqueNetId & UniqueNetId : PlayerUniqueIDs)
+	{
+		if (!UniqueNetId.IsValid() || !UniqueNetId.UniqueNetId->IsValid() || UniqueNetId.UniqueNetId->GetType() != STEAM_SUBSYSTEM)
+		{
+			UE_LOG(AdvancedSteamFriendsLog, Warning, TEXT("PrefetchSteamPlayerInfo Had a bad UniqueNetId!"));
+			continue;
+		}
+
+		uint64 id = *((uint64*)UniqueNetId.UniqueNetId->GetBytes());
+		PendingPlayers.Add(id, UniqueNetId);
+	}
+
+	if (PendingPlayers.Num() == 0)
+	{
+		OnPlayerInfo.Broadcast(FBPSteamPlayerInfo(), 0);
+		return;
+	}
+
+	// Nobody else holds on to us until every player is delivered
+	AddToRoot();
+
+	PlayerInfoChangedHandle = Backend->OnPlayerInfoChanged.AddUObject(this, &USteamPrefetchPlayerInfoCallbackProxy::OnPlayerInfoChanged);
+	TimeoutHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &USteamPrefetchPlayerInfoCallbackProxy::OnTimeout), FMath::Max(TimeoutSeconds, 0.0f));
+
+	// Every request goes out now, the ones steam already has are delivered right away
+	TArray<uint64> AlreadyAvailable;
+	for (const TPair<uint64, FBPUniqueNetId> & Pair : PendingPlayers)
+	{
+		if (!Backend->RequestPlayerInfo(Pair.Key))
+			AlreadyAvailable.Add(Pair.Key);
+	}
+
+	for (uint64 id : AlreadyAvailable)
+	{
+		TryDeliver(id, false);
+	}
+}
+
+void USteamPrefetchPlayerInfoCallbackProxy::OnPlayerInfoChanged(uint64 SteamID)
+{
+	if (PendingPlayers.Contains(SteamID))
+		TryDeliver(SteamID, false);
+}
+
+void USteamPrefetchPlayerInfoCallbackProxy::TryDeliver(uint64 SteamID, bool bTimedOut)
+{
+	const FBPUniqueNetId * UniqueNetId = PendingPlayers.Find(SteamID);
+
+	if (!UniqueNetId || !Backend.IsValid())
+		return;
+
+	FBPSteamPlayerInfo PlayerInfo;
+	PlayerInfo.PlayerUniqueNetID = *UniqueNetId;
+	PlayerInfo.PersonaName = Backend->GetPersonaName(SteamID);
+	PlayerInfo.SteamLevel = Backend->GetSteamLevel(SteamID);
+	PlayerInfo.bComplete = true;
+
+	if (AvatarSize != SteamAvatarSize::SteamAvatar_INVALID)
+	{
+		EBlueprintAsyncResultSwitch AvatarResult;
+		PlayerInfo.Avatar = FAdvancedSteamAvatarCache::Get().GetAvatar(SteamID, AvatarSize, AvatarResult);
+
+		// The avatar is still downloading, steam tells us when it's done
+		if (AvatarResult == EBlueprintAsyncResultSwitch::AsyncLoading)
+		{
+			if (!bTimedOut)
+				return;
+
+			PlayerInfo.bComplete = false;
+		}
+	}
+
+	PendingPlayers.Remove(SteamID);
+	OnPlayerInfo.Broadcast(PlayerInfo, PendingPlayers.Num());
+
+	if (PendingPlayers.Num() == 0)
+		Finish();
+}
+
+bool USteamPrefetchPlayerInfoCallbackProxy::OnTimeout(float DeltaTime)
+{
+	TimeoutHandle.Reset();
+
+	// Whatever didn't arrive is delivered with what we have
+	TArray<uint64> RemainingPlayers;
+	PendingPlayers.GetKeys(RemainingPlayers);
+
+	for (uint64 id : RemainingPlayers)
+	{
+		TryDeliver(id, true);
+	}
+
+	return false;
+}
+
+void USteamPrefetchPlayerInfoCallbackProxy::Finish()
+{
+	if (Backend.IsValid())
+		Backend->OnPlayerInfoChanged.Remove(PlayerInfoChangedHandle);
+
+	if (TimeoutHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TimeoutHandle);
+		TimeoutHandle.Reset();
+	}
+
+	Backend.Reset();
+	RemoveFromRoot();
+}
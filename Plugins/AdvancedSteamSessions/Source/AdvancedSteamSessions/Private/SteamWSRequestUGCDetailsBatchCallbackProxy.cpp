@@ -0,0 +1,454 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SteamWSRequestUGCDetailsBatchCallbackProxy.h"
+#include "OnlineSubSystemHeader.h"
+#include "Async/Async.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#if PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX
+#include "steam/isteamugc.h"
+#endif
+
+#if PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX
+
+// The default backend, straight from the steam API
+class FSteamUGCBackend : public IAdvancedSteamUGCBackend
+{
+public:
+
+	virtual int32 GetMaxItemsPerQuery() override
+	{
+		return kNumUGCResultsPerPage;
+	}
+
+	virtual bool QueryUGCDetails(const TArray<uint64> & ItemIDs, const FOnSteamUGCDetailsQueried & OnComplete) override
+	{
+		UGCQueryHandle_t hQueryHandle = SteamUGC()->CreateQueryUGCDetailsRequest((PublishedFileId_t *)ItemIDs.GetData(), ItemIDs.Num());
+
+		if (hQueryHandle == k_UGCQueryHandleInvalid)
+			return false;
+
+		SteamAPICall_t hSteamAPICall = SteamUGC()->SendQueryUGCRequest(hQueryHandle);
+
+		if (hSteamAPICall == k_uAPICallInvalid)
+		{
+			SteamUGC()->ReleaseQueryUGCRequest(hQueryHandle);
+			return false;
+		}
+
+		TUniquePtr<FQuery> & Query = GetQueries().Add(hSteamAPICall, MakeUnique<FQuery>());
+		Query->hSteamAPICall = hSteamAPICall;
+		Query->OnComplete = OnComplete;
+		Query->CallResult.Set(hSteamAPICall, Query.Get(), &FQuery::OnQueryCompleted);
+		return true;
+	}
+
+private:
+
+	struct FQuery
+	{
+		void OnQueryCompleted(SteamUGCQueryCompleted_t *pResult, bool bIOFailure)
+		{
+			const SteamAPICall_t hQueryAPICall = hSteamAPICall;
+			const bool bWasSuccessful = !bIOFailure && pResult && pResult->m_eResult == k_EResultOK;
+			TArray<FBPSteamWorkshopItemDetails> Details;
+
+			if (pResult && !bIOFailure)
+			{
+				// The results have to be read before the handle is released, so it happens here on the online thread
+				for (uint32 i = 0; bWasSuccessful && i < pResult->m_unNumResultsReturned; i++)
+				{
+					SteamUGCDetails_t ItemDetails;
+					if (SteamUGC()->GetQueryUGCResult(pResult->m_handle, i, &ItemDetails))
+						Details.Add(FBPSteamWorkshopItemDetails(ItemDetails));
+				}
+
+				SteamUGC()->ReleaseQueryUGCRequest(pResult->m_handle);
+			}
+
+			// Steam runs its callbacks on the online thread, the proxies live on the game thread
+			// Nothing of this query can be touched after this, the game thread deletes it
+			AsyncTask(ENamedThreads::GameThread, [hQueryAPICall, bWasSuccessful, Details]()
+			{
+				TUniquePtr<FQuery> Query;
+				if (GetQueries().RemoveAndCopyValue(hQueryAPICall, Query))
+					Query->OnComplete.ExecuteIfBound(bWasSuccessful, Details);
+			});
+		}
+
+		CCallResult<FQuery, SteamUGCQueryCompleted_t> CallResult;
+		SteamAPICall_t hSteamAPICall;
+		FOnSteamUGCDetailsQueried OnComplete;
+	};
+
+	// Queries in flight by their api call, outlives the backend so a query still completes if the backend is replaced
+	static TMap<SteamAPICall_t, TUniquePtr<FQuery>> & GetQueries()
+	{
+		static TMap<SteamAPICall_t, TUniquePtr<FQuery>> Queries;
+		return Queries;
+	}
+};
+
+#endif
+
+TSharedPtr<IAdvancedSteamUGCBackend> & IAdvancedSteamUGCBackend::GetBackendStorage()
+{
+	static TSharedPtr<IAdvancedSteamUGCBackend> Backend;
+	return Backend;
+}
+
+TSharedPtr<IAdvancedSteamUGCBackend> IAdvancedSteamUGCBackend::Get()
+{
+	TSharedPtr<IAdvancedSteamUGCBackend> & Backend = GetBackendStorage();
+
+#if PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX
+	if (!Backend.IsValid() && SteamAPI_Init())
+	{
+		Backend = MakeShared<FSteamUGCBackend>();
+	}
+#endif
+
+	return Backend;
+}
+
+void IAdvancedSteamUGCBackend::SetBackend(TSharedPtr<IAdvancedSteamUGCBackend> NewBackend)
+{
+	// Null is filled with steam again the next time someone asks
+	GetBackendStorage() = NewBackend;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FAdvancedSteamUGCDetailsCache
+
+FAdvancedSteamUGCDetailsCache & FAdvancedSteamUGCDetailsCache::Get()
+{
+	static FAdvancedSteamUGCDetailsCache Cache;
+	return Cache;
+}
+
+FAdvancedSteamUGCDetailsCache::FAdvancedSteamUGCDetailsCache()
+	: bDirty(false)
+{
+	Load();
+}
+
+bool FAdvancedSteamUGCDetailsCache::Find(uint64 ItemID, float MaxAgeSeconds, FBPSteamWorkshopItemDetails & OutDetails)
+{
+	const FCachedDetails * Entry = Entries.Find(ItemID);
+
+	if (!Entry || FDateTime::UtcNow().ToUnixTimestamp() - Entry->QueryTime >= MaxAgeSeconds)
+		return false;
+
+	OutDetails = Entry->Details;
+	return true;
+}
+
+void FAdvancedSteamUGCDetailsCache::Add(const FBPSteamWorkshopItemDetails & Details)
+{
+	Add(Details, FDateTime::UtcNow().ToUnixTimestamp());
+}
+
+void FAdvancedSteamUGCDetailsCache::Add(const FBPSteamWorkshopItemDetails & Details, int64 QueryTime)
+{
+	FCachedDetails & Entry = Entries.FindOrAdd(Details.WorkshopID.SteamWorkshopID);
+	Entry.Details = Details;
+	Entry.QueryTime = QueryTime;
+
+	bDirty = true;
+}
+
+void FAdvancedSteamUGCDetailsCache::Remove(uint64 ItemID)
+{
+	if (Entries.Remove(ItemID) > 0)
+		bDirty = true;
+}
+
+void FAdvancedSteamUGCDetailsCache::Empty()
+{
+	Entries.Empty();
+	bDirty = true;
+}
+
+FString FAdvancedSteamUGCDetailsCache::GetCacheFilename()
+{
+	return FPaths::ProjectSavedDir() / TEXT("AdvancedSteamSessions") / TEXT("UGCDetails.json");
+}
+
+void FAdvancedSteamUGCDetailsCache::Save()
+{
+	if (!bDirty)
+		return;
+
+	TArray<TSharedPtr<FJsonValue>> Items;
+	Items.Reserve(Entries.Num());
+
+	for (const TPair<uint64, FCachedDetails> & Entry : Entries)
+	{
+		const FBPSteamWorkshopItemDetails & Details = Entry.Value.Details;
+		TSharedPtr<FJsonObject> Item = MakeShared<FJsonObject>();
+
+		// Ids and times go as strings, a double can't hold every uint64
+		Item->SetStringField(TEXT("Id"), FString::Printf(TEXT("%llu"), Entry.Key));
+		Item->SetStringField(TEXT("QueryTime"), FString::Printf(TEXT("%lld"), Entry.Value.QueryTime));
+		Item->SetNumberField(TEXT("Result"), (uint8)Details.ResultOfRequest);
+		Item->SetNumberField(TEXT("FileType"), (uint8)Details.FileType);
+		Item->SetNumberField(TEXT("CreatorAppID"), Details.CreatorAppID);
+		Item->SetNumberField(TEXT("ConsumerAppID"), Details.ConsumerAppID);
+		Item->SetStringField(TEXT("Title"), Details.Title);
+		Item->SetStringField(TEXT("Description"), Details.Description);
+		Item->SetStringField(TEXT("ItemUrl"), Details.ItemUrl);
+		Item->SetNumberField(TEXT("VotesUp"), Details.VotesUp);
+		Item->SetNumberField(TEXT("VotesDown"), Details.VotesDown);
+		Item->SetNumberField(TEXT("Score"), Details.CalculatedScore);
+		Item->SetBoolField(TEXT("Banned"), Details.bBanned);
+		Item->SetBoolField(TEXT("AcceptedForUse"), Details.bAcceptedForUse);
+		Item->SetBoolField(TEXT("TagsTruncated"), Details.bTagsTruncated);
+		Item->SetStringField(TEXT("CreatorSteamID"), Details.CreatorSteamID);
+
+		Items.Add(MakeShared<FJsonValueObject>(Item));
+	}
+
+	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetArrayField(TEXT("Items"), Items);
+
+	FString Json;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+
+	if (FJsonSerializer::Serialize(Root, Writer) && FFileHelper::SaveStringToFile(Json, *GetCacheFilename()))
+	{
+		bDirty = false;
+	}
+	else
+	{
+		UE_LOG(AdvancedSteamWorkshopLog, Warning, TEXT("Couldn't save the workshop details cache to %s"), *GetCacheFilename());
+	}
+}
+
+void FAdvancedSteamUGCDetailsCache::Load()
+{
+	FString Json;
+	if (!FFileHelper::LoadFileToString(Json, *GetCacheFilename()))
+		return;
+
+	TSharedPtr<FJsonObject> Root;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Json);
+
+	const TArray<TSharedPtr<FJsonValue>> * Items = nullptr;
+	if (!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid() || !Root->TryGetArrayField(TEXT("Items"), Items))
+	{
+		UE_LOG(AdvancedSteamWorkshopLog, Warning, TEXT("The workshop details cache in %s is corrupt, starting empty"), *GetCacheFilename());
+		return;
+	}
+
+	for (const TSharedPtr<FJsonValue> & Value : *Items)
+	{
+		const TSharedPtr<FJsonObject> * Item = nullptr;
+		if (!Value.IsValid() || !Value->TryGetObject(Item))
+			continue;
+
+		const uint64 ItemID = FCString::Strtoui64(*(*Item)->GetStringField(TEXT("Id")), nullptr, 10);
+		if (ItemID == 0)
+			continue;
+
+		FCachedDetails & Entry = Entries.Add(ItemID);
+		Entry.QueryTime = FCString::Atoi64(*(*Item)->GetStringField(TEXT("QueryTime")));
+
+		FBPSteamWorkshopItemDetails & Details = Entry.Details;
+		Details.WorkshopID = FBPSteamWorkshopID(ItemID);
+		Details.ResultOfRequest = (FBPSteamResult)(*Item)->GetIntegerField(TEXT("Result"));
+		Details.FileType = (FBPWorkshopFileType)(*Item)->GetIntegerField(TEXT("FileType"));
+		Details.CreatorAppID = (*Item)->GetIntegerField(TEXT("CreatorAppID"));
+		Details.ConsumerAppID = (*Item)->GetIntegerField(TEXT("ConsumerAppID"));
+		Details.Title = (*Item)->GetStringField(TEXT("Title"));
+		Details.Description = (*Item)->GetStringField(TEXT("Description"));
+		Details.ItemUrl = (*Item)->GetStringField(TEXT("ItemUrl"));
+		Details.VotesUp = (*Item)->GetIntegerField(TEXT("VotesUp"));
+		Details.VotesDown = (*Item)->GetIntegerField(TEXT("VotesDown"));
+		Details.CalculatedScore = (float)(*Item)->GetNumberField(TEXT("Score"));
+		Details.bBanned = (*Item)->GetBoolField(TEXT("Banned"));
+		Details.bAcceptedForUse = (*Item)->GetBoolField(TEXT("AcceptedForUse"));
+		Details.bTagsTruncated = (*Item)->GetBoolField(TEXT("TagsTruncated"));
+		Details.CreatorSteamID = (*Item)->GetStringField(TEXT("CreatorSteamID"));
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// USteamWSRequestUGCDetailsBatchCallbackProxy
+
+USteamWSRequestUGCDetailsBatchCallbackProxy::USteamWSRequestUGCDetailsBatchCallbackProxy(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	CacheLifetimeSeconds = 3600.0f;
+	PagesInFlight = 0;
+	ItemsDone = 0;
+	ItemsTotal = 0;
+	bAnyPageFailed = false;
+	bSendingPages = false;
+	bFinished = false;
+}
+
+USteamWSRequestUGCDetailsBatchCallbackProxy* USteamWSRequestUGCDetailsBatchCallbackProxy::GetWorkshopItemDetailsBatch(UObject* WorldContextObject, const TArray<FBPSteamWorkshopID> & WorkShopIDs, float CacheLifetimeSeconds)
+{
+	USteamWSRequestUGCDetailsBatchCallbackProxy* Proxy = NewObject<USteamWSRequestUGCDetailsBatchCallbackProxy>();
+
+	Proxy->WorkShopIDs = WorkShopIDs;
+	Proxy->CacheLifetimeSeconds = CacheLifetimeSeconds;
+	return Proxy;
+}
+
+void USteamWSRequestUGCDetailsBatchCallbackProxy::Activate()
+{
+	Backend = IAdvancedSteamUGCBackend::Get();
+
+	if (!Backend.IsValid())
+	{
+		UE_LOG(AdvancedSteamWorkshopLog, Warning, TEXT("GetWorkshopItemDetailsBatch Couldn't init steamAPI!"));
+		OnFailure.Broadcast(TArray<FBPSteamWorkshopItemDetails>());
+		return;
+	}
+
+	FAdvancedSteamUGCDetailsCache & Cache = FAdvancedSteamUGCDetailsCache::Get();
+	const int32 PageSize = FMath::Max(Backend->GetMaxItemsPerQuery(), 1);
+
+	TSet<uint64> UniqueIDs;
+	UniqueIDs.Reserve(WorkShopIDs.Num());
+
+	for (const FBPSteamWorkshopID & WorkShopID : WorkShopIDs)
+	{
+		bool bAlreadyInSet = false;
+		UniqueIDs.Add(WorkShopID.SteamWorkshopID, &bAlreadyInSet);
+
+		if (bAlreadyInSet)
+			continue;
+
+		++ItemsTotal;
+
+		FBPSteamWorkshopItemDetails Details;
+		if (CacheLifetimeSeconds > 0.0f && Cache.Find(WorkShopID.SteamWorkshopID, CacheLifetimeSeconds, Details))
+		{
+			Results.Add(WorkShopID.SteamWorkshopID, Details);
+			++ItemsDone;
+			continue;
+		}
+
+		if (PendingPages.Num() == 0 || PendingPages.Last().Num() >= PageSize)
+			PendingPages.AddDefaulted();
+
+		PendingPages.Last().Add(WorkShopID.SteamWorkshopID);
+	}
+
+	UE_LOG(AdvancedSteamWorkshopLog, Verbose, TEXT("GetWorkshopItemDetailsBatch %d items, %d from the cache, %d pages to query"), ItemsTotal, ItemsDone, PendingPages.Num());
+
+	if (PendingPages.Num() == 0)
+	{
+		Finish();
+		return;
+	}
+
+	// Nobody else holds on to us until every page is back
+	AddToRoot();
+
+	OnProgress.Broadcast(ItemsDone, ItemsTotal);
+	SendPages();
+}
+
+void USteamWSRequestUGCDetailsBatchCallbackProxy::SendPages()
+{
+	// A backend can complete a page before QueryUGCDetails returns, the loop below carries on from there
+	if (bSendingPages || bFinished)
+		return;
+
+	bSendingPages = true;
+
+	while (PagesInFlight < MaxPagesInFlight && PendingPages.Num() > 0)
+	{
+		TArray<uint64> PageItemIDs = PendingPages[0];
+		PendingPages.RemoveAt(0);
+
+		++PagesInFlight;
+
+		if (!Backend->QueryUGCDetails(PageItemIDs, FOnSteamUGCDetailsQueried::CreateUObject(this, &USteamWSRequestUGCDetailsBatchCallbackProxy::OnPageQueried, PageItemIDs)))
+		{
+			UE_LOG(AdvancedSteamWorkshopLog, Warning, TEXT("GetWorkshopItemDetailsBatch Couldn't send a query of %d items"), PageItemIDs.Num());
+
+			--PagesInFlight;
+			bAnyPageFailed = true;
+			ItemsDone += PageItemIDs.Num();
+		}
+	}
+
+	bSendingPages = false;
+
+	if (PagesInFlight == 0 && PendingPages.Num() == 0)
+		Finish();
+}
+
+void USteamWSRequestUGCDetailsBatchCallbackProxy::OnPageQueried(bool bWasSuccessful, const TArray<FBPSteamWorkshopItemDetails> & Details, TArray<uint64> PageItemIDs)
+{
+	if (bFinished)
+		return;
+
+	--PagesInFlight;
+
+	if (!bWasSuccessful)
+		bAnyPageFailed = true;
+
+	FAdvancedSteamUGCDetailsCache & Cache = FAdvancedSteamUGCDetailsCache::Get();
+
+	for (const FBPSteamWorkshopItemDetails & ItemDetails : Details)
+	{
+		Results.Add(ItemDetails.WorkshopID.SteamWorkshopID, ItemDetails);
+
+		// Only what steam actually found is kept, a missing item is asked for again next time
+		if (ItemDetails.ResultOfRequest == FBPSteamResult::k_EResultOK)
+			Cache.Add(ItemDetails);
+	}
+
+	ItemsDone += PageItemIDs.Num();
+	OnProgress.Broadcast(ItemsDone, ItemsTotal);
+
+	SendPages();
+}
+
+void USteamWSRequestUGCDetailsBatchCallbackProxy::Finish()
+{
+	if (bFinished)
+		return;
+
+	bFinished = true;
+
+	FAdvancedSteamUGCDetailsCache::Get().Save();
+
+	TArray<FBPSteamWorkshopItemDetails> DetailsOut;
+	DetailsOut.Reserve(WorkShopIDs.Num());
+
+	bool bAllFound = !bAnyPageFailed;
+
+	for (const FBPSteamWorkshopID & WorkShopID : WorkShopIDs)
+	{
+		if (const FBPSteamWorkshopItemDetails * Details = Results.Find(WorkShopID.SteamWorkshopID))
+		{
+			DetailsOut.Add(*Details);
+			continue;
+		}
+
+		FBPSteamWorkshopItemDetails & MissingDetails = DetailsOut.AddDefaulted_GetRef();
+		MissingDetails.ResultOfRequest = FBPSteamResult::k_EResultFail;
+		MissingDetails.WorkshopID = WorkShopID;
+		bAllFound = false;
+	}
+
+	Backend.Reset();
+
+	if (bAllFound)
+		OnSuccess.Broadcast(DetailsOut);
+	else
+		OnFailure.Broadcast(DetailsOut);
+
+	if (IsRooted())
+		RemoveFromRoot();
+}
@@ -28,7 +28,7 @@ void USteamWSRequestUGCDetailsCallbackProxy::Activate()
 #if PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX
 	if (SteamAPI_Init())
 	{
-		// #TODO: Support arrays instead in the future?
+		// One item per query, GetWorkshopItemDetailsBatch asks for many at once
 		UGCQueryHandle_t hQueryHandle = SteamUGC()->CreateQueryUGCDetailsRequest((PublishedFileId_t *)&WorkShopID.SteamWorkshopID, 1);
 		// #TODO: add search settings here by calling into the handle?
 		SteamAPICall_t hSteamAPICall = SteamUGC()->SendQueryUGCRequest(hQueryHandle);
@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "AdvancedSteamWorkshopLibrary.h"
+#include "SteamUGCDetailsBatchTestListener.generated.h"
+
+// Keeps what a USteamWSRequestUGCDetailsBatchCallbackProxy broadcast, so the automation tests can check it
+// The proxy delegates are dynamic, they can only be bound to UFUNCTIONs
+UCLASS(Transient)
+class USteamUGCDetailsBatchTestListener : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UFUNCTION()
+	void OnProgress(int32 ItemsDone, int32 ItemsTotal)
+	{
+		Progress.Add(FIntPoint(ItemsDone, ItemsTotal));
+	}
+
+	UFUNCTION()
+	void OnSuccess(const TArray<FBPSteamWorkshopItemDetails> & WorkshopDetails)
+	{
+		++NumSuccess;
+		Details = WorkshopDetails;
+	}
+
+	UFUNCTION()
+	void OnFailure(const TArray<FBPSteamWorkshopItemDetails> & WorkshopDetails)
+	{
+		++NumFailure;
+		Details = WorkshopDetails;
+	}
+
+	// ItemsDone, ItemsTotal of every OnProgress
+	TArray<FIntPoint> Progress;
+
+	TArray<FBPSteamWorkshopItemDetails> Details;
+
+	int32 NumSuccess = 0;
+	int32 NumFailure = 0;
+};
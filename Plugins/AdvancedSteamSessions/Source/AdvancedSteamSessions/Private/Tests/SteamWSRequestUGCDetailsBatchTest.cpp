@@ -0,0 +1,340 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SteamWSRequestUGCDetailsBatchCallbackProxy.h"
+#include "SteamUGCDetailsBatchTestListener.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SteamUGCDetailsBatchTest
+{
+	// Far from any real workshop item, the cache on disk is the real one
+	static const uint64 FirstTestID = 0x7E57000000000000ull;
+
+	// A workshop that answers when the test tells it to, a page at a time
+	class FMockUGCBackend : public IAdvancedSteamUGCBackend
+	{
+	public:
+
+		struct FQuery
+		{
+			TArray<uint64> ItemIDs;
+			FOnSteamUGCDetailsQueried OnComplete;
+		};
+
+		int32 ItemsPerQuery = 3;
+
+		// Queries that fail to send, by the order they are asked in
+		TSet<int32> QueriesToRefuse;
+
+		// Items answered with this result instead of k_EResultOK
+		TMap<uint64, FBPSteamResult> ItemResults;
+
+		// Every page asked for, the refused ones too
+		TArray<TArray<uint64>> SentPages;
+
+		// Queries sent and not answered yet, in the order they were sent
+		TArray<FQuery> PendingQueries;
+
+		virtual int32 GetMaxItemsPerQuery() override
+		{
+			return ItemsPerQuery;
+		}
+
+		virtual bool QueryUGCDetails(const TArray<uint64> & ItemIDs, const FOnSteamUGCDetailsQueried & OnComplete) override
+		{
+			SentPages.Add(ItemIDs);
+
+			if (QueriesToRefuse.Contains(SentPages.Num() - 1))
+				return false;
+
+			FQuery & Query = PendingQueries.AddDefaulted_GetRef();
+			Query.ItemIDs = ItemIDs;
+			Query.OnComplete = OnComplete;
+			return true;
+		}
+
+		// Answers a pending query, steam leaves the items in MissingItems out of a successful answer
+		void Complete(int32 PendingIndex, bool bWasSuccessful, const TSet<uint64> & MissingItems = TSet<uint64>())
+		{
+			const FQuery Query = PendingQueries[PendingIndex];
+			PendingQueries.RemoveAt(PendingIndex);
+
+			TArray<FBPSteamWorkshopItemDetails> Details;
+
+			for (int32 i = 0; bWasSuccessful && i < Query.ItemIDs.Num(); i++)
+			{
+				const uint64 ItemID = Query.ItemIDs[i];
+				if (MissingItems.Contains(ItemID))
+					continue;
+
+				FBPSteamWorkshopItemDetails & ItemDetails = Details.AddDefaulted_GetRef();
+				ItemDetails.WorkshopID = FBPSteamWorkshopID(ItemID);
+				ItemDetails.Title = FString::Printf(TEXT("Queried %llu"), ItemID);
+
+				if (const FBPSteamResult * Result = ItemResults.Find(ItemID))
+					ItemDetails.ResultOfRequest = *Result;
+			}
+
+			Query.OnComplete.ExecuteIfBound(bWasSuccessful, Details);
+		}
+	};
+
+	// Puts the mock in place of steam and takes every test item out of the cache when the test ends
+	struct FScopedMockBackend
+	{
+		TSharedRef<FMockUGCBackend> Backend;
+		TArray<uint64> UsedIDs;
+
+		FScopedMockBackend()
+			: Backend(MakeShared<FMockUGCBackend>())
+		{
+			IAdvancedSteamUGCBackend::SetBackend(Backend);
+		}
+
+		~FScopedMockBackend()
+		{
+			IAdvancedSteamUGCBackend::SetBackend(nullptr);
+
+			FAdvancedSteamUGCDetailsCache & Cache = FAdvancedSteamUGCDetailsCache::Get();
+			for (uint64 ItemID : UsedIDs)
+				Cache.Remove(ItemID);
+
+			Cache.Save();
+		}
+
+		// Count items in a row, starting at FirstTestID + First
+		TArray<FBPSteamWorkshopID> MakeIDs(uint64 First, int32 Count)
+		{
+			TArray<FBPSteamWorkshopID> IDs;
+
+			for (int32 i = 0; i < Count; i++)
+			{
+				IDs.Add(FBPSteamWorkshopID(FirstTestID + First + i));
+				UsedIDs.AddUnique(FirstTestID + First + i);
+			}
+
+			return IDs;
+		}
+	};
+
+	static USteamUGCDetailsBatchTestListener * StartBatch(const TArray<FBPSteamWorkshopID> & WorkShopIDs, float CacheLifetimeSeconds)
+	{
+		USteamUGCDetailsBatchTestListener * Listener = NewObject<USteamUGCDetailsBatchTestListener>();
+		USteamWSRequestUGCDetailsBatchCallbackProxy * Proxy = USteamWSRequestUGCDetailsBatchCallbackProxy::GetWorkshopItemDetailsBatch(nullptr, WorkShopIDs, CacheLifetimeSeconds);
+
+		Proxy->OnProgress.AddDynamic(Listener, &USteamUGCDetailsBatchTestListener::OnProgress);
+		Proxy->OnSuccess.AddDynamic(Listener, &USteamUGCDetailsBatchTestListener::OnSuccess);
+		Proxy->OnFailure.AddDynamic(Listener, &USteamUGCDetailsBatchTestListener::OnFailure);
+		Proxy->Activate();
+
+		return Listener;
+	}
+
+	static TArray<uint64> ToItemIDs(const TArray<FBPSteamWorkshopID> & WorkShopIDs)
+	{
+		TArray<uint64> ItemIDs;
+
+		for (const FBPSteamWorkshopID & WorkShopID : WorkShopIDs)
+			ItemIDs.Add(WorkShopID.SteamWorkshopID);
+
+		return ItemIDs;
+	}
+}
+
+using namespace SteamUGCDetailsBatchTest;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSteamUGCDetailsBatchPagingTest, "AdvancedSteamSessions.Workshop.DetailsBatch.Paging", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSteamUGCDetailsBatchPagingTest::RunTest(const FString & Parameters)
+{
+	FScopedMockBackend Mock;
+
+	// 7 items and one of them twice, in pages of 3
+	TArray<FBPSteamWorkshopID> WorkShopIDs = Mock.MakeIDs(0, 7);
+	WorkShopIDs.Add(WorkShopIDs[2]);
+
+	USteamUGCDetailsBatchTestListener * Listener = StartBatch(WorkShopIDs, 0.0f);
+
+	TestEqual(TEXT("Pages sent"), Mock.Backend->SentPages.Num(), 3);
+	TestEqual(TEXT("First page"), Mock.Backend->SentPages[0], ToItemIDs(Mock.MakeIDs(0, 3)));
+	TestEqual(TEXT("Second page"), Mock.Backend->SentPages[1], ToItemIDs(Mock.MakeIDs(3, 3)));
+	TestEqual(TEXT("Last page"), Mock.Backend->SentPages[2], ToItemIDs(Mock.MakeIDs(6, 1)));
+	TestEqual(TEXT("Progress before any page"), Listener->Progress[0], FIntPoint(0, 7));
+
+	// Pages come back in any order
+	Mock.Backend->Complete(2, true);
+	TestEqual(TEXT("Progress after the last page"), Listener->Progress.Last(), FIntPoint(1, 7));
+
+	Mock.Backend->Complete(1, true);
+	TestEqual(TEXT("Progress after the second page"), Listener->Progress.Last(), FIntPoint(4, 7));
+	TestEqual(TEXT("Nothing broadcast before the last page"), Listener->NumSuccess + Listener->NumFailure, 0);
+
+	Mock.Backend->Complete(0, true);
+	TestEqual(TEXT("Progress after every page"), Listener->Progress.Last(), FIntPoint(7, 7));
+	TestEqual(TEXT("OnSuccess calls"), Listener->NumSuccess, 1);
+	TestEqual(TEXT("OnFailure calls"), Listener->NumFailure, 0);
+
+	// The details come in the order they were asked for, the repeated item twice
+	if (TestEqual(TEXT("Details"), Listener->Details.Num(), WorkShopIDs.Num()))
+	{
+		for (int32 i = 0; i < WorkShopIDs.Num(); i++)
+		{
+			TestEqual(TEXT("Detail item"), Listener->Details[i].WorkshopID.SteamWorkshopID, WorkShopIDs[i].SteamWorkshopID);
+			TestEqual(TEXT("Detail result"), Listener->Details[i].ResultOfRequest, FBPSteamResult::k_EResultOK);
+		}
+	}
+
+	// No more than 4 pages are out at once, the next one goes when one comes back
+	Mock.Backend->SentPages.Reset();
+	Listener = StartBatch(Mock.MakeIDs(100, 14), 0.0f);
+
+	TestEqual(TEXT("Pages in flight"), Mock.Backend->PendingQueries.Num(), 4);
+
+	Mock.Backend->Complete(0, true);
+	TestEqual(TEXT("Pages sent after one came back"), Mock.Backend->SentPages.Num(), 5);
+	TestEqual(TEXT("Last page"), Mock.Backend->SentPages.Last(), ToItemIDs(Mock.MakeIDs(112, 2)));
+
+	while (Mock.Backend->PendingQueries.Num() > 0)
+		Mock.Backend->Complete(0, true);
+
+	TestEqual(TEXT("OnSuccess calls"), Listener->NumSuccess, 1);
+	TestEqual(TEXT("Details"), Listener->Details.Num(), 14);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSteamUGCDetailsBatchFailuresTest, "AdvancedSteamSessions.Workshop.DetailsBatch.Failures", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSteamUGCDetailsBatchFailuresTest::RunTest(const FString & Parameters)
+{
+	FScopedMockBackend Mock;
+
+	// The second page can't be sent, the third fails, and the first answers without its second item
+	const TArray<FBPSteamWorkshopID> WorkShopIDs = Mock.MakeIDs(0, 9);
+	const uint64 MissingID = WorkShopIDs[1].SteamWorkshopID;
+	const uint64 NotFoundID = WorkShopIDs[2].SteamWorkshopID;
+
+	Mock.Backend->QueriesToRefuse.Add(1);
+	Mock.Backend->ItemResults.Add(NotFoundID, FBPSteamResult::k_EResultFileNotFound);
+
+	USteamUGCDetailsBatchTestListener * Listener = StartBatch(WorkShopIDs, 0.0f);
+
+	TestEqual(TEXT("Pages asked for"), Mock.Backend->SentPages.Num(), 3);
+	TestEqual(TEXT("Pages in flight"), Mock.Backend->PendingQueries.Num(), 2);
+
+	Mock.Backend->Complete(0, true, { MissingID });
+	Mock.Backend->Complete(0, false);
+
+	TestEqual(TEXT("OnSuccess calls"), Listener->NumSuccess, 0);
+	TestEqual(TEXT("OnFailure calls"), Listener->NumFailure, 1);
+	TestEqual(TEXT("Progress after every page"), Listener->Progress.Last(), FIntPoint(9, 9));
+
+	if (TestEqual(TEXT("Details"), Listener->Details.Num(), 9))
+	{
+		TestEqual(TEXT("Answered item"), Listener->Details[0].ResultOfRequest, FBPSteamResult::k_EResultOK);
+		TestEqual(TEXT("Item left out of the answer"), Listener->Details[1].ResultOfRequest, FBPSteamResult::k_EResultFail);
+		TestEqual(TEXT("Item left out keeps its id"), Listener->Details[1].WorkshopID.SteamWorkshopID, MissingID);
+		TestEqual(TEXT("Item steam didn't find"), Listener->Details[2].ResultOfRequest, FBPSteamResult::k_EResultFileNotFound);
+
+		for (int32 i = 3; i < 9; i++)
+		{
+			TestEqual(TEXT("Item of a failed page"), Listener->Details[i].ResultOfRequest, FBPSteamResult::k_EResultFail);
+			TestEqual(TEXT("Item of a failed page keeps its id"), Listener->Details[i].WorkshopID.SteamWorkshopID, WorkShopIDs[i].SteamWorkshopID);
+		}
+	}
+
+	// Only what steam found goes to the cache
+	FAdvancedSteamUGCDetailsCache & Cache = FAdvancedSteamUGCDetailsCache::Get();
+	FBPSteamWorkshopItemDetails CachedDetails;
+
+	TestTrue(TEXT("Answered item cached"), Cache.Find(WorkShopIDs[0].SteamWorkshopID, 3600.0f, CachedDetails));
+	TestFalse(TEXT("Item left out cached"), Cache.Find(MissingID, 3600.0f, CachedDetails));
+	TestFalse(TEXT("Item steam didn't find cached"), Cache.Find(NotFoundID, 3600.0f, CachedDetails));
+	TestFalse(TEXT("Item of a failed page cached"), Cache.Find(WorkShopIDs[8].SteamWorkshopID, 3600.0f, CachedDetails));
+
+	// Nothing that can be sent fails right away
+	Mock.Backend->QueriesToRefuse.Add(3);
+	Listener = StartBatch(Mock.MakeIDs(100, 2), 0.0f);
+
+	TestEqual(TEXT("OnFailure calls when nothing can be sent"), Listener->NumFailure, 1);
+	TestEqual(TEXT("Details when nothing can be sent"), Listener->Details.Num(), 2);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSteamUGCDetailsBatchCacheTest, "AdvancedSteamSessions.Workshop.DetailsBatch.Cache", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSteamUGCDetailsBatchCacheTest::RunTest(const FString & Parameters)
+{
+	FScopedMockBackend Mock;
+
+	const TArray<FBPSteamWorkshopID> WorkShopIDs = Mock.MakeIDs(0, 3);
+	const uint64 ExpiredID = WorkShopIDs[0].SteamWorkshopID;
+	const uint64 FreshID = WorkShopIDs[1].SteamWorkshopID;
+	const uint64 UncachedID = WorkShopIDs[2].SteamWorkshopID;
+
+	// Cached two hours and ten seconds ago, with a title steam wouldn't give
+	FAdvancedSteamUGCDetailsCache & Cache = FAdvancedSteamUGCDetailsCache::Get();
+	const int64 Now = FDateTime::UtcNow().ToUnixTimestamp();
+
+	FBPSteamWorkshopItemDetails ExpiredDetails;
+	ExpiredDetails.WorkshopID = FBPSteamWorkshopID(ExpiredID);
+	ExpiredDetails.Title = TEXT("Cached");
+	Cache.Add(ExpiredDetails, Now - 7200);
+
+	FBPSteamWorkshopItemDetails FreshDetails;
+	FreshDetails.WorkshopID = FBPSteamWorkshopID(FreshID);
+	FreshDetails.Title = TEXT("Cached");
+	Cache.Add(FreshDetails, Now - 10);
+
+	// With an hour of lifetime only the fresh item comes from the cache
+	USteamUGCDetailsBatchTestListener * Listener = StartBatch(WorkShopIDs, 3600.0f);
+
+	if (TestEqual(TEXT("Pages sent"), Mock.Backend->SentPages.Num(), 1))
+	{
+		const TArray<uint64> ExpectedPage = { ExpiredID, UncachedID };
+		TestEqual(TEXT("Items asked to steam"), Mock.Backend->SentPages[0], ExpectedPage);
+	}
+
+	TestEqual(TEXT("Cached items count as done"), Listener->Progress[0], FIntPoint(1, 3));
+
+	Mock.Backend->Complete(0, true);
+
+	TestEqual(TEXT("OnSuccess calls"), Listener->NumSuccess, 1);
+
+	if (TestEqual(TEXT("Details"), Listener->Details.Num(), 3))
+	{
+		TestEqual(TEXT("Expired item"), Listener->Details[0].Title, FString::Printf(TEXT("Queried %llu"), ExpiredID));
+		TestEqual(TEXT("Fresh item"), Listener->Details[1].Title, FString(TEXT("Cached")));
+		TestEqual(TEXT("Uncached item"), Listener->Details[2].Title, FString::Printf(TEXT("Queried %llu"), UncachedID));
+	}
+
+	// The answer is written to disk with the batch
+	FString CacheJson;
+	TestTrue(TEXT("Cache saved"), FFileHelper::LoadFileToString(CacheJson, *(FPaths::ProjectSavedDir() / TEXT("AdvancedSteamSessions") / TEXT("UGCDetails.json"))));
+	TestTrue(TEXT("Queried item saved"), CacheJson.Contains(FString::Printf(TEXT("\"%llu\""), UncachedID)));
+
+	// Everything is fresh now, nothing is asked and the batch ends right away
+	Mock.Backend->SentPages.Reset();
+	Listener = StartBatch(WorkShopIDs, 3600.0f);
+
+	TestEqual(TEXT("Pages sent with everything cached"), Mock.Backend->SentPages.Num(), 0);
+	TestEqual(TEXT("OnSuccess calls with everything cached"), Listener->NumSuccess, 1);
+	TestEqual(TEXT("Progress with everything cached"), Listener->Progress.Num(), 0);
+
+	// A lifetime of 0 always asks steam
+	Listener = StartBatch(WorkShopIDs, 0.0f);
+
+	if (TestEqual(TEXT("Pages sent without the cache"), Mock.Backend->SentPages.Num(), 1))
+		TestEqual(TEXT("Items asked without the cache"), Mock.Backend->SentPages[0], ToItemIDs(WorkShopIDs));
+
+	Mock.Backend->Complete(0, true);
+	TestEqual(TEXT("OnSuccess calls without the cache"), Listener->NumSuccess, 1);
+
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
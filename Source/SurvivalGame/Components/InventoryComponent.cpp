@@ -8,6 +8,11 @@
 #include "InventoryComponent.h"
 #include "Net/UnrealNetwork.h"
 #include "Engine/ActorChannel.h" //Need it to replicate UObjects
+#include "Net/DataBunch.h"
+
+#include "SurvivalGame.h"
+#include "Framework/SurvivalTelemetrySubsystem.h"
+#include "Framework/SurvivalWorldSnapshotSubsystem.h"
 
 #define LOCTEXT_NAMESPACE "Inventory"
 
@@ -83,6 +88,8 @@ bool UInventoryComponent::RemoveItem(class UItem* Item)
 
 			//If we don't update this, the server is not gonna update the items to the clients
 			ReplicatedItemsKey++;
+
+			USurvivalWorldSnapshotSubsystem::MarkActorDirty(GetOwner());
 			return true;
 		}
 	}
@@ -184,6 +191,10 @@ void UInventoryComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>&
 
 bool UInventoryComponent::ReplicateSubobjects(class UActorChannel* Channel, class FOutBunch* Bunch, FReplicationFlags* RepFlags)
 {
+	SURVIVAL_SCOPE_CYCLE_COUNTER(InventoryReplicateSubobjects);
+
+	const int64 StartBits = Bunch->GetNumBits();
+
 	//Whether or not we wrote something in the actor channel
 	bool bWroteSomething = Super::ReplicateSubobjects(Channel, Bunch, RepFlags);
 
@@ -201,6 +212,8 @@ bool UInventoryComponent::ReplicateSubobjects(class UActorChannel* Channel, clas
 		}
 	}
 
+	USurvivalTelemetrySubsystem::CountReplicatedBits(this, Bunch->GetNumBits() - StartBits);
+
 	return bWroteSomething;
 
 }
@@ -244,10 +257,18 @@ void UInventoryComponent::OnRep_Items()
 
 FItemAddResult UInventoryComponent::TryAddItem_Internal(class UItem* Item)
 {
+	SURVIVAL_SCOPE_CYCLE_COUNTER(TryAddItem);
+
 	//If we are in the server...
 	if (GetOwner() && GetOwner()->GetLocalRole() == ROLE_Authority)
 	{
 		const int32 AddAmount = Item->GetQuantity(); //Amount that we're trying to add
+
+		//Stack data from the item definition registry, it doesn't touch the class defaults.
+		const FItemDefinition Definition = Item->GetDefinition();
+
+		//The weight of the item itself, the same one GetCurrentWeight adds up for the items we already carry.
+		const float ItemWeight = Item->Weight;
 		
 		//We can't add items if the inventory is full
 		if (Items.Num() + 1 > GetCapacity())
@@ -256,38 +277,38 @@ FItemAddResult UInventoryComponent::TryAddItem_Internal(class UItem* Item)
 		}
 
 		//Items with a weight of zero don't require a weight check.
-		if (!FMath::IsNearlyZero(Item->Weight))
+		if (!FMath::IsNearlyZero(ItemWeight))
 		{
 			//If we are gonna exceed the weight capacity...
-			if (GetCurrentWeight() + Item->Weight > GetWeightCapacity())
+			if (GetCurrentWeight() + ItemWeight > GetWeightCapacity())
 			{
 				return FItemAddResult::AddedNone(AddAmount, LOCTEXT("InventoryTooMuchWeightText", "Couldn't add item to inventory. Carrying too much weigh."));
 			}
 		}
 
 		//If the item is stackable, check if we already have it and add it to their stack
-		if (Item->bStackable)
+		if (Definition.bStackable)
 		{
 			//Somehow the items quantity went over the max stack size. This shouldn't ever happen.
-			ensure(Item->GetQuantity() <= Item->MaxStackSize);
+			ensure(Item->GetQuantity() <= Definition.MaxStackSize);
 
 			//If we have this item in our items, it doesn't make sense to add a new item. 
 			//We just increase the item's quantity in our inventory.
 			if (UItem* ExistingItem = FindItem(Item))
 			{
-				if (ExistingItem->GetQuantity() < ExistingItem->MaxStackSize)
+				if (ExistingItem->GetQuantity() < Definition.MaxStackSize)
 				{
 					//Find out how much of the item we can add
-					const int32 CapacityMaxAddAmount = ExistingItem->MaxStackSize - ExistingItem->GetQuantity();
+					const int32 CapacityMaxAddAmount = Definition.MaxStackSize - ExistingItem->GetQuantity();
 					int32 ActualAddAmount = FMath::Min(AddAmount, CapacityMaxAddAmount);
 
 					FText ErrorText = LOCTEXT("InventoryErrorText", "Couldn't add all of the items to your inventory");
 
 					//If the weight of the item is not nearly zero...
-					if (!FMath::IsNearlyZero(Item->Weight))
+					if (!FMath::IsNearlyZero(ItemWeight))
 					{
 						//Find the max amount of the item we could take due to weight
-						const int32 WeightMaxAmount = FMath::FloorToInt((WeightCapacity - GetCurrentWeight()) / Item->Weight);						
+						const int32 WeightMaxAmount = FMath::FloorToInt((WeightCapacity - GetCurrentWeight()) / ItemWeight);						
 						ActualAddAmount = FMath::Min(ActualAddAmount, WeightMaxAmount);
 
 						if (ActualAddAmount < AddAmount)
@@ -310,7 +331,7 @@ FItemAddResult UInventoryComponent::TryAddItem_Internal(class UItem* Item)
 					ExistingItem->SetQuantity(ExistingItem->GetQuantity() + ActualAddAmount); //Set the new quantity to the item if everything goes fine!
 
 					//If we somehow get more of the item than the max stack size, then something is wrong with our math.
-					ensure(ExistingItem->GetQuantity() <= ExistingItem->MaxStackSize);
+					ensure(ExistingItem->GetQuantity() <= Definition.MaxStackSize);
 
 					//If we couldn't add ALL of the items...
 					if (ActualAddAmount < AddAmount)
@@ -347,9 +368,9 @@ FItemAddResult UInventoryComponent::TryAddItem_Internal(class UItem* Item)
 			}
 
 			//Items with a weight of zero don't require a weight check
-			if (!FMath::IsNearlyZero(Item->Weight))
+			if (!FMath::IsNearlyZero(ItemWeight))
 			{
-				if (GetCurrentWeight() + Item->Weight > GetWeightCapacity())
+				if (GetCurrentWeight() + ItemWeight > GetWeightCapacity())
 				{
 					return FItemAddResult::AddedNone(Item->GetQuantity(), FText::Format(LOCTEXT("StackWeightFullText", "Couldn't add {ItemName}, too much weight."), Item->ItemDisplayName));
 				}
@@ -0,0 +1,213 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "SessionHeartbeatComponent.h"
+
+#include "Engine/World.h"
+#include "GameFramework/GameModeBase.h"
+#include "TimerManager.h"
+#include "OnlineSubsystemUtils.h"
+#include "OnlineSessionSettings.h"
+#include "Interfaces/OnlineSessionInterface.h"
+
+const FName USessionHeartbeatComponent::PlayerCountKey(TEXT("NUMPLAYERS"));
+
+USessionHeartbeatComponent::USessionHeartbeatComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	PublishInterval = 10.f;
+	bPublishPlayerCount = true;
+	bPublishMapName = true;
+
+	bUpdateInFlight = false;
+	NumChanges = 0;
+	NumUpdates = 0;
+}
+
+void USessionHeartbeatComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	FParse::Value(FCommandLine::Get(), TEXT("SessionHeartbeat="), PublishInterval);
+	PublishInterval = FMath::Max(PublishInterval, 1.f);
+
+	if (bPublishMapName)
+	{
+		SetSessionSetting(SETTING_MAPNAME, FVariantData(UWorld::RemovePIEPrefix(GetWorld()->GetMapName())));
+	}
+
+	GetWorld()->GetTimerManager().SetTimer(HeartbeatTimerHandle, this, &USessionHeartbeatComponent::Heartbeat, PublishInterval, true);
+}
+
+void USessionHeartbeatComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	GetWorld()->GetTimerManager().ClearTimer(HeartbeatTimerHandle);
+
+	if (UpdateCompleteHandle.IsValid())
+	{
+		IOnlineSessionPtr Sessions = Online::GetSessionInterface(GetWorld());
+		if (Sessions.IsValid())
+		{
+			Sessions->ClearOnUpdateSessionCompleteDelegate_Handle(UpdateCompleteHandle);
+		}
+	}
+
+	if (NumChanges > 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("Session heartbeat published %d updates for %d setting changes."), NumUpdates, NumChanges);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void USessionHeartbeatComponent::SetSessionProperty(const FSessionPropertyKeyPair& Property)
+{
+	SetSessionSetting(Property.Key, Property.Data);
+}
+
+void USessionHeartbeatComponent::SetSessionProperties(const TArray<FSessionPropertyKeyPair>& Properties)
+{
+	for (const FSessionPropertyKeyPair& Property : Properties)
+	{
+		SetSessionSetting(Property.Key, Property.Data);
+	}
+}
+
+void USessionHeartbeatComponent::SetSessionSetting(const FName Key, const FVariantData& Value)
+{
+	++NumChanges;
+
+	//Back to what the backend already has, nothing to send for it.
+	const FVariantData* PublishedValue = PublishedSettings.Find(Key);
+	if (PublishedValue && *PublishedValue == Value && !InFlightSettings.Contains(Key))
+	{
+		PendingSettings.Remove(Key);
+		return;
+	}
+
+	PendingSettings.Add(Key, Value);
+}
+
+void USessionHeartbeatComponent::PublishNow()
+{
+	Heartbeat();
+}
+
+void USessionHeartbeatComponent::Heartbeat()
+{
+	if (bPublishPlayerCount)
+	{
+		if (AGameModeBase* GameMode = Cast<AGameModeBase>(GetOwner()))
+		{
+			const FVariantData PlayerCount(GameMode->GetNumPlayers());
+			const FVariantData* LatestCount = FindLatestValue(PlayerCountKey);
+
+			//Only a change counts, the heartbeat reading the same count every time doesn't.
+			if (!LatestCount || *LatestCount != PlayerCount)
+			{
+				SetSessionSetting(PlayerCountKey, PlayerCount);
+			}
+		}
+	}
+
+	//One update at a time. What changes meanwhile goes with the next one.
+	if (PendingSettings.Num() == 0 || bUpdateInFlight)
+	{
+		return;
+	}
+
+	IOnlineSessionPtr Sessions = Online::GetSessionInterface(GetWorld());
+	FOnlineSessionSettings* SessionSettings = Sessions.IsValid() ? Sessions->GetSessionSettings(NAME_GameSession) : nullptr;
+
+	//No session yet, keep the changes until there is one.
+	if (!SessionSettings)
+	{
+		return;
+	}
+
+	for (const TPair<FName, FVariantData>& Setting : PendingSettings)
+	{
+		if (FOnlineSessionSetting* ExistingSetting = SessionSettings->Settings.Find(Setting.Key))
+		{
+			ExistingSetting->Data = Setting.Value;
+		}
+		else
+		{
+			FOnlineSessionSetting NewSetting;
+			NewSetting.Data = Setting.Value;
+			NewSetting.AdvertisementType = EOnlineDataAdvertisementType::ViaOnlineService;
+			SessionSettings->Settings.Add(Setting.Key, NewSetting);
+		}
+	}
+
+	InFlightSettings = MoveTemp(PendingSettings);
+	PendingSettings.Reset();
+
+	bUpdateInFlight = true;
+	++NumUpdates;
+
+	if (!UpdateCompleteHandle.IsValid())
+	{
+		UpdateCompleteHandle = Sessions->AddOnUpdateSessionCompleteDelegate_Handle(FOnUpdateSessionCompleteDelegate::CreateUObject(this, &USessionHeartbeatComponent::OnUpdateSessionComplete));
+	}
+
+	if (!Sessions->UpdateSession(NAME_GameSession, *SessionSettings, true))
+	{
+		OnUpdateSessionComplete(NAME_GameSession, false);
+	}
+}
+
+const FVariantData* USessionHeartbeatComponent::FindLatestValue(const FName Key) const
+{
+	if (const FVariantData* PendingValue = PendingSettings.Find(Key))
+	{
+		return PendingValue;
+	}
+
+	if (const FVariantData* InFlightValue = InFlightSettings.Find(Key))
+	{
+		return InFlightValue;
+	}
+
+	return PublishedSettings.Find(Key);
+}
+
+void USessionHeartbeatComponent::OnUpdateSessionComplete(FName SessionName, bool bWasSuccessful)
+{
+	if (SessionName != NAME_GameSession || !bUpdateInFlight)
+	{
+		return;
+	}
+
+	bUpdateInFlight = false;
+
+	if (bWasSuccessful)
+	{
+		PublishedSettings.Append(InFlightSettings);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Session heartbeat couldn't update the session, trying again with the next heartbeat."));
+
+		//Newer values set meanwhile win over the ones that failed.
+		for (const TPair<FName, FVariantData>& Setting : InFlightSettings)
+		{
+			if (!PendingSettings.Contains(Setting.Key))
+			{
+				PendingSettings.Add(Setting.Key, Setting.Value);
+			}
+		}
+	}
+
+	InFlightSettings.Reset();
+}
@@ -0,0 +1,89 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "BlueprintDataDefinitions.h"
+#include "SessionHeartbeatComponent.generated.h"
+
+/*Publishes the session settings of the server (player count, map and custom keys) to the online backend,
+at most once every PublishInterval seconds, instead of one UpdateSession per change.
+
+Changes are collected between two heartbeats: a key changed ten times is published once with its last value,
+and a key that goes back to the value we published isn't published at all. If nothing changed, nothing is sent.
+Only the changed keys are written into the session settings, the rest are left as they are.
+
+The player count is read from the game mode on every heartbeat, so joins and leaves don't need to call anything.
+Only runs on the server. Works with any online subsystem that has sessions, the Null one included.*/
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class SURVIVALGAME_API USessionHeartbeatComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	USessionHeartbeatComponent();
+
+	/*The key the player count is published with.*/
+	static const FName PlayerCountKey;
+
+	/*Seconds between two heartbeats. Overridden by -SessionHeartbeat=<seconds> in the server command line.*/
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Session")
+	float PublishInterval;
+
+	/*Publishes the player count of the game mode that owns this component.*/
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Session")
+	bool bPublishPlayerCount;
+
+	/*Publishes the name of the map when the game starts.*/
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Session")
+	bool bPublishMapName;
+
+	/*Sets a key for the next heartbeat. Use the MakeLiteralSessionProperty nodes of Advanced Sessions to make one.*/
+	UFUNCTION(BlueprintCallable, Category = "Session")
+	void SetSessionProperty(const FSessionPropertyKeyPair& Property);
+
+	UFUNCTION(BlueprintCallable, Category = "Session")
+	void SetSessionProperties(const TArray<FSessionPropertyKeyPair>& Properties);
+
+	void SetSessionSetting(const FName Key, const FVariantData& Value);
+
+	/*Publishes the pending changes now, without waiting for the next heartbeat.*/
+	UFUNCTION(BlueprintCallable, Category = "Session")
+	void PublishNow();
+
+protected:
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/*Changes since the last heartbeat.*/
+	TMap<FName, FVariantData> PendingSettings;
+
+	/*The values the backend has, so we only send what changed.*/
+	TMap<FName, FVariantData> PublishedSettings;
+
+	/*What we sent with the update that didn't complete yet.*/
+	TMap<FName, FVariantData> InFlightSettings;
+
+	bool bUpdateInFlight;
+
+	FTimerHandle HeartbeatTimerHandle;
+	FDelegateHandle UpdateCompleteHandle;
+
+	/*Calls to SetSessionSetting, and updates we actually sent for them.*/
+	int32 NumChanges;
+	int32 NumUpdates;
+
+	void Heartbeat();
+
+	/*The value the backend will have once what we sent and what is pending is published. Null if we never set it.*/
+	const FVariantData* FindLatestValue(const FName Key) const;
+
+	void OnUpdateSessionComplete(FName SessionName, bool bWasSuccessful);
+};
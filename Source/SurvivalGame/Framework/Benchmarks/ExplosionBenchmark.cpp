@@ -0,0 +1,106 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "Framework/Benchmarks/SurvivalBenchmark.h"
+
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+
+#include "Player/SurvivalCharacter.h"
+#include "Weapons/ExplosionSubsystem.h"
+#include "Weapons/SurvivalDamageTypes.h"
+#include "Weapons/ThrowableWeapon.h"
+
+/*50 explosions among 64 players, batched and with a radial damage call per explosion like before.*/
+IMPLEMENT_SURVIVAL_BENCHMARK(FExplosionBenchmark, "Explosion")
+{
+	UExplosionSubsystem* ExplosionSubsystem = Context.World->GetSubsystem<UExplosionSubsystem>();
+
+	if (!ExplosionSubsystem)
+	{
+		UE_LOG(LogTemp, Error, TEXT("No explosion subsystem in the benchmark world."));
+		return;
+	}
+
+	const int32 Players = 64;
+	const int32 Explosions = 50;
+	const FVector Center(0.f, 0.f, -50000.f);
+
+	TArray<ASurvivalCharacter*> Characters;
+	TArray<AThrowableWeapon*> Throwables;
+
+	//8x8 players 3 meters apart, so every explosion reaches a few of them.
+	for (int32 i = 0; i < Players; ++i)
+	{
+		const FVector Location = Center + FVector((i % 8 - 3.5f) * 300.f, (i / 8 - 3.5f) * 300.f, 0.f);
+
+		if (ASurvivalCharacter* Character = Context.World->SpawnActor<ASurvivalCharacter>(Location, FRotator::ZeroRotator))
+		{
+			Characters.Add(Character);
+		}
+	}
+
+	FRandomStream Random(29);
+
+	for (int32 i = 0; i < Explosions; ++i)
+	{
+		const FVector Location = Center + FVector(Random.FRandRange(-1200.f, 1200.f), Random.FRandRange(-1200.f, 1200.f), 50.f);
+
+		if (AThrowableWeapon* Throwable = Context.World->SpawnActor<AThrowableWeapon>(Location, FRotator::ZeroRotator))
+		{
+			Throwables.Add(Throwable);
+		}
+	}
+
+	if (Characters.Num() != Players || Throwables.Num() != Explosions)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Couldn't spawn the players and throwables for the explosion benchmark."));
+	}
+	else
+	{
+		//Barely any damage, so nobody dies however many times the benchmark repeats.
+		FThrowableExplosionConfig Config;
+		Config.BaseDamage = 0.01f;
+		Config.MinimumDamage = 0.f;
+
+		const double BatchedTime = Context.MeasureMicroseconds(Explosions, []() {},
+			[ExplosionSubsystem, &Throwables, &Config]()
+			{
+				for (AThrowableWeapon* Throwable : Throwables)
+				{
+					ExplosionSubsystem->QueueExplosion(Throwable, nullptr, Throwable->GetActorLocation(), Config);
+				}
+
+				ExplosionSubsystem->FlushExplosions();
+			});
+
+		Context.AddResult(FString::Printf(TEXT("ExplosionBatched_N%d_P%d"), Explosions, Players), BatchedTime, TEXT("us"));
+
+		//What every throwable did on its own before: the engine radial damage, an overlap and a trace per component each.
+		const double UnbatchedTime = Context.MeasureMicroseconds(Explosions, []() {},
+			[&Context, &Throwables, &Config]()
+			{
+				for (AThrowableWeapon* Throwable : Throwables)
+				{
+					UGameplayStatics::ApplyRadialDamageWithFalloff(Context.World, Config.BaseDamage, Config.MinimumDamage, Throwable->GetActorLocation(),
+						Config.InnerRadius, Config.OuterRadius, Config.DamageFalloff, UExplosiveDamage::StaticClass(), TArray<AActor*>(), Throwable, nullptr, ECC_Visibility);
+				}
+			});
+
+		Context.AddResult(FString::Printf(TEXT("ExplosionUnbatched_N%d_P%d"), Explosions, Players), UnbatchedTime, TEXT("us"));
+	}
+
+	for (ASurvivalCharacter* Character : Characters)
+	{
+		Character->Destroy();
+	}
+
+	for (AThrowableWeapon* Throwable : Throwables)
+	{
+		Throwable->Destroy();
+	}
+}
@@ -0,0 +1,116 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "Framework/Benchmarks/SurvivalBenchmark.h"
+
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+
+#include "Framework/SurvivalGroundLootSubsystem.h"
+#include "Framework/SurvivalNetSize.h"
+#include "Items/AmmoItem.h"
+#include "Items/FoodItem.h"
+#include "Items/WeaponItem.h"
+#include "World/LootPile.h"
+#include "World/Pickup.h"
+
+/*A player dropping a full inventory on one spot, with the ground loot merged into a pile and without: the actors left on
+the ground, their primitive components (what a client draws, one draw call or more each) and their replicated bits.*/
+IMPLEMENT_SURVIVAL_BENCHMARK(FGroundLootBenchmark, "GroundLoot")
+{
+	USurvivalGroundLootSubsystem* GroundLoot = Context.World->GetSubsystem<USurvivalGroundLootSubsystem>();
+	IConsoleVariable* GroundLootCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("Survival.GroundLoot"));
+
+	if (!GroundLoot || !GroundLootCVar)
+	{
+		UE_LOG(LogTemp, Error, TEXT("No ground loot subsystem in the benchmark world."));
+		return;
+	}
+
+	//A full player inventory.
+	const int32 Drops = 20;
+	const FVector DropLocation(0.f, 0.f, -40000.f);
+
+	const TSubclassOf<UItem> DroppedClasses[] = { UItem::StaticClass(), UFoodItem::StaticClass(), UAmmoItem::StaticClass(), UWeaponItem::StaticClass() };
+
+	auto ClearGroundLoot = [&Context]()
+	{
+		for (TActorIterator<APickup> It(Context.World); It; ++It)
+		{
+			It->Destroy();
+		}
+
+		for (TActorIterator<ALootPile> It(Context.World); It; ++It)
+		{
+			It->Destroy();
+		}
+	};
+
+	//The player keeps dropping from the same spot, a little around the feet as it turns.
+	auto DropEverything = [GroundLoot, &DropLocation, &DroppedClasses, Drops]()
+	{
+		for (int32 i = 0; i < Drops; ++i)
+		{
+			const FVector Location = DropLocation + FVector(FMath::Cos(i * 0.5f), FMath::Sin(i * 0.5f), 0.f) * 20.f;
+			GroundLoot->DropItem(nullptr, DroppedClasses[i % ARRAY_COUNT(DroppedClasses)], 1, FTransform(Location), APickup::StaticClass(), ALootPile::StaticClass());
+		}
+	};
+
+	const int32 WasEnabled = GroundLootCVar->GetInt();
+
+	for (const bool bMerge : { false, true })
+	{
+		GroundLootCVar->Set(bMerge ? 1 : 0, ECVF_SetByCode);
+
+		const double DropTime = Context.MeasureMicroseconds(Drops, ClearGroundLoot, DropEverything);
+
+		int32 Actors = 0;
+		int32 Primitives = 0;
+		int64 ReplicatedBits = 0;
+
+		auto CountActor = [&Actors, &Primitives, &ReplicatedBits](AActor* Actor)
+		{
+			if (Actor->IsPendingKill())
+			{
+				return;
+			}
+
+			TArray<UPrimitiveComponent*> PrimitiveComponents;
+			Actor->GetComponents<UPrimitiveComponent>(PrimitiveComponents);
+
+			++Actors;
+			Primitives += PrimitiveComponents.Num();
+			ReplicatedBits += FSurvivalNetSize::GetReplicatedBits(Actor);
+		};
+
+		for (TActorIterator<APickup> It(Context.World); It; ++It)
+		{
+			CountActor(*It);
+		}
+
+		for (TActorIterator<ALootPile> It(Context.World); It; ++It)
+		{
+			CountActor(*It);
+
+			//The items of a pile are in its inventory, the pile itself is only the mesh.
+			ReplicatedBits += It->IsPendingKill() ? 0 : FSurvivalNetSize::GetReplicatedBits(It->Inventory);
+		}
+
+		const TCHAR* Variant = bMerge ? TEXT("") : TEXT("Unmerged");
+
+		Context.AddResult(FString::Printf(TEXT("GroundLootDrop%s_Dump%d"), Variant, Drops), DropTime, TEXT("us"));
+		Context.AddResult(FString::Printf(TEXT("GroundLootActors%s_Dump%d"), Variant, Drops), Actors, TEXT("actors"));
+		Context.AddResult(FString::Printf(TEXT("GroundLootPrimitives%s_Dump%d"), Variant, Drops), Primitives, TEXT("primitives"));
+		Context.AddResult(FString::Printf(TEXT("GroundLootReplication%s_Dump%d"), Variant, Drops), ReplicatedBits, TEXT("bits"));
+
+		ClearGroundLoot();
+	}
+
+	GroundLootCVar->Set(WasEnabled, ECVF_SetByCode);
+}
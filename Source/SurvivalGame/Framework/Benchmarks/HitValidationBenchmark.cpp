@@ -0,0 +1,60 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "Framework/Benchmarks/SurvivalBenchmark.h"
+
+#include "Engine/World.h"
+
+#include "Weapons/Weapon.h"
+#include "World/LootableActor.h"
+
+/*The server checking the hitscan hits clients send.*/
+IMPLEMENT_SURVIVAL_BENCHMARK(FHitValidationBenchmark, "HitValidation")
+{
+	AWeapon* Weapon = Context.World->SpawnActor<AWeapon>();
+	ALootableActor* Target = Context.SpawnLootable(FVector(1000.f, 0.f, 0.f));
+
+	if (!Weapon || !Target)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Couldn't spawn the actors of the hit validation benchmark."));
+		return;
+	}
+
+	const int32 Shots = 1000;
+
+	//Some of the shots land inside the tolerance and some don't, like the hits real clients send.
+	FRandomStream Stream(Shots);
+	TArray<FHitResult> Impacts;
+
+	for (int32 i = 0; i < Shots; ++i)
+	{
+		FHitResult Impact;
+		Impact.Actor = Target;
+		Impact.bBlockingHit = true;
+		Impact.Location = Target->GetActorLocation() + Stream.VRand() * Stream.FRandRange(0.f, 150.f);
+		Impact.ImpactPoint = Impact.Location;
+		Impacts.Add(Impact);
+	}
+
+	int32 ValidHits = 0;
+
+	const double ValidationTime = Context.MeasureMicroseconds(Shots, [&ValidHits]() { ValidHits = 0; },
+		[Weapon, &Impacts, &ValidHits]()
+		{
+			for (const FHitResult& Impact : Impacts)
+			{
+				ValidHits += Weapon->IsClientHitWithinTolerance(Impact) ? 1 : 0;
+			}
+		});
+
+	UE_LOG(LogTemp, Log, TEXT("Hit validation accepted %d of %d shots."), ValidHits, Shots);
+
+	Context.AddResult(TEXT("HitValidation"), ValidationTime, TEXT("us"));
+
+	Weapon->Destroy();
+	Target->Destroy();
+}
@@ -0,0 +1,86 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "Framework/Benchmarks/SurvivalBenchmark.h"
+
+#include "AIController.h"
+#include "Engine/World.h"
+
+#include "Player/SurvivalCharacter.h"
+#include "World/LootableActor.h"
+
+/*The interaction check of a character with N interactables around.*/
+IMPLEMENT_SURVIVAL_BENCHMARK(FInteractionBenchmark, "Interaction")
+{
+	ASurvivalCharacter* Character = Context.World->SpawnActor<ASurvivalCharacter>(FVector::ZeroVector, FRotator::ZeroRotator);
+	AAIController* Controller = Context.World->SpawnActor<AAIController>();
+
+	if (!Character || !Controller)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Couldn't spawn a character for the interaction benchmark."));
+		return;
+	}
+
+	Controller->Possess(Character);
+	Controller->SetControlRotation(FRotator::ZeroRotator);
+
+	const int32 InteractableCounts[] = { 10, 100, 1000 };
+	const int32 Checks = 1000;
+
+	for (const int32 InteractableCount : InteractableCounts)
+	{
+		TArray<ALootableActor*> Lootables;
+
+		//The one we are looking at, close enough to interact with it.
+		Lootables.Add(Context.SpawnLootable(FVector(150.f, 0.f, Character->BaseEyeHeight)));
+
+		//Same positions on every run, so the runs compare.
+		FRandomStream Stream(InteractableCount);
+
+		for (int32 i = 1; i < InteractableCount; ++i)
+		{
+			FVector Location(Stream.FRandRange(-5000.f, 5000.f), Stream.FRandRange(-5000.f, 5000.f), Stream.FRandRange(-200.f, 200.f));
+
+			//Keep the space in front of the character clear.
+			if (Location.Size2D() < 500.f)
+			{
+				Location.X += 1000.f;
+			}
+
+			Lootables.Add(Context.SpawnLootable(Location));
+		}
+
+		const double CheckTime = Context.MeasureMicroseconds(Checks, []() {},
+			[Character, Checks]()
+			{
+				for (int32 i = 0; i < Checks; ++i)
+				{
+					Character->PerformInteractionCheck();
+				}
+			});
+
+		if (!Character->GetInteractable())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Interaction benchmark didn't find the interactable in front of the character."));
+		}
+
+		Context.AddResult(FString::Printf(TEXT("InteractionCheck_N%d"), InteractableCount), CheckTime, TEXT("us"));
+
+		Character->CouldntFindInteractable();
+
+		for (ALootableActor* Lootable : Lootables)
+		{
+			Lootable->Destroy();
+		}
+
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	Controller->UnPossess();
+	Controller->Destroy();
+	Character->Destroy();
+}
@@ -0,0 +1,145 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "Framework/Benchmarks/SurvivalBenchmark.h"
+
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/StrongObjectPtr.h"
+#include "UObject/UObjectIterator.h"
+
+#include "Components/InventoryComponent.h"
+#include "Items/FoodItem.h"
+#include "Items/ItemDefinitionRegistry.h"
+
+/*Inventory add/find/consume at different inventory sizes, adds with the item definition registry and with the class defaults,
+and generating and loading the registry.*/
+IMPLEMENT_SURVIVAL_BENCHMARK(FInventoryBenchmark, "Inventory")
+{
+	TArray<UClass*> ItemClasses;
+
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		if (It->IsChildOf(UItem::StaticClass()))
+		{
+			ItemClasses.Add(*It);
+		}
+	}
+
+	//Reading the defaults of every item class, what the registry saves the server at startup.
+	TArray<uint8> RegistryData;
+
+	const double GenerateTime = Context.MeasureMicroseconds(1, []() {},
+		[&ItemClasses, &RegistryData]()
+		{
+			FItemDefinitionRegistry::Generate(ItemClasses, RegistryData);
+		});
+
+	Context.AddResult(TEXT("ItemRegistryGenerate"), GenerateTime, TEXT("us"));
+
+	FItemDefinitionRegistry& Registry = FItemDefinitionRegistry::Get();
+	const bool bRegistryWasLoaded = Registry.IsLoaded();
+
+	const FString RegistryFile = FPaths::Combine(FPaths::ProfilingDir(), TEXT("SurvivalBenchmark"), TEXT("ItemDefinitions.bin"));
+	FFileHelper::SaveArrayToFile(RegistryData, *RegistryFile);
+
+	const double LoadTime = Context.MeasureMicroseconds(1, [&Registry]() { Registry.Unload(); },
+		[&Registry, &RegistryFile]()
+		{
+			Registry.Load(RegistryFile);
+		});
+
+	Context.AddResult(TEXT("ItemRegistryLoad"), LoadTime, TEXT("us"));
+
+	//Created after the registry is loaded, so it gets the id of its class. Kept alive through the garbage collections below.
+	TStrongObjectPtr<UItem> ItemTemplatePtr(NewObject<USurvivalBenchmarkItem>(GetTransientPackage()));
+	UItem* ItemTemplate = ItemTemplatePtr.Get();
+
+	//The same item without a registry id, it reads its own weight and stack data like before the registry.
+	TStrongObjectPtr<UItem> ClassDefaultsTemplatePtr(NewObject<USurvivalBenchmarkItem>(GetTransientPackage()));
+	UItem* ClassDefaultsTemplate = ClassDefaultsTemplatePtr.Get();
+	ClassDefaultsTemplate->DefinitionId = INDEX_NONE;
+
+	const int32 InventorySizes[] = { 10, 50, 200 };
+	const int32 Finds = 1000;
+
+	for (const int32 InventorySize : InventorySizes)
+	{
+		UInventoryComponent* Inventory = Context.SpawnInventory(InventorySize);
+
+		auto FillInventory = [Inventory, ItemTemplate, InventorySize]()
+		{
+			FSurvivalBenchmarkContext::EmptyInventory(Inventory);
+
+			for (int32 i = 0; i < InventorySize; ++i)
+			{
+				Inventory->TryAddItem(ItemTemplate);
+			}
+		};
+
+		const double AddTime = Context.MeasureMicroseconds(InventorySize,
+			[Inventory]() { FSurvivalBenchmarkContext::EmptyInventory(Inventory); },
+			[Inventory, ItemTemplate, InventorySize]()
+			{
+				for (int32 i = 0; i < InventorySize; ++i)
+				{
+					Inventory->TryAddItem(ItemTemplate);
+				}
+			});
+
+		Context.AddResult(FString::Printf(TEXT("InventoryAdd_N%d"), InventorySize), AddTime, TEXT("us"));
+
+		const double ClassDefaultsAddTime = Context.MeasureMicroseconds(InventorySize,
+			[Inventory]() { FSurvivalBenchmarkContext::EmptyInventory(Inventory); },
+			[Inventory, ClassDefaultsTemplate, InventorySize]()
+			{
+				for (int32 i = 0; i < InventorySize; ++i)
+				{
+					Inventory->TryAddItem(ClassDefaultsTemplate);
+				}
+			});
+
+		Context.AddResult(FString::Printf(TEXT("InventoryAddClassDefaults_N%d"), InventorySize), ClassDefaultsAddTime, TEXT("us"));
+
+		//Looking for something we don't have is the worst case, we have to check every item.
+		const double FindTime = Context.MeasureMicroseconds(Finds, FillInventory,
+			[Inventory, Finds]()
+			{
+				for (int32 i = 0; i < Finds; ++i)
+				{
+					Inventory->FindItemByClass(UFoodItem::StaticClass());
+				}
+			});
+
+		Context.AddResult(FString::Printf(TEXT("InventoryFind_N%d"), InventorySize), FindTime, TEXT("us"));
+
+		const double ConsumeTime = Context.MeasureMicroseconds(InventorySize, FillInventory,
+			[Inventory]()
+			{
+				for (UItem* Item : Inventory->GetItems())
+				{
+					Inventory->ConsumeItem(Item, 1);
+				}
+			});
+
+		Context.AddResult(FString::Printf(TEXT("InventoryConsume_N%d"), InventorySize), ConsumeTime, TEXT("us"));
+
+		Inventory->GetOwner()->Destroy();
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	//Back to the registry the game started with.
+	Registry.Unload();
+	IFileManager::Get().Delete(*RegistryFile, false, true, true);
+
+	if (bRegistryWasLoaded)
+	{
+		Registry.Load(FItemDefinitionRegistry::GetDefaultFilename());
+	}
+}
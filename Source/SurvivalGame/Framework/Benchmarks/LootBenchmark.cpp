@@ -0,0 +1,76 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "Framework/Benchmarks/SurvivalBenchmark.h"
+
+#include "Engine/DataTable.h"
+#include "Engine/World.h"
+
+#include "Components/InventoryComponent.h"
+#include "Items/AmmoItem.h"
+#include "Items/FoodItem.h"
+#include "World/LootableActor.h"
+
+/*Loot rolls of a chest with a few rows in its loot table.*/
+IMPLEMENT_SURVIVAL_BENCHMARK(FLootBenchmark, "Loot")
+{
+	UDataTable* LootTable = NewObject<UDataTable>(GetTransientPackage());
+	LootTable->RowStruct = FLootTableRow::StaticStruct();
+
+	FLootTableRow CommonRow;
+	CommonRow.Items.Add(UItem::StaticClass());
+	CommonRow.Probability = 1.f;
+	LootTable->AddRow(TEXT("Common"), CommonRow);
+
+	FLootTableRow FoodRow;
+	FoodRow.Items.Add(UFoodItem::StaticClass());
+	FoodRow.Probability = 0.5f;
+	LootTable->AddRow(TEXT("Food"), FoodRow);
+
+	FLootTableRow AmmoRow;
+	AmmoRow.Items.Add(UAmmoItem::StaticClass());
+	AmmoRow.Items.Add(UItem::StaticClass());
+	AmmoRow.Probability = 0.1f;
+	LootTable->AddRow(TEXT("Ammo"), AmmoRow);
+
+	//Enough chests to get a measurable time out of one roll each.
+	const int32 Chests = 100;
+
+	TArray<ALootableActor*> Lootables;
+
+	for (int32 i = 0; i < Chests; ++i)
+	{
+		ALootableActor* Lootable = Context.World->SpawnActor<ALootableActor>(FVector(i * 200.f, 0.f, -10000.f), FRotator::ZeroRotator);
+		Lootable->LootTable = LootTable;
+		Lootables.Add(Lootable);
+	}
+
+	FMath::RandInit(1234);
+
+	const double RollTime = Context.MeasureMicroseconds(Chests,
+		[&Lootables]()
+		{
+			for (ALootableActor* Lootable : Lootables)
+			{
+				FSurvivalBenchmarkContext::EmptyInventory(Lootable->Inventory);
+			}
+		},
+		[&Lootables]()
+		{
+			for (ALootableActor* Lootable : Lootables)
+			{
+				Lootable->RollLoot();
+			}
+		});
+
+	Context.AddResult(TEXT("LootRoll"), RollTime, TEXT("us"));
+
+	for (ALootableActor* Lootable : Lootables)
+	{
+		Lootable->Destroy();
+	}
+}
@@ -0,0 +1,127 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "Framework/Benchmarks/SurvivalBenchmark.h"
+
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+#include "Components/InventoryComponent.h"
+#include "Framework/SurvivalPlayerSaveSubsystem.h"
+#include "Items/AmmoItem.h"
+#include "Items/FoodItem.h"
+#include "Items/WeaponItem.h"
+#include "Player/SurvivalCharacter.h"
+
+/*Saving and restoring 200 player inventories with the local file store.*/
+IMPLEMENT_SURVIVAL_BENCHMARK(FPlayerSaveBenchmark, "PlayerSave")
+{
+	const int32 Players = 200;
+	const int32 ItemsPerPlayer = 30;
+
+	ASurvivalCharacter* Character = Context.World->SpawnActor<ASurvivalCharacter>(FVector(0.f, 0.f, -30000.f), FRotator::ZeroRotator);
+
+	if (!Character || !Character->PlayerInventory)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Couldn't spawn a character for the player save benchmark."));
+		return;
+	}
+
+	UInventoryComponent* Inventory = Character->PlayerInventory;
+	Inventory->SetCapacity(ItemsPerPlayer + 1);
+	Inventory->SetWeightCapacity(BIG_NUMBER);
+
+	//Food and ammo, and a weapon that gets equipped when it's added.
+	for (int32 i = 0; i < ItemsPerPlayer; ++i)
+	{
+		Inventory->TryAddItemFromClass(i % 2 ? UFoodItem::StaticClass() : UAmmoItem::StaticClass());
+	}
+
+	Inventory->TryAddItemFromClass(UWeaponItem::StaticClass());
+
+	TArray<FString> PlayerIds;
+	for (int32 i = 0; i < Players; ++i)
+	{
+		PlayerIds.Add(FString::Printf(TEXT("BenchmarkPlayer%d"), i));
+	}
+
+	FSurvivalPlayerSave Save;
+	TArray<uint8> SaveData;
+
+	//What the game thread pays to turn a character into a blob.
+	const double CaptureTime = Context.MeasureMicroseconds(Players, []() {},
+		[Character, Players, &Save, &SaveData]()
+		{
+			for (int32 i = 0; i < Players; ++i)
+			{
+				USurvivalPlayerSaveSubsystem::CaptureCharacter(Character, Save);
+				Save.ToBytes(SaveData);
+			}
+		});
+
+	Context.AddResult(FString::Printf(TEXT("PlayerSaveCapture_P%d"), Players), CaptureTime, TEXT("us"));
+	Context.AddResult(TEXT("PlayerSaveSize"), SaveData.Num(), TEXT("bytes"));
+
+	const FString SaveDirectory = FPaths::Combine(FPaths::ProfilingDir(), TEXT("SurvivalBenchmark"), TEXT("PlayerSaves"));
+	TSharedRef<FSurvivalPlayerSaveQueue, ESPMode::ThreadSafe> SaveQueue = MakeShared<FSurvivalPlayerSaveQueue, ESPMode::ThreadSafe>(MakeShared<FSurvivalPlayerSaveFileStore, ESPMode::ThreadSafe>(SaveDirectory));
+
+	auto QueueSaves = [&SaveQueue, &PlayerIds, &SaveData]()
+	{
+		for (const FString& PlayerId : PlayerIds)
+		{
+			TArray<uint8> Data = SaveData;
+			SaveQueue->Write(PlayerId, MoveTemp(Data));
+		}
+	};
+
+	//Queueing is all the game thread waits for, the files are written on the thread pool.
+	const double QueueTime = Context.MeasureMicroseconds(Players, [&SaveQueue]() { SaveQueue->Flush(); }, QueueSaves);
+
+	Context.AddResult(FString::Printf(TEXT("PlayerSaveQueue_P%d"), Players), QueueTime, TEXT("us"));
+
+	//Until every file is on disk, the time a server shutting down waits for.
+	const double WriteTime = Context.MeasureMicroseconds(Players, [&SaveQueue]() { SaveQueue->Flush(); },
+		[&SaveQueue, &QueueSaves]()
+		{
+			QueueSaves();
+			SaveQueue->Flush();
+		});
+
+	Context.AddResult(FString::Printf(TEXT("PlayerSaveWrite_P%d"), Players), WriteTime, TEXT("us"));
+
+	//Reads from disk and decodes, what the thread pool does when a player logs in. Done here on one thread.
+	const double LoadTime = Context.MeasureMicroseconds(Players, []() {},
+		[&SaveQueue, &PlayerIds]()
+		{
+			TArray<uint8> Data;
+			FSurvivalPlayerSave LoadedSave;
+
+			for (const FString& PlayerId : PlayerIds)
+			{
+				SaveQueue->Read(PlayerId, Data);
+				LoadedSave.FromBytes(Data);
+			}
+		});
+
+	Context.AddResult(FString::Printf(TEXT("PlayerSaveLoad_P%d"), Players), LoadTime, TEXT("us"));
+
+	//Rebuilding the inventory and equipping, the game thread part of a restore.
+	const double RestoreTime = Context.MeasureMicroseconds(Players, []() {},
+		[Character, Players, &Save]()
+		{
+			for (int32 i = 0; i < Players; ++i)
+			{
+				USurvivalPlayerSaveSubsystem::ApplyToCharacter(Character, Save);
+			}
+		});
+
+	Context.AddResult(FString::Printf(TEXT("PlayerSaveRestore_P%d"), Players), RestoreTime, TEXT("us"));
+
+	Character->Destroy();
+	IFileManager::Get().DeleteDirectory(*SaveDirectory, false, true);
+}
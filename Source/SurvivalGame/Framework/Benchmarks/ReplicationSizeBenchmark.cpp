@@ -0,0 +1,45 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "Framework/Benchmarks/SurvivalBenchmark.h"
+
+#include "Engine/World.h"
+
+#include "Components/InventoryComponent.h"
+#include "Framework/SurvivalNetSize.h"
+#include "World/Pickup.h"
+
+/*The size of the replicated state of inventories and pickups.*/
+IMPLEMENT_SURVIVAL_BENCHMARK(FReplicationSizeBenchmark, "ReplicationSize")
+{
+	UItem* ItemTemplate = NewObject<UItem>(GetTransientPackage());
+
+	const int32 InventorySizes[] = { 10, 50, 200 };
+
+	for (const int32 InventorySize : InventorySizes)
+	{
+		UInventoryComponent* Inventory = Context.SpawnInventory(InventorySize);
+
+		for (int32 i = 0; i < InventorySize; ++i)
+		{
+			Inventory->TryAddItem(ItemTemplate);
+		}
+
+		Context.AddResult(FString::Printf(TEXT("InventoryReplication_N%d"), InventorySize), FSurvivalNetSize::GetReplicatedBits(Inventory), TEXT("bits"));
+
+		Inventory->GetOwner()->Destroy();
+	}
+
+	APickup* Pickup = Context.World->SpawnActor<APickup>(FVector(0.f, 0.f, -20000.f), FRotator::ZeroRotator);
+
+	if (Pickup)
+	{
+		Pickup->InitializePickup(UItem::StaticClass(), 1);
+		Context.AddResult(TEXT("PickupReplication"), FSurvivalNetSize::GetReplicatedBits(Pickup), TEXT("bits"));
+		Pickup->Destroy();
+	}
+}
@@ -0,0 +1,131 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "Framework/Benchmarks/SurvivalBenchmark.h"
+
+#include "AdvancedSessionsLibrary.h"
+#include "FindSessionsCallbackProxyAdvanced.h"
+#include "OnlineSessionSettings.h"
+
+/*Server browser session settings lookups and filters over a full refresh.*/
+IMPLEMENT_SURVIVAL_BENCHMARK(FSessionSettingsBenchmark, "SessionSettings")
+{
+	//What a server browser refresh can bring back, and what each row reads.
+	const int32 Sessions = 1000;
+	const int32 PropertiesPerSession = 10;
+
+	TArray<FName> PropertyNames;
+	for (int32 i = 0; i < PropertiesPerSession; ++i)
+	{
+		PropertyNames.Add(FName(*FString::Printf(TEXT("Property%d"), i)));
+	}
+
+	FRandomStream Stream(Sessions);
+	TArray<FBlueprintSessionResult> SessionResults;
+	SessionResults.SetNum(Sessions);
+
+	for (FBlueprintSessionResult& SessionResult : SessionResults)
+	{
+		FOnlineSessionSettings& SessionSettings = SessionResult.OnlineResult.Session.SessionSettings;
+
+		//Half ints and half strings, like map names and game modes next to player counts.
+		for (int32 i = 0; i < PropertiesPerSession; ++i)
+		{
+			if (i % 2 == 0)
+			{
+				SessionSettings.Set(PropertyNames[i], Stream.RandRange(0, 10), EOnlineDataAdvertisementType::ViaOnlineService);
+			}
+			else
+			{
+				SessionSettings.Set(PropertyNames[i], FString::Printf(TEXT("Value%d"), Stream.RandRange(0, 10)), EOnlineDataAdvertisementType::ViaOnlineService);
+			}
+		}
+	}
+
+	int32 FoundProperties = 0;
+
+	//What the browser rows did: copy the settings into an array, then search it for every property.
+	const double ArrayTime = Context.MeasureMicroseconds(Sessions, [&FoundProperties]() { FoundProperties = 0; },
+		[&SessionResults, &PropertyNames, &FoundProperties]()
+		{
+			TArray<FSessionPropertyKeyPair> ExtraSettings;
+			ESessionSettingSearchResult SearchResult;
+			int32 IntValue;
+			FString StringValue;
+
+			for (const FBlueprintSessionResult& SessionResult : SessionResults)
+			{
+				ExtraSettings.Reset();
+				UAdvancedSessionsLibrary::GetExtraSettings(SessionResult, ExtraSettings);
+
+				for (int32 i = 0; i < PropertyNames.Num(); ++i)
+				{
+					if (i % 2 == 0)
+					{
+						UAdvancedSessionsLibrary::GetSessionPropertyInt(ExtraSettings, PropertyNames[i], SearchResult, IntValue);
+					}
+					else
+					{
+						UAdvancedSessionsLibrary::GetSessionPropertyString(ExtraSettings, PropertyNames[i], SearchResult, StringValue);
+					}
+
+					FoundProperties += SearchResult == ESessionSettingSearchResult::Found ? 1 : 0;
+				}
+			}
+		});
+
+	Context.AddResult(FString::Printf(TEXT("SessionSettingsArray_N%dx%d"), Sessions, PropertiesPerSession), ArrayTime, TEXT("us"));
+
+	const double IndexedTime = Context.MeasureMicroseconds(Sessions, [&FoundProperties]() { FoundProperties = 0; },
+		[&SessionResults, &PropertyNames, &FoundProperties]()
+		{
+			ESessionSettingSearchResult SearchResult;
+			int32 IntValue;
+			FString StringValue;
+
+			for (const FBlueprintSessionResult& SessionResult : SessionResults)
+			{
+				const FSessionPropertyIndex PropertyIndex = UAdvancedSessionsLibrary::MakeSessionPropertyIndex(SessionResult);
+
+				for (int32 i = 0; i < PropertyNames.Num(); ++i)
+				{
+					if (i % 2 == 0)
+					{
+						UAdvancedSessionsLibrary::GetIndexedSessionPropertyInt(PropertyIndex, PropertyNames[i], SearchResult, IntValue);
+					}
+					else
+					{
+						UAdvancedSessionsLibrary::GetIndexedSessionPropertyString(PropertyIndex, PropertyNames[i], SearchResult, StringValue);
+					}
+
+					FoundProperties += SearchResult == ESessionSettingSearchResult::Found ? 1 : 0;
+				}
+			}
+		});
+
+	if (FoundProperties != Sessions * PropertiesPerSession)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Session settings benchmark found %d of %d properties."), FoundProperties, Sessions * PropertiesPerSession);
+	}
+
+	Context.AddResult(FString::Printf(TEXT("SessionSettingsIndexed_N%dx%d"), Sessions, PropertiesPerSession), IndexedTime, TEXT("us"));
+
+	//A browser filter: one int setting and one string setting.
+	TArray<FSessionsSearchSetting> Filters;
+	Filters.Add(UAdvancedSessionsLibrary::MakeLiteralSessionSearchProperty(UAdvancedSessionsLibrary::MakeLiteralSessionPropertyInt(PropertyNames[0], 5), EOnlineComparisonOpRedux::GreaterThanEquals));
+	Filters.Add(UAdvancedSessionsLibrary::MakeLiteralSessionSearchProperty(UAdvancedSessionsLibrary::MakeLiteralSessionPropertyString(PropertyNames[1], TEXT("Value3")), EOnlineComparisonOpRedux::NotEquals));
+
+	TArray<FBlueprintSessionResult> FilteredResults;
+
+	const double FilterTime = Context.MeasureMicroseconds(Sessions, [&FilteredResults]() { FilteredResults.Reset(); },
+		[&SessionResults, &Filters, &FilteredResults]()
+		{
+			UFindSessionsCallbackProxyAdvanced::FilterSessionResults(SessionResults, Filters, FilteredResults);
+		});
+
+	Context.AddResult(FString::Printf(TEXT("SessionFilter_N%d"), Sessions), FilterTime, TEXT("us"));
+}
@@ -0,0 +1,112 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "SurvivalBenchmark.h"
+
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+
+#include "Components/InventoryComponent.h"
+#include "World/LootableActor.h"
+
+USurvivalBenchmarkItem::USurvivalBenchmarkItem()
+{
+	Weight = 1.f;
+}
+
+FSurvivalBenchmarkContext::FSurvivalBenchmarkContext(UWorld* InWorld, const int32 InRepeats)
+	: World(InWorld)
+	, Repeats(FMath::Max(1, InRepeats))
+{
+}
+
+double FSurvivalBenchmarkContext::MeasureMicroseconds(const int32 Operations, TFunctionRef<void()> Setup, TFunctionRef<void()> Run) const
+{
+	TArray<double> Times;
+
+	for (int32 i = 0; i < Repeats; ++i)
+	{
+		Setup();
+
+		const double StartTime = FPlatformTime::Seconds();
+		Run();
+		const double EndTime = FPlatformTime::Seconds();
+
+		Times.Add((EndTime - StartTime) * 1000000.0 / FMath::Max(1, Operations));
+	}
+
+	Times.Sort();
+	return Times[Times.Num() / 2];
+}
+
+void FSurvivalBenchmarkContext::AddResult(const FString& Name, const double Value, const TCHAR* Unit)
+{
+	FSurvivalBenchmarkResult Result;
+	Result.Name = Name;
+	Result.Unit = Unit;
+	Result.Value = Value;
+	Result.Baseline = 0.0;
+	Result.bRegressed = false;
+
+	Results.Add(Result);
+
+	UE_LOG(LogTemp, Display, TEXT("%-28s %12.3f %s"), *Name, Value, Unit);
+}
+
+UInventoryComponent* FSurvivalBenchmarkContext::SpawnInventory(const int32 Capacity) const
+{
+	AActor* InventoryOwner = World->SpawnActor<AActor>();
+
+	UInventoryComponent* Inventory = NewObject<UInventoryComponent>(InventoryOwner);
+	Inventory->RegisterComponent();
+	Inventory->SetCapacity(Capacity);
+	Inventory->SetWeightCapacity(BIG_NUMBER);
+
+	return Inventory;
+}
+
+ALootableActor* FSurvivalBenchmarkContext::SpawnLootable(const FVector& Location) const
+{
+	static UStaticMesh* CubeMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+
+	ALootableActor* Lootable = World->SpawnActor<ALootableActor>(Location, FRotator::ZeroRotator);
+
+	if (Lootable)
+	{
+		Lootable->LootContainerMesh->SetStaticMesh(CubeMesh);
+	}
+
+	return Lootable;
+}
+
+void FSurvivalBenchmarkContext::EmptyInventory(UInventoryComponent* Inventory)
+{
+	for (UItem* Item : Inventory->GetItems())
+	{
+		Inventory->RemoveItem(Item);
+	}
+}
+
+FSurvivalBenchmark::FSurvivalBenchmark(const TCHAR* InName)
+	: Name(InName)
+{
+	GetMutableRegistered().Add(this);
+}
+
+const TArray<const FSurvivalBenchmark*>& FSurvivalBenchmark::GetRegistered()
+{
+	return GetMutableRegistered();
+}
+
+TArray<const FSurvivalBenchmark*>& FSurvivalBenchmark::GetMutableRegistered()
+{
+	//A function static, the benchmarks register from static constructors in other files.
+	static TArray<const FSurvivalBenchmark*> Registered;
+	return Registered;
+}
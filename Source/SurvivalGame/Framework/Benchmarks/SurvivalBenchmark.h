@@ -0,0 +1,107 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Items/Item.h"
+#include "SurvivalBenchmark.generated.h"
+
+/*One measured value. Every metric is "lower is better": microseconds per operation, bits on the wire, bytes on disk
+or actors and primitive components left in the world.*/
+struct FSurvivalBenchmarkResult
+{
+	FString Name;
+	FString Unit;
+	double Value;
+
+	/*The value we compared against. Zero if the metric has no baseline.*/
+	double Baseline;
+
+	bool bRegressed;
+};
+
+/*An item that weights something, like the real ones do, so the weight check is part of the cost of adding it.
+Only the benchmarks create it, the class defaults of UItem stay as they are.*/
+UCLASS(NotBlueprintable, HideDropdown)
+class SURVIVALGAME_API USurvivalBenchmarkItem : public UItem
+{
+	GENERATED_BODY()
+
+public:
+
+	USurvivalBenchmarkItem();
+};
+
+/*What every benchmark gets from the commandlet: the world to spawn in, the timing and where the results go.*/
+class SURVIVALGAME_API FSurvivalBenchmarkContext
+{
+public:
+
+	FSurvivalBenchmarkContext(UWorld* InWorld, const int32 InRepeats);
+
+	/*Created with no map by the commandlet. Everything a benchmark spawns has to be destroyed before it returns.*/
+	UWorld* const World;
+
+	/*Times every measure runs. The median of them is the result, so one slow run doesn't fail the build.*/
+	const int32 Repeats;
+
+	/*Calls Setup (not timed) and then Run (timed) Repeats times. Returns the median of the microseconds per operation.*/
+	double MeasureMicroseconds(const int32 Operations, TFunctionRef<void()> Setup, TFunctionRef<void()> Run) const;
+
+	void AddResult(const FString& Name, const double Value, const TCHAR* Unit);
+
+	const TArray<FSurvivalBenchmarkResult>& GetResults() const { return Results; }
+
+	/*Spawns an actor that only has an inventory, so we can test the inventory on its own.*/
+	class UInventoryComponent* SpawnInventory(const int32 Capacity) const;
+
+	/*Spawns a chest with a cube as collision, so line traces can hit it.*/
+	class ALootableActor* SpawnLootable(const FVector& Location) const;
+
+	/*Removes every item of the inventory. Used to reset it between two runs.*/
+	static void EmptyInventory(class UInventoryComponent* Inventory);
+
+private:
+
+	TArray<FSurvivalBenchmarkResult> Results;
+};
+
+/*The benchmark of one system. Declared with IMPLEMENT_SURVIVAL_BENCHMARK in its own file under Framework/Benchmarks,
+the commandlet runs every one of them in the order they registered.*/
+class SURVIVALGAME_API FSurvivalBenchmark
+{
+public:
+
+	explicit FSurvivalBenchmark(const TCHAR* InName);
+	virtual ~FSurvivalBenchmark() {}
+
+	/*What -Benchmarks= selects it with.*/
+	const TCHAR* GetName() const { return Name; }
+
+	virtual void Run(FSurvivalBenchmarkContext& Context) const = 0;
+
+	static const TArray<const FSurvivalBenchmark*>& GetRegistered();
+
+private:
+
+	const TCHAR* Name;
+
+	static TArray<const FSurvivalBenchmark*>& GetMutableRegistered();
+};
+
+#define IMPLEMENT_SURVIVAL_BENCHMARK(TClass, PrettyName) \
+	class TClass : public FSurvivalBenchmark \
+	{ \
+	public: \
+		TClass() : FSurvivalBenchmark(TEXT(PrettyName)) {} \
+		virtual void Run(FSurvivalBenchmarkContext& Context) const override; \
+	}; \
+	namespace \
+	{ \
+		TClass TClass##Instance; \
+	} \
+	void TClass::Run(FSurvivalBenchmarkContext& Context) const
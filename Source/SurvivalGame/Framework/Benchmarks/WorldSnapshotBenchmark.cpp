@@ -0,0 +1,134 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "Framework/Benchmarks/SurvivalBenchmark.h"
+
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+#include "Components/InventoryComponent.h"
+#include "Framework/SurvivalWorldSnapshotSubsystem.h"
+#include "Items/AmmoItem.h"
+#include "Items/FoodItem.h"
+#include "World/LootableActor.h"
+
+/*The world snapshot of 10000 containers: the game thread cost of a snapshot interval, writing the log, and reading it back
+and restoring the containers.*/
+IMPLEMENT_SURVIVAL_BENCHMARK(FWorldSnapshotBenchmark, "WorldSnapshot")
+{
+	const int32 Containers = 10000;
+	const int32 ItemsPerContainer = 5;
+
+	TArray<ALootableActor*> Lootables;
+	TArray<FString> Keys;
+
+	Lootables.Reserve(Containers);
+	Keys.Reserve(Containers);
+
+	for (int32 i = 0; i < Containers; ++i)
+	{
+		ALootableActor* Lootable = Context.World->SpawnActor<ALootableActor>(FVector(i * 200.f, 0.f, -30000.f), FRotator::ZeroRotator);
+
+		if (!Lootable || !Lootable->Inventory)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Couldn't spawn the containers for the world snapshot benchmark."));
+			return;
+		}
+
+		for (int32 j = 0; j < ItemsPerContainer; ++j)
+		{
+			Lootable->Inventory->TryAddItemFromClass(j % 2 ? UFoodItem::StaticClass() : UAmmoItem::StaticClass());
+		}
+
+		Lootables.Add(Lootable);
+		Keys.Add(FString::Printf(TEXT("Container%d"), i));
+	}
+
+	auto CaptureContainers = [&Lootables, &Keys](const int32 NumDirty)
+	{
+		TArray<TPair<FString, FWorldSnapshotRecord>> Records;
+		Records.Reserve(NumDirty);
+
+		for (int32 i = 0; i < NumDirty; ++i)
+		{
+			FWorldSnapshotRecord Record;
+			USurvivalWorldSnapshotSubsystem::CaptureContainer(Lootables[i], Record);
+
+			Records.Emplace(Keys[i], MoveTemp(Record));
+		}
+
+		return Records;
+	};
+
+	const FString SnapshotFile = FPaths::Combine(FPaths::ProfilingDir(), TEXT("SurvivalBenchmark"), TEXT("WorldSnapshot.snap"));
+	IFileManager::Get().Delete(*SnapshotFile, false, true, true);
+
+	TSharedRef<FWorldSnapshotWriter, ESPMode::ThreadSafe> Writer = MakeShared<FWorldSnapshotWriter, ESPMode::ThreadSafe>(SnapshotFile, TMap<FString, FWorldSnapshotRecord>());
+
+	//What the game thread pays every interval, with a few containers looted or with all of them. The writing is on the thread pool.
+	for (const int32 NumDirty : { 100, Containers })
+	{
+		const double IntervalTime = Context.MeasureMicroseconds(1, [&Writer]() { Writer->Flush(); },
+			[&Writer, &CaptureContainers, NumDirty]()
+			{
+				Writer->Write(CaptureContainers(NumDirty));
+			});
+
+		Context.AddResult(FString::Printf(TEXT("WorldSnapshotInterval_Dirty%d"), NumDirty), IntervalTime, TEXT("us"));
+	}
+
+	//Until a full snapshot is in the log, what a server shutting down waits for.
+	const double WriteTime = Context.MeasureMicroseconds(1, [&Writer]() { Writer->Flush(); },
+		[&Writer, &CaptureContainers, &Lootables]()
+		{
+			Writer->Write(CaptureContainers(Lootables.Num()));
+			Writer->Flush();
+		});
+
+	Context.AddResult(FString::Printf(TEXT("WorldSnapshotWrite_N%d"), Containers), WriteTime, TEXT("us"));
+
+	//The log a server finds when it restarts: the live state once, and a few small frames after it.
+	Writer->RequestCompaction();
+	Writer->Write(CaptureContainers(100));
+	Writer->Flush();
+
+	TMap<FString, FWorldSnapshotRecord> LoadedRecords;
+	int32 NumFrames = 0;
+
+	const double LoadTime = Context.MeasureMicroseconds(1, [&LoadedRecords]() { LoadedRecords.Reset(); },
+		[&SnapshotFile, &LoadedRecords, &NumFrames]()
+		{
+			FWorldSnapshotLog::ReadLog(SnapshotFile, LoadedRecords, NumFrames);
+		});
+
+	Context.AddResult(FString::Printf(TEXT("WorldSnapshotLoad_N%d"), Containers), LoadTime, TEXT("us"));
+
+	//Giving every container its items back, the game thread part of a restore.
+	TMap<FString, UClass*> ClassCache;
+
+	const double RestoreTime = Context.MeasureMicroseconds(1, []() {},
+		[&Lootables, &Keys, &LoadedRecords, &ClassCache]()
+		{
+			for (int32 i = 0; i < Lootables.Num(); ++i)
+			{
+				if (const FWorldSnapshotRecord* Record = LoadedRecords.Find(Keys[i]))
+				{
+					USurvivalWorldSnapshotSubsystem::ApplyContainer(Lootables[i], *Record, ClassCache);
+				}
+			}
+		});
+
+	Context.AddResult(FString::Printf(TEXT("WorldSnapshotRestore_N%d"), Containers), RestoreTime, TEXT("us"));
+
+	for (ALootableActor* Lootable : Lootables)
+	{
+		Lootable->Destroy();
+	}
+
+	IFileManager::Get().Delete(*SnapshotFile, false, true, true);
+}
@@ -0,0 +1,375 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "SurvivalBanListSubsystem.h"
+
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/GameSession.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+USurvivalBanListSubsystem::USurvivalBanListSubsystem()
+{
+	ReloadInterval = 5.f;
+	bAllowListOnly = false;
+	JournalReadOffset = 0;
+}
+
+void USurvivalBanListSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	JournalPath = FPaths::ProjectSavedDir() / TEXT("Server") / TEXT("BanList.journal");
+	FParse::Value(FCommandLine::Get(), TEXT("BanList="), JournalPath);
+
+	bAllowListOnly = FParse::Param(FCommandLine::Get(), TEXT("AllowListOnly"));
+
+	ReloadJournal();
+
+	ReloadTickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &USurvivalBanListSubsystem::OnReloadTicker), FMath::Max(ReloadInterval, 1.f));
+}
+
+void USurvivalBanListSubsystem::Deinitialize()
+{
+	FTicker::GetCoreTicker().RemoveTicker(ReloadTickerHandle);
+
+	Super::Deinitialize();
+}
+
+bool USurvivalBanListSubsystem::IsBlocked(const FUniqueNetIdRepl& UniqueId, FString& OutReason) const
+{
+	const FString Id = UniqueId.IsValid() ? UniqueId->ToString() : FString();
+
+	if (const FString* BanReason = BannedIds.Find(Id))
+	{
+		OutReason = BanReason->IsEmpty() ? TEXT("Banned") : *BanReason;
+		return true;
+	}
+
+	if (bAllowListOnly && !AllowedIds.Contains(Id))
+	{
+		OutReason = TEXT("Not in the allow list of this server");
+		return true;
+	}
+
+	return false;
+}
+
+int32 USurvivalBanListSubsystem::BanPlayers(const TArray<APlayerController*>& Players, const FText& Reason)
+{
+	TArray<FString> Lines;
+	TArray<APlayerController*> PlayersToKick;
+
+	for (APlayerController* Player : Players)
+	{
+		if (Player && Player->PlayerState && Player->PlayerState->GetUniqueId().IsValid())
+		{
+			Lines.Add(MakeJournalLine(TEXT("BAN"), Player->PlayerState->GetUniqueId()->ToString(), Reason.ToString()));
+			PlayersToKick.Add(Player);
+		}
+	}
+
+	AppendToJournal(Lines);
+
+	for (APlayerController* Player : PlayersToKick)
+	{
+		KickPlayer(Player, Reason);
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Banned %d players."), PlayersToKick.Num());
+
+	return PlayersToKick.Num();
+}
+
+int32 USurvivalBanListSubsystem::KickPlayers(const TArray<APlayerController*>& Players, const FText& Reason)
+{
+	int32 NumKicked = 0;
+
+	for (APlayerController* Player : Players)
+	{
+		if (KickPlayer(Player, Reason))
+		{
+			++NumKicked;
+		}
+	}
+
+	return NumKicked;
+}
+
+void USurvivalBanListSubsystem::BanIds(const TArray<FString>& UniqueIds, const FString& Reason)
+{
+	TArray<FString> Lines;
+	Lines.Reserve(UniqueIds.Num());
+
+	for (const FString& UniqueId : UniqueIds)
+	{
+		Lines.Add(MakeJournalLine(TEXT("BAN"), UniqueId, Reason));
+	}
+
+	AppendToJournal(Lines);
+	KickBannedPlayers(UniqueIds);
+}
+
+void USurvivalBanListSubsystem::UnbanIds(const TArray<FString>& UniqueIds)
+{
+	TArray<FString> Lines;
+	Lines.Reserve(UniqueIds.Num());
+
+	for (const FString& UniqueId : UniqueIds)
+	{
+		Lines.Add(MakeJournalLine(TEXT("UNBAN"), UniqueId));
+	}
+
+	AppendToJournal(Lines);
+}
+
+void USurvivalBanListSubsystem::AllowIds(const TArray<FString>& UniqueIds)
+{
+	TArray<FString> Lines;
+	Lines.Reserve(UniqueIds.Num());
+
+	for (const FString& UniqueId : UniqueIds)
+	{
+		Lines.Add(MakeJournalLine(TEXT("ALLOW"), UniqueId));
+	}
+
+	AppendToJournal(Lines);
+}
+
+void USurvivalBanListSubsystem::DisallowIds(const TArray<FString>& UniqueIds)
+{
+	TArray<FString> Lines;
+	Lines.Reserve(UniqueIds.Num());
+
+	for (const FString& UniqueId : UniqueIds)
+	{
+		Lines.Add(MakeJournalLine(TEXT("DISALLOW"), UniqueId));
+	}
+
+	AppendToJournal(Lines);
+}
+
+void USurvivalBanListSubsystem::ReloadJournal()
+{
+	IFileManager& FileManager = IFileManager::Get();
+	const int64 JournalSize = FileManager.FileSize(*JournalPath);
+
+	//No journal yet, or it was deleted. The bans we have stay until there is one again.
+	if (JournalSize < 0)
+	{
+		return;
+	}
+
+	//Rewritten shorter, whatever we read before doesn't hold anymore.
+	if (JournalSize < JournalReadOffset)
+	{
+		UE_LOG(LogTemp, Log, TEXT("Ban list journal %s was rewritten, reading it again."), *JournalPath);
+
+		BannedIds.Empty();
+		AllowedIds.Empty();
+		JournalReadOffset = 0;
+	}
+
+	if (JournalSize <= JournalReadOffset)
+	{
+		return;
+	}
+
+	TUniquePtr<FArchive> Reader(FileManager.CreateFileReader(*JournalPath, FILEREAD_AllowWrite));
+	if (!Reader)
+	{
+		return;
+	}
+
+	TArray<uint8> NewBytes;
+	NewBytes.SetNumUninitialized(JournalSize - JournalReadOffset);
+
+	Reader->Seek(JournalReadOffset);
+	Reader->Serialize(NewBytes.GetData(), NewBytes.Num());
+	Reader->Close();
+
+	int32 LastLineEnd = INDEX_NONE;
+	NewBytes.FindLast('\n', LastLineEnd);
+
+	if (LastLineEnd == INDEX_NONE)
+	{
+		return;
+	}
+
+	const FUTF8ToTCHAR Converted((const ANSICHAR*)NewBytes.GetData(), LastLineEnd + 1);
+	const FString NewText(Converted.Length(), Converted.Get());
+
+	TArray<FString> Lines;
+	NewText.ParseIntoArrayLines(Lines);
+
+	TArray<FString> NewlyBanned;
+
+	for (const FString& Line : Lines)
+	{
+		ApplyJournalLine(Line, NewlyBanned);
+	}
+
+	JournalReadOffset += LastLineEnd + 1;
+
+	UE_LOG(LogTemp, Log, TEXT("Read %d ban list changes, %d bans and %d allowed ids."), Lines.Num(), BannedIds.Num(), AllowedIds.Num());
+
+	//Players banned by lines added while they were playing.
+	KickBannedPlayers(NewlyBanned);
+}
+
+bool USurvivalBanListSubsystem::OnReloadTicker(float DeltaTime)
+{
+	UWorld* World = GetGameInstance()->GetWorld();
+
+	//Clients never check anyone.
+	if (World && World->GetNetMode() != NM_Client)
+	{
+		ReloadJournal();
+	}
+
+	return true;
+}
+
+void USurvivalBanListSubsystem::ApplyJournalLine(const FString& Line, TArray<FString>& NewlyBanned)
+{
+	if (Line.IsEmpty() || Line.StartsWith(TEXT("#")))
+	{
+		return;
+	}
+
+	TArray<FString> Fields;
+	Line.ParseIntoArray(Fields, TEXT("\t"), false);
+
+	if (Fields.Num() < 3 || Fields[2].IsEmpty())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Bad ban list line: %s"), *Line);
+		return;
+	}
+
+	const FString& Operation = Fields[1];
+	const FString& UniqueId = Fields[2];
+
+	if (Operation == TEXT("BAN"))
+	{
+		if (!BannedIds.Contains(UniqueId))
+		{
+			NewlyBanned.Add(UniqueId);
+		}
+
+		BannedIds.Add(UniqueId, Fields.Num() > 3 ? Fields[3] : FString());
+	}
+	else if (Operation == TEXT("UNBAN"))
+	{
+		BannedIds.Remove(UniqueId);
+	}
+	else if (Operation == TEXT("ALLOW"))
+	{
+		AllowedIds.Add(UniqueId);
+	}
+	else if (Operation == TEXT("DISALLOW"))
+	{
+		AllowedIds.Remove(UniqueId);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Unknown ban list operation %s."), *Operation);
+	}
+}
+
+void USurvivalBanListSubsystem::AppendToJournal(const TArray<FString>& Lines)
+{
+	if (Lines.Num() == 0)
+	{
+		return;
+	}
+
+	//Admins may have appended something we didn't read yet, it goes before ours.
+	ReloadJournal();
+
+	IFileManager& FileManager = IFileManager::Get();
+	const bool bUpToDate = FMath::Max<int64>(FileManager.FileSize(*JournalPath), 0) == JournalReadOffset;
+
+	FString Text;
+	for (const FString& Line : Lines)
+	{
+		Text += Line;
+		Text += TEXT("\n");
+	}
+
+	if (!FFileHelper::SaveStringToFile(Text, *JournalPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM, &FileManager, FILEWRITE_Append))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Couldn't write to the ban list journal %s, the changes only last until the server stops."), *JournalPath);
+	}
+	else if (bUpToDate)
+	{
+		//We apply our own lines below, no need to read them back.
+		JournalReadOffset = FileManager.FileSize(*JournalPath);
+	}
+
+	TArray<FString> NewlyBanned;
+
+	for (const FString& Line : Lines)
+	{
+		ApplyJournalLine(Line, NewlyBanned);
+	}
+}
+
+FString USurvivalBanListSubsystem::MakeJournalLine(const TCHAR* Operation, const FString& UniqueId, const FString& Reason)
+{
+	//A tab or a line break in the reason would break the line.
+	FString CleanReason = Reason.Replace(TEXT("\t"), TEXT(" ")).Replace(TEXT("\r"), TEXT(" ")).Replace(TEXT("\n"), TEXT(" "));
+
+	return FString::Printf(TEXT("%lld\t%s\t%s\t%s"), FDateTime::UtcNow().ToUnixTimestamp(), Operation, *UniqueId, *CleanReason);
+}
+
+void USurvivalBanListSubsystem::KickBannedPlayers(const TArray<FString>& UniqueIds)
+{
+	UWorld* World = GetGameInstance()->GetWorld();
+	if (!World || UniqueIds.Num() == 0)
+	{
+		return;
+	}
+
+	const TSet<FString> IdsToKick(UniqueIds);
+
+	//Kicking destroys the controller, so we collect them first.
+	TArray<APlayerController*> PlayersToKick;
+
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* Player = It->Get();
+
+		if (Player && Player->PlayerState && Player->PlayerState->GetUniqueId().IsValid() && IdsToKick.Contains(Player->PlayerState->GetUniqueId()->ToString()))
+		{
+			PlayersToKick.Add(Player);
+		}
+	}
+
+	for (APlayerController* Player : PlayersToKick)
+	{
+		const FString* BanReason = BannedIds.Find(Player->PlayerState->GetUniqueId()->ToString());
+		KickPlayer(Player, FText::FromString(BanReason && !BanReason->IsEmpty() ? *BanReason : TEXT("Banned")));
+	}
+}
+
+bool USurvivalBanListSubsystem::KickPlayer(APlayerController* Player, const FText& Reason)
+{
+	UWorld* World = Player ? Player->GetWorld() : nullptr;
+	AGameModeBase* GameMode = World ? World->GetAuthGameMode() : nullptr;
+
+	if (!GameMode || !GameMode->GameSession || Player->IsLocalController())
+	{
+		return false;
+	}
+
+	return GameMode->GameSession->KickPlayer(Player, Reason);
+}
@@ -0,0 +1,102 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "GameFramework/OnlineReplStructs.h"
+#include "Containers/Ticker.h"
+#include "SurvivalBanListSubsystem.generated.h"
+
+/*The bans and the allow list of the server, kept in a hash of unique net ids so the game mode can check every login in PreLogin.
+
+Everything is stored in an append-only journal, one change per line: <unix time> <BAN|UNBAN|ALLOW|DISALLOW> <unique net id> [reason],
+separated by tabs. Loading replays the journal from the start. Admins can add lines to the file while the server runs: every
+ReloadInterval seconds we read only what was appended since the last read, and kick the connected players the new lines ban.
+If the file gets shorter (someone rewrote it) it's read again from the start.
+
+The journal is Saved/Server/BanList.journal, or the one given with -BanList=<path>.
+With -AllowListOnly only the ids in the allow list can join.*/
+UCLASS()
+class SURVIVALGAME_API USurvivalBanListSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	USurvivalBanListSubsystem();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/*Seconds between two checks of the journal for new lines.*/
+	float ReloadInterval;
+
+	/*True if the id can't join. Reason is the one given when it was banned, or why it isn't in the allow list.*/
+	bool IsBlocked(const FUniqueNetIdRepl& UniqueId, FString& OutReason) const;
+
+	UFUNCTION(BlueprintPure, Category = "Ban List")
+	bool IsBanned(const FString& UniqueId) const { return BannedIds.Contains(UniqueId); }
+
+	/*Bans every player given with one write to the journal, then kicks them. Returns how many were banned.*/
+	UFUNCTION(BlueprintCallable, Category = "Ban List")
+	int32 BanPlayers(const TArray<APlayerController*>& Players, const FText& Reason);
+
+	/*Kicks every player given, without banning them. Returns how many were kicked.*/
+	UFUNCTION(BlueprintCallable, Category = "Ban List")
+	int32 KickPlayers(const TArray<APlayerController*>& Players, const FText& Reason);
+
+	/*Bans ids that don't have to be connected. Connected players among them are kicked.*/
+	UFUNCTION(BlueprintCallable, Category = "Ban List")
+	void BanIds(const TArray<FString>& UniqueIds, const FString& Reason);
+
+	UFUNCTION(BlueprintCallable, Category = "Ban List")
+	void UnbanIds(const TArray<FString>& UniqueIds);
+
+	UFUNCTION(BlueprintCallable, Category = "Ban List")
+	void AllowIds(const TArray<FString>& UniqueIds);
+
+	UFUNCTION(BlueprintCallable, Category = "Ban List")
+	void DisallowIds(const TArray<FString>& UniqueIds);
+
+	/*Reads what was appended to the journal since the last read.*/
+	UFUNCTION(BlueprintCallable, Category = "Ban List")
+	void ReloadJournal();
+
+	int32 GetNumBans() const { return BannedIds.Num(); }
+
+protected:
+
+	/*Banned ids and why.*/
+	TMap<FString, FString> BannedIds;
+
+	TSet<FString> AllowedIds;
+
+	bool bAllowListOnly;
+
+	FString JournalPath;
+
+	/*Bytes of the journal we already read. Only whole lines are read, a line being written is left for the next reload.*/
+	int64 JournalReadOffset;
+
+	FDelegateHandle ReloadTickerHandle;
+
+	bool OnReloadTicker(float DeltaTime);
+
+	/*Applies one line of the journal. Ids banned by it are added to NewlyBanned.*/
+	void ApplyJournalLine(const FString& Line, TArray<FString>& NewlyBanned);
+
+	/*Appends the lines to the journal and applies them, in one write.*/
+	void AppendToJournal(const TArray<FString>& Lines);
+
+	static FString MakeJournalLine(const TCHAR* Operation, const FString& UniqueId, const FString& Reason = FString());
+
+	/*Kicks the connected players with these ids.*/
+	void KickBannedPlayers(const TArray<FString>& UniqueIds);
+
+	static bool KickPlayer(APlayerController* Player, const FText& Reason);
+};
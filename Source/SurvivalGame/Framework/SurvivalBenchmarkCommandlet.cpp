@@ -0,0 +1,246 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "SurvivalBenchmarkCommandlet.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+
+USurvivalBenchmarkCommandlet::USurvivalBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = true;
+	IsEditor = false;
+	LogToConsole = true;
+
+	BenchmarkWorld = nullptr;
+	Repeats = 5;
+}
+
+int32 USurvivalBenchmarkCommandlet::Main(const FString& Params)
+{
+	FString BaselinesFile = FPaths::Combine(FPaths::ProjectConfigDir(), TEXT("Benchmarks"), TEXT("SurvivalBenchmarkBaselines.json"));
+	FParse::Value(*Params, TEXT("Baselines="), BaselinesFile);
+
+	FString OutputFile = FPaths::Combine(FPaths::ProfilingDir(), TEXT("SurvivalBenchmark"), TEXT("Results.json"));
+	FParse::Value(*Params, TEXT("Output="), OutputFile);
+
+	float Tolerance = 0.25f;
+	FParse::Value(*Params, TEXT("Tolerance="), Tolerance);
+
+	FParse::Value(*Params, TEXT("Repeats="), Repeats);
+	Repeats = FMath::Max(1, Repeats);
+
+	FString BenchmarksList;
+	TArray<FString> SelectedBenchmarks;
+
+	if (FParse::Value(*Params, TEXT("Benchmarks="), BenchmarksList, false))
+	{
+		BenchmarksList.ParseIntoArray(SelectedBenchmarks, TEXT(","));
+	}
+
+	const bool bUpdateBaselines = FParse::Param(*Params, TEXT("UpdateBaselines"));
+
+	//The baselines file is replaced as a whole, the benchmarks that didn't run would lose theirs.
+	if (bUpdateBaselines && SelectedBenchmarks.Num() > 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("-UpdateBaselines runs every benchmark, it can't be used with -Benchmarks=."));
+		return 1;
+	}
+
+	CreateBenchmarkWorld();
+
+	FSurvivalBenchmarkContext Context(BenchmarkWorld, Repeats);
+
+	for (const FSurvivalBenchmark* Benchmark : FSurvivalBenchmark::GetRegistered())
+	{
+		if (SelectedBenchmarks.Num() > 0 && !SelectedBenchmarks.Contains(Benchmark->GetName()))
+		{
+			continue;
+		}
+
+		UE_LOG(LogTemp, Display, TEXT("Running the %s benchmark."), Benchmark->GetName());
+
+		Benchmark->Run(Context);
+
+		//Whatever the benchmark destroyed is gone before the next one measures anything.
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	Results = Context.GetResults();
+
+	DestroyBenchmarkWorld();
+
+	if (Results.Num() == 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("No benchmark ran. Check the names in -Benchmarks=."));
+		return 1;
+	}
+
+	if (bUpdateBaselines)
+	{
+		WriteBaselines(BaselinesFile);
+		WriteResults(OutputFile, true);
+		return 0;
+	}
+
+	const bool bPassed = CompareWithBaselines(BaselinesFile, Tolerance);
+	WriteResults(OutputFile, bPassed);
+
+	return bPassed ? 0 : 1;
+}
+
+void USurvivalBenchmarkCommandlet::CreateBenchmarkWorld()
+{
+	BenchmarkWorld = UWorld::CreateWorld(EWorldType::Game, false, TEXT("SurvivalBenchmark"));
+
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(BenchmarkWorld);
+
+	BenchmarkWorld->InitializeActorsForPlay(FURL());
+}
+
+void USurvivalBenchmarkCommandlet::DestroyBenchmarkWorld()
+{
+	if (BenchmarkWorld)
+	{
+		GEngine->DestroyWorldContext(BenchmarkWorld);
+		BenchmarkWorld->DestroyWorld(false);
+		BenchmarkWorld = nullptr;
+
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+}
+
+#pragma region Baselines
+
+bool USurvivalBenchmarkCommandlet::CompareWithBaselines(const FString& BaselinesFile, const float Tolerance)
+{
+	FString BaselinesText;
+
+	if (!FFileHelper::LoadFileToString(BaselinesText, *BaselinesFile))
+	{
+		//Passing without anything to compare with would hide every regression.
+		UE_LOG(LogTemp, Error, TEXT("No baselines in %s. Run with -UpdateBaselines on the build machine and commit them."), *BaselinesFile);
+		return false;
+	}
+
+	TSharedPtr<FJsonObject> BaselinesObject;
+	TSharedRef<TJsonReader<>> JsonReader = TJsonReaderFactory<>::Create(BaselinesText);
+
+	if (!FJsonSerializer::Deserialize(JsonReader, BaselinesObject) || !BaselinesObject.IsValid())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Couldn't read the baselines in %s."), *BaselinesFile);
+		return false;
+	}
+
+	const TSharedPtr<FJsonObject>* Metrics = nullptr;
+
+	if (!BaselinesObject->TryGetObjectField(TEXT("metrics"), Metrics))
+	{
+		UE_LOG(LogTemp, Error, TEXT("The baselines in %s don't have any metrics."), *BaselinesFile);
+		return false;
+	}
+
+	bool bPassed = true;
+
+	for (FSurvivalBenchmarkResult& Result : Results)
+	{
+		double Baseline = 0.0;
+
+		if (!(*Metrics)->TryGetNumberField(Result.Name, Baseline) || Baseline <= 0.0)
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s doesn't have a baseline. Run with -UpdateBaselines and commit them."), *Result.Name);
+			bPassed = false;
+			continue;
+		}
+
+		Result.Baseline = Baseline;
+		Result.bRegressed = Result.Value > Baseline * (1.0 + Tolerance);
+
+		if (Result.bRegressed)
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s regressed: %.3f %s, baseline %.3f %s."), *Result.Name, Result.Value, *Result.Unit, Baseline, *Result.Unit);
+			bPassed = false;
+		}
+	}
+
+	return bPassed;
+}
+
+void USurvivalBenchmarkCommandlet::WriteResults(const FString& OutputFile, const bool bPassed) const
+{
+	TArray<TSharedPtr<FJsonValue>> ResultValues;
+
+	for (const FSurvivalBenchmarkResult& Result : Results)
+	{
+		TSharedRef<FJsonObject> ResultObject = MakeShared<FJsonObject>();
+		ResultObject->SetStringField(TEXT("name"), Result.Name);
+		ResultObject->SetStringField(TEXT("unit"), Result.Unit);
+		ResultObject->SetNumberField(TEXT("value"), Result.Value);
+		ResultObject->SetNumberField(TEXT("baseline"), Result.Baseline);
+		ResultObject->SetBoolField(TEXT("regressed"), Result.bRegressed);
+
+		ResultValues.Add(MakeShared<FJsonValueObject>(ResultObject));
+	}
+
+	TSharedRef<FJsonObject> ResultsObject = MakeShared<FJsonObject>();
+	ResultsObject->SetStringField(TEXT("timestamp"), FDateTime::UtcNow().ToIso8601());
+	ResultsObject->SetStringField(TEXT("platform"), FPlatformProperties::IniPlatformName());
+	ResultsObject->SetNumberField(TEXT("repeats"), Repeats);
+	ResultsObject->SetBoolField(TEXT("passed"), bPassed);
+	ResultsObject->SetArrayField(TEXT("results"), ResultValues);
+
+	FString ResultsText;
+	TSharedRef<TJsonWriter<>> JsonWriter = TJsonWriterFactory<>::Create(&ResultsText);
+	FJsonSerializer::Serialize(ResultsObject, JsonWriter);
+
+	if (FFileHelper::SaveStringToFile(ResultsText, *OutputFile))
+	{
+		UE_LOG(LogTemp, Display, TEXT("Benchmark results written to %s. %s"), *OutputFile, bPassed ? TEXT("Passed.") : TEXT("Regressions found."));
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("Couldn't write the benchmark results to %s."), *OutputFile);
+	}
+}
+
+void USurvivalBenchmarkCommandlet::WriteBaselines(const FString& BaselinesFile) const
+{
+	TSharedRef<FJsonObject> Metrics = MakeShared<FJsonObject>();
+
+	for (const FSurvivalBenchmarkResult& Result : Results)
+	{
+		Metrics->SetNumberField(Result.Name, Result.Value);
+	}
+
+	TSharedRef<FJsonObject> BaselinesObject = MakeShared<FJsonObject>();
+	BaselinesObject->SetStringField(TEXT("timestamp"), FDateTime::UtcNow().ToIso8601());
+	BaselinesObject->SetStringField(TEXT("platform"), FPlatformProperties::IniPlatformName());
+	BaselinesObject->SetObjectField(TEXT("metrics"), Metrics);
+
+	FString BaselinesText;
+	TSharedRef<TJsonWriter<>> JsonWriter = TJsonWriterFactory<>::Create(&BaselinesText);
+	FJsonSerializer::Serialize(BaselinesObject, JsonWriter);
+
+	if (FFileHelper::SaveStringToFile(BaselinesText, *BaselinesFile))
+	{
+		UE_LOG(LogTemp, Display, TEXT("Benchmark baselines written to %s."), *BaselinesFile);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("Couldn't write the benchmark baselines to %s."), *BaselinesFile);
+	}
+}
+
+#pragma endregion
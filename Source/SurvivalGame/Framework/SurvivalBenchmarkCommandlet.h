@@ -0,0 +1,60 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "Framework/Benchmarks/SurvivalBenchmark.h"
+#include "SurvivalBenchmarkCommandlet.generated.h"
+
+/*Measures the gameplay code the dedicated server runs the most, without a map, a net driver or a player.
+Every system has its own benchmark in Framework/Benchmarks (inventory and item registry, loot, interaction, hit validation,
+explosions, replication size, session settings, player saves, world snapshots and ground loot), this runs them all
+in one world and compares the results with the committed baselines.
+
+Runs headless, for example on a Linux build machine:
+UE4Editor-Cmd SurvivalGame.uproject -run=SurvivalBenchmark -nullrhi -unattended
+
+Parameters:
+-Baselines=<file>		Baselines to compare with. Config/Benchmarks/SurvivalBenchmarkBaselines.json by default.
+-Tolerance=<0.25>		How much worse than the baseline a metric can be before it counts as a regression.
+-Output=<file>			Where to write the results. Saved/Profiling/SurvivalBenchmark/Results.json by default.
+-Benchmarks=<A,B>		Only runs these benchmarks, by name. All of them by default.
+-UpdateBaselines		Writes the results of this run as the new baselines.
+
+Returns 1 if any metric regressed, or if there is no baseline to compare it with, so the build machine can fail the run.*/
+UCLASS()
+class SURVIVALGAME_API USurvivalBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	USurvivalBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+protected:
+
+	/*Where all the benchmark actors are spawned. Created with no map and destroyed at the end of the run.*/
+	UPROPERTY()
+	class UWorld* BenchmarkWorld;
+
+	/*Times every measure runs, -Repeats= on the command line.*/
+	int32 Repeats;
+
+	TArray<FSurvivalBenchmarkResult> Results;
+
+	void CreateBenchmarkWorld();
+	void DestroyBenchmarkWorld();
+
+	/*Compares every result with its baseline. Returns true if nothing regressed and every result has a baseline.*/
+	bool CompareWithBaselines(const FString& BaselinesFile, const float Tolerance);
+
+	void WriteResults(const FString& OutputFile, const bool bPassed) const;
+	void WriteBaselines(const FString& BaselinesFile) const;
+};
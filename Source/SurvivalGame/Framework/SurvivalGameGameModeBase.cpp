@@ -6,4 +6,195 @@
 
 
 #include "SurvivalGameGameModeBase.h"
+#include "Components/SessionHeartbeatComponent.h"
+#include "SurvivalBanListSubsystem.h"
+#include "SurvivalPlayerSaveSubsystem.h"
+#include "SurvivalVoiceInterestSubsystem.h"
 
+#include "GameFramework/PlayerState.h"
+#include "Kismet/GameplayStatics.h"
+
+ASurvivalGameGameModeBase::ASurvivalGameGameModeBase()
+{
+	SessionHeartbeat = CreateDefaultSubobject<USessionHeartbeatComponent>("SessionHeartbeat");
+
+	BotControllerClass = ASurvivalBotController::StaticClass();
+	NumStartingBots = 0;
+}
+
+void ASurvivalGameGameModeBase::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+	Super::InitGame(MapName, Options, ErrorMessage);
+
+	//The URL wins over the command line, and the command line over the defaults.
+	FParse::Value(FCommandLine::Get(), TEXT("Bots="), NumStartingBots);
+	NumStartingBots = UGameplayStatics::GetIntOption(Options, TEXT("Bots"), NumStartingBots);
+
+	FString BotMix;
+	FParse::Value(FCommandLine::Get(), TEXT("BotMix="), BotMix);
+
+	if (UGameplayStatics::HasOption(Options, TEXT("BotMix")))
+	{
+		BotMix = UGameplayStatics::ParseOption(Options, TEXT("BotMix"));
+	}
+
+	if (!BotMix.IsEmpty())
+	{
+		ParseBotMix(BotMix);
+	}
+}
+
+void ASurvivalGameGameModeBase::StartPlay()
+{
+	Super::StartPlay();
+
+	if (NumStartingBots > 0)
+	{
+		SpawnBots(NumStartingBots);
+	}
+}
+
+void ASurvivalGameGameModeBase::PreLogin(const FString& Options, const FString& Address, const FUniqueNetIdRepl& UniqueId, FString& ErrorMessage)
+{
+	Super::PreLogin(Options, Address, UniqueId, ErrorMessage);
+
+	if (!ErrorMessage.IsEmpty())
+	{
+		return;
+	}
+
+	USurvivalBanListSubsystem* BanList = GetGameInstance() ? GetGameInstance()->GetSubsystem<USurvivalBanListSubsystem>() : nullptr;
+
+	if (BanList && BanList->IsBlocked(UniqueId, ErrorMessage))
+	{
+		UE_LOG(LogGameMode, Log, TEXT("Refused %s: %s"), *UniqueId.ToString(), *ErrorMessage);
+	}
+}
+
+void ASurvivalGameGameModeBase::PostLogin(APlayerController* NewPlayer)
+{
+	//Before Super, which spawns the character. The save is read while the player loads in, and applied in Restart.
+	USurvivalPlayerSaveSubsystem* PlayerSaves = GetGameInstance() ? GetGameInstance()->GetSubsystem<USurvivalPlayerSaveSubsystem>() : nullptr;
+
+	if (PlayerSaves && NewPlayer && NewPlayer->PlayerState)
+	{
+		PlayerSaves->PrefetchPlayer(NewPlayer->PlayerState->GetUniqueId());
+	}
+
+	Super::PostLogin(NewPlayer);
+}
+
+void ASurvivalGameGameModeBase::Logout(AController* Exiting)
+{
+	Super::Logout(Exiting);
+
+	//The character was saved in ASurvivalPlayerController::PawnLeavingGame, the controller destroys it before we get here.
+	USurvivalPlayerSaveSubsystem* PlayerSaves = GetGameInstance() ? GetGameInstance()->GetSubsystem<USurvivalPlayerSaveSubsystem>() : nullptr;
+
+	if (PlayerSaves && Exiting && Exiting->PlayerState)
+	{
+		PlayerSaves->ForgetPlayer(Exiting->PlayerState->GetUniqueId());
+	}
+
+	if (USurvivalVoiceInterestSubsystem* VoiceInterest = GetWorld()->GetSubsystem<USurvivalVoiceInterestSubsystem>())
+	{
+		VoiceInterest->OnPlayerLogout(Exiting);
+	}
+}
+
+void ASurvivalGameGameModeBase::SpawnBots(const int32 NumBots)
+{
+	if (!BotControllerClass)
+	{
+		return;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	for (int32 i = 0; i < NumBots; ++i)
+	{
+		if (ASurvivalBotController* Bot = GetWorld()->SpawnActor<ASurvivalBotController>(BotControllerClass, SpawnParams))
+		{
+			Bot->SetBehavior(PickBotBehavior());
+
+			if (APlayerState* BotPlayerState = Bot->GetPlayerState<APlayerState>())
+			{
+				BotPlayerState->SetPlayerName(FString::Printf(TEXT("Bot %d"), Bots.Num() + 1));
+			}
+
+			Bots.Add(Bot);
+			RestartPlayer(Bot);
+		}
+	}
+
+	UE_LOG(LogGameMode, Log, TEXT("Spawned %d bots, %d in total."), NumBots, Bots.Num());
+}
+
+void ASurvivalGameGameModeBase::ParseBotMix(const FString& BotMix)
+{
+	const UEnum* BehaviorEnum = StaticEnum<EBotBehavior>();
+
+	BotBehaviorWeights.Empty();
+
+	TArray<FString> Entries;
+	BotMix.ParseIntoArray(Entries, TEXT(","));
+
+	for (const FString& Entry : Entries)
+	{
+		FString BehaviorName;
+		FString WeightString;
+
+		if (!Entry.Split(TEXT(":"), &BehaviorName, &WeightString))
+		{
+			BehaviorName = Entry;
+			WeightString = TEXT("1");
+		}
+
+		//Works with "Fighter" or "BB_Fighter".
+		int64 BehaviorValue = BehaviorEnum->GetValueByNameString(BehaviorName.TrimStartAndEnd());
+
+		if (BehaviorValue == INDEX_NONE)
+		{
+			BehaviorValue = BehaviorEnum->GetValueByNameString(TEXT("BB_") + BehaviorName.TrimStartAndEnd());
+		}
+
+		if (BehaviorValue == INDEX_NONE || BehaviorValue >= (int64)EBotBehavior::BB_MAX)
+		{
+			UE_LOG(LogGameMode, Warning, TEXT("Unknown bot behavior %s in the bot mix."), *BehaviorName);
+			continue;
+		}
+
+		BotBehaviorWeights.Add((EBotBehavior)BehaviorValue, FMath::Max(0.f, FCString::Atof(*WeightString)));
+	}
+}
+
+EBotBehavior ASurvivalGameGameModeBase::PickBotBehavior() const
+{
+	float TotalWeight = 0.f;
+
+	for (const auto& BehaviorWeight : BotBehaviorWeights)
+	{
+		TotalWeight += BehaviorWeight.Value;
+	}
+
+	//No mix, every behavior is equally likely.
+	if (TotalWeight <= 0.f)
+	{
+		return (EBotBehavior)FMath::RandRange(0, (int32)EBotBehavior::BB_MAX - 1);
+	}
+
+	float Pick = FMath::FRandRange(0.f, TotalWeight);
+
+	for (const auto& BehaviorWeight : BotBehaviorWeights)
+	{
+		Pick -= BehaviorWeight.Value;
+
+		if (Pick <= 0.f)
+		{
+			return BehaviorWeight.Key;
+		}
+	}
+
+	return EBotBehavior::BB_Wanderer;
+}
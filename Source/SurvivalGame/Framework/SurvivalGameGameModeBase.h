@@ -8,12 +8,57 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/GameModeBase.h"
+#include "Player/SurvivalBotController.h"
 #include "SurvivalGameGameModeBase.generated.h"
 
-
+/*The game mode can fill the server with bots for load testing. They are set in the travel URL or in the server command line:
+SurvivalGameServer MapName?Bots=100?BotMix=Fighter:2,Looter:1,Wanderer:1,Grenadier:1
+The mix is a list of behaviors with their weights. Without it, every behavior is equally likely.*/
 UCLASS()
 class SURVIVALGAME_API ASurvivalGameGameModeBase : public AGameModeBase
 {
 	GENERATED_BODY()
-	
+
+public:
+
+	ASurvivalGameGameModeBase();
+
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+	virtual void StartPlay() override;
+
+	/*Players in the ban list, or not in the allow list when it's required, are refused here.*/
+	virtual void PreLogin(const FString& Options, const FString& Address, const FUniqueNetIdRepl& UniqueId, FString& ErrorMessage) override;
+
+	/*Starts reading the player save, see USurvivalPlayerSaveSubsystem.*/
+	virtual void PostLogin(APlayerController* NewPlayer) override;
+	virtual void Logout(AController* Exiting) override;
+
+	/*Spawns this amount of bots. Their behavior is chosen from the bot mix.*/
+	UFUNCTION(BlueprintCallable, Category = "Bots")
+	void SpawnBots(const int32 NumBots);
+
+protected:
+
+	/*Publishes the player count, the map and the custom session keys to the server list.*/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Session")
+	class USessionHeartbeatComponent* SessionHeartbeat;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Bots")
+	TSubclassOf<ASurvivalBotController> BotControllerClass;
+
+	/*Bots spawned when the game starts. Overridden by the Bots option.*/
+	UPROPERTY(EditDefaultsOnly, Category = "Bots")
+	int32 NumStartingBots;
+
+	/*How likely each behavior is. Overridden by the BotMix option.*/
+	UPROPERTY(EditDefaultsOnly, Category = "Bots")
+	TMap<EBotBehavior, float> BotBehaviorWeights;
+
+	UPROPERTY(Transient)
+	TArray<ASurvivalBotController*> Bots;
+
+	/*Reads a mix like "Fighter:2,Looter:1" into the behavior weights.*/
+	void ParseBotMix(const FString& BotMix);
+
+	EBotBehavior PickBotBehavior() const;
 };
@@ -0,0 +1,197 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "SurvivalGroundLootSubsystem.h"
+#include "SurvivalGame.h"
+
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+#include "Components/InventoryComponent.h"
+#include "Items/Item.h"
+#include "Items/ItemDefinitionRegistry.h"
+#include "World/LootPile.h"
+#include "World/Pickup.h"
+
+static TAutoConsoleVariable<int32> CVarSurvivalGroundLoot(
+	TEXT("Survival.GroundLoot"),
+	1,
+	TEXT("Merges the items players drop close to each other into loot piles and stacks.\n")
+	TEXT("0: off, every drop is a pickup, 1: on"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSurvivalGroundLootMergeRadius(
+	TEXT("Survival.GroundLoot.MergeRadius"),
+	150.f,
+	TEXT("Distance within which dropped items are merged."),
+	ECVF_Default);
+
+bool USurvivalGroundLootSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld();
+}
+
+void USurvivalGroundLootSubsystem::Deinitialize()
+{
+	DroppedPickups.Empty();
+
+	Super::Deinitialize();
+}
+
+bool USurvivalGroundLootSubsystem::IsEnabled()
+{
+	return CVarSurvivalGroundLoot.GetValueOnGameThread() != 0;
+}
+
+void USurvivalGroundLootSubsystem::DropItem(AActor* Dropper, TSubclassOf<UItem> ItemClass, const int32 Quantity, const FTransform& Transform,
+	TSubclassOf<APickup> PickupClass, TSubclassOf<ALootPile> LootPileClass)
+{
+	SURVIVAL_SCOPE_CYCLE_COUNTER(GroundLootDrop);
+
+	if (!ItemClass || Quantity <= 0)
+	{
+		return;
+	}
+
+	int32 Remaining = Quantity;
+
+	DroppedPickups.RemoveAll([](const TWeakObjectPtr<APickup>& Pickup) { return !Pickup.IsValid() || Pickup->IsPendingKill(); });
+
+	if (IsEnabled())
+	{
+		const FVector Location = Transform.GetLocation();
+		const float RadiusSquared = FMath::Square(CVarSurvivalGroundLootMergeRadius.GetValueOnGameThread());
+
+		if (ALootPile* Pile = FindClosestLootPile(Location, RadiusSquared))
+		{
+			Remaining -= Pile->AddItem(ItemClass, Remaining);
+		}
+
+		TArray<APickup*> NearbyPickups;
+
+		for (const TWeakObjectPtr<APickup>& Pickup : DroppedPickups)
+		{
+			if (Pickup->GetItem() && FVector::DistSquared(Pickup->GetActorLocation(), Location) <= RadiusSquared)
+			{
+				NearbyPickups.Add(Pickup.Get());
+			}
+		}
+
+		const FItemDefinition Definition = FItemDefinitionRegistry::Get().GetDefinition(ItemClass);
+
+		//Stacks on what's already on the ground before anything new is spawned.
+		if (Definition.bStackable)
+		{
+			for (APickup* Pickup : NearbyPickups)
+			{
+				const UItem* Item = Pickup->GetItem();
+
+				if (Remaining > 0 && Item->GetClass() == ItemClass && Item->GetQuantity() < Definition.MaxStackSize)
+				{
+					const int32 Added = FMath::Min(Remaining, Definition.MaxStackSize - Item->GetQuantity());
+
+					Pickup->SetPickupQuantity(Item->GetQuantity() + Added);
+					Remaining -= Added;
+				}
+			}
+		}
+
+		//A second item dropped next to another one, from here on it's a pile.
+		if (Remaining > 0 && NearbyPickups.Num() > 0 && LootPileClass)
+		{
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.bNoFail = true;
+			SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+			if (ALootPile* Pile = GetWorld()->SpawnActor<ALootPile>(LootPileClass, Transform, SpawnParams))
+			{
+				for (APickup* Pickup : NearbyPickups)
+				{
+					MovePickupToPile(Pickup, Pile);
+				}
+
+				Remaining -= Pile->AddItem(ItemClass, Remaining);
+			}
+		}
+	}
+
+	if (Remaining > 0)
+	{
+		SpawnPickup(Dropper, ItemClass, Remaining, Transform, PickupClass);
+	}
+}
+
+ALootPile* USurvivalGroundLootSubsystem::FindClosestLootPile(const FVector& Location, const float RadiusSquared) const
+{
+	ALootPile* ClosestPile = nullptr;
+	float ClosestDistanceSquared = RadiusSquared;
+
+	//Piles restored from a world snapshot count too, so they are found in the world rather than kept in a list.
+	for (TActorIterator<ALootPile> It(GetWorld()); It; ++It)
+	{
+		ALootPile* Pile = *It;
+		const float DistanceSquared = FVector::DistSquared(Pile->GetActorLocation(), Location);
+
+		if (!Pile->IsPendingKill() && DistanceSquared <= ClosestDistanceSquared)
+		{
+			ClosestPile = Pile;
+			ClosestDistanceSquared = DistanceSquared;
+		}
+	}
+
+	return ClosestPile;
+}
+
+void USurvivalGroundLootSubsystem::MovePickupToPile(APickup* Pickup, ALootPile* Pile)
+{
+	const UItem* Item = Pickup->GetItem();
+
+	if (!Item)
+	{
+		return;
+	}
+
+	const int32 Quantity = Item->GetQuantity();
+	const int32 Added = Pile->AddItem(Item->GetClass(), Quantity);
+
+	if (Added >= Quantity)
+	{
+		Pickup->Destroy();
+	}
+	else if (Added > 0)
+	{
+		Pickup->SetPickupQuantity(Quantity - Added);
+	}
+}
+
+APickup* USurvivalGroundLootSubsystem::SpawnPickup(AActor* Dropper, TSubclassOf<UItem> ItemClass, const int32 Quantity, const FTransform& Transform,
+	TSubclassOf<APickup> PickupClass)
+{
+	if (!ensure(PickupClass))
+	{
+		return nullptr;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Owner = Dropper;
+	SpawnParams.bNoFail = true; //Always spawn the item.
+
+	//If we somehow drop an item inside of a wall, Unreal is gonna try to correct that item so is not inside of the wall.
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	APickup* Pickup = GetWorld()->SpawnActor<APickup>(PickupClass, Transform, SpawnParams);
+
+	if (Pickup)
+	{
+		Pickup->InitializePickup(ItemClass, Quantity); //Give the pickup the item to represent and the amount.
+		DroppedPickups.Add(Pickup);
+	}
+
+	return Pickup;
+}
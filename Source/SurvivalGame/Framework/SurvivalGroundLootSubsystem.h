@@ -0,0 +1,55 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Templates/SubclassOf.h"
+#include "SurvivalGroundLootSubsystem.generated.h"
+
+/*Keeps the items players drop from becoming an actor each. Every pickup is replicated to every client in range and drawn
+with its own mesh and interaction widget, so a player that dumps a full inventory used to cost 20 actors.
+
+A dropped item, within Survival.GroundLoot.MergeRadius of the drop:
+ - goes in the closest loot pile,
+ - or stacks on a dropped pickup of the same class, if it's stackable and the stack has room,
+ - or if there are other dropped pickups, they all go in a new loot pile with it.
+What doesn't fit is spawned as a pickup like before.
+
+Only pickups dropped through here are merged. Placed pickups and the ones of item spawns stay where they are, an item
+spawn only respawns its pickups once they are taken.
+
+Survival.GroundLoot 0 turns it off, every drop is a pickup again.*/
+UCLASS()
+class SURVIVALGAME_API USurvivalGroundLootSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	/*[Server] Drops the items at the transform, merged with the ground loot around it when it can be.*/
+	void DropItem(AActor* Dropper, TSubclassOf<class UItem> ItemClass, const int32 Quantity, const FTransform& Transform,
+		TSubclassOf<class APickup> PickupClass, TSubclassOf<class ALootPile> LootPileClass);
+
+	static bool IsEnabled();
+
+protected:
+
+	/*Pickups dropped through DropItem that are still on the ground.*/
+	TArray<TWeakObjectPtr<class APickup>> DroppedPickups;
+
+	class ALootPile* FindClosestLootPile(const FVector& Location, const float RadiusSquared) const;
+
+	/*Moves the item of the pickup into the pile, and destroys the pickup if all of it fit.*/
+	static void MovePickupToPile(class APickup* Pickup, class ALootPile* Pile);
+
+	class APickup* SpawnPickup(AActor* Dropper, TSubclassOf<class UItem> ItemClass, const int32 Quantity, const FTransform& Transform,
+		TSubclassOf<class APickup> PickupClass);
+};
@@ -0,0 +1,98 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "SurvivalItemRegistryCommandlet.h"
+
+#include "AssetRegistryModule.h"
+#include "Engine/Blueprint.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectIterator.h"
+
+#include "Items/Item.h"
+#include "Items/ItemDefinitionRegistry.h"
+
+USurvivalItemRegistryCommandlet::USurvivalItemRegistryCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 USurvivalItemRegistryCommandlet::Main(const FString& Params)
+{
+	FString OutputFile = FItemDefinitionRegistry::GetDefaultFilename();
+	FParse::Value(*Params, TEXT("Output="), OutputFile);
+
+	return GenerateRegistry(OutputFile) ? 0 : 1;
+}
+
+bool USurvivalItemRegistryCommandlet::GenerateRegistry(const FString& OutputFile)
+{
+	TArray<UClass*> ItemClasses;
+	GatherItemClasses(ItemClasses);
+
+	TArray<uint8> Data;
+	FItemDefinitionRegistry::Generate(ItemClasses, Data);
+
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(OutputFile), true);
+
+	if (!FFileHelper::SaveArrayToFile(Data, *OutputFile))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Couldn't write the item definition registry %s."), *OutputFile);
+		return false;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Wrote %d item definitions to %s (%d bytes)."), ItemClasses.Num(), *OutputFile, Data.Num());
+	return true;
+}
+
+void USurvivalItemRegistryCommandlet::GatherItemClasses(TArray<UClass*>& OutItemClasses)
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	TArray<FAssetData> Blueprints;
+	AssetRegistry.GetAssetsByClass(UBlueprint::StaticClass()->GetFName(), Blueprints, true);
+
+	//Only the Blueprints with a native item parent are loaded, the tags tell us without loading the rest.
+	for (const FAssetData& Blueprint : Blueprints)
+	{
+		FString NativeParentClassPath;
+		FString GeneratedClassPath;
+
+		if (!Blueprint.GetTagValue(FBlueprintTags::NativeParentClassPath, NativeParentClassPath) || !Blueprint.GetTagValue(FBlueprintTags::GeneratedClassPath, GeneratedClassPath))
+		{
+			continue;
+		}
+
+		UClass* NativeParentClass = FindObject<UClass>(nullptr, *FPackageName::ExportTextPathToObjectPath(NativeParentClassPath));
+
+		if (NativeParentClass && NativeParentClass->IsChildOf(UItem::StaticClass()))
+		{
+			if (!LoadObject<UClass>(nullptr, *FPackageName::ExportTextPathToObjectPath(GeneratedClassPath)))
+			{
+				UE_LOG(LogTemp, Warning, TEXT("Couldn't load the item class %s."), *GeneratedClassPath);
+			}
+		}
+	}
+
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		UClass* Class = *It;
+
+		//Skeleton and reinstanced classes of the Blueprints aren't what the game spawns.
+		if (Class->IsChildOf(UItem::StaticClass()) && !Class->HasAnyClassFlags(CLASS_NewerVersionExists | CLASS_Deprecated)
+			&& !Class->GetName().StartsWith(TEXT("SKEL_")) && !Class->GetName().StartsWith(TEXT("REINST_")))
+		{
+			OutItemClasses.Add(Class);
+		}
+	}
+}
@@ -0,0 +1,38 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SurvivalItemRegistryCommandlet.generated.h"
+
+/*Generates the item definition registry (see FItemDefinitionRegistry) from every native and Blueprint UItem class.
+The cook runs it on its own when it starts (see FSurvivalGameModule), so every cooked build ships a table of its own content.
+To test the table in the editor with -ItemRegistry, run it by hand after changing the weight, stack or quantity defaults of an item:
+
+UE4Editor-Cmd SurvivalGame.uproject -run=SurvivalItemRegistry [-Output=<file>]
+
+Writes Content/ItemRegistry/ItemDefinitions.bin by default, which is staged as a loose file so the game can map it.*/
+UCLASS()
+class SURVIVALGAME_API USurvivalItemRegistryCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	USurvivalItemRegistryCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+	/*Gathers the item classes and writes their table to the file. False if it couldn't be written.*/
+	static bool GenerateRegistry(const FString& OutputFile);
+
+protected:
+
+	/*Loads the Blueprint item classes and returns them with the native ones.*/
+	static void GatherItemClasses(TArray<UClass*>& OutItemClasses);
+};
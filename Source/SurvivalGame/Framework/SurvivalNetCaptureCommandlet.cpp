@@ -0,0 +1,361 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "SurvivalNetCaptureCommandlet.h"
+
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/UnrealType.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+#include "SurvivalNetSize.h"
+
+USurvivalNetCaptureCommandlet::USurvivalNetCaptureCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+
+	FirstTime = -1.0;
+	LastTime = 0.0;
+}
+
+int32 USurvivalNetCaptureCommandlet::Main(const FString& Params)
+{
+	FString CaptureFile;
+
+	if (!FParse::Value(*Params, TEXT("Capture="), CaptureFile))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Usage: -run=SurvivalNetCapture -Capture=<file> [-Output=<file>] [-Top=20]"));
+		return 1;
+	}
+
+	FString OutputFile = FPaths::GetBaseFilename(CaptureFile, false) + TEXT("_Breakdown.csv");
+	FParse::Value(*Params, TEXT("Output="), OutputFile);
+
+	int32 Top = 20;
+	FParse::Value(*Params, TEXT("Top="), Top);
+
+	TArray<FString> Lines;
+
+	if (!FFileHelper::LoadFileToStringArray(Lines, *CaptureFile))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Couldn't read the capture %s."), *CaptureFile);
+		return 1;
+	}
+
+	int32 InvalidLines = 0;
+
+	for (const FString& Line : Lines)
+	{
+		if (Line.IsEmpty())
+		{
+			continue;
+		}
+
+		TSharedPtr<FJsonObject> Record;
+		TSharedRef<TJsonReader<>> JsonReader = TJsonReaderFactory<>::Create(Line);
+
+		//The last line can be cut if the server didn't close the capture.
+		if (!FJsonSerializer::Deserialize(JsonReader, Record) || !Record.IsValid())
+		{
+			InvalidLines++;
+			continue;
+		}
+
+		double Time = 0.0;
+
+		if (Record->TryGetNumberField(TEXT("t"), Time))
+		{
+			FirstTime = FirstTime < 0.0 ? Time : FirstTime;
+			LastTime = Time;
+		}
+
+		const FString Type = Record->GetStringField(TEXT("type"));
+
+		if (Type == TEXT("conn"))
+		{
+			const int32 ConnectionId = (int32)Record->GetNumberField(TEXT("conn"));
+
+			FString ConnectionName;
+			if (!Record->TryGetStringField(TEXT("player"), ConnectionName))
+			{
+				ConnectionName = Record->GetStringField(TEXT("address"));
+			}
+
+			ConnectionNames.Add(ConnectionId, FString::Printf(TEXT("%d %s"), ConnectionId, *ConnectionName));
+		}
+		else if (Type == TEXT("bw"))
+		{
+			//One sample every second, so the bytes per second are the bytes of that second.
+			const int32 ConnectionId = (int32)Record->GetNumberField(TEXT("conn"));
+			MeasuredBytes.FindOrAdd(GetConnectionName(ConnectionId)) += (int64)Record->GetNumberField(TEXT("outBytesPerSecond"));
+		}
+		else if (Type == TEXT("prop"))
+		{
+			ReplayProperty(Record);
+		}
+		else if (Type == TEXT("rpc"))
+		{
+			ReplayRPC(Record);
+		}
+	}
+
+	if (InvalidLines > 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Skipped %d lines of the capture that couldn't be read."), InvalidLines);
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Capture %s, %.1f seconds."), *CaptureFile, FMath::Max(0.0, LastTime - FirstTime));
+
+	LogTop(TEXT("Connection"), ConnectionTotals, Top);
+	LogTop(TEXT("Class"), ClassTotals, Top);
+	LogTop(TEXT("Property"), PropertyTotals, Top);
+	LogTop(TEXT("RPC"), RPCTotals, Top);
+
+	WriteBreakdown(OutputFile);
+
+	return 0;
+}
+
+#pragma region Replay
+
+void USurvivalNetCaptureCommandlet::ReplayProperty(const TSharedPtr<FJsonObject>& Record)
+{
+	const FString ClassPath = Record->GetStringField(TEXT("class"));
+	const FString PropertyName = Record->GetStringField(TEXT("prop"));
+	const int64 RecordedBits = (int64)Record->GetNumberField(TEXT("bits"));
+
+	int64 ReplayedBits = RecordedBits;
+
+	UClass* Class = FindClass(ClassPath);
+	FProperty* Property = Class ? FindFProperty<FProperty>(Class, *PropertyName) : nullptr;
+
+	FString ValueText;
+
+	if (Property && Record->TryGetStringField(TEXT("value"), ValueText))
+	{
+		ReplayedBits = ReplayValue(Property, ValueText, RecordedBits);
+	}
+
+	const FString ClassName = GetShortClassName(ClassPath);
+	AddToTotals(Record, ClassName, PropertyTotals, ClassName + TEXT(".") + PropertyName, RecordedBits, ReplayedBits);
+}
+
+void USurvivalNetCaptureCommandlet::ReplayRPC(const TSharedPtr<FJsonObject>& Record)
+{
+	const FString ClassPath = Record->GetStringField(TEXT("class"));
+	const FString FunctionName = Record->GetStringField(TEXT("function"));
+	const int64 RecordedBits = (int64)Record->GetNumberField(TEXT("bits"));
+
+	int64 ReplayedBits = RecordedBits;
+
+	UClass* Class = FindClass(ClassPath);
+	UFunction* Function = Class ? Class->FindFunctionByName(FName(*FunctionName)) : nullptr;
+
+	const TSharedPtr<FJsonObject>* ParametersObject = nullptr;
+
+	if (Function && Record->TryGetObjectField(TEXT("params"), ParametersObject))
+	{
+		const int32 ParametersSize = FMath::Max<int32>(1, Function->ParmsSize);
+
+		uint8* Parameters = static_cast<uint8*>(FMemory::Malloc(ParametersSize, Function->GetMinAlignment()));
+		FMemory::Memzero(Parameters, ParametersSize);
+		Function->InitializeStruct(Parameters);
+
+		bool bCanReplay = true;
+
+		for (TFieldIterator<FProperty> It(Function); It && It->HasAnyPropertyFlags(CPF_Parm); ++It)
+		{
+			if (It->HasAnyPropertyFlags(CPF_ReturnParm))
+			{
+				continue;
+			}
+
+			FString ValueText;
+
+			if (HasObjectReferences(*It) || !(*ParametersObject)->TryGetStringField(It->GetName(), ValueText) ||
+				!It->ImportText(*ValueText, It->ContainerPtrToValuePtr<void>(Parameters), PPF_None, nullptr))
+			{
+				bCanReplay = false;
+				break;
+			}
+		}
+
+		if (bCanReplay)
+		{
+			ReplayedBits = FSurvivalNetSize::GetParametersBits(Function, Parameters);
+		}
+
+		Function->DestroyStruct(Parameters);
+		FMemory::Free(Parameters);
+	}
+
+	const FString ClassName = GetShortClassName(ClassPath);
+	AddToTotals(Record, ClassName, RPCTotals, ClassName + TEXT(".") + FunctionName, RecordedBits, ReplayedBits);
+}
+
+int64 USurvivalNetCaptureCommandlet::ReplayValue(FProperty* Property, const FString& ValueText, const int64 RecordedBits)
+{
+	if (HasObjectReferences(Property))
+	{
+		return RecordedBits;
+	}
+
+	void* Value = FMemory::Malloc(Property->ElementSize, Property->GetMinAlignment());
+	Property->InitializeValue(Value);
+
+	int64 ReplayedBits = RecordedBits;
+
+	if (Property->ImportText(*ValueText, Value, PPF_None, nullptr))
+	{
+		ReplayedBits = FSurvivalNetSize::GetValueBits(Property, Value);
+	}
+
+	Property->DestroyValue(Value);
+	FMemory::Free(Value);
+
+	return ReplayedBits;
+}
+
+bool USurvivalNetCaptureCommandlet::HasObjectReferences(FProperty* Property)
+{
+	//The objects of the match don't exist here, importing them would give us null references and smaller sizes.
+	TArray<const FStructProperty*> EncounteredStructProperties;
+	return Property->ContainsObjectReference(EncounteredStructProperties);
+}
+
+UClass* USurvivalNetCaptureCommandlet::FindClass(const FString& ClassPath)
+{
+	if (UClass** FoundClass = LoadedClasses.Find(ClassPath))
+	{
+		return *FoundClass;
+	}
+
+	UClass* Class = LoadObject<UClass>(nullptr, *ClassPath, nullptr, LOAD_NoWarn | LOAD_Quiet);
+
+	if (!Class)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s doesn't exist in this build, its records keep their recorded size."), *ClassPath);
+	}
+
+	LoadedClasses.Add(ClassPath, Class);
+
+	return Class;
+}
+
+#pragma endregion
+
+#pragma region Totals
+
+void USurvivalNetCaptureCommandlet::AddToTotals(const TSharedPtr<FJsonObject>& Record, const FString& ClassName, TMap<FString, FNetCaptureTotal>& NameTotals, const FString& Name, const int64 RecordedBits, const int64 ReplayedBits)
+{
+	auto AddBits = [RecordedBits, ReplayedBits](FNetCaptureTotal& Total)
+	{
+		Total.Count++;
+		Total.RecordedBits += RecordedBits;
+		Total.ReplayedBits += ReplayedBits;
+	};
+
+	//Deltas and initial states cost the same, the record is sent once to every connection in both lists.
+	const TCHAR* ConnectionFields[] = { TEXT("conns"), TEXT("initial") };
+
+	for (const TCHAR* ConnectionField : ConnectionFields)
+	{
+		const TArray<TSharedPtr<FJsonValue>>* ConnectionIds = nullptr;
+
+		if (!Record->TryGetArrayField(ConnectionField, ConnectionIds))
+		{
+			continue;
+		}
+
+		for (const TSharedPtr<FJsonValue>& ConnectionId : *ConnectionIds)
+		{
+			AddBits(ConnectionTotals.FindOrAdd(GetConnectionName((int32)ConnectionId->AsNumber())));
+			AddBits(ClassTotals.FindOrAdd(ClassName));
+			AddBits(NameTotals.FindOrAdd(Name));
+		}
+	}
+}
+
+FString USurvivalNetCaptureCommandlet::GetConnectionName(const int32 ConnectionId) const
+{
+	const FString* ConnectionName = ConnectionNames.Find(ConnectionId);
+	return ConnectionName ? *ConnectionName : FString::FromInt(ConnectionId);
+}
+
+FString USurvivalNetCaptureCommandlet::GetShortClassName(const FString& ClassPath)
+{
+	FString PackagePath;
+	FString ClassName;
+
+	return ClassPath.Split(TEXT("."), &PackagePath, &ClassName, ESearchCase::CaseSensitive, ESearchDir::FromEnd) ? ClassName : ClassPath;
+}
+
+void USurvivalNetCaptureCommandlet::WriteBreakdown(const FString& OutputFile) const
+{
+	const double Duration = FMath::Max(1.0, LastTime - FirstTime);
+
+	FString Csv = TEXT("Category,Name,Count,RecordedBytes,ReplayedBytes,ReplayedBytesPerSecond,Change\n");
+
+	auto AddRows = [&Csv, Duration](const TCHAR* Category, const TMap<FString, FNetCaptureTotal>& Totals)
+	{
+		for (const auto& Total : Totals)
+		{
+			const double RecordedBytes = Total.Value.RecordedBits / 8.0;
+			const double ReplayedBytes = Total.Value.ReplayedBits / 8.0;
+			const double Change = RecordedBytes > 0.0 ? (ReplayedBytes - RecordedBytes) / RecordedBytes * 100.0 : 0.0;
+
+			Csv += FString::Printf(TEXT("%s,\"%s\",%lld,%.1f,%.1f,%.2f,%.1f%%\n"), Category, *Total.Key, Total.Value.Count, RecordedBytes, ReplayedBytes, ReplayedBytes / Duration, Change);
+		}
+	};
+
+	AddRows(TEXT("Connection"), ConnectionTotals);
+	AddRows(TEXT("Class"), ClassTotals);
+	AddRows(TEXT("Property"), PropertyTotals);
+	AddRows(TEXT("RPC"), RPCTotals);
+
+	//What the engine really sent, headers and acks included. The estimates above should be a good part of it.
+	for (const auto& Measured : MeasuredBytes)
+	{
+		Csv += FString::Printf(TEXT("Measured,\"%s\",0,%lld,%lld,%.2f,0.0%%\n"), *Measured.Key, Measured.Value, Measured.Value, Measured.Value / Duration);
+	}
+
+	if (FFileHelper::SaveStringToFile(Csv, *OutputFile))
+	{
+		UE_LOG(LogTemp, Display, TEXT("Bandwidth breakdown written to %s"), *OutputFile);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("Couldn't write the bandwidth breakdown to %s."), *OutputFile);
+	}
+}
+
+void USurvivalNetCaptureCommandlet::LogTop(const TCHAR* Category, const TMap<FString, FNetCaptureTotal>& Totals, const int32 Top) const
+{
+	TArray<TPair<FString, FNetCaptureTotal>> SortedTotals = Totals.Array();
+
+	SortedTotals.Sort([](const TPair<FString, FNetCaptureTotal>& A, const TPair<FString, FNetCaptureTotal>& B)
+	{
+		return A.Value.ReplayedBits > B.Value.ReplayedBits;
+	});
+
+	UE_LOG(LogTemp, Display, TEXT("Top %s by bytes:"), Category);
+
+	for (int32 i = 0; i < FMath::Min(Top, SortedTotals.Num()); ++i)
+	{
+		const FNetCaptureTotal& Total = SortedTotals[i].Value;
+
+		UE_LOG(LogTemp, Display, TEXT("  %-60s %8lld sends %12.1f KB recorded %12.1f KB replayed"),
+			*SortedTotals[i].Key, Total.Count, Total.RecordedBits / 8192.0, Total.ReplayedBits / 8192.0);
+	}
+}
+
+#pragma endregion
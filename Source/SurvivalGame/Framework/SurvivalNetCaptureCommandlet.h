@@ -0,0 +1,84 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SurvivalNetCaptureCommandlet.generated.h"
+
+/*Bytes we attribute to one connection, class, property or RPC.*/
+struct FNetCaptureTotal
+{
+	int64 Count = 0;
+
+	/*What the recorder measured during the match.*/
+	int64 RecordedBits = 0;
+
+	/*The recorded values serialized again with the code of this build.*/
+	int64 ReplayedBits = 0;
+};
+
+/*Replays a capture of USurvivalNetRecorderSubsystem and breaks the bandwidth down by connection, actor class, property and RPC.
+
+Every recorded value is serialized again with the code of this build, so after changing how something replicates
+(quantizing a vector, packing a struct) we can see the difference without playing a new match.
+Values that reference objects can't be rebuilt outside the match, they keep their recorded size.
+
+UE4Editor-Cmd SurvivalGame.uproject -run=SurvivalNetCapture -Capture=<file> [-Output=<file>] [-Top=20]
+
+Writes a CSV next to the capture (or to -Output) and logs the biggest properties and RPCs.*/
+UCLASS()
+class SURVIVALGAME_API USurvivalNetCaptureCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	USurvivalNetCaptureCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+protected:
+
+	TMap<FString, FNetCaptureTotal> ConnectionTotals;
+	TMap<FString, FNetCaptureTotal> ClassTotals;
+	TMap<FString, FNetCaptureTotal> PropertyTotals;
+	TMap<FString, FNetCaptureTotal> RPCTotals;
+
+	/*Bytes the engine measured for every connection, from the bandwidth samples of the capture.*/
+	TMap<FString, int64> MeasuredBytes;
+
+	/*Names of the connections in the capture, by id.*/
+	TMap<int32, FString> ConnectionNames;
+
+	TMap<FString, UClass*> LoadedClasses;
+
+	double FirstTime;
+	double LastTime;
+
+	void ReplayProperty(const TSharedPtr<class FJsonObject>& Record);
+	void ReplayRPC(const TSharedPtr<class FJsonObject>& Record);
+
+	/*Adds the bits of a record once for every connection it went to.*/
+	void AddToTotals(const TSharedPtr<class FJsonObject>& Record, const FString& ClassName, TMap<FString, FNetCaptureTotal>& NameTotals, const FString& Name, const int64 RecordedBits, const int64 ReplayedBits);
+
+	UClass* FindClass(const FString& ClassPath);
+
+	FString GetConnectionName(const int32 ConnectionId) const;
+
+	/*BP_Character_C out of /Game/Blueprints/BP_Character.BP_Character_C*/
+	static FString GetShortClassName(const FString& ClassPath);
+
+	/*Serializes the recorded value again. Returns the recorded bits if it can't.*/
+	static int64 ReplayValue(FProperty* Property, const FString& ValueText, const int64 RecordedBits);
+
+	/*True if we can't rebuild the value from text outside the match.*/
+	static bool HasObjectReferences(FProperty* Property);
+
+	void WriteBreakdown(const FString& OutputFile) const;
+	void LogTop(const TCHAR* Category, const TMap<FString, FNetCaptureTotal>& Totals, const int32 Top) const;
+};
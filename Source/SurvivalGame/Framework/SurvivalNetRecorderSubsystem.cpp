@@ -0,0 +1,653 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "SurvivalNetRecorderSubsystem.h"
+
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetworkObjectList.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+
+#include "SurvivalNetSize.h"
+
+static TAutoConsoleVariable<int32> CVarSurvivalNetRecord(
+	TEXT("Survival.NetRecord"),
+	0,
+	TEXT("Records what we send through the network to Saved/Profiling/SurvivalNetCapture.\n")
+	TEXT("0: off, 1: on"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarSurvivalNetRecordValues(
+	TEXT("Survival.NetRecord.Values"),
+	1,
+	TEXT("Saves the value of every recorded property and RPC parameter, so the capture can be replayed with new code.\n")
+	TEXT("0: only sizes, much smaller captures. 1: sizes and values."),
+	ECVF_Default);
+
+USurvivalNetRecorderSubsystem::USurvivalNetRecorderSubsystem()
+{
+	CaptureWriter = nullptr;
+	PackageMap = nullptr;
+	BandwidthSampleTime = 0.f;
+}
+
+bool USurvivalNetRecorderSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld();
+}
+
+void USurvivalNetRecorderSubsystem::Deinitialize()
+{
+	StopRecording();
+
+	Super::Deinitialize();
+}
+
+bool USurvivalNetRecorderSubsystem::IsRecordingEnabled()
+{
+	static const bool bEnabledFromCommandLine = FParse::Param(FCommandLine::Get(), TEXT("SurvivalNetRecord"));
+	return bEnabledFromCommandLine || CVarSurvivalNetRecord.GetValueOnGameThread() != 0;
+}
+
+bool USurvivalNetRecorderSubsystem::IsTickable() const
+{
+	//Keep ticking while a capture is open, so turning it off closes the file.
+	return (IsRecordingEnabled() || CaptureWriter) && !HasAnyFlags(RF_ClassDefaultObject);
+}
+
+TStatId USurvivalNetRecorderSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USurvivalNetRecorderSubsystem, STATGROUP_Tickables);
+}
+
+void USurvivalNetRecorderSubsystem::Tick(float DeltaTime)
+{
+	UNetDriver* NetDriver = GetWorld() ? GetWorld()->GetNetDriver() : nullptr;
+
+	if (!IsRecordingEnabled() || !NetDriver)
+	{
+		StopRecording();
+		return;
+	}
+
+	if (!CaptureWriter || RecordedNetDriver.Get() != NetDriver)
+	{
+		StopRecording();
+		StartRecording(NetDriver);
+	}
+
+	//Undilated, the engine measures the bandwidth in real time too.
+	BandwidthSampleTime += FApp::GetDeltaTime();
+
+	if (BandwidthSampleTime >= 1.f)
+	{
+		RecordBandwidth(NetDriver);
+		BandwidthSampleTime = 0.f;
+	}
+
+	FlushLines();
+}
+
+#pragma region Capture File
+
+void USurvivalNetRecorderSubsystem::StartRecording(UNetDriver* NetDriver)
+{
+	const FString Directory = FPaths::Combine(FPaths::ProfilingDir(), TEXT("SurvivalNetCapture"));
+	IFileManager::Get().MakeDirectory(*Directory, true);
+
+	const FString MapName = GetWorld()->GetMapName();
+	const TCHAR* Side = NetDriver->IsServer() ? TEXT("Server") : TEXT("Client");
+	const FString FilePath = FPaths::Combine(Directory, FString::Printf(TEXT("%s_%s_%s.jsonl"), *MapName, *FDateTime::Now().ToString(), Side));
+
+	CaptureWriter = IFileManager::Get().CreateFileWriter(*FilePath, FILEWRITE_AllowRead);
+
+	if (!CaptureWriter)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Couldn't create the network capture %s."), *FilePath);
+		return;
+	}
+
+	RecordedNetDriver = NetDriver;
+
+	PackageMap = FSurvivalNetSize::NewPackageMap();
+	ValueWriter = MakeUnique<FNetBitWriter>(PackageMap, 1024);
+
+	//The delegate only takes one listener, we chain to the one that was there.
+	PreviousSendRPCDel = NetDriver->SendRPCDel;
+	NetDriver->SendRPCDel.BindUObject(this, &USurvivalNetRecorderSubsystem::OnSendRPC);
+
+	if (NetDriver->IsServer())
+	{
+		PostTickFlushHandle = GetWorld()->OnPostTickFlush().AddUObject(this, &USurvivalNetRecorderSubsystem::OnPostTickFlush);
+	}
+
+	TSharedRef<FJsonObject> Header = MakeShared<FJsonObject>();
+	Header->SetStringField(TEXT("type"), TEXT("header"));
+	Header->SetNumberField(TEXT("version"), 2);
+	Header->SetStringField(TEXT("timestamp"), FDateTime::UtcNow().ToIso8601());
+	Header->SetStringField(TEXT("map"), MapName);
+	Header->SetStringField(TEXT("side"), Side);
+	WriteLine(Header);
+
+	UE_LOG(LogTemp, Log, TEXT("Recording network capture to %s"), *FilePath);
+}
+
+void USurvivalNetRecorderSubsystem::StopRecording()
+{
+	if (UNetDriver* NetDriver = RecordedNetDriver.Get())
+	{
+		if (NetDriver->SendRPCDel.IsBoundToObject(this))
+		{
+			NetDriver->SendRPCDel = PreviousSendRPCDel;
+		}
+	}
+
+	if (PostTickFlushHandle.IsValid())
+	{
+		if (UWorld* World = GetWorld())
+		{
+			World->OnPostTickFlush().Remove(PostTickFlushHandle);
+		}
+
+		PostTickFlushHandle.Reset();
+	}
+
+	PreviousSendRPCDel.Unbind();
+
+	if (CaptureWriter)
+	{
+		FlushLines();
+
+		CaptureWriter->Close();
+		delete CaptureWriter;
+		CaptureWriter = nullptr;
+	}
+
+	RecordedNetDriver.Reset();
+	PendingLines.Reset();
+	ConnectionIds.Reset();
+	OpenChannels.Reset();
+	ObjectStates.Reset();
+	RecordedClasses.Reset();
+
+	ValueWriter.Reset();
+	PackageMap = nullptr;
+}
+
+void USurvivalNetRecorderSubsystem::WriteLine(const TSharedRef<FJsonObject>& Record)
+{
+	FString Line;
+	TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> JsonWriter = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Line);
+	FJsonSerializer::Serialize(Record, JsonWriter);
+
+	PendingLines += Line;
+	PendingLines += TEXT("\n");
+}
+
+void USurvivalNetRecorderSubsystem::FlushLines()
+{
+	if (CaptureWriter && PendingLines.Len() > 0)
+	{
+		FTCHARToUTF8 UTF8Lines(*PendingLines);
+		CaptureWriter->Serialize(const_cast<ANSICHAR*>(UTF8Lines.Get()), UTF8Lines.Length());
+	}
+
+	PendingLines.Reset();
+}
+
+#pragma endregion
+
+#pragma region Connections
+
+int32 USurvivalNetRecorderSubsystem::FindOrAddConnectionId(UNetConnection* Connection)
+{
+	if (const int32* ConnectionId = ConnectionIds.Find(Connection))
+	{
+		return *ConnectionId;
+	}
+
+	const int32 NewConnectionId = ConnectionIds.Num() + 1;
+	ConnectionIds.Add(Connection, NewConnectionId);
+
+	TSharedRef<FJsonObject> Record = MakeShared<FJsonObject>();
+	Record->SetStringField(TEXT("type"), TEXT("conn"));
+	Record->SetNumberField(TEXT("t"), GetWorld()->GetRealTimeSeconds());
+	Record->SetNumberField(TEXT("conn"), NewConnectionId);
+	Record->SetStringField(TEXT("address"), Connection->LowLevelGetRemoteAddress(true));
+
+	if (Connection->PlayerController && Connection->PlayerController->PlayerState)
+	{
+		Record->SetStringField(TEXT("player"), Connection->PlayerController->PlayerState->GetPlayerName());
+	}
+
+	WriteLine(Record);
+
+	return NewConnectionId;
+}
+
+TArray<TSharedPtr<FJsonValue>> USurvivalNetRecorderSubsystem::GetConnectionIds(const TArray<UNetConnection*>& Connections)
+{
+	TArray<TSharedPtr<FJsonValue>> Ids;
+
+	for (UNetConnection* Connection : Connections)
+	{
+		Ids.Add(MakeShared<FJsonValueNumber>(FindOrAddConnectionId(Connection)));
+	}
+
+	return Ids;
+}
+
+void USurvivalNetRecorderSubsystem::RecordBandwidth(UNetDriver* NetDriver)
+{
+	TArray<UNetConnection*> Connections = NetDriver->ClientConnections;
+
+	if (NetDriver->ServerConnection)
+	{
+		Connections.Add(NetDriver->ServerConnection);
+	}
+
+	for (UNetConnection* Connection : Connections)
+	{
+		if (!Connection)
+		{
+			continue;
+		}
+
+		TSharedRef<FJsonObject> Record = MakeShared<FJsonObject>();
+		Record->SetStringField(TEXT("type"), TEXT("bw"));
+		Record->SetNumberField(TEXT("t"), GetWorld()->GetRealTimeSeconds());
+		Record->SetNumberField(TEXT("conn"), FindOrAddConnectionId(Connection));
+		Record->SetNumberField(TEXT("outBytesPerSecond"), Connection->OutBytesPerSecond);
+		Record->SetNumberField(TEXT("inBytesPerSecond"), Connection->InBytesPerSecond);
+		WriteLine(Record);
+	}
+
+	//Forget about the objects and classes that don't exist anymore.
+	for (auto It = ObjectStates.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	for (auto It = RecordedClasses.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+#pragma endregion
+
+#pragma region Properties
+
+void USurvivalNetRecorderSubsystem::OnPostTickFlush(float DeltaSeconds)
+{
+	UNetDriver* NetDriver = RecordedNetDriver.Get();
+
+	if (CaptureWriter && NetDriver && NetDriver->IsServer())
+	{
+		RecordReplicatedActors(NetDriver);
+		FlushLines();
+	}
+}
+
+void USurvivalNetRecorderSubsystem::RecordReplicatedActors(UNetDriver* NetDriver)
+{
+	const float TimeSeconds = GetWorld()->GetTimeSeconds();
+
+	for (const TSharedPtr<FNetworkObjectInfo>& ObjectInfo : NetDriver->GetNetworkObjectList().GetActiveObjects())
+	{
+		AActor* Actor = ObjectInfo->Actor;
+
+		if (!Actor || Actor->IsPendingKillPending())
+		{
+			continue;
+		}
+
+		TArray<UNetConnection*> Connections;
+		TSet<UNetConnection*> NewConnections;
+
+		for (UNetConnection* Connection : NetDriver->ClientConnections)
+		{
+			if (!Connection)
+			{
+				continue;
+			}
+
+			TSet<TWeakObjectPtr<AActor>>& ConnectionChannels = OpenChannels.FindOrAdd(FindOrAddConnectionId(Connection));
+
+			if (Connection->FindActorChannelRef(Actor))
+			{
+				Connections.Add(Connection);
+
+				if (!ConnectionChannels.Contains(Actor))
+				{
+					ConnectionChannels.Add(Actor);
+					NewConnections.Add(Connection);
+				}
+			}
+			else
+			{
+				ConnectionChannels.Remove(Actor);
+			}
+		}
+
+		//The engine sends everything that changed between two net updates at once, so we only look when the actor replicated.
+		//ServerReplicateActors sets the time in TickFlush, which already ran this frame.
+		const bool bReplicatedThisFrame = ObjectInfo->LastNetReplicateTime >= TimeSeconds;
+
+		if (Connections.Num() == 0 || (!bReplicatedThisFrame && NewConnections.Num() == 0))
+		{
+			continue;
+		}
+
+		TArray<UObject*> Subobjects;
+		Subobjects.Add(Actor);
+
+		for (UActorComponent* Component : Actor->GetReplicatedComponents())
+		{
+			if (Component && Component->GetIsReplicated())
+			{
+				Subobjects.Add(Component);
+			}
+		}
+
+		//The array grows with the items the components reference.
+		for (int32 SubobjectIndex = 0; SubobjectIndex < Subobjects.Num(); ++SubobjectIndex)
+		{
+			RecordObject(Subobjects[SubobjectIndex], Actor, Connections, NewConnections, Subobjects);
+		}
+	}
+}
+
+void USurvivalNetRecorderSubsystem::RecordObject(UObject* Object, AActor* OwningActor, const TArray<UNetConnection*>& Connections, const TSet<UNetConnection*>& NewConnections, TArray<UObject*>& Subobjects)
+{
+	const FRecordedNetClass& RecordedClass = GetRecordedClass(Object->GetClass());
+	const TArray<FRecordedNetProperty>& Properties = RecordedClass.Properties;
+
+	FRecordedObjectState& State = ObjectStates.FindOrAdd(Object);
+
+	//A new object is sent whole to everyone, like a new channel.
+	const bool bNewObject = State.Values.Num() != Properties.Num();
+
+	if (bNewObject)
+	{
+		State.Values.SetNum(Properties.Num());
+	}
+
+	UObject* Archetype = Object->GetArchetype();
+	UNetConnection* OwnerConnection = OwningActor->GetNetConnection();
+	const bool bRecordValues = CVarSurvivalNetRecordValues.GetValueOnGameThread() != 0;
+
+	FNetBitWriter& Writer = *ValueWriter;
+
+	for (int32 PropertyIndex = 0; PropertyIndex < Properties.Num(); ++PropertyIndex)
+	{
+		const FRecordedNetProperty& RecordedProperty = Properties[PropertyIndex];
+		const void* Data = RecordedProperty.Property->ContainerPtrToValuePtr<void>(Object, RecordedProperty.ArrayIndex);
+
+		Writer.Reset();
+		FSurvivalNetSize::SerializeValue(Writer, RecordedProperty.Property, Data, &Subobjects);
+
+		TArray<uint8>& LastValue = State.Values[PropertyIndex];
+		const bool bChanged = LastValue.Num() != Writer.GetNumBytes() || FMemory::Memcmp(LastValue.GetData(), Writer.GetData(), Writer.GetNumBytes()) != 0;
+
+		if (bChanged)
+		{
+			LastValue.Reset();
+			LastValue.Append(Writer.GetData(), Writer.GetNumBytes());
+		}
+
+		//The first time, only the values that are different from the defaults are sent.
+		const void* ArchetypeData = Archetype ? RecordedProperty.Property->ContainerPtrToValuePtr<void>(Archetype, RecordedProperty.ArrayIndex) : nullptr;
+		const bool bDifferentFromDefault = !ArchetypeData || !RecordedProperty.Property->Identical(Data, ArchetypeData);
+
+		DeltaConnectionIds.Reset();
+		InitialConnectionIds.Reset();
+
+		for (UNetConnection* Connection : Connections)
+		{
+			const bool bInitial = bNewObject || NewConnections.Contains(Connection);
+
+			if ((bInitial && !bDifferentFromDefault) || (!bInitial && !bChanged))
+			{
+				continue;
+			}
+
+			if (ShouldSendToConnection(RecordedProperty.Condition, Connection == OwnerConnection, bInitial))
+			{
+				(bInitial ? InitialConnectionIds : DeltaConnectionIds).Add(FindOrAddConnectionId(Connection));
+			}
+		}
+
+		if (DeltaConnectionIds.Num() == 0 && InitialConnectionIds.Num() == 0)
+		{
+			continue;
+		}
+
+		WritePropertyLine(RecordedClass, RecordedProperty, Object, Writer.GetNumBits(), bRecordValues);
+	}
+}
+
+void USurvivalNetRecorderSubsystem::WritePropertyLine(const FRecordedNetClass& RecordedClass, const FRecordedNetProperty& RecordedProperty, UObject* Object, const int64 NumBits, const bool bRecordValue)
+{
+	//The same fields, in the same order, WriteLine would give a "prop" record.
+	PendingLines += TEXT("{\"type\":\"prop\",\"t\":");
+	PendingLines += FString::SanitizeFloat(GetWorld()->GetRealTimeSeconds());
+	PendingLines += TEXT(",\"class\":");
+	AppendJsonString(PendingLines, RecordedClass.ClassPath);
+	PendingLines += TEXT(",\"object\":");
+	AppendJsonString(PendingLines, Object->GetName());
+	PendingLines += TEXT(",\"prop\":");
+	AppendJsonString(PendingLines, RecordedProperty.Name);
+	PendingLines += FString::Printf(TEXT(",\"index\":%d,\"bits\":%lld"), RecordedProperty.ArrayIndex, NumBits);
+
+	if (bRecordValue)
+	{
+		const void* Data = RecordedProperty.Property->ContainerPtrToValuePtr<void>(Object, RecordedProperty.ArrayIndex);
+
+		ValueText.Reset();
+		RecordedProperty.Property->ExportTextItem(ValueText, Data, nullptr, nullptr, PPF_None);
+
+		PendingLines += TEXT(",\"value\":");
+		AppendJsonString(PendingLines, ValueText);
+	}
+
+	PendingLines += TEXT(",\"conns\":");
+	AppendJsonNumbers(PendingLines, DeltaConnectionIds);
+	PendingLines += TEXT(",\"initial\":");
+	AppendJsonNumbers(PendingLines, InitialConnectionIds);
+	PendingLines += TEXT("}\n");
+}
+
+void USurvivalNetRecorderSubsystem::AppendJsonString(FString& Out, const FString& Value)
+{
+	Out += TEXT('"');
+
+	for (const TCHAR Character : Value)
+	{
+		switch (Character)
+		{
+		case TEXT('"'):		Out += TEXT("\\\""); break;
+		case TEXT('\\'):	Out += TEXT("\\\\"); break;
+		case TEXT('\n'):	Out += TEXT("\\n"); break;
+		case TEXT('\r'):	Out += TEXT("\\r"); break;
+		case TEXT('\t'):	Out += TEXT("\\t"); break;
+		default:
+			if (Character < 0x20)
+			{
+				Out += FString::Printf(TEXT("\\u%04x"), (int32)Character);
+			}
+			else
+			{
+				Out += Character;
+			}
+		}
+	}
+
+	Out += TEXT('"');
+}
+
+void USurvivalNetRecorderSubsystem::AppendJsonNumbers(FString& Out, const TArray<int32>& Numbers)
+{
+	Out += TEXT('[');
+
+	for (int32 i = 0; i < Numbers.Num(); ++i)
+	{
+		if (i > 0)
+		{
+			Out += TEXT(',');
+		}
+
+		Out.AppendInt(Numbers[i]);
+	}
+
+	Out += TEXT(']');
+}
+
+const FRecordedNetClass& USurvivalNetRecorderSubsystem::GetRecordedClass(UClass* Class)
+{
+	if (const FRecordedNetClass* FoundClass = RecordedClasses.Find(Class))
+	{
+		return *FoundClass;
+	}
+
+	FRecordedNetClass& RecordedClass = RecordedClasses.Add(Class);
+	RecordedClass.ClassPath = Class->GetPathName();
+
+	Class->SetUpRuntimeReplicationData();
+
+	//Same list the replication layout is built from, it has the conditions.
+	TArray<FLifetimeProperty> LifetimeProperties;
+	Class->GetDefaultObject()->GetLifetimeReplicatedProps(LifetimeProperties);
+
+	for (const FLifetimeProperty& LifetimeProperty : LifetimeProperties)
+	{
+		if (!Class->ClassReps.IsValidIndex(LifetimeProperty.RepIndex))
+		{
+			continue;
+		}
+
+		const FRepRecord& RepRecord = Class->ClassReps[LifetimeProperty.RepIndex];
+
+		FRecordedNetProperty RecordedProperty;
+		RecordedProperty.Property = RepRecord.Property;
+		RecordedProperty.ArrayIndex = RepRecord.Index;
+		RecordedProperty.Condition = LifetimeProperty.Condition;
+		RecordedProperty.Name = RepRecord.Property->GetName();
+
+		RecordedClass.Properties.Add(RecordedProperty);
+	}
+
+	return RecordedClass;
+}
+
+bool USurvivalNetRecorderSubsystem::ShouldSendToConnection(const ELifetimeCondition Condition, const bool bIsOwner, const bool bInitial)
+{
+	switch (Condition)
+	{
+	case COND_InitialOnly:
+		return bInitial;
+	case COND_OwnerOnly:
+	case COND_AutonomousOnly:
+	case COND_ReplayOrOwner:
+		return bIsOwner;
+	case COND_InitialOrOwner:
+		return bInitial || bIsOwner;
+	//The owner is the autonomous proxy, everyone else simulates.
+	case COND_SkipOwner:
+	case COND_SimulatedOnly:
+	case COND_SimulatedOrPhysics:
+		return !bIsOwner;
+	case COND_ReplayOnly:
+		return false;
+	default:
+		return true;
+	}
+}
+
+#pragma endregion
+
+#pragma region RPCs
+
+void USurvivalNetRecorderSubsystem::OnSendRPC(AActor* Actor, UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack, UObject* SubObject, bool& bBlockSendRPC)
+{
+	PreviousSendRPCDel.ExecuteIfBound(Actor, Function, Parameters, OutParms, Stack, SubObject, bBlockSendRPC);
+
+	//Blocked RPCs are never sent.
+	if (bBlockSendRPC || !CaptureWriter || !Actor || !Function)
+	{
+		return;
+	}
+
+	TArray<UNetConnection*> Connections;
+
+	if (Function->HasAnyFunctionFlags(FUNC_NetMulticast))
+	{
+		//Multicasts go to everyone that has a channel for the actor.
+		if (UNetDriver* NetDriver = RecordedNetDriver.Get())
+		{
+			for (UNetConnection* Connection : NetDriver->ClientConnections)
+			{
+				if (Connection && Connection->FindActorChannelRef(Actor))
+				{
+					Connections.Add(Connection);
+				}
+			}
+		}
+	}
+	else if (UNetConnection* Connection = Actor->GetNetConnection())
+	{
+		Connections.Add(Connection);
+	}
+
+	UObject* TargetObject = SubObject ? SubObject : Actor;
+
+	TSharedRef<FJsonObject> Record = MakeShared<FJsonObject>();
+	Record->SetStringField(TEXT("type"), TEXT("rpc"));
+	Record->SetNumberField(TEXT("t"), GetWorld()->GetRealTimeSeconds());
+	Record->SetStringField(TEXT("class"), Function->GetOwnerClass()->GetPathName());
+	Record->SetStringField(TEXT("function"), Function->GetName());
+	Record->SetStringField(TEXT("object"), TargetObject->GetName());
+	Record->SetBoolField(TEXT("reliable"), Function->HasAnyFunctionFlags(FUNC_NetReliable));
+	Record->SetNumberField(TEXT("bits"), FSurvivalNetSize::GetParametersBits(Function, Parameters, PackageMap));
+
+	if (CVarSurvivalNetRecordValues.GetValueOnGameThread() != 0)
+	{
+		TSharedRef<FJsonObject> ParametersObject = MakeShared<FJsonObject>();
+
+		for (TFieldIterator<FProperty> It(Function); It && It->HasAnyPropertyFlags(CPF_Parm); ++It)
+		{
+			if (!It->HasAnyPropertyFlags(CPF_ReturnParm))
+			{
+				FString Value;
+				It->ExportTextItem(Value, It->ContainerPtrToValuePtr<void>(Parameters), nullptr, nullptr, PPF_None);
+				ParametersObject->SetStringField(It->GetName(), Value);
+			}
+		}
+
+		Record->SetObjectField(TEXT("params"), ParametersObject);
+	}
+
+	Record->SetArrayField(TEXT("conns"), GetConnectionIds(Connections));
+	WriteLine(Record);
+}
+
+#pragma endregion
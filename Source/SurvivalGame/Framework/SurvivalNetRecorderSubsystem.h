@@ -0,0 +1,149 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "UObject/CoreNet.h"
+#include "Engine/NetDriver.h"
+#include "SurvivalNetRecorderSubsystem.generated.h"
+
+/*A replicated property of a class, with the condition it replicates with.*/
+struct FRecordedNetProperty
+{
+	FProperty* Property;
+	int32 ArrayIndex;
+	ELifetimeCondition Condition;
+
+	/*The name as it goes in the capture, so we don't build it again for every record.*/
+	FString Name;
+};
+
+/*The replicated properties of a class, and its path as it goes in the capture.*/
+struct FRecordedNetClass
+{
+	FString ClassPath;
+	TArray<FRecordedNetProperty> Properties;
+};
+
+/*Records what this machine sends through the network, so we can break the bandwidth down offline (see USurvivalNetCaptureCommandlet).
+
+On the server it records, for every connection, the replicated properties that changed on every actor that replicated this frame
+(and their components and items), the full state when an actor channel opens, and every Client and Multicast RPC.
+Actors are recorded after the net driver's TickFlush, the only time we can tell which of them replicated this frame.
+On a client it records the Server RPCs we send. Every record keeps the value as text, so the replay can serialize it again
+with the current code and tell us how much an optimization saves without playing a new match.
+
+Sizes are estimated with FSurvivalNetSize, through one package map for the whole recording (a client that joined when it started).
+The engine's measured outgoing bytes per second of every connection are recorded
+next to them to compare. Disabled by default. Turn it on with -SurvivalNetRecord in the command line, or Survival.NetRecord 1 in the console.
+Captures go to Saved/Profiling/SurvivalNetCapture, one JSON object per line.*/
+UCLASS()
+class SURVIVALGAME_API USurvivalNetRecorderSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	USurvivalNetRecorderSubsystem();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual TStatId GetStatId() const override;
+
+	static bool IsRecordingEnabled();
+
+protected:
+
+	/*What we sent last time for every property of an object, to know what changed.*/
+	struct FRecordedObjectState
+	{
+		TArray<TArray<uint8>> Values;
+	};
+
+	/*The net driver we are listening to for RPCs.*/
+	TWeakObjectPtr<class UNetDriver> RecordedNetDriver;
+
+	/*Whoever listened to the RPCs of the net driver before us. We call it first, and give it back when we stop.*/
+	FOnSendRPC PreviousSendRPCDel;
+
+	FDelegateHandle PostTickFlushHandle;
+
+	FArchive* CaptureWriter;
+
+	/*Gives the object references of the recording their NetGUIDs.*/
+	UPROPERTY()
+	class USurvivalNetSizePackageMap* PackageMap;
+
+	/*Every property of every object that replicated is written here to compare it with what we sent last time.
+	Reset for each one, it keeps its buffer.*/
+	TUniquePtr<FNetBitWriter> ValueWriter;
+
+	/*Reused for every property record, they keep their memory.*/
+	FString ValueText;
+	TArray<int32> DeltaConnectionIds;
+	TArray<int32> InitialConnectionIds;
+
+	/*Lines waiting to be written. We write them once per frame.*/
+	FString PendingLines;
+
+	/*Ids we give to connections in the capture, in the order we see them.*/
+	TMap<TWeakObjectPtr<class UNetConnection>, int32> ConnectionIds;
+
+	/*Actors whose channel was already open for a connection the last time we looked, by connection id.*/
+	TMap<int32, TSet<TWeakObjectPtr<AActor>>> OpenChannels;
+
+	TMap<TWeakObjectPtr<UObject>, FRecordedObjectState> ObjectStates;
+
+	/*Weak, a class can be garbage collected (a Blueprint compiled again) and another one take its address.*/
+	TMap<TWeakObjectPtr<UClass>, FRecordedNetClass> RecordedClasses;
+
+	float BandwidthSampleTime;
+
+	void StartRecording(class UNetDriver* NetDriver);
+	void StopRecording();
+
+	void WriteLine(const TSharedRef<class FJsonObject>& Record);
+	void FlushLines();
+
+	/*Records the outgoing bytes per second the engine measured for every connection.*/
+	void RecordBandwidth(class UNetDriver* NetDriver);
+
+	/*Records the properties every actor that replicated this frame sent to every connection.*/
+	void RecordReplicatedActors(class UNetDriver* NetDriver);
+
+	/*After the net driver replicated the actors of this frame.*/
+	void OnPostTickFlush(float DeltaSeconds);
+
+	/*Records the properties of one object of the actor. Items the object references are added to Subobjects.*/
+	void RecordObject(UObject* Object, AActor* OwningActor, const TArray<class UNetConnection*>& Connections, const TSet<class UNetConnection*>& NewConnections, TArray<UObject*>& Subobjects);
+
+	/*Called by the net driver for every RPC we send.*/
+	void OnSendRPC(AActor* Actor, UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack, UObject* SubObject, bool& bBlockSendRPC);
+
+	/*The replicated properties of the class and their conditions. Built the first time we see the class.*/
+	const FRecordedNetClass& GetRecordedClass(UClass* Class);
+
+	/*Properties are most of the capture, their records are written straight to the pending lines without a JSON object.*/
+	void WritePropertyLine(const FRecordedNetClass& RecordedClass, const FRecordedNetProperty& RecordedProperty, UObject* Object, const int64 NumBits, const bool bRecordValue);
+
+	static void AppendJsonString(FString& Out, const FString& Value);
+	static void AppendJsonNumbers(FString& Out, const TArray<int32>& Numbers);
+
+	/*True if a property with this condition goes to this connection.*/
+	static bool ShouldSendToConnection(const ELifetimeCondition Condition, const bool bIsOwner, const bool bInitial);
+
+	/*The id of the connection in the capture. The first time we see a connection we record who it is.*/
+	int32 FindOrAddConnectionId(class UNetConnection* Connection);
+
+	TArray<TSharedPtr<class FJsonValue>> GetConnectionIds(const TArray<class UNetConnection*>& Connections);
+};
@@ -0,0 +1,222 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "SurvivalNetSize.h"
+
+#include "Misc/NetworkGuid.h"
+#include "UObject/CoreNet.h"
+#include "UObject/UnrealType.h"
+
+#include "Items/Item.h"
+
+USurvivalNetSizePackageMap* FSurvivalNetSize::NewPackageMap()
+{
+	return NewObject<USurvivalNetSizePackageMap>(GetTransientPackage());
+}
+
+void FSurvivalNetSize::SerializeValue(FNetBitWriter& Writer, FProperty* Property, const void* Data, TArray<UObject*>* Subobjects)
+{
+	void* MutableData = const_cast<void*>(Data);
+
+	if (FObjectPropertyBase* ObjectProperty = CastField<FObjectPropertyBase>(Property))
+	{
+		UObject* Object = ObjectProperty->GetObjectPropertyValue(Data);
+		Writer.PackageMap->SerializeObject(Writer, ObjectProperty->PropertyClass, Object);
+
+		//Items are the only subobjects we replicate.
+		if (Subobjects && Object && Object->IsA<UItem>())
+		{
+			Subobjects->AddUnique(Object);
+		}
+	}
+	else if (FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property))
+	{
+		FScriptArrayHelper ArrayHelper(ArrayProperty, MutableData);
+
+		uint16 ArrayNum = ArrayHelper.Num();
+		Writer << ArrayNum;
+
+		for (int32 i = 0; i < ArrayHelper.Num(); ++i)
+		{
+			SerializeValue(Writer, ArrayProperty->Inner, ArrayHelper.GetRawPtr(i), Subobjects);
+		}
+	}
+	else if (FStructProperty* StructProperty = CastField<FStructProperty>(Property))
+	{
+		//Structs with their own NetSerialize write themselves. The rest replicate field by field.
+		if (StructProperty->Struct->StructFlags & STRUCT_NetSerializeNative)
+		{
+			StructProperty->NetSerializeItem(Writer, Writer.PackageMap, MutableData);
+		}
+		else
+		{
+			for (TFieldIterator<FProperty> It(StructProperty->Struct); It; ++It)
+			{
+				if (It->HasAnyPropertyFlags(CPF_RepSkip))
+				{
+					continue;
+				}
+
+				for (int32 Index = 0; Index < It->ArrayDim; ++Index)
+				{
+					SerializeValue(Writer, *It, It->ContainerPtrToValuePtr<void>(MutableData, Index), Subobjects);
+				}
+			}
+		}
+	}
+	else if (Property->IsA<FNameProperty>())
+	{
+		FName Name = *static_cast<const FName*>(Data);
+		UPackageMap::StaticSerializeName(Writer, Name);
+	}
+	else
+	{
+		Property->NetSerializeItem(Writer, Writer.PackageMap, MutableData);
+	}
+}
+
+int64 FSurvivalNetSize::GetValueBits(FProperty* Property, const void* Data, UPackageMap* PackageMap)
+{
+	FNetBitWriter Writer(PackageMap ? PackageMap : NewPackageMap(), 1024);
+	SerializeValue(Writer, Property, Data);
+
+	return Writer.GetNumBits();
+}
+
+int64 FSurvivalNetSize::GetReplicatedBits(UObject* Object)
+{
+	TArray<UObject*> Subobjects;
+	int64 NumBits = 0;
+
+	//Everything the new client receives goes through the same connection.
+	UPackageMap* PackageMap = NewPackageMap();
+
+	Subobjects.Add(Object);
+
+	//The array grows while we go through it with every item we find.
+	for (int32 SubobjectIndex = 0; SubobjectIndex < Subobjects.Num(); ++SubobjectIndex)
+	{
+		UObject* Subobject = Subobjects[SubobjectIndex];
+		FNetBitWriter Writer(PackageMap, 1024);
+
+		for (TFieldIterator<FProperty> It(Subobject->GetClass()); It; ++It)
+		{
+			if (!It->HasAnyPropertyFlags(CPF_Net))
+			{
+				continue;
+			}
+
+			for (int32 Index = 0; Index < It->ArrayDim; ++Index)
+			{
+				SerializeValue(Writer, *It, It->ContainerPtrToValuePtr<void>(Subobject, Index), &Subobjects);
+			}
+		}
+
+		NumBits += Writer.GetNumBits();
+
+		//The actor channel writes a content block header before every subobject: whether it has a rep layout, whether it's
+		//the actor, the subobject, whether it's stably named, its class and the size of what follows.
+		if (SubobjectIndex > 0)
+		{
+			FNetBitWriter HeaderWriter(PackageMap, 256);
+
+			UObject* SubobjectReference = Subobject;
+			UObject* ClassReference = Subobject->GetClass();
+			uint32 PayloadBits = Writer.GetNumBits();
+
+			HeaderWriter.WriteBit(1);
+			HeaderWriter.WriteBit(0);
+			HeaderWriter << SubobjectReference;
+			HeaderWriter.WriteBit(0);
+			HeaderWriter << ClassReference;
+			HeaderWriter.SerializeIntPacked(PayloadBits);
+
+			NumBits += HeaderWriter.GetNumBits();
+		}
+	}
+
+	return NumBits;
+}
+
+int64 FSurvivalNetSize::GetParametersBits(UFunction* Function, const void* Parameters, UPackageMap* PackageMap)
+{
+	FNetBitWriter Writer(PackageMap ? PackageMap : NewPackageMap(), 1024);
+
+	for (TFieldIterator<FProperty> It(Function); It && It->HasAnyPropertyFlags(CPF_Parm); ++It)
+	{
+		if (It->HasAnyPropertyFlags(CPF_ReturnParm))
+		{
+			continue;
+		}
+
+		for (int32 Index = 0; Index < It->ArrayDim; ++Index)
+		{
+			SerializeValue(Writer, *It, It->ContainerPtrToValuePtr<void>(Parameters, Index));
+		}
+	}
+
+	return Writer.GetNumBits();
+}
+
+USurvivalNetSizePackageMap::USurvivalNetSizePackageMap()
+{
+	NextStaticId = 1;
+	NextDynamicId = 1;
+}
+
+bool USurvivalNetSizePackageMap::SerializeObject(FArchive& Ar, UClass* InClass, UObject*& Obj, FNetworkGUID* OutNetGUID)
+{
+	FNetworkGUID NetGUID;
+
+	if (Obj)
+	{
+		if (const FNetworkGUID* KnownNetGUID = NetGUIDs.Find(Obj))
+		{
+			NetGUID = *KnownNetGUID;
+			Ar << NetGUID;
+		}
+		else
+		{
+			const bool bStablyNamed = Obj->IsFullNameStableForNetworking();
+
+			//The low bit tells static from dynamic, like FNetworkGUID::IsStatic.
+			NetGUID = FNetworkGUID(bStablyNamed ? (NextStaticId++ << 1) | 1 : NextDynamicId++ << 1);
+			NetGUIDs.Add(Obj, NetGUID);
+
+			Ar << NetGUID;
+
+			//Spawned objects come with their channel or subobject header, only the ones with a stable name are exported by path.
+			if (bStablyNamed)
+			{
+				uint8 ExportFlags = 0;
+				Ar << ExportFlags;
+
+				//The outer is a reference too, exported the first time like this one. Up to the package.
+				UObject* Outer = Obj->GetOuter();
+				SerializeObject(Ar, Outer ? Outer->GetClass() : nullptr, Outer);
+
+				FString ObjectName = Obj->GetName();
+				Ar << ObjectName;
+
+				//The network checksum of the object.
+				uint32 Checksum = 0;
+				Ar << Checksum;
+			}
+		}
+	}
+	else
+	{
+		Ar << NetGUID;
+	}
+
+	if (OutNetGUID)
+	{
+		*OutNetGUID = NetGUID;
+	}
+
+	return true;
+}
@@ -0,0 +1,64 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/CoreNet.h"
+#include "SurvivalNetSize.generated.h"
+
+/*Estimates how many bits replicated values take on the wire, writing them the same way the replication layout does.
+Used by the benchmark commandlet and the network recorder, so their numbers compare.
+
+Object references go through a USurvivalNetSizePackageMap, which hands out NetGUIDs like the engine does for one connection.
+Bunch and property headers are not counted, only the values and the header the actor channel writes before every subobject.*/
+class SURVIVALGAME_API FSurvivalNetSize
+{
+public:
+
+	/*Writes one replicated value with the package map of the writer. If Subobjects is given, the items the value references are added to it.*/
+	static void SerializeValue(FNetBitWriter& Writer, FProperty* Property, const void* Data, TArray<UObject*>* Subobjects = nullptr);
+
+	/*The package map of a connection that just opened, it doesn't know any object yet.*/
+	static class USurvivalNetSizePackageMap* NewPackageMap();
+
+	/*Bits of one replicated value. Without a package map, as a new client would receive it.*/
+	static int64 GetValueBits(FProperty* Property, const void* Data, UPackageMap* PackageMap = nullptr);
+
+	/*Bits of every replicated property of the object and of the items it references with their subobject headers, as a new client would receive them.*/
+	static int64 GetReplicatedBits(UObject* Object);
+
+	/*Bits of the parameters of an RPC, without the RPC header. Without a package map, as a new client would receive them.*/
+	static int64 GetParametersBits(UFunction* Function, const void* Parameters, UPackageMap* PackageMap = nullptr);
+};
+
+/*Hands out NetGUIDs like the package map of one connection: objects with a stable name (assets, classes, actors placed in
+the map) get odd ids, spawned objects even ones, both counting up in the order they are first referenced. A packed NetGUID
+grows with the number of objects the connection knows, so a long match writes bigger references than a new one.
+
+The first reference to an object with a stable name also writes what the engine exports for it once per connection:
+export flags, its outer and its name. The engine sends that in the bunch just before, we count it with the value.*/
+UCLASS(Transient)
+class SURVIVALGAME_API USurvivalNetSizePackageMap : public UPackageMap
+{
+	GENERATED_BODY()
+
+public:
+
+	USurvivalNetSizePackageMap();
+
+	virtual bool SerializeObject(FArchive& Ar, UClass* InClass, UObject*& Obj, FNetworkGUID* OutNetGUID = nullptr) override;
+
+	int32 GetNumKnownObjects() const { return NetGUIDs.Num(); }
+
+protected:
+
+	/*Weak, the package map doesn't keep what it saw alive. A destroyed object keeps its id, like in the engine.*/
+	TMap<TWeakObjectPtr<UObject>, FNetworkGUID> NetGUIDs;
+
+	uint32 NextStaticId;
+	uint32 NextDynamicId;
+};
@@ -0,0 +1,743 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "SurvivalPlayerSaveSubsystem.h"
+#include "SurvivalGame.h"
+
+#include "Async/Async.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "UObject/SoftObjectPath.h"
+
+#include "Components/InventoryComponent.h"
+#include "Items/EquippableItem.h"
+#include "Player/SurvivalCharacter.h"
+#include "Weapons/Weapon.h"
+
+static TAutoConsoleVariable<int32> CVarSurvivalPlayerSave(
+	TEXT("Survival.PlayerSave"),
+	1,
+	TEXT("Saves the players inventories between logins.\n")
+	TEXT("0: off, 1: on"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSurvivalPlayerSaveAutosaveInterval(
+	TEXT("Survival.PlayerSave.AutosaveInterval"),
+	60.f,
+	TEXT("Seconds between two saves of every player. 0 only saves when they leave."),
+	ECVF_Default);
+
+#pragma region Save
+
+FSurvivalPlayerSave::FSurvivalPlayerSave()
+{
+	Health = 0.f;
+	AmmoInClip = 0;
+}
+
+void FSurvivalPlayerSave::ToBytes(TArray<uint8>& OutData) const
+{
+	OutData.Reset();
+	FMemoryWriter Writer(OutData);
+
+	uint32 SavedMagic = Magic;
+	uint32 Version = LatestVersion;
+	float SavedHealth = Health;
+	uint32 SavedAmmoInClip = FMath::Max(AmmoInClip, 0);
+	uint32 NumClasses = ItemClasses.Num();
+	uint32 NumItems = Items.Num();
+
+	Writer << SavedMagic;
+	Writer.SerializeIntPacked(Version);
+	Writer << SavedHealth;
+	Writer.SerializeIntPacked(SavedAmmoInClip);
+
+	Writer.SerializeIntPacked(NumClasses);
+	for (FString ItemClass : ItemClasses)
+	{
+		Writer << ItemClass;
+	}
+
+	Writer.SerializeIntPacked(NumItems);
+	for (const FItem& Item : Items)
+	{
+		uint32 ClassIndex = Item.ClassIndex;
+		uint32 Quantity = FMath::Max(Item.Quantity, 0);
+		uint8 bEquipped = Item.bEquipped ? 1 : 0;
+
+		Writer.SerializeIntPacked(ClassIndex);
+		Writer.SerializeIntPacked(Quantity);
+		Writer << bEquipped;
+	}
+}
+
+bool FSurvivalPlayerSave::FromBytes(const TArray<uint8>& Data)
+{
+	FMemoryReader Reader(Data);
+
+	uint32 SavedMagic = 0;
+	Reader << SavedMagic;
+
+	if (Reader.IsError() || SavedMagic != Magic)
+	{
+		return false;
+	}
+
+	uint32 Version = 0;
+	Reader.SerializeIntPacked(Version);
+
+	if (Version == 0 || Version > LatestVersion)
+	{
+		return false;
+	}
+
+	uint32 SavedAmmoInClip = 0;
+	Reader << Health;
+	Reader.SerializeIntPacked(SavedAmmoInClip);
+	AmmoInClip = SavedAmmoInClip;
+
+	//Every class and every item takes at least a byte, bigger counts mean the data is broken.
+	uint32 NumClasses = 0;
+	Reader.SerializeIntPacked(NumClasses);
+
+	if (Reader.IsError() || NumClasses > (uint32)Data.Num())
+	{
+		return false;
+	}
+
+	ItemClasses.SetNum(NumClasses);
+	for (FString& ItemClass : ItemClasses)
+	{
+		Reader << ItemClass;
+	}
+
+	uint32 NumItems = 0;
+	Reader.SerializeIntPacked(NumItems);
+
+	if (Reader.IsError() || NumItems > (uint32)Data.Num())
+	{
+		return false;
+	}
+
+	Items.SetNum(NumItems);
+	for (FItem& Item : Items)
+	{
+		uint32 ClassIndex = 0;
+		uint32 Quantity = 0;
+		uint8 bEquipped = 0;
+
+		Reader.SerializeIntPacked(ClassIndex);
+		Reader.SerializeIntPacked(Quantity);
+		Reader << bEquipped;
+
+		if (ClassIndex >= NumClasses)
+		{
+			return false;
+		}
+
+		Item.ClassIndex = ClassIndex;
+		Item.Quantity = Quantity;
+		Item.bEquipped = bEquipped != 0;
+	}
+
+	return !Reader.IsError();
+}
+
+#pragma endregion
+
+#pragma region File Store
+
+FSurvivalPlayerSaveFileStore::FSurvivalPlayerSaveFileStore(const FString& InDirectory)
+	: Directory(InDirectory)
+{
+	IFileManager::Get().MakeDirectory(*Directory, true);
+}
+
+bool FSurvivalPlayerSaveFileStore::Write(const FString& PlayerId, const TArray<uint8>& Data)
+{
+	const FString Filename = GetFilename(PlayerId);
+	const FString TempFilename = Filename + TEXT(".tmp");
+
+	if (!FFileHelper::SaveArrayToFile(Data, *TempFilename))
+	{
+		return false;
+	}
+
+	return IFileManager::Get().Move(*Filename, *TempFilename, true, true);
+}
+
+bool FSurvivalPlayerSaveFileStore::Read(const FString& PlayerId, TArray<uint8>& OutData)
+{
+	return FFileHelper::LoadFileToArray(OutData, *GetFilename(PlayerId), FILEREAD_Silent);
+}
+
+bool FSurvivalPlayerSaveFileStore::Remove(const FString& PlayerId)
+{
+	return IFileManager::Get().Delete(*GetFilename(PlayerId), false, false, true);
+}
+
+FString FSurvivalPlayerSaveFileStore::GetFilename(const FString& PlayerId) const
+{
+	return Directory / FPaths::MakeValidFileName(PlayerId, TEXT('_')) + TEXT(".sav");
+}
+
+#pragma endregion
+
+#pragma region Queue
+
+FSurvivalPlayerSaveQueue::FSurvivalPlayerSaveQueue(TSharedRef<ISurvivalPlayerSaveStore, ESPMode::ThreadSafe> InStore)
+	: Store(InStore)
+	, bWriterRunning(false)
+	, NumWritten(0)
+{
+}
+
+void FSurvivalPlayerSaveQueue::Write(const FString& PlayerId, TArray<uint8>&& Data)
+{
+	{
+		FScopeLock Lock(&QueueLock);
+		Queued.Add(PlayerId, TOptional<TArray<uint8>>(MoveTemp(Data)));
+	}
+
+	StartWriter();
+}
+
+void FSurvivalPlayerSaveQueue::Remove(const FString& PlayerId)
+{
+	{
+		FScopeLock Lock(&QueueLock);
+		Queued.Add(PlayerId, TOptional<TArray<uint8>>());
+	}
+
+	StartWriter();
+}
+
+bool FSurvivalPlayerSaveQueue::Read(const FString& PlayerId, TArray<uint8>& OutData)
+{
+	{
+		FScopeLock Lock(&QueueLock);
+
+		//The newest save is the queued one, then the one being written, then the one in the store.
+		const TOptional<TArray<uint8>>* Save = Queued.Find(PlayerId);
+
+		if (!Save && WritingPlayerId == PlayerId)
+		{
+			Save = &WritingSave;
+		}
+
+		if (Save)
+		{
+			if (Save->IsSet())
+			{
+				OutData = Save->GetValue();
+				return true;
+			}
+
+			return false;
+		}
+	}
+
+	return Store->Read(PlayerId, OutData);
+}
+
+void FSurvivalPlayerSaveQueue::Flush()
+{
+	for (;;)
+	{
+		{
+			FScopeLock Lock(&QueueLock);
+
+			if (!bWriterRunning && Queued.Num() == 0)
+			{
+				return;
+			}
+		}
+
+		FPlatformProcess::Sleep(0.001f);
+	}
+}
+
+void FSurvivalPlayerSaveQueue::StartWriter()
+{
+	{
+		FScopeLock Lock(&QueueLock);
+
+		if (bWriterRunning)
+		{
+			return;
+		}
+
+		bWriterRunning = true;
+	}
+
+	TSharedRef<FSurvivalPlayerSaveQueue, ESPMode::ThreadSafe> Self = AsShared();
+
+	Async(EAsyncExecution::ThreadPool, [Self]()
+	{
+		Self->WriteQueued();
+	});
+}
+
+void FSurvivalPlayerSaveQueue::WriteQueued()
+{
+	for (;;)
+	{
+		FString PlayerId;
+		TOptional<TArray<uint8>> Save;
+
+		{
+			FScopeLock Lock(&QueueLock);
+
+			WritingPlayerId.Reset();
+			WritingSave.Reset();
+
+			auto It = Queued.CreateIterator();
+
+			if (!It)
+			{
+				bWriterRunning = false;
+				return;
+			}
+
+			//Kept until it's written, so reads don't get the old file in the meantime.
+			WritingPlayerId = It.Key();
+			WritingSave = MoveTemp(It.Value());
+			It.RemoveCurrent();
+
+			PlayerId = WritingPlayerId;
+			Save = WritingSave;
+		}
+
+		const bool bWritten = Save.IsSet() ? Store->Write(PlayerId, Save.GetValue()) : Store->Remove(PlayerId);
+
+		if (!bWritten)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Couldn't write the save of player %s."), *PlayerId);
+		}
+
+		++NumWritten;
+	}
+}
+
+#pragma endregion
+
+#pragma region Subsystem
+
+USurvivalPlayerSaveSubsystem::USurvivalPlayerSaveSubsystem()
+{
+	AutosaveTime = 0.f;
+}
+
+void USurvivalPlayerSaveSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	FString SaveDirectory = FPaths::ProjectSavedDir() / TEXT("PlayerSaves");
+	FParse::Value(FCommandLine::Get(), TEXT("PlayerSaveDir="), SaveDirectory);
+
+	SaveQueue = MakeShared<FSurvivalPlayerSaveQueue, ESPMode::ThreadSafe>(MakeShared<FSurvivalPlayerSaveFileStore, ESPMode::ThreadSafe>(SaveDirectory));
+
+	AutosaveTickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &USurvivalPlayerSaveSubsystem::OnAutosaveTicker), 1.f);
+}
+
+void USurvivalPlayerSaveSubsystem::Deinitialize()
+{
+	FTicker::GetCoreTicker().RemoveTicker(AutosaveTickerHandle);
+
+	//Players still in the world when the server stops.
+	SaveAllPlayers();
+
+	SaveQueue->Flush();
+
+	Super::Deinitialize();
+}
+
+void USurvivalPlayerSaveSubsystem::PrefetchPlayer(const FUniqueNetIdRepl& UniqueId)
+{
+	if (IsEnabled() && UniqueId.IsValid())
+	{
+		StartLoad(UniqueId->ToString());
+	}
+}
+
+void USurvivalPlayerSaveSubsystem::RestorePlayer(ASurvivalCharacter* Character)
+{
+	if (!IsEnabled() || !Character || Character->GetLocalRole() != ROLE_Authority)
+	{
+		return;
+	}
+
+	const FString PlayerId = GetPlayerId(Character);
+
+	//Respawns start with nothing.
+	if (PlayerId.IsEmpty() || RestoredPlayers.Contains(PlayerId))
+	{
+		return;
+	}
+
+	if (LoadedSaves.Contains(PlayerId))
+	{
+		ApplyLoadedSave(PlayerId, Character);
+		return;
+	}
+
+	WaitingCharacters.Add(PlayerId, Character);
+	StartLoad(PlayerId);
+}
+
+void USurvivalPlayerSaveSubsystem::SavePlayer(ASurvivalCharacter* Character)
+{
+	SavePlayer(Character, Character ? Character->GetPlayerState() : nullptr);
+}
+
+void USurvivalPlayerSaveSubsystem::SavePlayer(ASurvivalCharacter* Character, const APlayerState* PlayerState)
+{
+	if (!IsEnabled() || !Character || !Character->IsAlive() || Character->GetLocalRole() != ROLE_Authority)
+	{
+		return;
+	}
+
+	const FString PlayerId = GetPlayerId(PlayerState);
+
+	if (PlayerId.IsEmpty() || !RestoredPlayers.Contains(PlayerId))
+	{
+		return;
+	}
+
+	FSurvivalPlayerSave Save;
+	CaptureCharacter(Character, Save);
+
+	TArray<uint8> Data;
+	Save.ToBytes(Data);
+
+	SaveQueue->Write(PlayerId, MoveTemp(Data));
+}
+
+void USurvivalPlayerSaveSubsystem::ClearPlayer(ASurvivalCharacter* Character)
+{
+	if (!IsEnabled() || !Character || Character->GetLocalRole() != ROLE_Authority)
+	{
+		return;
+	}
+
+	const FString PlayerId = GetPlayerId(Character);
+
+	//If the save wasn't applied yet the character didn't die with it, the next one still gets it.
+	if (!PlayerId.IsEmpty() && RestoredPlayers.Contains(PlayerId))
+	{
+		SaveQueue->Remove(PlayerId);
+	}
+}
+
+void USurvivalPlayerSaveSubsystem::ForgetPlayer(const FUniqueNetIdRepl& UniqueId)
+{
+	if (!UniqueId.IsValid())
+	{
+		return;
+	}
+
+	const FString PlayerId = UniqueId->ToString();
+
+	RestoredPlayers.Remove(PlayerId);
+	LoadedSaves.Remove(PlayerId);
+	LoadsInFlight.Remove(PlayerId);
+	WaitingCharacters.Remove(PlayerId);
+}
+
+void USurvivalPlayerSaveSubsystem::SaveAllPlayers()
+{
+	UWorld* World = GetGameInstance()->GetWorld();
+
+	if (!World)
+	{
+		return;
+	}
+
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* Player = It->Get();
+
+		if (ASurvivalCharacter* Character = Player ? Cast<ASurvivalCharacter>(Player->GetPawn()) : nullptr)
+		{
+			SavePlayer(Character);
+		}
+	}
+}
+
+void USurvivalPlayerSaveSubsystem::CaptureCharacter(const ASurvivalCharacter* Character, FSurvivalPlayerSave& OutSave)
+{
+	SURVIVAL_SCOPE_CYCLE_COUNTER(PlayerSaveCapture);
+
+	OutSave = FSurvivalPlayerSave();
+	OutSave.Health = Character->GetHealth();
+
+	if (const AWeapon* Weapon = Character->GetEquippedWeapon())
+	{
+		OutSave.AmmoInClip = Weapon->GetCurrentAmmoInClip();
+	}
+
+	if (!Character->GetPlayerInventory())
+	{
+		return;
+	}
+
+	TMap<UClass*, int32> ClassIndices;
+
+	for (UItem* Item : Character->GetPlayerInventory()->GetItems())
+	{
+		if (!Item)
+		{
+			continue;
+		}
+
+		int32* ClassIndex = ClassIndices.Find(Item->GetClass());
+
+		if (!ClassIndex)
+		{
+			ClassIndex = &ClassIndices.Add(Item->GetClass(), OutSave.ItemClasses.Add(Item->GetClass()->GetPathName()));
+		}
+
+		const UEquippableItem* Equippable = Cast<UEquippableItem>(Item);
+
+		FSurvivalPlayerSave::FItem SavedItem;
+		SavedItem.ClassIndex = *ClassIndex;
+		SavedItem.Quantity = Item->GetQuantity();
+		SavedItem.bEquipped = Equippable && Equippable->IsEquipped();
+
+		OutSave.Items.Add(SavedItem);
+	}
+}
+
+void USurvivalPlayerSaveSubsystem::ApplyToCharacter(ASurvivalCharacter* Character, const FSurvivalPlayerSave& Save)
+{
+	SURVIVAL_SCOPE_CYCLE_COUNTER(PlayerSaveRestore);
+
+	UInventoryComponent* Inventory = Character->GetPlayerInventory();
+
+	if (!Inventory || Character->GetLocalRole() != ROLE_Authority)
+	{
+		return;
+	}
+
+	//Whatever the character spawned with is replaced by the save.
+	const TArray<UEquippableItem*> EquippedInvItems = Character->GetEquippedItemSlots();
+
+	for (UEquippableItem* Equippable : EquippedInvItems)
+	{
+		if (Equippable)
+		{
+			Equippable->SetEquipped(false);
+		}
+	}
+
+	for (UItem* Item : Inventory->GetItems())
+	{
+		Inventory->RemoveItem(Item);
+	}
+
+	TArray<UClass*> ItemClasses;
+	ItemClasses.Reserve(Save.ItemClasses.Num());
+
+	for (const FString& ItemClassPath : Save.ItemClasses)
+	{
+		UClass* ItemClass = FSoftClassPath(ItemClassPath).TryLoadClass<UItem>();
+
+		if (!ItemClass)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Item class %s of a player save doesn't exist anymore, its items are lost."), *ItemClassPath);
+		}
+
+		ItemClasses.Add(ItemClass);
+	}
+
+	TArray<TPair<UEquippableItem*, bool>> Equippables;
+
+	for (const FSurvivalPlayerSave::FItem& SavedItem : Save.Items)
+	{
+		UClass* ItemClass = ItemClasses[SavedItem.ClassIndex];
+
+		if (!ItemClass || SavedItem.Quantity <= 0)
+		{
+			continue;
+		}
+
+		const int32 NumItemsBefore = Inventory->GetItems().Num();
+		const FItemAddResult AddResult = Inventory->TryAddItemFromClass(ItemClass, SavedItem.Quantity);
+
+		if (AddResult.ActualAmountGiven < SavedItem.Quantity)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Only %d of %d %s from a player save fit in the inventory."), AddResult.ActualAmountGiven, SavedItem.Quantity, *ItemClass->GetName());
+		}
+
+		//Equippables don't stack, a new one is always the last item.
+		const TArray<UItem*> Items = Inventory->GetItems();
+
+		if (Items.Num() > NumItemsBefore)
+		{
+			if (UEquippableItem* Equippable = Cast<UEquippableItem>(Items.Last()))
+			{
+				Equippables.Emplace(Equippable, SavedItem.bEquipped);
+			}
+		}
+	}
+
+	//Adding an equippable equips it if its slot is free, which isn't always the one the player had equipped.
+	for (const TPair<UEquippableItem*, bool>& Equippable : Equippables)
+	{
+		if (Equippable.Key->IsEquipped() && !Equippable.Value)
+		{
+			Equippable.Key->SetEquipped(false);
+		}
+	}
+
+	for (const TPair<UEquippableItem*, bool>& Equippable : Equippables)
+	{
+		if (!Equippable.Key->IsEquipped() && Equippable.Value)
+		{
+			Equippable.Key->SetEquipped(true);
+		}
+	}
+
+	//Dead players don't have a save, so a saved health of zero is a broken one.
+	Character->ModifyHealth(FMath::Max(Save.Health, 1.f) - Character->GetHealth());
+
+	if (AWeapon* Weapon = Character->GetEquippedWeapon())
+	{
+		Weapon->SetCurrentAmmoInClip(Save.AmmoInClip);
+	}
+}
+
+FString USurvivalPlayerSaveSubsystem::GetPlayerId(const ASurvivalCharacter* Character)
+{
+	return GetPlayerId(Character ? Character->GetPlayerState() : nullptr);
+}
+
+FString USurvivalPlayerSaveSubsystem::GetPlayerId(const APlayerState* PlayerState)
+{
+	if (!PlayerState || PlayerState->IsABot() || !PlayerState->GetUniqueId().IsValid())
+	{
+		return FString();
+	}
+
+	return PlayerState->GetUniqueId()->ToString();
+}
+
+bool USurvivalPlayerSaveSubsystem::OnAutosaveTicker(float DeltaTime)
+{
+	const float AutosaveInterval = CVarSurvivalPlayerSaveAutosaveInterval.GetValueOnGameThread();
+
+	if (!IsEnabled() || AutosaveInterval <= 0.f)
+	{
+		AutosaveTime = 0.f;
+		return true;
+	}
+
+	AutosaveTime += DeltaTime;
+
+	if (AutosaveTime >= AutosaveInterval)
+	{
+		AutosaveTime = 0.f;
+		SaveAllPlayers();
+	}
+
+	return true;
+}
+
+void USurvivalPlayerSaveSubsystem::StartLoad(const FString& PlayerId)
+{
+	if (LoadsInFlight.Contains(PlayerId) || LoadedSaves.Contains(PlayerId))
+	{
+		return;
+	}
+
+	//A player who logs out and back in before their first read comes back must not get the answer of the old one.
+	static int32 LastLoadSerial = 0;
+	const int32 LoadSerial = ++LastLoadSerial;
+
+	LoadsInFlight.Add(PlayerId, LoadSerial);
+
+	TWeakObjectPtr<USurvivalPlayerSaveSubsystem> WeakThis(this);
+	TSharedPtr<FSurvivalPlayerSaveQueue, ESPMode::ThreadSafe> Queue = SaveQueue;
+
+	Async(EAsyncExecution::ThreadPool, [WeakThis, Queue, PlayerId, LoadSerial]()
+	{
+		TArray<uint8> Data;
+		Queue->Read(PlayerId, Data);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, PlayerId, LoadSerial, Data = MoveTemp(Data)]() mutable
+		{
+			if (USurvivalPlayerSaveSubsystem* Subsystem = WeakThis.Get())
+			{
+				Subsystem->OnSaveLoaded(PlayerId, LoadSerial, MoveTemp(Data));
+			}
+		});
+	});
+}
+
+void USurvivalPlayerSaveSubsystem::OnSaveLoaded(const FString& PlayerId, const int32 LoadSerial, TArray<uint8>&& Data)
+{
+	const int32* InFlightSerial = LoadsInFlight.Find(PlayerId);
+
+	if (!InFlightSerial || *InFlightSerial != LoadSerial)
+	{
+		return;
+	}
+
+	LoadsInFlight.Remove(PlayerId);
+	LoadedSaves.Add(PlayerId, MoveTemp(Data));
+
+	TWeakObjectPtr<ASurvivalCharacter> Character;
+
+	if (WaitingCharacters.RemoveAndCopyValue(PlayerId, Character) && Character.IsValid() && Character->IsAlive())
+	{
+		ApplyLoadedSave(PlayerId, Character.Get());
+	}
+}
+
+void USurvivalPlayerSaveSubsystem::ApplyLoadedSave(const FString& PlayerId, ASurvivalCharacter* Character)
+{
+	TArray<uint8> Data;
+	LoadedSaves.RemoveAndCopyValue(PlayerId, Data);
+
+	RestoredPlayers.Add(PlayerId);
+
+	//First time on this server.
+	if (Data.Num() == 0)
+	{
+		return;
+	}
+
+	FSurvivalPlayerSave Save;
+
+	if (!Save.FromBytes(Data))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("The save of player %s is broken or from a newer version, they start with nothing."), *PlayerId);
+		return;
+	}
+
+	ApplyToCharacter(Character, Save);
+
+	UE_LOG(LogTemp, Log, TEXT("Restored %d items of player %s from a %d bytes save."), Save.Items.Num(), *PlayerId, Data.Num());
+}
+
+bool USurvivalPlayerSaveSubsystem::IsEnabled() const
+{
+	UWorld* World = GetGameInstance()->GetWorld();
+
+	//Clients never save anything, the server gives them their inventory.
+	return CVarSurvivalPlayerSave.GetValueOnGameThread() != 0 && World && World->GetNetMode() != NM_Client;
+}
+
+#pragma endregion
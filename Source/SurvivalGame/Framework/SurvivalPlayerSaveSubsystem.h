@@ -0,0 +1,204 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "GameFramework/OnlineReplStructs.h"
+#include "Containers/Ticker.h"
+#include "SurvivalPlayerSaveSubsystem.generated.h"
+
+class ASurvivalCharacter;
+
+/*What we keep of a player between two logins: the inventory, which items were equipped, the health and the ammo in the clip.
+
+Saved as a small binary blob: a magic, a version, and then every value packed. Item classes are written once in a table and
+the items only point into it, so a full inventory of the same ammo is a few bytes per item.*/
+struct SURVIVALGAME_API FSurvivalPlayerSave
+{
+	static const uint32 Magic = 0x53505653; //"SVPS"
+
+	/*Bump it when the layout changes. Older versions still have to load.*/
+	static const uint32 LatestVersion = 1;
+
+	struct FItem
+	{
+		/*Index in ItemClasses.*/
+		int32 ClassIndex;
+		int32 Quantity;
+		bool bEquipped;
+	};
+
+	float Health;
+	int32 AmmoInClip;
+
+	TArray<FString> ItemClasses;
+	TArray<FItem> Items;
+
+	FSurvivalPlayerSave();
+
+	void ToBytes(TArray<uint8>& OutData) const;
+
+	/*False if the data isn't a save, or is from a newer version than this build.*/
+	bool FromBytes(const TArray<uint8>& Data);
+};
+
+/*Where the saves end up. Called from the thread pool, so it has to be thread safe.*/
+class SURVIVALGAME_API ISurvivalPlayerSaveStore
+{
+public:
+
+	virtual ~ISurvivalPlayerSaveStore() {}
+
+	virtual bool Write(const FString& PlayerId, const TArray<uint8>& Data) = 0;
+
+	/*False if the player has no save.*/
+	virtual bool Read(const FString& PlayerId, TArray<uint8>& OutData) = 0;
+
+	virtual bool Remove(const FString& PlayerId) = 0;
+};
+
+/*One file per player in a folder. Files are written next to the old one and then moved over it, so a crash never leaves half a save.*/
+class SURVIVALGAME_API FSurvivalPlayerSaveFileStore : public ISurvivalPlayerSaveStore
+{
+public:
+
+	FSurvivalPlayerSaveFileStore(const FString& InDirectory);
+
+	virtual bool Write(const FString& PlayerId, const TArray<uint8>& Data) override;
+	virtual bool Read(const FString& PlayerId, TArray<uint8>& OutData) override;
+	virtual bool Remove(const FString& PlayerId) override;
+
+	FString GetFilename(const FString& PlayerId) const;
+
+private:
+
+	FString Directory;
+};
+
+/*Writes the saves on the thread pool, one at a time. A player saved again before their last save was written only has the
+newest one written. Reads look at the saves still waiting first, so a player who logs out and back in right away gets what
+they left with.*/
+class SURVIVALGAME_API FSurvivalPlayerSaveQueue : public TSharedFromThis<FSurvivalPlayerSaveQueue, ESPMode::ThreadSafe>
+{
+public:
+
+	FSurvivalPlayerSaveQueue(TSharedRef<ISurvivalPlayerSaveStore, ESPMode::ThreadSafe> InStore);
+
+	void Write(const FString& PlayerId, TArray<uint8>&& Data);
+	void Remove(const FString& PlayerId);
+
+	/*Blocks. Call it from the thread pool, not from the game thread.*/
+	bool Read(const FString& PlayerId, TArray<uint8>& OutData);
+
+	/*Blocks until every queued save is written.*/
+	void Flush();
+
+	int32 GetNumWritten() const { return NumWritten; }
+
+private:
+
+	void StartWriter();
+	void WriteQueued();
+
+	TSharedRef<ISurvivalPlayerSaveStore, ESPMode::ThreadSafe> Store;
+
+	FCriticalSection QueueLock;
+
+	/*Saves waiting to be written. An unset value removes the save.*/
+	TMap<FString, TOptional<TArray<uint8>>> Queued;
+
+	/*The save the writer is on, kept until it's written.*/
+	FString WritingPlayerId;
+	TOptional<TArray<uint8>> WritingSave;
+
+	bool bWriterRunning;
+
+	TAtomic<int32> NumWritten;
+};
+
+/*Keeps the players inventories between logins and server restarts, keyed by their unique net id.
+
+The save is read off the game thread as soon as the player logs in (PostLogin), and applied when their character spawns (Restart).
+Characters are saved when their player leaves the game (ASurvivalPlayerController::PawnLeavingGame), when the server stops and every Survival.PlayerSave.AutosaveInterval seconds, a dead character removes
+the save since its items stay on the body. Only the first character of a login is restored, respawns start with nothing.
+
+The saves are in Saved/PlayerSaves, or in the folder given with -PlayerSaveDir=<path>.*/
+UCLASS()
+class SURVIVALGAME_API USurvivalPlayerSaveSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	USurvivalPlayerSaveSubsystem();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/*Starts reading the save of a player who just logged in.*/
+	void PrefetchPlayer(const FUniqueNetIdRepl& UniqueId);
+
+	/*Gives the character what the player had when they left. If the save isn't read yet it's applied when it is.*/
+	void RestorePlayer(ASurvivalCharacter* Character);
+
+	/*Queues a save of the character. Only characters that were restored can be saved, so we don't overwrite a save we didn't apply yet.*/
+	void SavePlayer(ASurvivalCharacter* Character);
+
+	/*Same, for the player of this player state. A character that is destroyed with its controller lost its own player state
+	before it ends play, so the controller saves it with its own when the player leaves.*/
+	void SavePlayer(ASurvivalCharacter* Character, const class APlayerState* PlayerState);
+
+	/*The character died and left everything on its body.*/
+	void ClearPlayer(ASurvivalCharacter* Character);
+
+	/*The player logged out, their next login restores again.*/
+	void ForgetPlayer(const FUniqueNetIdRepl& UniqueId);
+
+	/*Saves every living player character.*/
+	UFUNCTION(BlueprintCallable, Category = "Player Save")
+	void SaveAllPlayers();
+
+	/*Reads the character into a save. Game thread only.*/
+	static void CaptureCharacter(const ASurvivalCharacter* Character, FSurvivalPlayerSave& OutSave);
+
+	/*Replaces the inventory, the equipped items, the health and the clip of the character with the ones of the save. Server only.*/
+	static void ApplyToCharacter(ASurvivalCharacter* Character, const FSurvivalPlayerSave& Save);
+
+	/*The unique net id of the player controlling the character, empty for bots.*/
+	static FString GetPlayerId(const ASurvivalCharacter* Character);
+	static FString GetPlayerId(const class APlayerState* PlayerState);
+
+protected:
+
+	TSharedPtr<FSurvivalPlayerSaveQueue, ESPMode::ThreadSafe> SaveQueue;
+
+	/*Saves read and not applied yet. An empty array means the player has no save.*/
+	TMap<FString, TArray<uint8>> LoadedSaves;
+
+	/*Players whose save is being read, with the number of the read so a late answer to an older one is ignored.*/
+	TMap<FString, int32> LoadsInFlight;
+
+	/*Characters that spawned before their save was read.*/
+	TMap<FString, TWeakObjectPtr<ASurvivalCharacter>> WaitingCharacters;
+
+	/*Players whose save was applied this login.*/
+	TSet<FString> RestoredPlayers;
+
+	float AutosaveTime;
+
+	FDelegateHandle AutosaveTickerHandle;
+
+	bool OnAutosaveTicker(float DeltaTime);
+
+	void StartLoad(const FString& PlayerId);
+	void OnSaveLoaded(const FString& PlayerId, const int32 LoadSerial, TArray<uint8>&& Data);
+
+	void ApplyLoadedSave(const FString& PlayerId, ASurvivalCharacter* Character);
+
+	bool IsEnabled() const;
+};
@@ -0,0 +1,38 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "SurvivalReplayConnection.h"
+
+USurvivalReplayConnection::USurvivalReplayConnection()
+{
+	JournalConnectionId = 0;
+}
+
+void USurvivalReplayConnection::InitConnection(UNetDriver* InDriver, EConnectionState InState, const FURL& InURL, int32 InConnectionSpeed, int32 InMaxPacket)
+{
+	Super::InitConnection(InDriver, InState, InURL, InConnectionSpeed, InMaxPacket);
+
+	//Nobody is going to acknowledge our packets, so we do it ourselves. Otherwise the reliable buffer fills up and the connection times out.
+	InternalAck = true;
+
+	InitSendBuffer();
+}
+
+void USurvivalReplayConnection::LowLevelSend(void* Data, int32 CountBits, FOutPacketTraits& Traits)
+{
+	//The server already did all the work of building the packet, that's the load we wanted to reproduce.
+}
+
+FString USurvivalReplayConnection::LowLevelGetRemoteAddress(bool bAppendPort)
+{
+	return FString::Printf(TEXT("Replay%u"), JournalConnectionId);
+}
+
+FString USurvivalReplayConnection::LowLevelDescribe()
+{
+	return FString::Printf(TEXT("Replay connection %u"), JournalConnectionId);
+}
@@ -0,0 +1,32 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetConnection.h"
+#include "SurvivalReplayConnection.generated.h"
+
+/*A client connection without a client, used by USurvivalServerReplaySubsystem to play a journaled player.
+The server replicates to it like to any other player, but the packets go nowhere and everything counts as acknowledged,
+the same way the engine does with replay recording connections.*/
+UCLASS(Transient)
+class SURVIVALGAME_API USurvivalReplayConnection : public UNetConnection
+{
+	GENERATED_BODY()
+
+public:
+
+	USurvivalReplayConnection();
+
+	virtual void InitConnection(UNetDriver* InDriver, EConnectionState InState, const FURL& InURL, int32 InConnectionSpeed = 0, int32 InMaxPacket = 0) override;
+	virtual void LowLevelSend(void* Data, int32 CountBits, FOutPacketTraits& Traits) override;
+	virtual FString LowLevelGetRemoteAddress(bool bAppendPort = false) override;
+	virtual FString LowLevelDescribe() override;
+
+	/*The id of the journaled connection we are playing.*/
+	uint32 JournalConnectionId;
+};
@@ -0,0 +1,366 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "SurvivalServerBrowserSubsystem.h"
+
+#include "FindSessionsCallbackProxyAdvanced.h"
+#include "OnlineSessionSettings.h"
+#include "Engine/GameInstance.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+
+USurvivalServerBrowserSubsystem::USurvivalServerBrowserSubsystem()
+{
+	MaxMissedRefreshes = 3;
+	ActiveSearch = nullptr;
+}
+
+bool USurvivalServerBrowserSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	//Servers don't browse servers.
+	return !IsRunningDedicatedServer();
+}
+
+void USurvivalServerBrowserSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	LoadServerList();
+}
+
+void USurvivalServerBrowserSubsystem::Deinitialize()
+{
+	if (ActiveSearch)
+	{
+		ActiveSearch->OnResultsFound.RemoveAll(this);
+		ActiveSearch->OnSuccess.RemoveAll(this);
+		ActiveSearch->OnFailure.RemoveAll(this);
+		ActiveSearch = nullptr;
+	}
+
+	Super::Deinitialize();
+}
+
+#pragma region Refresh
+
+void USurvivalServerBrowserSubsystem::RefreshServerList(APlayerController* PlayerController, int32 MaxResults, bool bUseLAN)
+{
+	if (ActiveSearch)
+	{
+		return;
+	}
+
+	FoundThisRefresh.Empty();
+
+	UObject* WorldContextObject = PlayerController ? static_cast<UObject*>(PlayerController) : static_cast<UObject*>(GetGameInstance());
+
+	ActiveSearch = UFindSessionsCallbackProxyAdvanced::FindSessionsAdvanced(WorldContextObject, PlayerController, MaxResults, bUseLAN, EBPServerPresenceSearchType::AllServers, TArray<FSessionsSearchSetting>());
+	ActiveSearch->OnResultsFound.AddDynamic(this, &USurvivalServerBrowserSubsystem::OnSearchResultsFound);
+	ActiveSearch->OnSuccess.AddDynamic(this, &USurvivalServerBrowserSubsystem::OnSearchCompleted);
+	ActiveSearch->OnFailure.AddDynamic(this, &USurvivalServerBrowserSubsystem::OnSearchFailed);
+	ActiveSearch->Activate();
+}
+
+void USurvivalServerBrowserSubsystem::OnSearchResultsFound(const TArray<FBlueprintSessionResult>& Results)
+{
+	for (const FBlueprintSessionResult& Result : Results)
+	{
+		MergeResult(Result);
+	}
+
+	OnServerListUpdated.Broadcast();
+}
+
+void USurvivalServerBrowserSubsystem::OnSearchCompleted(const TArray<FBlueprintSessionResult>& Results)
+{
+	//Every result already came through OnResultsFound, this only ends the refresh.
+	FinishRefresh();
+}
+
+void USurvivalServerBrowserSubsystem::OnSearchFailed(const TArray<FBlueprintSessionResult>& Results)
+{
+	UE_LOG(LogTemp, Warning, TEXT("Server browser refresh failed, keeping the servers we already know."));
+
+	//A failed search says nothing about the servers, don't age them for it.
+	FoundThisRefresh.Empty();
+	ActiveSearch = nullptr;
+	OnServerListUpdated.Broadcast();
+}
+
+void USurvivalServerBrowserSubsystem::MergeResult(const FBlueprintSessionResult& Result)
+{
+	const FOnlineSessionSearchResult& OnlineResult = Result.OnlineResult;
+	if (!OnlineResult.IsValid())
+	{
+		return;
+	}
+
+	const FString SessionId = OnlineResult.GetSessionIdStr();
+	const FOnlineSessionSettings& SessionSettings = OnlineResult.Session.SessionSettings;
+
+	FSurvivalServerEntry& Entry = Servers.FindOrAdd(SessionId);
+	Entry.SessionId = SessionId;
+	Entry.ServerName = OnlineResult.Session.OwningUserName;
+	Entry.PingInMs = OnlineResult.PingInMs;
+	Entry.MaxPlayers = SessionSettings.NumPublicConnections;
+	Entry.CurrentPlayers = SessionSettings.NumPublicConnections - OnlineResult.Session.NumOpenPublicConnections;
+	Entry.bIsDedicated = SessionSettings.bIsDedicated;
+	Entry.LastSeen = FDateTime::UtcNow();
+	Entry.bIsLive = true;
+	Entry.Session = Result;
+	Entry.MissedRefreshes = 0;
+
+	Entry.Settings.Empty(SessionSettings.Settings.Num());
+	for (const TPair<FName, FOnlineSessionSetting>& Setting : SessionSettings.Settings)
+	{
+		Entry.Settings.Add(Setting.Key, Setting.Value.Data.ToString());
+	}
+
+	FoundThisRefresh.Add(SessionId);
+}
+
+void USurvivalServerBrowserSubsystem::FinishRefresh()
+{
+	ActiveSearch = nullptr;
+
+	for (auto It = Servers.CreateIterator(); It; ++It)
+	{
+		FSurvivalServerEntry& Entry = It.Value();
+		if (FoundThisRefresh.Contains(It.Key()))
+		{
+			continue;
+		}
+
+		//The search result we had is stale now, it can't be used to join.
+		Entry.bIsLive = false;
+		Entry.Session = FBlueprintSessionResult();
+
+		if (++Entry.MissedRefreshes >= MaxMissedRefreshes)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	FoundThisRefresh.Empty();
+
+	SaveServerList();
+	OnServerListUpdated.Broadcast();
+}
+
+#pragma endregion
+
+#pragma region Queries
+
+TArray<FSurvivalServerEntry> USurvivalServerBrowserSubsystem::GetServers(const FSurvivalServerFilter& Filter, EServerSortMode SortMode, bool bDescending) const
+{
+	TArray<FSurvivalServerEntry> Result;
+	Result.Reserve(Servers.Num());
+
+	for (const TPair<FString, FSurvivalServerEntry>& Pair : Servers)
+	{
+		const FSurvivalServerEntry& Entry = Pair.Value;
+
+		if (Filter.MaxPing > 0 && Entry.PingInMs > Filter.MaxPing)
+			continue;
+
+		if (Filter.bHideFull && Entry.MaxPlayers > 0 && Entry.CurrentPlayers >= Entry.MaxPlayers)
+			continue;
+
+		if (Filter.bHideEmpty && Entry.CurrentPlayers <= 0)
+			continue;
+
+		if (Filter.bOnlyLive && !Entry.bIsLive)
+			continue;
+
+		bool bHasRequiredSettings = true;
+		for (const TPair<FName, FString>& RequiredSetting : Filter.RequiredSettings)
+		{
+			const FString* Value = Entry.Settings.Find(RequiredSetting.Key);
+			if (!Value || *Value != RequiredSetting.Value)
+			{
+				bHasRequiredSettings = false;
+				break;
+			}
+		}
+
+		if (bHasRequiredSettings)
+		{
+			Result.Add(Entry);
+		}
+	}
+
+	//Ties go by name, so the list doesn't jump around between refreshes.
+	Result.Sort([SortMode, bDescending](const FSurvivalServerEntry& A, const FSurvivalServerEntry& B)
+	{
+		int32 Compare = 0;
+		switch (SortMode)
+		{
+		case EServerSortMode::SSM_Ping:
+			Compare = A.PingInMs - B.PingInMs;
+			break;
+		case EServerSortMode::SSM_Players:
+			Compare = A.CurrentPlayers - B.CurrentPlayers;
+			break;
+		default:
+			break;
+		}
+
+		if (Compare == 0)
+		{
+			Compare = A.ServerName.Compare(B.ServerName, ESearchCase::IgnoreCase);
+		}
+
+		if (Compare == 0)
+		{
+			Compare = A.SessionId.Compare(B.SessionId);
+		}
+
+		return bDescending ? Compare > 0 : Compare < 0;
+	});
+
+	return Result;
+}
+
+bool USurvivalServerBrowserSubsystem::GetServerSession(const FString& SessionId, FBlueprintSessionResult& OutSession) const
+{
+	const FSurvivalServerEntry* Entry = Servers.Find(SessionId);
+	if (!Entry || !Entry->bIsLive)
+	{
+		return false;
+	}
+
+	OutSession = Entry->Session;
+	return true;
+}
+
+void USurvivalServerBrowserSubsystem::ClearServerList()
+{
+	Servers.Empty();
+	FoundThisRefresh.Empty();
+
+	IFileManager::Get().Delete(*GetServerListPath(), false, false, true);
+	OnServerListUpdated.Broadcast();
+}
+
+#pragma endregion
+
+#pragma region Disk
+
+FString USurvivalServerBrowserSubsystem::GetServerListPath() const
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ServerBrowser"), TEXT("ServerList.json"));
+}
+
+void USurvivalServerBrowserSubsystem::SaveServerList() const
+{
+	TArray<TSharedPtr<FJsonValue>> ServerValues;
+
+	for (const TPair<FString, FSurvivalServerEntry>& Pair : Servers)
+	{
+		const FSurvivalServerEntry& Entry = Pair.Value;
+
+		TSharedRef<FJsonObject> ServerObject = MakeShared<FJsonObject>();
+		ServerObject->SetStringField(TEXT("SessionId"), Entry.SessionId);
+		ServerObject->SetStringField(TEXT("ServerName"), Entry.ServerName);
+		ServerObject->SetNumberField(TEXT("PingInMs"), Entry.PingInMs);
+		ServerObject->SetNumberField(TEXT("CurrentPlayers"), Entry.CurrentPlayers);
+		ServerObject->SetNumberField(TEXT("MaxPlayers"), Entry.MaxPlayers);
+		ServerObject->SetBoolField(TEXT("IsDedicated"), Entry.bIsDedicated);
+		ServerObject->SetStringField(TEXT("LastSeen"), Entry.LastSeen.ToIso8601());
+		ServerObject->SetNumberField(TEXT("MissedRefreshes"), Entry.MissedRefreshes);
+
+		TSharedRef<FJsonObject> SettingsObject = MakeShared<FJsonObject>();
+		for (const TPair<FName, FString>& Setting : Entry.Settings)
+		{
+			SettingsObject->SetStringField(Setting.Key.ToString(), Setting.Value);
+		}
+		ServerObject->SetObjectField(TEXT("Settings"), SettingsObject);
+
+		ServerValues.Add(MakeShared<FJsonValueObject>(ServerObject));
+	}
+
+	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetArrayField(TEXT("Servers"), ServerValues);
+
+	FString JsonText;
+	TSharedRef<TJsonWriter<>> JsonWriter = TJsonWriterFactory<>::Create(&JsonText);
+	FJsonSerializer::Serialize(Root, JsonWriter);
+
+	FFileHelper::SaveStringToFile(JsonText, *GetServerListPath(), FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+}
+
+void USurvivalServerBrowserSubsystem::LoadServerList()
+{
+	FString JsonText;
+	if (!FFileHelper::LoadFileToString(JsonText, *GetServerListPath()))
+	{
+		return;
+	}
+
+	TSharedPtr<FJsonObject> Root;
+	TSharedRef<TJsonReader<>> JsonReader = TJsonReaderFactory<>::Create(JsonText);
+	if (!FJsonSerializer::Deserialize(JsonReader, Root) || !Root.IsValid())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Couldn't read the server list in %s, starting with an empty one."), *GetServerListPath());
+		return;
+	}
+
+	const TArray<TSharedPtr<FJsonValue>>* ServerValues = nullptr;
+	if (!Root->TryGetArrayField(TEXT("Servers"), ServerValues))
+	{
+		return;
+	}
+
+	for (const TSharedPtr<FJsonValue>& ServerValue : *ServerValues)
+	{
+		const TSharedPtr<FJsonObject>* ServerObject = nullptr;
+		if (!ServerValue->TryGetObject(ServerObject))
+		{
+			continue;
+		}
+
+		FSurvivalServerEntry Entry;
+		if (!(*ServerObject)->TryGetStringField(TEXT("SessionId"), Entry.SessionId) || Entry.SessionId.IsEmpty())
+		{
+			continue;
+		}
+
+		(*ServerObject)->TryGetStringField(TEXT("ServerName"), Entry.ServerName);
+		(*ServerObject)->TryGetNumberField(TEXT("PingInMs"), Entry.PingInMs);
+		(*ServerObject)->TryGetNumberField(TEXT("CurrentPlayers"), Entry.CurrentPlayers);
+		(*ServerObject)->TryGetNumberField(TEXT("MaxPlayers"), Entry.MaxPlayers);
+		(*ServerObject)->TryGetBoolField(TEXT("IsDedicated"), Entry.bIsDedicated);
+		(*ServerObject)->TryGetNumberField(TEXT("MissedRefreshes"), Entry.MissedRefreshes);
+
+		FString LastSeen;
+		if ((*ServerObject)->TryGetStringField(TEXT("LastSeen"), LastSeen))
+		{
+			FDateTime::ParseIso8601(*LastSeen, Entry.LastSeen);
+		}
+
+		const TSharedPtr<FJsonObject>* SettingsObject = nullptr;
+		if ((*ServerObject)->TryGetObjectField(TEXT("Settings"), SettingsObject))
+		{
+			for (const TPair<FString, TSharedPtr<FJsonValue>>& Setting : (*SettingsObject)->Values)
+			{
+				Entry.Settings.Add(FName(*Setting.Key), Setting.Value->AsString());
+			}
+		}
+
+		//We can only show it until a refresh finds it again.
+		Entry.bIsLive = false;
+		Servers.Add(Entry.SessionId, Entry);
+	}
+}
+
+#pragma endregion
@@ -0,0 +1,174 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "FindSessionsCallbackProxy.h"
+#include "SurvivalServerBrowserSubsystem.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnServerListUpdated);
+
+//How the server browser orders the list. SSM = Server Sort Mode.
+UENUM(BlueprintType)
+enum class EServerSortMode : uint8
+{
+	SSM_Ping		UMETA(DisplayName = "Ping"),
+	SSM_Players		UMETA(DisplayName = "Players"),
+	SSM_Name		UMETA(DisplayName = "Name")
+};
+
+/*A server we know about, from this refresh or a previous one.*/
+USTRUCT(BlueprintType)
+struct FSurvivalServerEntry
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY(BlueprintReadOnly, Category = "Server Browser")
+	FString SessionId;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Server Browser")
+	FString ServerName;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Server Browser")
+	int32 PingInMs = 9999;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Server Browser")
+	int32 CurrentPlayers = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Server Browser")
+	int32 MaxPlayers = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Server Browser")
+	bool bIsDedicated = false;
+
+	/*The extra settings the server advertises, as text.*/
+	UPROPERTY(BlueprintReadOnly, Category = "Server Browser")
+	TMap<FName, FString> Settings;
+
+	/*When a search found it the last time (UTC).*/
+	UPROPERTY(BlueprintReadOnly, Category = "Server Browser")
+	FDateTime LastSeen;
+
+	/*True if the last refresh found it, so Session can be joined. Servers loaded from disk are not live until a refresh finds them.*/
+	UPROPERTY(BlueprintReadOnly, Category = "Server Browser")
+	bool bIsLive = false;
+
+	/*Only valid while bIsLive.*/
+	UPROPERTY(BlueprintReadOnly, Category = "Server Browser")
+	FBlueprintSessionResult Session;
+
+	/*Refreshes in a row that didn't find it. Forgotten after MaxMissedRefreshes.*/
+	int32 MissedRefreshes = 0;
+};
+
+/*What the server browser shows. Everything is applied to the cached list, without searching again.*/
+USTRUCT(BlueprintType)
+struct FSurvivalServerFilter
+{
+	GENERATED_BODY()
+
+public:
+
+	/*0 shows every ping.*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Server Browser")
+	int32 MaxPing = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Server Browser")
+	bool bHideFull = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Server Browser")
+	bool bHideEmpty = false;
+
+	/*Hides the servers loaded from disk that the last refresh didn't find.*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Server Browser")
+	bool bOnlyLive = false;
+
+	/*Settings the server must advertise with exactly these values.*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Server Browser")
+	TMap<FName, FString> RequiredSettings;
+};
+
+/*Keeps the server list between server browser openings, instead of searching from scratch every time.
+
+Refresh searches again and merges what it finds: known servers get their new ping and players, new servers are added
+and servers that stop showing up are forgotten after a few refreshes. OnServerListUpdated fires with every search batch,
+so the browser can redraw while the slower search is still running.
+The list is saved to Saved/ServerBrowser when a refresh ends, and loaded when the game starts, so the browser has
+something to show right away. Those servers can't be joined until a refresh finds them again (bIsLive).*/
+UCLASS()
+class SURVIVALGAME_API USurvivalServerBrowserSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	USurvivalServerBrowserSubsystem();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/*Fires every time the list changes: a search batch arrived, a refresh ended or the list was cleared.*/
+	UPROPERTY(BlueprintAssignable, Category = "Server Browser")
+	FOnServerListUpdated OnServerListUpdated;
+
+	/*Searches for servers and merges them into the list. Does nothing if a refresh is already running.*/
+	UFUNCTION(BlueprintCallable, Category = "Server Browser")
+	void RefreshServerList(APlayerController* PlayerController, int32 MaxResults = 100, bool bUseLAN = false);
+
+	UFUNCTION(BlueprintPure, Category = "Server Browser")
+	bool IsRefreshing() const { return ActiveSearch != nullptr; }
+
+	/*The cached servers that pass the filter, sorted. Doesn't search.*/
+	UFUNCTION(BlueprintCallable, Category = "Server Browser")
+	TArray<FSurvivalServerEntry> GetServers(const FSurvivalServerFilter& Filter, EServerSortMode SortMode = EServerSortMode::SSM_Ping, bool bDescending = false) const;
+
+	/*The session to join for this server, false if the last refresh didn't find it.*/
+	UFUNCTION(BlueprintCallable, Category = "Server Browser")
+	bool GetServerSession(const FString& SessionId, FBlueprintSessionResult& OutSession) const;
+
+	/*Forgets every server, on disk too.*/
+	UFUNCTION(BlueprintCallable, Category = "Server Browser")
+	void ClearServerList();
+
+protected:
+
+	/*Servers that a refresh didn't find are forgotten after this many refreshes in a row.*/
+	int32 MaxMissedRefreshes;
+
+	/*By session id.*/
+	TMap<FString, FSurvivalServerEntry> Servers;
+
+	/*Servers found by the refresh that is running.*/
+	TSet<FString> FoundThisRefresh;
+
+	UPROPERTY(Transient)
+	class UFindSessionsCallbackProxyAdvanced* ActiveSearch;
+
+	UFUNCTION()
+	void OnSearchResultsFound(const TArray<FBlueprintSessionResult>& Results);
+
+	UFUNCTION()
+	void OnSearchCompleted(const TArray<FBlueprintSessionResult>& Results);
+
+	UFUNCTION()
+	void OnSearchFailed(const TArray<FBlueprintSessionResult>& Results);
+
+	/*Updates the server if we know it already, adds it if we don't.*/
+	void MergeResult(const FBlueprintSessionResult& Result);
+
+	/*Ages the servers this refresh didn't find and saves the list.*/
+	void FinishRefresh();
+
+	FString GetServerListPath() const;
+
+	void SaveServerList() const;
+	void LoadServerList();
+};
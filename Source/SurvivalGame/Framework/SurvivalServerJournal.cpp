@@ -0,0 +1,146 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "SurvivalServerJournal.h"
+
+#include "Misc/Paths.h"
+#include "UObject/UnrealType.h"
+
+void FJournalObjectDescriptor::Serialize(FArchive& Ar)
+{
+	uint8 KindValue = (uint8)Kind;
+	Ar << KindValue;
+	Kind = (EJournalObject)KindValue;
+
+	switch (Kind)
+	{
+	case EJournalObject::JO_Path:
+		Ar << Path;
+		break;
+	case EJournalObject::JO_Controller:
+	case EJournalObject::JO_Pawn:
+		Ar.SerializeIntPacked(ConnectionId);
+		break;
+	case EJournalObject::JO_Item:
+	case EJournalObject::JO_OwnedActor:
+		Ar.SerializeIntPacked(OuterId);
+		Ar << Path;
+		Ar.SerializeIntPacked(Index);
+		break;
+	case EJournalObject::JO_Actor:
+		Ar << Path;
+		Ar << Location;
+		break;
+	case EJournalObject::JO_Subobject:
+		Ar.SerializeIntPacked(OuterId);
+		UPackageMap::StaticSerializeName(Ar, Name);
+		break;
+	}
+}
+
+void FSurvivalServerJournal::SerializeValue(FArchive& Ar, UPackageMap* PackageMap, FProperty* Property, void* Data)
+{
+	if (FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property))
+	{
+		FScriptArrayHelper ArrayHelper(ArrayProperty, Data);
+
+		uint16 ArrayNum = ArrayHelper.Num();
+		Ar << ArrayNum;
+
+		if (Ar.IsLoading())
+		{
+			ArrayHelper.Resize(ArrayNum);
+		}
+
+		for (int32 i = 0; i < ArrayHelper.Num(); ++i)
+		{
+			SerializeValue(Ar, PackageMap, ArrayProperty->Inner, ArrayHelper.GetRawPtr(i));
+		}
+	}
+	else if (FStructProperty* StructProperty = CastField<FStructProperty>(Property))
+	{
+		//Same as the replication layout: structs with their own NetSerialize write themselves, the rest field by field.
+		if (StructProperty->Struct->StructFlags & STRUCT_NetSerializeNative)
+		{
+			StructProperty->NetSerializeItem(Ar, PackageMap, Data);
+		}
+		else
+		{
+			for (TFieldIterator<FProperty> It(StructProperty->Struct); It; ++It)
+			{
+				if (It->HasAnyPropertyFlags(CPF_RepSkip))
+				{
+					continue;
+				}
+
+				for (int32 Index = 0; Index < It->ArrayDim; ++Index)
+				{
+					SerializeValue(Ar, PackageMap, *It, It->ContainerPtrToValuePtr<void>(Data, Index));
+				}
+			}
+		}
+	}
+	else if (Property->IsA<FNameProperty>())
+	{
+		UPackageMap::StaticSerializeName(Ar, *static_cast<FName*>(Data));
+	}
+	else
+	{
+		//Object properties ask the package map to write the reference.
+		Property->NetSerializeItem(Ar, PackageMap, Data);
+	}
+}
+
+void FSurvivalServerJournal::SerializeParameters(FArchive& Ar, UPackageMap* PackageMap, UFunction* Function, void* Parameters)
+{
+	for (TFieldIterator<FProperty> It(Function); It && It->HasAnyPropertyFlags(CPF_Parm); ++It)
+	{
+		if (It->HasAnyPropertyFlags(CPF_ReturnParm))
+		{
+			continue;
+		}
+
+		for (int32 Index = 0; Index < It->ArrayDim; ++Index)
+		{
+			SerializeValue(Ar, PackageMap, *It, It->ContainerPtrToValuePtr<void>(Parameters, Index));
+		}
+	}
+}
+
+FString FSurvivalServerJournal::GetJournalDirectory()
+{
+	return FPaths::Combine(FPaths::ProfilingDir(), TEXT("SurvivalJournal"));
+}
+
+bool USurvivalJournalPackageMap::SerializeObject(FArchive& Ar, UClass* InClass, UObject*& Obj, FNetworkGUID* OutNetGUID)
+{
+	uint32 ObjectId = 0;
+
+	if (Ar.IsSaving())
+	{
+		ObjectId = GetObjectId ? GetObjectId(Obj) : 0;
+		Ar.SerializeIntPacked(ObjectId);
+	}
+	else
+	{
+		Ar.SerializeIntPacked(ObjectId);
+		Obj = ResolveObject ? ResolveObject(ObjectId) : nullptr;
+
+		//A replay can find an object of another class in the same place, better nothing than the wrong type.
+		if (Obj && InClass && !Obj->IsA(InClass))
+		{
+			Obj = nullptr;
+		}
+	}
+
+	if (OutNetGUID)
+	{
+		*OutNetGUID = FNetworkGUID(ObjectId);
+	}
+
+	return true;
+}
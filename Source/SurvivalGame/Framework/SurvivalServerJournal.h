@@ -0,0 +1,97 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/CoreNet.h"
+#include "SurvivalServerJournal.generated.h"
+
+/*The records of a server journal. Every record is its type, its size in bits (packed) and a bit stream.*/
+enum class EJournalRecord : uint8
+{
+	JR_Connect,
+	JR_Disconnect,
+	JR_Object,
+	JR_RPC
+};
+
+/*How an object referenced by the journal is found again on the replay server. JO = Journal Object.*/
+enum class EJournalObject : uint8
+{
+	/*Placed in the map or an asset, found by its path.*/
+	JO_Path,
+	/*The player controller of a journaled connection.*/
+	JO_Controller,
+	/*Whatever pawn the player controller of a journaled connection has right now.*/
+	JO_Pawn,
+	/*An item, by its class and its place among the items of the same class of its inventory.*/
+	JO_Item,
+	/*An actor owned by another journaled object, by its class and its place among the owned actors of that class.*/
+	JO_OwnedActor,
+	/*An actor without an owner, the closest one of its class to where it was.*/
+	JO_Actor,
+	/*Anything else, by its name inside another journaled object.*/
+	JO_Subobject
+};
+
+/*Everything the replay needs to find a journaled object again.*/
+struct FJournalObjectDescriptor
+{
+	EJournalObject Kind = EJournalObject::JO_Path;
+
+	/*The journal id of the inventory, owner or outer this object belongs to.*/
+	uint32 OuterId = 0;
+
+	/*The connection of the controller or pawn.*/
+	uint32 ConnectionId = 0;
+
+	/*Path of the object, or of its class.*/
+	FString Path;
+
+	FName Name;
+
+	uint32 Index = 0;
+
+	FVector Location = FVector::ZeroVector;
+
+	void Serialize(FArchive& Ar);
+};
+
+/*The format of the server journal, shared by USurvivalServerJournalSubsystem (writes it) and USurvivalServerReplaySubsystem (reads it).
+
+File: Magic, Version, the map name and then the records until the end of the file.
+Values are written the way the replication layout writes them, so a journal takes about what the clients sent us.*/
+class SURVIVALGAME_API FSurvivalServerJournal
+{
+public:
+
+	static const uint32 Magic = 0x4A525653; //SVRJ
+	static const uint32 Version = 1;
+
+	/*Writes or reads one value. Object references go through the package map of the archive.*/
+	static void SerializeValue(FArchive& Ar, UPackageMap* PackageMap, FProperty* Property, void* Data);
+
+	/*Writes or reads every parameter of an RPC. Parameters must be initialized before reading.*/
+	static void SerializeParameters(FArchive& Ar, UPackageMap* PackageMap, UFunction* Function, void* Parameters);
+
+	/*Saved/Profiling/SurvivalJournal*/
+	static FString GetJournalDirectory();
+};
+
+/*Writes journaled objects as their journal id, and reads them back as the object the replay found for that id.*/
+UCLASS(Transient)
+class SURVIVALGAME_API USurvivalJournalPackageMap : public UPackageMap
+{
+	GENERATED_BODY()
+
+public:
+
+	TFunction<uint32(UObject*)> GetObjectId;
+	TFunction<UObject*(uint32)> ResolveObject;
+
+	virtual bool SerializeObject(FArchive& Ar, UClass* InClass, UObject*& Obj, FNetworkGUID* OutNetGUID = nullptr) override;
+};
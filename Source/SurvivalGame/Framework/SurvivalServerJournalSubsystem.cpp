@@ -0,0 +1,481 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "SurvivalServerJournalSubsystem.h"
+
+#include "EngineUtils.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryWriter.h"
+#include "UObject/UObjectHash.h"
+
+#include "Components/InventoryComponent.h"
+#include "Items/Item.h"
+
+static TAutoConsoleVariable<int32> CVarSurvivalJournal(
+	TEXT("Survival.Journal"),
+	0,
+	TEXT("Journals the Server RPCs and movement of every connection to Saved/Profiling/SurvivalJournal, to replay them later.\n")
+	TEXT("0: off, 1: on"),
+	ECVF_Default);
+
+int32 USurvivalServerJournalSubsystem::NumOpenJournals = 0;
+int32 USurvivalServerJournalSubsystem::ServerRPCDepth = 0;
+
+USurvivalServerJournalSubsystem::USurvivalServerJournalSubsystem()
+{
+	JournalWriter = nullptr;
+	PackageMap = nullptr;
+
+	NextConnectionId = 1;
+	NextObjectId = 1;
+	StartTime = 0.0;
+	LastRecordTime = 0;
+	NumRecordedRPCs = 0;
+	FlushTime = 0.f;
+	bDispatchingPackets = false;
+}
+
+bool USurvivalServerJournalSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && !IsRunningClientOnly();
+}
+
+void USurvivalServerJournalSubsystem::Deinitialize()
+{
+	StopJournal();
+
+	Super::Deinitialize();
+}
+
+bool USurvivalServerJournalSubsystem::IsJournalEnabled()
+{
+	static const bool bEnabledFromCommandLine = FParse::Param(FCommandLine::Get(), TEXT("SurvivalJournal"));
+	return bEnabledFromCommandLine || CVarSurvivalJournal.GetValueOnGameThread() != 0;
+}
+
+bool USurvivalServerJournalSubsystem::IsTickable() const
+{
+	//Keep ticking while a journal is open, so turning it off closes the file.
+	return (IsJournalEnabled() || JournalWriter) && !HasAnyFlags(RF_ClassDefaultObject);
+}
+
+TStatId USurvivalServerJournalSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USurvivalServerJournalSubsystem, STATGROUP_Tickables);
+}
+
+void USurvivalServerJournalSubsystem::Tick(float DeltaTime)
+{
+	UNetDriver* NetDriver = GetWorld() ? GetWorld()->GetNetDriver() : nullptr;
+
+	if (!IsJournalEnabled() || !NetDriver || !NetDriver->IsServer())
+	{
+		StopJournal();
+		return;
+	}
+
+	if (!JournalWriter)
+	{
+		StartJournal();
+	}
+
+	UpdateConnections();
+	FlushRecords();
+
+	//If the server crashes in the middle of a hitch we still want the journal until there.
+	FlushTime += FApp::GetDeltaTime();
+
+	if (JournalWriter && FlushTime >= 1.f)
+	{
+		JournalWriter->Flush();
+		FlushTime = 0.f;
+	}
+}
+
+#pragma region Journal File
+
+void USurvivalServerJournalSubsystem::StartJournal()
+{
+	const FString Directory = FSurvivalServerJournal::GetJournalDirectory();
+	IFileManager::Get().MakeDirectory(*Directory, true);
+
+	FString MapName = GetWorld()->GetMapName();
+	MapName.RemoveFromStart(GetWorld()->StreamingLevelsPrefix);
+
+	const FString FilePath = FPaths::Combine(Directory, FString::Printf(TEXT("%s_%s.journal"), *MapName, *FDateTime::Now().ToString()));
+
+	JournalWriter = IFileManager::Get().CreateFileWriter(*FilePath, FILEWRITE_AllowRead);
+
+	if (!JournalWriter)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Couldn't create the server journal %s."), *FilePath);
+		return;
+	}
+
+	PackageMap = NewObject<USurvivalJournalPackageMap>(this);
+	PackageMap->GetObjectId = [this](UObject* Object) { return GetObjectId(Object); };
+
+	StartTime = GetWorld()->GetRealTimeSeconds();
+	LastRecordTime = 0;
+	NextConnectionId = 1;
+	NextObjectId = 1;
+	NumRecordedRPCs = 0;
+	NumOpenJournals++;
+
+	WorldTickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &USurvivalServerJournalSubsystem::OnWorldTickStart);
+	WorldPreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &USurvivalServerJournalSubsystem::OnWorldPreActorTick);
+
+	FMemoryWriter Header(PendingRecords, false, true);
+
+	uint32 Magic = FSurvivalServerJournal::Magic;
+	uint32 Version = FSurvivalServerJournal::Version;
+	Header << Magic;
+	Header << Version;
+	Header << MapName;
+
+	UE_LOG(LogTemp, Log, TEXT("Journaling the server to %s"), *FilePath);
+}
+
+void USurvivalServerJournalSubsystem::StopJournal()
+{
+	if (!JournalWriter)
+	{
+		return;
+	}
+
+	FlushRecords();
+
+	JournalWriter->Close();
+	delete JournalWriter;
+	JournalWriter = nullptr;
+
+	NumOpenJournals--;
+
+	FWorldDelegates::OnWorldTickStart.Remove(WorldTickStartHandle);
+	FWorldDelegates::OnWorldPreActorTick.Remove(WorldPreActorTickHandle);
+	bDispatchingPackets = false;
+
+	UE_LOG(LogTemp, Log, TEXT("Server journal closed: %d RPCs from %d connections."), NumRecordedRPCs, ConnectionIds.Num());
+
+	PackageMap = nullptr;
+	PendingRecords.Reset();
+	ConnectionIds.Reset();
+	ObjectIds.Reset();
+}
+
+void USurvivalServerJournalSubsystem::OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World == GetWorld())
+	{
+		bDispatchingPackets = true;
+	}
+}
+
+void USurvivalServerJournalSubsystem::OnWorldPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World == GetWorld())
+	{
+		bDispatchingPackets = false;
+	}
+}
+
+uint32 USurvivalServerJournalSubsystem::GetRecordTimeDelta()
+{
+	//Deltas of the rounded time, so the rounding doesn't add up during a long match.
+	const uint32 RecordTime = (uint32)FMath::RoundToInt((GetWorld()->GetRealTimeSeconds() - StartTime) * 1000.0);
+	const uint32 TimeDelta = RecordTime - LastRecordTime;
+
+	LastRecordTime = RecordTime;
+
+	return TimeDelta;
+}
+
+void USurvivalServerJournalSubsystem::WriteRecord(const EJournalRecord Type, FBitWriter& Record)
+{
+	FMemoryWriter Writer(PendingRecords, false, true);
+
+	uint8 TypeValue = (uint8)Type;
+	uint32 NumBits = (uint32)Record.GetNumBits();
+
+	Writer << TypeValue;
+	Writer.SerializeIntPacked(NumBits);
+	Writer.Serialize(Record.GetData(), Record.GetNumBytes());
+}
+
+void USurvivalServerJournalSubsystem::FlushRecords()
+{
+	if (JournalWriter && PendingRecords.Num() > 0)
+	{
+		JournalWriter->Serialize(PendingRecords.GetData(), PendingRecords.Num());
+	}
+
+	PendingRecords.Reset();
+}
+
+#pragma endregion
+
+#pragma region Connections
+
+void USurvivalServerJournalSubsystem::UpdateConnections()
+{
+	UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+
+	//A connection counts once it has a player controller, that's when the replay can log it in.
+	for (UNetConnection* Connection : NetDriver->ClientConnections)
+	{
+		if (Connection && Connection->PlayerController && Connection->State != USOCK_Closed)
+		{
+			FindOrAddConnectionId(Connection);
+		}
+	}
+
+	for (auto It = ConnectionIds.CreateIterator(); It; ++It)
+	{
+		UNetConnection* Connection = It.Key().Get();
+
+		if (Connection && Connection->State != USOCK_Closed && NetDriver->ClientConnections.Contains(Connection))
+		{
+			continue;
+		}
+
+		FBitWriter Record(64, true);
+
+		uint32 TimeDelta = GetRecordTimeDelta();
+		uint32 ConnectionId = It.Value();
+		Record.SerializeIntPacked(TimeDelta);
+		Record.SerializeIntPacked(ConnectionId);
+
+		WriteRecord(EJournalRecord::JR_Disconnect, Record);
+
+		It.RemoveCurrent();
+	}
+}
+
+uint32 USurvivalServerJournalSubsystem::FindOrAddConnectionId(UNetConnection* Connection)
+{
+	if (const uint32* ConnectionId = ConnectionIds.Find(Connection))
+	{
+		return *ConnectionId;
+	}
+
+	//Ids are never reused, a player that comes back is a new connection.
+	const uint32 NewConnectionId = NextConnectionId++;
+	ConnectionIds.Add(Connection, NewConnectionId);
+
+	FString PlayerName;
+
+	if (Connection->PlayerController && Connection->PlayerController->PlayerState)
+	{
+		PlayerName = Connection->PlayerController->PlayerState->GetPlayerName();
+	}
+
+	FBitWriter Record(256, true);
+
+	uint32 TimeDelta = GetRecordTimeDelta();
+	uint32 RecordConnectionId = NewConnectionId;
+	Record.SerializeIntPacked(TimeDelta);
+	Record.SerializeIntPacked(RecordConnectionId);
+	Record << Connection->RequestURL;
+	Record << PlayerName;
+
+	WriteRecord(EJournalRecord::JR_Connect, Record);
+
+	return NewConnectionId;
+}
+
+#pragma endregion
+
+#pragma region RPCs
+
+void USurvivalServerJournalSubsystem::RecordServerRPC(AActor* Actor, UFunction* Function, void* Parameters)
+{
+	UWorld* World = Actor ? Actor->GetWorld() : nullptr;
+
+	if (USurvivalServerJournalSubsystem* Journal = World ? World->GetSubsystem<USurvivalServerJournalSubsystem>() : nullptr)
+	{
+		Journal->RecordRPC(Actor, Function, Parameters);
+	}
+}
+
+void USurvivalServerJournalSubsystem::RecordRPC(AActor* Actor, UFunction* Function, void* Parameters)
+{
+	//Only what a client asked for. The server running its own Server functions is not load we have to reproduce,
+	//even on an actor a client owns: outside of the packet dispatch nothing we run came from a connection.
+	UNetConnection* Connection = Actor->GetNetConnection();
+
+	if (!JournalWriter || !bDispatchingPackets || !Connection || Actor->GetLocalRole() != ROLE_Authority)
+	{
+		return;
+	}
+
+	const uint32 ConnectionId = FindOrAddConnectionId(Connection);
+
+	//Objects seen for the first time are described while we write the record, so their records go before this one.
+	FNetBitWriter Record(PackageMap, 512);
+
+	uint32 RecordConnectionId = ConnectionId;
+	uint32 TargetId = GetObjectId(Actor);
+	uint32 TimeDelta = GetRecordTimeDelta();
+	FName FunctionName = Function->GetFName();
+
+	Record.SerializeIntPacked(TimeDelta);
+	Record.SerializeIntPacked(RecordConnectionId);
+	Record.SerializeIntPacked(TargetId);
+	UPackageMap::StaticSerializeName(Record, FunctionName);
+
+	FSurvivalServerJournal::SerializeParameters(Record, PackageMap, Function, Parameters);
+
+	WriteRecord(EJournalRecord::JR_RPC, Record);
+	NumRecordedRPCs++;
+}
+
+#pragma endregion
+
+#pragma region Objects
+
+uint32 USurvivalServerJournalSubsystem::GetObjectId(UObject* Object)
+{
+	if (!Object)
+	{
+		return 0;
+	}
+
+	if (const uint32* ObjectId = ObjectIds.Find(Object))
+	{
+		return *ObjectId;
+	}
+
+	FJournalObjectDescriptor Descriptor = DescribeObject(Object);
+
+	const uint32 NewObjectId = NextObjectId++;
+	ObjectIds.Add(Object, NewObjectId);
+
+	FBitWriter Record(256, true);
+
+	uint32 RecordObjectId = NewObjectId;
+	Record.SerializeIntPacked(RecordObjectId);
+	Descriptor.Serialize(Record);
+
+	WriteRecord(EJournalRecord::JR_Object, Record);
+
+	return NewObjectId;
+}
+
+FJournalObjectDescriptor USurvivalServerJournalSubsystem::DescribeObject(UObject* Object)
+{
+	FJournalObjectDescriptor Descriptor;
+
+	//Placed in the map, or an asset like an item class.
+	if (Object->IsFullNameStableForNetworking())
+	{
+		Descriptor.Kind = EJournalObject::JO_Path;
+		Descriptor.Path = Object->GetPathName();
+		return Descriptor;
+	}
+
+	if (APlayerController* PlayerController = Cast<APlayerController>(Object))
+	{
+		if (UNetConnection* Connection = PlayerController->GetNetConnection())
+		{
+			Descriptor.Kind = EJournalObject::JO_Controller;
+			Descriptor.ConnectionId = FindOrAddConnectionId(Connection);
+			return Descriptor;
+		}
+	}
+
+	if (APawn* Pawn = Cast<APawn>(Object))
+	{
+		APlayerController* PlayerController = Cast<APlayerController>(Pawn->GetController());
+
+		if (PlayerController && PlayerController->GetNetConnection())
+		{
+			Descriptor.Kind = EJournalObject::JO_Pawn;
+			Descriptor.ConnectionId = FindOrAddConnectionId(PlayerController->GetNetConnection());
+			return Descriptor;
+		}
+	}
+
+	//Item names change every match, but the inventories are filled in the same order.
+	if (UItem* Item = Cast<UItem>(Object))
+	{
+		UObject* Container = Item->OwningInventory ? static_cast<UObject*>(Item->OwningInventory) : Item->GetOuter();
+
+		TArray<UObject*> Items;
+
+		if (Item->OwningInventory)
+		{
+			Items.Append(Item->OwningInventory->GetItems());
+		}
+		else
+		{
+			GetObjectsWithOuter(Container, Items, false);
+		}
+
+		Descriptor.Kind = EJournalObject::JO_Item;
+		Descriptor.OuterId = GetObjectId(Container);
+		Descriptor.Path = Item->GetClass()->GetPathName();
+
+		for (UObject* Other : Items)
+		{
+			if (Other == Item)
+			{
+				break;
+			}
+
+			if (Other && Other->GetClass() == Item->GetClass())
+			{
+				Descriptor.Index++;
+			}
+		}
+
+		return Descriptor;
+	}
+
+	if (AActor* Actor = Cast<AActor>(Object))
+	{
+		Descriptor.Path = Actor->GetClass()->GetPathName();
+
+		//Weapons, player states and anything else spawned for someone.
+		if (AActor* Owner = Actor->GetOwner())
+		{
+			Descriptor.Kind = EJournalObject::JO_OwnedActor;
+			Descriptor.OuterId = GetObjectId(Owner);
+
+			for (TActorIterator<AActor> It(GetWorld(), Actor->GetClass()); It && *It != Actor; ++It)
+			{
+				if (It->GetClass() == Actor->GetClass() && It->GetOwner() == Owner)
+				{
+					Descriptor.Index++;
+				}
+			}
+
+			return Descriptor;
+		}
+
+		//Pickups and bodies, nobody owns them.
+		Descriptor.Kind = EJournalObject::JO_Actor;
+		Descriptor.Location = Actor->GetActorLocation();
+		return Descriptor;
+	}
+
+	//Components and other subobjects, created with the same name every match.
+	Descriptor.Kind = EJournalObject::JO_Subobject;
+	Descriptor.OuterId = GetObjectId(Object->GetOuter());
+	Descriptor.Name = Object->GetFName();
+	return Descriptor;
+}
+
+#pragma endregion
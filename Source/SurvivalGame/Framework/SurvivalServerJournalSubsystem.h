@@ -0,0 +1,146 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "SurvivalServerJournal.h"
+#include "SurvivalServerJournalSubsystem.generated.h"
+
+/*Journals everything the clients ask the server to do, so a hitch seen in a real match can be reproduced later
+with USurvivalServerReplaySubsystem on a local server.
+
+Every Server RPC we receive is written with its parameters and the time we received it, movement included (ServerMove
+is an RPC of the character). The actors that receive Server RPCs put a FScopedServerRPC in ProcessEvent. Only the
+calls the net driver makes while it dispatches what the clients sent are journaled, a Server function the server
+calls itself on an actor owned by a client is not something a client asked for.
+Connections are journaled when they join and leave. Objects referenced by the RPCs are written once, with enough
+information to find them again on another server (see EJournalObject).
+
+Disabled by default. Turn it on with -SurvivalJournal in the server command line, or Survival.Journal 1 in the console.
+Journals go to Saved/Profiling/SurvivalJournal.*/
+UCLASS()
+class SURVIVALGAME_API USurvivalServerJournalSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	USurvivalServerJournalSubsystem();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual TStatId GetStatId() const override;
+
+	static bool IsJournalEnabled();
+
+	/*Put it in ProcessEvent of an actor that receives Server RPCs, before running the function. Does nothing unless a
+	journal is open. It has to live while the function runs, so the Server functions it calls aren't journaled.*/
+	struct FScopedServerRPC
+	{
+		FScopedServerRPC(AActor* Actor, UFunction* Function, void* Parameters)
+			: bServerRPC(NumOpenJournals > 0 && Function->HasAnyFunctionFlags(FUNC_NetServer))
+		{
+			if (bServerRPC)
+			{
+				//Only the outer one can come from a connection, the others are called by its implementation.
+				if (ServerRPCDepth == 0)
+				{
+					RecordServerRPC(Actor, Function, Parameters);
+				}
+
+				ServerRPCDepth++;
+			}
+		}
+
+		~FScopedServerRPC()
+		{
+			if (bServerRPC)
+			{
+				ServerRPCDepth--;
+			}
+		}
+
+	private:
+
+		const bool bServerRPC;
+	};
+
+protected:
+
+	/*So the actors don't look for the subsystem on every function call while nobody is journaling.*/
+	static int32 NumOpenJournals;
+
+	/*Server RPCs running right now, the received one and the ones it calls.*/
+	static int32 ServerRPCDepth;
+
+	static void RecordServerRPC(AActor* Actor, UFunction* Function, void* Parameters);
+
+	FArchive* JournalWriter;
+
+	UPROPERTY(Transient)
+	USurvivalJournalPackageMap* PackageMap;
+
+	/*Records waiting to be written. We write them once per frame.*/
+	TArray<uint8> PendingRecords;
+
+	/*Ids we give to connections in the journal, in the order we see them.*/
+	TMap<TWeakObjectPtr<class UNetConnection>, uint32> ConnectionIds;
+
+	uint32 NextConnectionId;
+
+	/*Ids of the objects we already described in the journal.*/
+	TMap<TWeakObjectPtr<UObject>, uint32> ObjectIds;
+
+	uint32 NextObjectId;
+
+	double StartTime;
+
+	/*Time of the last record since the journal started, in milliseconds.*/
+	uint32 LastRecordTime;
+
+	int32 NumRecordedRPCs;
+
+	float FlushTime;
+
+	/*True from the start of the world tick until the actors tick. The net driver dispatches the packets of the clients
+	in between, every RPC it runs there arrived from a connection.*/
+	bool bDispatchingPackets;
+
+	FDelegateHandle WorldTickStartHandle;
+	FDelegateHandle WorldPreActorTickHandle;
+
+	void OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	void OnWorldPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	void StartJournal();
+	void StopJournal();
+
+	/*The time since the last record, in milliseconds.*/
+	uint32 GetRecordTimeDelta();
+
+	void WriteRecord(const EJournalRecord Type, FBitWriter& Record);
+	void FlushRecords();
+
+	/*Journals the connections that joined or left since the last frame.*/
+	void UpdateConnections();
+
+	uint32 FindOrAddConnectionId(class UNetConnection* Connection);
+
+	void RecordRPC(AActor* Actor, UFunction* Function, void* Parameters);
+
+	/*The id of the object in the journal. The first time we see an object we describe it, and everything it depends on.*/
+	uint32 GetObjectId(UObject* Object);
+
+	FJournalObjectDescriptor DescribeObject(UObject* Object);
+};
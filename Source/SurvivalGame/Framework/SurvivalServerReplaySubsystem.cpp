@@ -0,0 +1,525 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "SurvivalServerReplaySubsystem.h"
+
+#include "EngineUtils.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "UObject/UObjectHash.h"
+
+#include "SurvivalReplayConnection.h"
+#include "Components/InventoryComponent.h"
+#include "Items/Item.h"
+
+USurvivalServerReplaySubsystem::USurvivalServerReplaySubsystem()
+{
+	JournalOffset = 0;
+	bHasPendingRecord = false;
+	JournalTime = 0;
+
+	bStarted = false;
+	bFinished = false;
+	StartTime = 0.0;
+
+	PackageMap = nullptr;
+
+	NumPlayedRPCs = 0;
+	NumSkippedRPCs = 0;
+}
+
+bool USurvivalServerReplaySubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && !IsRunningClientOnly() && !GetReplayJournal().IsEmpty();
+}
+
+void USurvivalServerReplaySubsystem::Deinitialize()
+{
+	//The net driver cleans up the fake connections with the rest.
+	Connections.Reset();
+
+	Super::Deinitialize();
+}
+
+FString USurvivalServerReplaySubsystem::GetReplayJournal()
+{
+	FString JournalFile;
+	FParse::Value(FCommandLine::Get(), TEXT("SurvivalReplay="), JournalFile);
+
+	return JournalFile;
+}
+
+bool USurvivalServerReplaySubsystem::IsTickable() const
+{
+	return !bFinished && !HasAnyFlags(RF_ClassDefaultObject);
+}
+
+TStatId USurvivalServerReplaySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USurvivalServerReplaySubsystem, STATGROUP_Tickables);
+}
+
+void USurvivalServerReplaySubsystem::Tick(float DeltaTime)
+{
+	UWorld* World = GetWorld();
+	UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+
+	//The players can't join before the server is listening and the game has started.
+	if (!bStarted)
+	{
+		if (!NetDriver || !NetDriver->IsServer() || !World->HasBegunPlay())
+		{
+			return;
+		}
+
+		bStarted = true;
+
+		if (!StartReplay())
+		{
+			bFinished = true;
+			return;
+		}
+	}
+
+	const double ElapsedTime = (World->GetRealTimeSeconds() - StartTime) * 1000.0;
+
+	while (bHasPendingRecord && PendingRecord.Time <= ElapsedTime)
+	{
+		PlayRecord(PendingRecord);
+		bHasPendingRecord = ReadNextRecord();
+	}
+
+	if (!bHasPendingRecord)
+	{
+		FinishReplay();
+	}
+}
+
+#pragma region Journal
+
+bool USurvivalServerReplaySubsystem::StartReplay()
+{
+	FString JournalFile = GetReplayJournal();
+
+	if (FPaths::IsRelative(JournalFile) && !FPaths::FileExists(JournalFile))
+	{
+		JournalFile = FPaths::Combine(FSurvivalServerJournal::GetJournalDirectory(), JournalFile);
+	}
+
+	if (!FFileHelper::LoadFileToArray(Journal, *JournalFile))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Couldn't read the server journal %s."), *JournalFile);
+		return false;
+	}
+
+	FMemoryReader Header(Journal);
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	FString MapName;
+
+	Header << Magic;
+	Header << Version;
+
+	if (Magic != FSurvivalServerJournal::Magic || Version != FSurvivalServerJournal::Version)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s is not a server journal of this version."), *JournalFile);
+		return false;
+	}
+
+	Header << MapName;
+	JournalOffset = Header.Tell();
+
+	FString CurrentMapName = GetWorld()->GetMapName();
+	CurrentMapName.RemoveFromStart(GetWorld()->StreamingLevelsPrefix);
+
+	//Placed actors are found by their path, in another map most RPCs would lose their target.
+	if (MapName != CurrentMapName)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("The server journal is for %s but we are playing %s."), *MapName, *CurrentMapName);
+	}
+
+	PackageMap = NewObject<USurvivalJournalPackageMap>(this);
+	PackageMap->ResolveObject = [this](uint32 ObjectId) { return ResolveObject(ObjectId); };
+
+	StartTime = GetWorld()->GetRealTimeSeconds();
+	bHasPendingRecord = ReadNextRecord();
+
+	UE_LOG(LogTemp, Log, TEXT("Replaying the server journal %s"), *JournalFile);
+
+	return true;
+}
+
+void USurvivalServerReplaySubsystem::FinishReplay()
+{
+	bFinished = true;
+
+	UE_LOG(LogTemp, Log, TEXT("Server journal replayed in %.1f seconds: %d RPCs played, %d skipped because we couldn't find their target."),
+		GetWorld()->GetRealTimeSeconds() - StartTime, NumPlayedRPCs, NumSkippedRPCs);
+
+	//The journaled players leave with the journal, the server goes back to how it was.
+	TArray<uint32> ConnectionIds;
+	Connections.GetKeys(ConnectionIds);
+
+	for (const uint32 ConnectionId : ConnectionIds)
+	{
+		RemoveConnection(ConnectionId);
+	}
+
+	Journal.Empty();
+	Descriptors.Empty();
+	ResolvedObjects.Empty();
+
+	if (FParse::Param(FCommandLine::Get(), TEXT("SurvivalReplayExit")))
+	{
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+bool USurvivalServerReplaySubsystem::ReadNextRecord()
+{
+	if (JournalOffset >= Journal.Num())
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Journal);
+	Reader.Seek(JournalOffset);
+
+	uint8 TypeValue = 0;
+	uint32 NumBits = 0;
+
+	Reader << TypeValue;
+	Reader.SerializeIntPacked(NumBits);
+
+	const int64 NumBytes = (NumBits + 7) >> 3;
+
+	//A server that crashed can leave the last record cut.
+	if (Reader.IsError() || Reader.Tell() + NumBytes > Journal.Num())
+	{
+		return false;
+	}
+
+	PendingRecord.Type = (EJournalRecord)TypeValue;
+	PendingRecord.NumBits = NumBits;
+	PendingRecord.Data.SetNumUninitialized(NumBytes);
+	Reader.Serialize(PendingRecord.Data.GetData(), NumBytes);
+
+	JournalOffset = Reader.Tell();
+
+	//Object records don't have a time, they are played right away.
+	if (PendingRecord.Type != EJournalRecord::JR_Object)
+	{
+		FBitReader TimeReader(PendingRecord.Data.GetData(), PendingRecord.NumBits);
+
+		uint32 TimeDelta = 0;
+		TimeReader.SerializeIntPacked(TimeDelta);
+
+		JournalTime += TimeDelta;
+	}
+
+	PendingRecord.Time = JournalTime;
+
+	return true;
+}
+
+void USurvivalServerReplaySubsystem::PlayRecord(FPendingJournalRecord& Record)
+{
+	FNetBitReader Reader(PackageMap, Record.Data.GetData(), Record.NumBits);
+
+	if (Record.Type == EJournalRecord::JR_Object)
+	{
+		uint32 ObjectId = 0;
+		Reader.SerializeIntPacked(ObjectId);
+
+		FJournalObjectDescriptor Descriptor;
+		Descriptor.Serialize(Reader);
+
+		Descriptors.Add(ObjectId, Descriptor);
+		return;
+	}
+
+	uint32 TimeDelta = 0;
+	uint32 ConnectionId = 0;
+
+	Reader.SerializeIntPacked(TimeDelta);
+	Reader.SerializeIntPacked(ConnectionId);
+
+	switch (Record.Type)
+	{
+	case EJournalRecord::JR_Connect:
+	{
+		FString RequestURL;
+		FString PlayerName;
+		Reader << RequestURL;
+		Reader << PlayerName;
+
+		AddConnection(ConnectionId, RequestURL, PlayerName);
+		break;
+	}
+	case EJournalRecord::JR_Disconnect:
+		RemoveConnection(ConnectionId);
+		break;
+	case EJournalRecord::JR_RPC:
+		PlayRPC(Reader);
+		break;
+	default:
+		break;
+	}
+}
+
+#pragma endregion
+
+#pragma region Connections
+
+void USurvivalServerReplaySubsystem::AddConnection(const uint32 JournalConnectionId, const FString& RequestURL, const FString& PlayerName)
+{
+	UWorld* World = GetWorld();
+	UNetDriver* NetDriver = World->GetNetDriver();
+
+	FURL URL(nullptr, *RequestURL, TRAVEL_Absolute);
+
+	USurvivalReplayConnection* Connection = NewObject<USurvivalReplayConnection>(NetDriver);
+	Connection->JournalConnectionId = JournalConnectionId;
+	Connection->InitConnection(NetDriver, USOCK_Open, URL, 1000000);
+
+	NetDriver->AddClientConnection(Connection);
+
+	//Same as the server does when a client joins, without the handshake.
+	FString Error;
+	APlayerController* PlayerController = World->SpawnPlayActor(Connection, ROLE_AutonomousProxy, URL, FUniqueNetIdRepl(), Error);
+
+	if (!PlayerController)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Journaled player %u couldn't join: %s"), JournalConnectionId, *Error);
+
+		Connection->Close();
+		Connection->CleanUp();
+		return;
+	}
+
+	Connection->PlayerController = PlayerController;
+	Connection->OwningActor = PlayerController;
+
+	if (PlayerController->PlayerState && !PlayerName.IsEmpty())
+	{
+		PlayerController->PlayerState->SetPlayerName(PlayerName);
+	}
+
+	Connections.Add(JournalConnectionId, Connection);
+}
+
+void USurvivalServerReplaySubsystem::RemoveConnection(const uint32 JournalConnectionId)
+{
+	TWeakObjectPtr<USurvivalReplayConnection> Connection;
+
+	if (Connections.RemoveAndCopyValue(JournalConnectionId, Connection) && Connection.IsValid())
+	{
+		//Logs the player out and destroys its controller, like a client that left.
+		Connection->Close();
+		Connection->CleanUp();
+	}
+}
+
+#pragma endregion
+
+#pragma region RPCs
+
+void USurvivalServerReplaySubsystem::PlayRPC(FNetBitReader& Reader)
+{
+	uint32 TargetId = 0;
+	FName FunctionName;
+
+	Reader.SerializeIntPacked(TargetId);
+	UPackageMap::StaticSerializeName(Reader, FunctionName);
+
+	AActor* Target = Cast<AActor>(ResolveObject(TargetId));
+	UFunction* Function = Target ? Target->FindFunction(FunctionName) : nullptr;
+
+	if (!Function || !Function->HasAnyFunctionFlags(FUNC_NetServer))
+	{
+		NumSkippedRPCs++;
+		return;
+	}
+
+	uint8* Parameters = static_cast<uint8*>(FMemory_Alloca(FMath::Max<int32>(1, Function->ParmsSize)));
+	FMemory::Memzero(Parameters, Function->ParmsSize);
+	Function->InitializeStruct(Parameters);
+
+	FSurvivalServerJournal::SerializeParameters(Reader, PackageMap, Function, Parameters);
+
+	if (Reader.IsError())
+	{
+		NumSkippedRPCs++;
+	}
+	else
+	{
+		//The generated code validates and runs the implementation, like for an RPC that came from the network.
+		Target->ProcessEvent(Function, Parameters);
+		NumPlayedRPCs++;
+	}
+
+	Function->DestroyStruct(Parameters);
+}
+
+#pragma endregion
+
+#pragma region Objects
+
+UObject* USurvivalServerReplaySubsystem::ResolveObject(const uint32 ObjectId)
+{
+	const FJournalObjectDescriptor* Descriptor = Descriptors.Find(ObjectId);
+
+	if (!Descriptor)
+	{
+		return nullptr;
+	}
+
+	if (const TWeakObjectPtr<UObject>* ResolvedObject = ResolvedObjects.Find(ObjectId))
+	{
+		if (ResolvedObject->IsValid())
+		{
+			return ResolvedObject->Get();
+		}
+	}
+
+	UObject* Object = nullptr;
+
+	switch (Descriptor->Kind)
+	{
+	case EJournalObject::JO_Path:
+	{
+		Object = StaticFindObject(UObject::StaticClass(), nullptr, *Descriptor->Path);
+
+		if (!Object)
+		{
+			Object = StaticLoadObject(UObject::StaticClass(), nullptr, *Descriptor->Path, nullptr, LOAD_NoWarn | LOAD_Quiet);
+		}
+
+		ResolvedObjects.Add(ObjectId, Object);
+		break;
+	}
+	case EJournalObject::JO_Controller:
+	case EJournalObject::JO_Pawn:
+	{
+		//Not remembered, the pawn changes every time the player respawns.
+		const TWeakObjectPtr<USurvivalReplayConnection>* Connection = Connections.Find(Descriptor->ConnectionId);
+		APlayerController* PlayerController = Connection && Connection->IsValid() ? (*Connection)->PlayerController : nullptr;
+
+		if (PlayerController)
+		{
+			Object = Descriptor->Kind == EJournalObject::JO_Pawn ? static_cast<UObject*>(PlayerController->GetPawn()) : PlayerController;
+		}
+		break;
+	}
+	case EJournalObject::JO_Item:
+	{
+		UObject* Container = ResolveObject(Descriptor->OuterId);
+		UClass* ItemClass = FindClass(Descriptor->Path);
+
+		if (!Container || !ItemClass)
+		{
+			break;
+		}
+
+		TArray<UObject*> Items;
+
+		if (UInventoryComponent* Inventory = Cast<UInventoryComponent>(Container))
+		{
+			Items.Append(Inventory->GetItems());
+		}
+		else
+		{
+			GetObjectsWithOuter(Container, Items, false);
+		}
+
+		uint32 Index = 0;
+
+		for (UObject* Item : Items)
+		{
+			if (Item && Item->GetClass() == ItemClass && Index++ == Descriptor->Index)
+			{
+				Object = Item;
+				break;
+			}
+		}
+		break;
+	}
+	case EJournalObject::JO_OwnedActor:
+	{
+		UObject* Owner = ResolveObject(Descriptor->OuterId);
+		UClass* ActorClass = FindClass(Descriptor->Path);
+
+		if (!Owner || !ActorClass)
+		{
+			break;
+		}
+
+		uint32 Index = 0;
+
+		for (TActorIterator<AActor> It(GetWorld(), ActorClass); It; ++It)
+		{
+			if (It->GetClass() == ActorClass && It->GetOwner() == Owner && Index++ == Descriptor->Index)
+			{
+				Object = *It;
+				break;
+			}
+		}
+		break;
+	}
+	case EJournalObject::JO_Actor:
+	{
+		UClass* ActorClass = FindClass(Descriptor->Path);
+
+		if (!ActorClass)
+		{
+			break;
+		}
+
+		float ClosestDistanceSquared = MAX_FLT;
+
+		for (TActorIterator<AActor> It(GetWorld(), ActorClass); It; ++It)
+		{
+			const float DistanceSquared = FVector::DistSquared(It->GetActorLocation(), Descriptor->Location);
+
+			if (DistanceSquared < ClosestDistanceSquared)
+			{
+				ClosestDistanceSquared = DistanceSquared;
+				Object = *It;
+			}
+		}
+
+		ResolvedObjects.Add(ObjectId, Object);
+		break;
+	}
+	case EJournalObject::JO_Subobject:
+	{
+		if (UObject* Outer = ResolveObject(Descriptor->OuterId))
+		{
+			Object = StaticFindObjectFast(UObject::StaticClass(), Outer, Descriptor->Name);
+		}
+		break;
+	}
+	}
+
+	return Object;
+}
+
+UClass* USurvivalServerReplaySubsystem::FindClass(const FString& ClassPath) const
+{
+	UClass* Class = FindObject<UClass>(nullptr, *ClassPath);
+	return Class ? Class : LoadObject<UClass>(nullptr, *ClassPath, nullptr, LOAD_NoWarn | LOAD_Quiet);
+}
+
+#pragma endregion
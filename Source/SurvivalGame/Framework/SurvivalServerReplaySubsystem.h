@@ -0,0 +1,101 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "SurvivalServerJournal.h"
+#include "SurvivalServerReplaySubsystem.generated.h"
+
+/*Plays a journal of USurvivalServerJournalSubsystem on a local server, so the load of a real match can be profiled again and again.
+
+Every journaled player joins through a USurvivalReplayConnection at the time it joined, and its Server RPCs (movement
+included) run on the same actors at the same times, through ProcessEvent, the same way the engine runs the RPCs it receives.
+The server replicates to the fake connections like to real players, so the replication cost is reproduced too.
+
+SurvivalGameServer <Map> -SurvivalReplay=<journal> [-SurvivalReplayExit] -nullrhi
+Add -benchmark -fps=<tick rate> -fixedseed to get the same frames and the same random rolls on every run.
+-SurvivalReplayExit closes the server when the journal ends, for scripted profiling.*/
+UCLASS()
+class SURVIVALGAME_API USurvivalServerReplaySubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	USurvivalServerReplaySubsystem();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual TStatId GetStatId() const override;
+
+	/*The journal in the command line, empty if we are not replaying.*/
+	static FString GetReplayJournal();
+
+protected:
+
+	/*The record we read but didn't play yet, because its time didn't come.*/
+	struct FPendingJournalRecord
+	{
+		EJournalRecord Type;
+		TArray<uint8> Data;
+		int64 NumBits;
+
+		/*Milliseconds since the journal started.*/
+		uint32 Time;
+	};
+
+	TArray<uint8> Journal;
+	int64 JournalOffset;
+
+	FPendingJournalRecord PendingRecord;
+	bool bHasPendingRecord;
+
+	/*Time of the last timed record we read, in milliseconds.*/
+	uint32 JournalTime;
+
+	bool bStarted;
+	bool bFinished;
+	double StartTime;
+
+	UPROPERTY(Transient)
+	USurvivalJournalPackageMap* PackageMap;
+
+	/*The fake connections, by the id they have in the journal.*/
+	TMap<uint32, TWeakObjectPtr<class USurvivalReplayConnection>> Connections;
+
+	TMap<uint32, FJournalObjectDescriptor> Descriptors;
+
+	/*Objects that don't change during the match (placed actors, assets, pickups) are only searched once.*/
+	TMap<uint32, TWeakObjectPtr<UObject>> ResolvedObjects;
+
+	int32 NumPlayedRPCs;
+	int32 NumSkippedRPCs;
+
+	/*Loads the journal and checks that it's for this map.*/
+	bool StartReplay();
+	void FinishReplay();
+
+	/*Reads the next record into PendingRecord. False at the end of the journal.*/
+	bool ReadNextRecord();
+	void PlayRecord(FPendingJournalRecord& Record);
+
+	void AddConnection(const uint32 JournalConnectionId, const FString& RequestURL, const FString& PlayerName);
+	void RemoveConnection(const uint32 JournalConnectionId);
+
+	void PlayRPC(class FNetBitReader& Reader);
+
+	/*Finds the object of this replay that plays the journaled one.*/
+	UObject* ResolveObject(const uint32 ObjectId);
+
+	UClass* FindClass(const FString& ClassPath) const;
+};
@@ -0,0 +1,257 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "SurvivalTelemetrySubsystem.h"
+#include "SurvivalGame.h"
+
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+
+static TAutoConsoleVariable<int32> CVarSurvivalTelemetry(
+	TEXT("Survival.Telemetry"),
+	0,
+	TEXT("Writes server telemetry snapshots to Saved/Profiling/SurvivalTelemetry.\n")
+	TEXT("0: off, 1: on"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSurvivalTelemetryInterval(
+	TEXT("Survival.Telemetry.Interval"),
+	10.f,
+	TEXT("Seconds between two telemetry snapshots."),
+	ECVF_Default);
+
+USurvivalTelemetrySubsystem::USurvivalTelemetrySubsystem()
+{
+	SnapshotTime = 0.f;
+	TotalTime = 0.f;
+}
+
+bool USurvivalTelemetrySubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld();
+}
+
+void USurvivalTelemetrySubsystem::Deinitialize()
+{
+	//Don't lose the last seconds of the session.
+	if (FrameTimes.Num() > 0)
+	{
+		WriteSnapshot();
+	}
+
+	Super::Deinitialize();
+}
+
+bool USurvivalTelemetrySubsystem::IsTelemetryEnabled()
+{
+	static const bool bEnabledFromCommandLine = FParse::Param(FCommandLine::Get(), TEXT("SurvivalTelemetry"));
+	return bEnabledFromCommandLine || CVarSurvivalTelemetry.GetValueOnGameThread() != 0;
+}
+
+bool USurvivalTelemetrySubsystem::IsTickable() const
+{
+	return IsTelemetryEnabled() && !HasAnyFlags(RF_ClassDefaultObject);
+}
+
+TStatId USurvivalTelemetrySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USurvivalTelemetrySubsystem, STATGROUP_Tickables);
+}
+
+void USurvivalTelemetrySubsystem::Tick(float DeltaTime)
+{
+	//Undilated, so slow motion doesn't look like a slow server.
+	const float FrameTime = FApp::GetDeltaTime();
+
+	FrameTimes.Add(FrameTime * 1000.f);
+	SnapshotTime += FrameTime;
+	TotalTime += FrameTime;
+
+	if (SnapshotTime >= FMath::Max(1.f, CVarSurvivalTelemetryInterval.GetValueOnGameThread()))
+	{
+		WriteSnapshot();
+	}
+}
+
+void USurvivalTelemetrySubsystem::CountRPC(const UObject* WorldContextObject, const TCHAR* FunctionName)
+{
+	INC_DWORD_STAT(STAT_ServerRPCs);
+	CSV_CUSTOM_STAT(SurvivalGame, ServerRPCs, 1, ECsvCustomStatOp::Accumulate);
+
+	if (IsTelemetryEnabled() && WorldContextObject)
+	{
+		if (UWorld* World = WorldContextObject->GetWorld())
+		{
+			if (USurvivalTelemetrySubsystem* Telemetry = World->GetSubsystem<USurvivalTelemetrySubsystem>())
+			{
+				Telemetry->RPCCounts.FindOrAdd(FName(FunctionName))++;
+			}
+		}
+	}
+}
+
+void USurvivalTelemetrySubsystem::CountReplicatedBits(const UObject* ReplicatedObject, const int64 NumBits)
+{
+	if (NumBits <= 0)
+	{
+		return;
+	}
+
+	INC_DWORD_STAT_BY(STAT_ReplicatedSubobjectBits, NumBits);
+	CSV_CUSTOM_STAT(SurvivalGame, ReplicatedSubobjectBytes, (float)NumBits / 8.f, ECsvCustomStatOp::Accumulate);
+
+	if (IsTelemetryEnabled() && ReplicatedObject)
+	{
+		if (UWorld* World = ReplicatedObject->GetWorld())
+		{
+			if (USurvivalTelemetrySubsystem* Telemetry = World->GetSubsystem<USurvivalTelemetrySubsystem>())
+			{
+				Telemetry->ReplicatedBits.FindOrAdd(ReplicatedObject->GetClass()->GetFName()) += NumBits;
+			}
+		}
+	}
+}
+
+void USurvivalTelemetrySubsystem::WriteSnapshot()
+{
+	if (FrameTimes.Num() == 0 || SnapshotTime <= 0.f)
+	{
+		ResetSnapshot();
+		return;
+	}
+
+	OpenFiles();
+
+	FrameTimes.Sort();
+
+	auto Percentile = [this](const float Percent)
+	{
+		const int32 Index = FMath::Clamp(FMath::CeilToInt(Percent * FrameTimes.Num()) - 1, 0, FrameTimes.Num() - 1);
+		return FrameTimes[Index];
+	};
+
+	float FrameTimeSum = 0.f;
+	for (const float FrameTime : FrameTimes)
+	{
+		FrameTimeSum += FrameTime;
+	}
+
+	const FString Timestamp = FDateTime::UtcNow().ToIso8601();
+	FString CsvRows;
+
+	auto AddCsvRow = [&CsvRows, &Timestamp, this](const TCHAR* Metric, const FString& Name, const double Value)
+	{
+		CsvRows += FString::Printf(TEXT("%s,%.2f,%s,%s,%.3f\n"), *Timestamp, TotalTime, Metric, *Name, Value);
+	};
+
+	TSharedRef<FJsonObject> Snapshot = MakeShared<FJsonObject>();
+	Snapshot->SetStringField(TEXT("timestamp"), Timestamp);
+	Snapshot->SetNumberField(TEXT("time"), TotalTime);
+	Snapshot->SetNumberField(TEXT("duration"), SnapshotTime);
+	Snapshot->SetNumberField(TEXT("frames"), FrameTimes.Num());
+
+	//Frame time percentiles.
+	{
+		TSharedRef<FJsonObject> FrameTimeObject = MakeShared<FJsonObject>();
+
+		struct FFrameTimeValue
+		{
+			const TCHAR* Name;
+			float Value;
+		};
+
+		const FFrameTimeValue FrameTimeValues[] =
+		{
+			{ TEXT("avg"), FrameTimeSum / FrameTimes.Num() },
+			{ TEXT("p50"), Percentile(0.5f) },
+			{ TEXT("p90"), Percentile(0.9f) },
+			{ TEXT("p99"), Percentile(0.99f) },
+			{ TEXT("max"), FrameTimes.Last() }
+		};
+
+		for (const FFrameTimeValue& FrameTimeValue : FrameTimeValues)
+		{
+			FrameTimeObject->SetNumberField(FrameTimeValue.Name, FrameTimeValue.Value);
+			AddCsvRow(TEXT("FrameTimeMs"), FrameTimeValue.Name, FrameTimeValue.Value);
+		}
+
+		Snapshot->SetObjectField(TEXT("frameTimeMs"), FrameTimeObject);
+	}
+
+	//Server RPCs per second, by function.
+	{
+		TSharedRef<FJsonObject> RPCObject = MakeShared<FJsonObject>();
+
+		for (const auto& RPCCount : RPCCounts)
+		{
+			const double RPCsPerSecond = RPCCount.Value / SnapshotTime;
+			RPCObject->SetNumberField(RPCCount.Key.ToString(), RPCsPerSecond);
+			AddCsvRow(TEXT("RPCsPerSecond"), RPCCount.Key.ToString(), RPCsPerSecond);
+		}
+
+		Snapshot->SetObjectField(TEXT("rpcsPerSecond"), RPCObject);
+	}
+
+	//Replicated subobject bytes per second, by class.
+	{
+		TSharedRef<FJsonObject> BytesObject = MakeShared<FJsonObject>();
+
+		for (const auto& ClassBits : ReplicatedBits)
+		{
+			const double BytesPerSecond = (ClassBits.Value / 8.0) / SnapshotTime;
+			BytesObject->SetNumberField(ClassBits.Key.ToString(), BytesPerSecond);
+			AddCsvRow(TEXT("ReplicatedBytesPerSecond"), ClassBits.Key.ToString(), BytesPerSecond);
+		}
+
+		Snapshot->SetObjectField(TEXT("replicatedBytesPerSecond"), BytesObject);
+	}
+
+	FString JsonLine;
+	TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> JsonWriter = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&JsonLine);
+	FJsonSerializer::Serialize(Snapshot, JsonWriter);
+	JsonLine += LINE_TERMINATOR;
+
+	FFileHelper::SaveStringToFile(JsonLine, *JsonFilePath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM, &IFileManager::Get(), FILEWRITE_Append);
+	FFileHelper::SaveStringToFile(CsvRows, *CsvFilePath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM, &IFileManager::Get(), FILEWRITE_Append);
+
+	ResetSnapshot();
+}
+
+void USurvivalTelemetrySubsystem::OpenFiles()
+{
+	if (!JsonFilePath.IsEmpty())
+	{
+		return;
+	}
+
+	const FString Directory = FPaths::Combine(FPaths::ProfilingDir(), TEXT("SurvivalTelemetry"));
+	IFileManager::Get().MakeDirectory(*Directory, true);
+
+	const FString MapName = GetWorld() ? GetWorld()->GetMapName() : TEXT("NoMap");
+	const FString BaseName = FString::Printf(TEXT("%s_%s"), *MapName, *FDateTime::Now().ToString());
+
+	JsonFilePath = FPaths::Combine(Directory, BaseName + TEXT(".jsonl"));
+	CsvFilePath = FPaths::Combine(Directory, BaseName + TEXT(".csv"));
+
+	FFileHelper::SaveStringToFile(TEXT("Timestamp,Time,Metric,Name,Value\n"), *CsvFilePath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+
+	UE_LOG(LogTemp, Log, TEXT("Writing survival telemetry to %s"), *JsonFilePath);
+}
+
+void USurvivalTelemetrySubsystem::ResetSnapshot()
+{
+	FrameTimes.Reset();
+	RPCCounts.Reset();
+	ReplicatedBits.Reset();
+	SnapshotTime = 0.f;
+}
@@ -0,0 +1,70 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "SurvivalTelemetrySubsystem.generated.h"
+
+/*Counts a server RPC for the telemetry. Call it at the start of the _Implementation.*/
+#define SURVIVAL_COUNT_RPC(FunctionName) USurvivalTelemetrySubsystem::CountRPC(this, TEXT(#FunctionName))
+
+/*Writes a snapshot of how the server is doing every few seconds, for offline analysis:
+frame time percentiles, server RPCs per second by function and replicated subobject bytes per second by class.
+Disabled by default. Turn it on with -SurvivalTelemetry in the command line, or Survival.Telemetry 1 in the console.
+Snapshots go to Saved/Profiling/SurvivalTelemetry, one JSON object per line and the same values in a CSV.*/
+UCLASS()
+class SURVIVALGAME_API USurvivalTelemetrySubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	USurvivalTelemetrySubsystem();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual TStatId GetStatId() const override;
+
+	/*Counts a call of this RPC in the world of the object.*/
+	static void CountRPC(const UObject* WorldContextObject, const TCHAR* FunctionName);
+
+	/*Counts the bits this object wrote in a bunch.*/
+	static void CountReplicatedBits(const UObject* ReplicatedObject, const int64 NumBits);
+
+	static bool IsTelemetryEnabled();
+
+protected:
+
+	/*Frame times of the current snapshot, in milliseconds.*/
+	TArray<float> FrameTimes;
+
+	TMap<FName, int32> RPCCounts;
+	TMap<FName, int64> ReplicatedBits;
+
+	/*Time since we wrote the last snapshot.*/
+	float SnapshotTime;
+
+	/*Time since telemetry started, written with every snapshot.*/
+	float TotalTime;
+
+	FString JsonFilePath;
+	FString CsvFilePath;
+
+	/*Writes the current snapshot to the files and starts a new one.*/
+	void WriteSnapshot();
+
+	/*Creates the files of this session the first time we write to them.*/
+	void OpenFiles();
+
+	void ResetSnapshot();
+};
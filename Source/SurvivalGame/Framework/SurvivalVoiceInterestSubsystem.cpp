@@ -0,0 +1,319 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "SurvivalVoiceInterestSubsystem.h"
+#include "SurvivalGame.h"
+
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "Camera/PlayerCameraManager.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarSurvivalVoiceInterest(
+	TEXT("Survival.VoiceInterest"),
+	1,
+	TEXT("Only relays the voice of players within hearing range.\n")
+	TEXT("0: off, everyone hears everyone, 1: on"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSurvivalVoiceInterestRange(
+	TEXT("Survival.VoiceInterest.Range"),
+	3000.f,
+	TEXT("Distance within which players hear each other."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSurvivalVoiceInterestHysteresis(
+	TEXT("Survival.VoiceInterest.Hysteresis"),
+	1.2f,
+	TEXT("A player heard is only muted beyond Range times this."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSurvivalVoiceInterestUpdateInterval(
+	TEXT("Survival.VoiceInterest.UpdateInterval"),
+	0.25f,
+	TEXT("Seconds between two hearing range checks."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSurvivalSyntheticVoiceRate(
+	TEXT("Survival.VoiceInterest.SyntheticPacketRate"),
+	15.f,
+	TEXT("Voice packets per second the -SurvivalSyntheticVoice model has every talker send."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSurvivalVoiceInterestReportInterval(
+	TEXT("Survival.VoiceInterest.ReportInterval"),
+	10.f,
+	TEXT("Seconds between two synthetic voice reports."),
+	ECVF_Default);
+
+USurvivalVoiceInterestSubsystem::USurvivalVoiceInterestSubsystem()
+{
+	UpdateTime = 0.f;
+	bWasEnabled = false;
+
+	RelayedPackets = 0.0;
+	UnfilteredPackets = 0.0;
+	ReportTime = 0.f;
+}
+
+bool USurvivalVoiceInterestSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld();
+}
+
+void USurvivalVoiceInterestSubsystem::Deinitialize()
+{
+	MutedTalkers.Empty();
+
+	Super::Deinitialize();
+}
+
+bool USurvivalVoiceInterestSubsystem::IsTickable() const
+{
+	if (HasAnyFlags(RF_ClassDefaultObject))
+	{
+		return false;
+	}
+
+	//Voice is relayed by the server, clients have nothing to filter.
+	UWorld* World = GetWorld();
+	return World && (World->GetNetMode() == NM_DedicatedServer || World->GetNetMode() == NM_ListenServer);
+}
+
+TStatId USurvivalVoiceInterestSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USurvivalVoiceInterestSubsystem, STATGROUP_Tickables);
+}
+
+void USurvivalVoiceInterestSubsystem::Tick(float DeltaTime)
+{
+	const bool bEnabled = CVarSurvivalVoiceInterest.GetValueOnGameThread() != 0;
+
+	if (bWasEnabled && !bEnabled)
+	{
+		UnmuteAll();
+	}
+
+	bWasEnabled = bEnabled;
+
+	UpdateTime += DeltaTime;
+
+	if (UpdateTime >= CVarSurvivalVoiceInterestUpdateInterval.GetValueOnGameThread())
+	{
+		UpdateInterest(UpdateTime);
+		UpdateTime = 0.f;
+	}
+
+	if (IsSyntheticVoiceEnabled())
+	{
+		ReportTime += DeltaTime;
+
+		if (ReportTime >= FMath::Max(1.f, CVarSurvivalVoiceInterestReportInterval.GetValueOnGameThread()))
+		{
+			ReportSyntheticVoice();
+		}
+	}
+}
+
+bool USurvivalVoiceInterestSubsystem::IsTalkerMuted(const APlayerController* Listener, const FUniqueNetIdRepl& TalkerId) const
+{
+	const TSet<FUniqueNetIdRepl>* ListenerMutes = MutedTalkers.Find(Listener);
+	return ListenerMutes && ListenerMutes->Contains(TalkerId);
+}
+
+void USurvivalVoiceInterestSubsystem::OnPlayerLogout(AController* Exiting)
+{
+	//The filter of the listener goes with its controller.
+	MutedTalkers.Remove(Cast<APlayerController>(Exiting));
+
+	const FUniqueNetIdRepl TalkerId = Exiting && Exiting->PlayerState ? Exiting->PlayerState->GetUniqueId() : FUniqueNetIdRepl();
+
+	if (!TalkerId.IsValid())
+	{
+		return;
+	}
+
+	//Mutes are by net id, if the player comes back it has to be heard again.
+	for (auto& ListenerMutes : MutedTalkers)
+	{
+		if (ListenerMutes.Value.Remove(TalkerId) > 0 && ListenerMutes.Key.IsValid())
+		{
+			ListenerMutes.Key->GameplayUnmutePlayer(TalkerId);
+		}
+	}
+}
+
+void USurvivalVoiceInterestSubsystem::UpdateInterest(const float DeltaTime)
+{
+	SURVIVAL_SCOPE_CYCLE_COUNTER(VoiceInterestUpdate);
+
+	const bool bEnabled = CVarSurvivalVoiceInterest.GetValueOnGameThread() != 0;
+	const bool bSyntheticVoice = IsSyntheticVoiceEnabled();
+
+	if (!bEnabled && !bSyntheticVoice)
+	{
+		return;
+	}
+
+	//Everyone with a player state can talk. Bots can only listen when we count synthetic voice.
+	TArray<AController*> Talkers;
+	TArray<FVector> TalkerLocations;
+
+	for (FConstControllerIterator It = GetWorld()->GetControllerIterator(); It; ++It)
+	{
+		AController* Controller = It->Get();
+		FVector Location;
+
+		if (Controller && Controller->PlayerState && GetHearingLocation(Controller, Location))
+		{
+			Talkers.Add(Controller);
+			TalkerLocations.Add(Location);
+		}
+	}
+
+	//Players that left, their mutes go with them.
+	for (auto It = MutedTalkers.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	const float HearingRange = CVarSurvivalVoiceInterestRange.GetValueOnGameThread();
+	const float UnmuteDistanceSquared = FMath::Square(HearingRange);
+	const float MuteDistanceSquared = FMath::Square(HearingRange * FMath::Max(1.f, CVarSurvivalVoiceInterestHysteresis.GetValueOnGameThread()));
+
+	const double PacketsPerTalker = bSyntheticVoice ? CVarSurvivalSyntheticVoiceRate.GetValueOnGameThread() * DeltaTime : 0.0;
+
+	for (int32 ListenerIndex = 0; ListenerIndex < Talkers.Num(); ++ListenerIndex)
+	{
+		APlayerController* Listener = Cast<APlayerController>(Talkers[ListenerIndex]);
+
+		if (!bSyntheticVoice && !Listener)
+		{
+			continue;
+		}
+
+		for (int32 TalkerIndex = 0; TalkerIndex < Talkers.Num(); ++TalkerIndex)
+		{
+			if (TalkerIndex == ListenerIndex)
+			{
+				continue;
+			}
+
+			const FUniqueNetIdRepl& TalkerId = Talkers[TalkerIndex]->PlayerState->GetUniqueId();
+			const float DistanceSquared = FVector::DistSquared(TalkerLocations[ListenerIndex], TalkerLocations[TalkerIndex]);
+
+			bool bMuted = false;
+
+			if (Listener && TalkerId.IsValid())
+			{
+				bMuted = IsTalkerMuted(Listener, TalkerId);
+
+				if (bEnabled && bMuted && DistanceSquared <= UnmuteDistanceSquared)
+				{
+					SetTalkerMuted(Listener, TalkerId, false);
+					bMuted = false;
+				}
+				else if (bEnabled && !bMuted && DistanceSquared > MuteDistanceSquared)
+				{
+					SetTalkerMuted(Listener, TalkerId, true);
+					bMuted = true;
+				}
+			}
+			else
+			{
+				//Only the model gets here, with a bot on either side.
+				bMuted = bEnabled && DistanceSquared > MuteDistanceSquared;
+			}
+
+			UnfilteredPackets += PacketsPerTalker;
+			RelayedPackets += bMuted ? 0.0 : PacketsPerTalker;
+		}
+	}
+}
+
+void USurvivalVoiceInterestSubsystem::UnmuteAll()
+{
+	//Talkers that already left are unmuted too, the filter is by net id. Listeners that left took their filter with them.
+	for (auto& ListenerMutes : MutedTalkers)
+	{
+		if (APlayerController* Listener = ListenerMutes.Key.Get())
+		{
+			for (const FUniqueNetIdRepl& TalkerId : ListenerMutes.Value)
+			{
+				Listener->GameplayUnmutePlayer(TalkerId);
+			}
+		}
+	}
+
+	MutedTalkers.Empty();
+}
+
+void USurvivalVoiceInterestSubsystem::SetTalkerMuted(APlayerController* Listener, const FUniqueNetIdRepl& TalkerId, const bool bMuted)
+{
+	//The server stops relaying the talker to this listener, and the listener drops the remote talker.
+	if (bMuted)
+	{
+		MutedTalkers.FindOrAdd(Listener).Add(TalkerId);
+		Listener->GameplayMutePlayer(TalkerId);
+	}
+	else
+	{
+		if (TSet<FUniqueNetIdRepl>* ListenerMutes = MutedTalkers.Find(Listener))
+		{
+			ListenerMutes->Remove(TalkerId);
+		}
+
+		Listener->GameplayUnmutePlayer(TalkerId);
+	}
+}
+
+void USurvivalVoiceInterestSubsystem::ReportSyntheticVoice()
+{
+	const double RelayedPerSecond = RelayedPackets / ReportTime;
+	const double UnfilteredPerSecond = UnfilteredPackets / ReportTime;
+
+	UE_LOG(LogTemp, Log, TEXT("Synthetic voice model: %.0f packets/s relayed, %.0f packets/s without interest management (%.0f%%)."),
+		RelayedPerSecond, UnfilteredPerSecond, UnfilteredPerSecond > 0.0 ? RelayedPerSecond * 100.0 / UnfilteredPerSecond : 100.0);
+
+	CSV_CUSTOM_STAT(SurvivalGame, VoicePacketsRelayedPerSecond, (float)RelayedPerSecond, ECsvCustomStatOp::Set);
+
+	RelayedPackets = 0.0;
+	UnfilteredPackets = 0.0;
+	ReportTime = 0.f;
+}
+
+bool USurvivalVoiceInterestSubsystem::GetHearingLocation(const AController* Controller, FVector& OutLocation)
+{
+	if (const APawn* Pawn = Controller->GetPawn())
+	{
+		OutLocation = Pawn->GetActorLocation();
+		return true;
+	}
+
+	//Dead or spectating players hear from where their camera is.
+	const APlayerController* PlayerController = Cast<APlayerController>(Controller);
+	if (PlayerController && PlayerController->PlayerCameraManager)
+	{
+		OutLocation = PlayerController->PlayerCameraManager->GetCameraLocation();
+		return true;
+	}
+
+	return false;
+}
+
+bool USurvivalVoiceInterestSubsystem::IsSyntheticVoiceEnabled()
+{
+	static const bool bSyntheticVoice = FParse::Param(FCommandLine::Get(), TEXT("SurvivalSyntheticVoice"));
+	return bSyntheticVoice;
+}
@@ -0,0 +1,80 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "GameFramework/OnlineReplStructs.h"
+#include "SurvivalVoiceInterestSubsystem.generated.h"
+
+/*Proximity voice on the server: every player only hears the players within hearing range.
+
+A few times per second the server checks who is near each listener. A talker that goes out of range is gameplay muted
+for that listener, which stops the server from relaying its voice packets to them and makes the client drop the remote
+talker. When the talker comes back in range it's unmuted. A talker is muted beyond Survival.VoiceInterest.Range * Hysteresis
+and unmuted within Survival.VoiceInterest.Range, so players on the edge don't flip every update.
+
+Mutes are kept by the net id of the talker, like the voice packet filter of the listener, so a player that leaves is
+unmuted for everyone on Logout and one that rejoins is still known. Survival.VoiceInterest 0 turns it off and unmutes
+everyone it muted.
+
+-SurvivalSyntheticVoice turns on a model of the voice traffic for bot servers: no packets are sent, it counts the packets
+the server would relay if every player and bot talked all the time, with the current mutes and without interest management.
+Bots have no net id and can't be gameplay muted, the model counts them as muted beyond the hearing range.
+The counts are logged every Survival.VoiceInterest.ReportInterval seconds.*/
+UCLASS()
+class SURVIVALGAME_API USurvivalVoiceInterestSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	USurvivalVoiceInterestSubsystem();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual TStatId GetStatId() const override;
+
+	/*True if the talker is out of the hearing range of the listener.*/
+	bool IsTalkerMuted(const class APlayerController* Listener, const FUniqueNetIdRepl& TalkerId) const;
+
+	/*[Server] Forgets the mutes of the player, and unmutes it for everyone that had it muted. Called by the game mode on Logout.*/
+	void OnPlayerLogout(class AController* Exiting);
+
+protected:
+
+	/*Net ids of the talkers each player has muted because they are too far away.*/
+	TMap<TWeakObjectPtr<class APlayerController>, TSet<FUniqueNetIdRepl>> MutedTalkers;
+
+	/*Time since the last interest update.*/
+	float UpdateTime;
+
+	bool bWasEnabled;
+
+	/*Modeled voice packets since the last report, relayed and the ones a server without interest management would relay.*/
+	double RelayedPackets;
+	double UnfilteredPackets;
+	float ReportTime;
+
+	void UpdateInterest(const float DeltaTime);
+
+	/*Gameplay unmutes every talker we muted.*/
+	void UnmuteAll();
+
+	void SetTalkerMuted(class APlayerController* Listener, const FUniqueNetIdRepl& TalkerId, const bool bMuted);
+
+	void ReportSyntheticVoice();
+
+	static bool GetHearingLocation(const class AController* Controller, FVector& OutLocation);
+
+	static bool IsSyntheticVoiceEnabled();
+};
@@ -0,0 +1,1033 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "SurvivalWorldSnapshotSubsystem.h"
+#include "SurvivalGame.h"
+
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "UObject/SoftObjectPath.h"
+
+#include "Components/InventoryComponent.h"
+#include "Items/Item.h"
+#include "World/ItemSpawn.h"
+#include "World/LootableActor.h"
+#include "World/LootPile.h"
+#include "World/Pickup.h"
+
+static TAutoConsoleVariable<int32> CVarSurvivalWorldSnapshot(
+	TEXT("Survival.WorldSnapshot"),
+	1,
+	TEXT("Records the loot of the world so a restarted server gets it back.\n")
+	TEXT("0: off, 1: on"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSurvivalWorldSnapshotInterval(
+	TEXT("Survival.WorldSnapshot.Interval"),
+	10.f,
+	TEXT("Seconds between two world snapshots. What changed in between is lost if the server crashes."),
+	ECVF_Default);
+
+/*Logs smaller than this are never compacted, it wouldn't be worth the rewrite.*/
+static const int64 MinCompactionBytes = 64 * 1024;
+
+#pragma region Log
+
+void FWorldSnapshotLog::WriteHeader(FArchive& Ar)
+{
+	uint32 FileMagic = Magic;
+	uint32 FileVersion = Version;
+
+	Ar << FileMagic;
+	Ar << FileVersion;
+}
+
+void FWorldSnapshotLog::WriteFrame(FArchive& Ar, const TArray<TPair<FString, FWorldSnapshotRecord>>& Records)
+{
+	//Class paths are written once, records point into the table. 0 is no class.
+	TArray<FString> ClassPaths;
+	TMap<FString, uint32> ClassIndices;
+
+	auto AddClass = [&ClassPaths, &ClassIndices](const FString& ClassPath)
+	{
+		if (!ClassPath.IsEmpty() && !ClassIndices.Contains(ClassPath))
+		{
+			ClassIndices.Add(ClassPath, ClassPaths.Add(ClassPath) + 1);
+		}
+	};
+
+	for (const TPair<FString, FWorldSnapshotRecord>& Record : Records)
+	{
+		for (const FString& ItemClass : Record.Value.ItemClasses)
+		{
+			AddClass(ItemClass);
+		}
+
+		AddClass(Record.Value.ActorClass);
+	}
+
+	auto GetClassIndex = [&ClassIndices](const FString& ClassPath) -> uint32
+	{
+		const uint32* ClassIndex = ClassIndices.Find(ClassPath);
+		return ClassIndex ? *ClassIndex : 0;
+	};
+
+	uint32 NumClasses = ClassPaths.Num();
+	Ar.SerializeIntPacked(NumClasses);
+
+	for (FString& ClassPath : ClassPaths)
+	{
+		Ar << ClassPath;
+	}
+
+	uint32 NumRecords = Records.Num();
+	Ar.SerializeIntPacked(NumRecords);
+
+	for (const TPair<FString, FWorldSnapshotRecord>& Record : Records)
+	{
+		const FWorldSnapshotRecord& Value = Record.Value;
+
+		FString Key = Record.Key;
+		uint8 Type = (uint8)Value.Type;
+
+		Ar << Key;
+		Ar << Type;
+
+		if (Value.Type == EWorldSnapshotRecord::WS_Container || Value.Type == EWorldSnapshotRecord::WS_Pickup)
+		{
+			uint32 NumItems = Value.ItemClasses.Num();
+			Ar.SerializeIntPacked(NumItems);
+
+			for (int32 i = 0; i < Value.ItemClasses.Num(); ++i)
+			{
+				uint32 ClassIndex = GetClassIndex(Value.ItemClasses[i]);
+				uint32 Quantity = Value.Quantities.IsValidIndex(i) ? FMath::Max(Value.Quantities[i], 0) : 0;
+
+				Ar.SerializeIntPacked(ClassIndex);
+				Ar.SerializeIntPacked(Quantity);
+			}
+		}
+
+		if (Value.Type == EWorldSnapshotRecord::WS_Container || Value.Type == EWorldSnapshotRecord::WS_Pickup)
+		{
+			uint32 ActorClassIndex = GetClassIndex(Value.ActorClass);
+			Ar.SerializeIntPacked(ActorClassIndex);
+
+			//Only pickups and loot piles spawned at runtime have to be spawned again.
+			if (ActorClassIndex != 0)
+			{
+				FVector Location = Value.Transform.GetLocation();
+				FQuat Rotation = Value.Transform.GetRotation();
+				FVector Scale = Value.Transform.GetScale3D();
+				FString SpawnerKey = Value.SpawnerKey;
+
+				Ar << Location;
+				Ar << Rotation;
+				Ar << Scale;
+				Ar << SpawnerKey;
+			}
+		}
+		else if (Value.Type == EWorldSnapshotRecord::WS_ItemSpawn)
+		{
+			int64 RespawnTime = Value.RespawnTime;
+			Ar << RespawnTime;
+		}
+	}
+}
+
+bool FWorldSnapshotLog::ReadFrame(FArchive& Ar, TArray<TPair<FString, FWorldSnapshotRecord>>& OutRecords, const uint32 FileVersion)
+{
+	//Every class and record takes at least a byte, bigger counts mean the frame is broken.
+	const int64 MaxCount = Ar.TotalSize() - Ar.Tell();
+
+	uint32 NumClasses = 0;
+	Ar.SerializeIntPacked(NumClasses);
+
+	if (Ar.IsError() || NumClasses > MaxCount)
+	{
+		return false;
+	}
+
+	TArray<FString> ClassPaths;
+	ClassPaths.SetNum(NumClasses);
+
+	for (FString& ClassPath : ClassPaths)
+	{
+		Ar << ClassPath;
+	}
+
+	auto GetClassPath = [&ClassPaths](const uint32 ClassIndex)
+	{
+		return ClassIndex > 0 ? ClassPaths[ClassIndex - 1] : FString();
+	};
+
+	uint32 NumRecords = 0;
+	Ar.SerializeIntPacked(NumRecords);
+
+	if (Ar.IsError() || NumRecords > MaxCount)
+	{
+		return false;
+	}
+
+	OutRecords.Reserve(OutRecords.Num() + NumRecords);
+
+	for (uint32 RecordIndex = 0; RecordIndex < NumRecords; ++RecordIndex)
+	{
+		FString Key;
+		uint8 Type = 0;
+
+		Ar << Key;
+		Ar << Type;
+
+		if (Ar.IsError() || Type > (uint8)EWorldSnapshotRecord::WS_ItemSpawn)
+		{
+			return false;
+		}
+
+		FWorldSnapshotRecord Value;
+		Value.Type = (EWorldSnapshotRecord)Type;
+
+		if (Value.Type == EWorldSnapshotRecord::WS_Container || Value.Type == EWorldSnapshotRecord::WS_Pickup)
+		{
+			uint32 NumItems = 0;
+			Ar.SerializeIntPacked(NumItems);
+
+			if (Ar.IsError() || NumItems > MaxCount)
+			{
+				return false;
+			}
+
+			for (uint32 i = 0; i < NumItems; ++i)
+			{
+				uint32 ClassIndex = 0;
+				uint32 Quantity = 0;
+
+				Ar.SerializeIntPacked(ClassIndex);
+				Ar.SerializeIntPacked(Quantity);
+
+				if (ClassIndex > NumClasses)
+				{
+					return false;
+				}
+
+				Value.ItemClasses.Add(GetClassPath(ClassIndex));
+				Value.Quantities.Add(Quantity);
+			}
+		}
+
+		//Containers of version 1 logs are all placed in the map.
+		if (Value.Type == EWorldSnapshotRecord::WS_Pickup || (Value.Type == EWorldSnapshotRecord::WS_Container && FileVersion >= 2))
+		{
+			uint32 ActorClassIndex = 0;
+			Ar.SerializeIntPacked(ActorClassIndex);
+
+			if (ActorClassIndex > NumClasses)
+			{
+				return false;
+			}
+
+			if (ActorClassIndex != 0)
+			{
+				FVector Location;
+				FQuat Rotation;
+				FVector Scale;
+
+				Ar << Location;
+				Ar << Rotation;
+				Ar << Scale;
+				Ar << Value.SpawnerKey;
+
+				Value.ActorClass = GetClassPath(ActorClassIndex);
+				Value.Transform = FTransform(Rotation, Location, Scale);
+			}
+		}
+		else if (Value.Type == EWorldSnapshotRecord::WS_ItemSpawn)
+		{
+			Ar << Value.RespawnTime;
+		}
+
+		OutRecords.Emplace(MoveTemp(Key), MoveTemp(Value));
+	}
+
+	return !Ar.IsError();
+}
+
+bool FWorldSnapshotLog::ReadLog(const FString& Filename, TMap<FString, FWorldSnapshotRecord>& OutRecords, int32& OutNumFrames)
+{
+	OutNumFrames = 0;
+
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *Filename, FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Data);
+
+	uint32 FileMagic = 0;
+	uint32 FileVersion = 0;
+
+	Reader << FileMagic;
+	Reader << FileVersion;
+
+	if (Reader.IsError() || FileMagic != Magic || FileVersion == 0 || FileVersion > Version)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s isn't a world snapshot log this build can read."), *Filename);
+		return false;
+	}
+
+	TArray<TPair<FString, FWorldSnapshotRecord>> Records;
+
+	while (Reader.Tell() + (int64)sizeof(int32) <= Reader.TotalSize())
+	{
+		int32 FrameSize = 0;
+		Reader << FrameSize;
+
+		const int64 FrameEnd = Reader.Tell() + FrameSize;
+
+		//The last frame was being written when the server went down.
+		if (FrameSize <= 0 || FrameEnd > Reader.TotalSize())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("The last frame of %s is cut, the world is restored from the one before."), *Filename);
+			break;
+		}
+
+		Records.Reset();
+
+		if (!ReadFrame(Reader, Records, FileVersion) || Reader.Tell() != FrameEnd)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Frame %d of %s is broken, the world is restored from the one before."), OutNumFrames, *Filename);
+			break;
+		}
+
+		ApplyFrame(Records, OutRecords);
+		++OutNumFrames;
+	}
+
+	return true;
+}
+
+void FWorldSnapshotLog::ApplyFrame(TArray<TPair<FString, FWorldSnapshotRecord>>& Records, TMap<FString, FWorldSnapshotRecord>& LiveRecords)
+{
+	for (TPair<FString, FWorldSnapshotRecord>& Record : Records)
+	{
+		if (Record.Value.Type == EWorldSnapshotRecord::WS_Forget)
+		{
+			LiveRecords.Remove(Record.Key);
+		}
+		else
+		{
+			LiveRecords.Add(Record.Key, MoveTemp(Record.Value));
+		}
+	}
+}
+
+#pragma endregion
+
+#pragma region Writer
+
+FWorldSnapshotWriter::FWorldSnapshotWriter(const FString& InFilename, TMap<FString, FWorldSnapshotRecord>&& InLiveRecords)
+	: Filename(InFilename)
+	, bCompactionRequested(false)
+	, bWriterRunning(false)
+	, LiveRecords(MoveTemp(InLiveRecords))
+	, BytesSinceCompaction(0)
+	, CompactedBytes(0)
+{
+}
+
+void FWorldSnapshotWriter::Write(TArray<TPair<FString, FWorldSnapshotRecord>>&& Records)
+{
+	{
+		FScopeLock Lock(&QueueLock);
+		Queued.Add(MoveTemp(Records));
+	}
+
+	StartWriter();
+}
+
+void FWorldSnapshotWriter::RequestCompaction()
+{
+	{
+		FScopeLock Lock(&QueueLock);
+		bCompactionRequested = true;
+	}
+
+	StartWriter();
+}
+
+void FWorldSnapshotWriter::Flush()
+{
+	for (;;)
+	{
+		{
+			FScopeLock Lock(&QueueLock);
+
+			if (!bWriterRunning && Queued.Num() == 0 && !bCompactionRequested)
+			{
+				return;
+			}
+		}
+
+		FPlatformProcess::Sleep(0.001f);
+	}
+}
+
+void FWorldSnapshotWriter::StartWriter()
+{
+	{
+		FScopeLock Lock(&QueueLock);
+
+		if (bWriterRunning)
+		{
+			return;
+		}
+
+		bWriterRunning = true;
+	}
+
+	TSharedRef<FWorldSnapshotWriter, ESPMode::ThreadSafe> Self = AsShared();
+
+	Async(EAsyncExecution::ThreadPool, [Self]()
+	{
+		Self->WriteQueued();
+	});
+}
+
+void FWorldSnapshotWriter::WriteQueued()
+{
+	for (;;)
+	{
+		TArray<TPair<FString, FWorldSnapshotRecord>> Records;
+		bool bCompact = false;
+
+		{
+			FScopeLock Lock(&QueueLock);
+
+			if (Queued.Num() == 0 && !bCompactionRequested)
+			{
+				bWriterRunning = false;
+				return;
+			}
+
+			if (Queued.Num() > 0)
+			{
+				Records = MoveTemp(Queued[0]);
+				Queued.RemoveAt(0);
+			}
+
+			bCompact = bCompactionRequested;
+			bCompactionRequested = false;
+		}
+
+		if (Records.Num() > 0)
+		{
+			AppendFrame(Records);
+			FWorldSnapshotLog::ApplyFrame(Records, LiveRecords);
+		}
+
+		//Once the old frames outweigh the live state, the log starts again from the live state.
+		if (bCompact || BytesSinceCompaction > FMath::Max(CompactedBytes, MinCompactionBytes))
+		{
+			Compact();
+		}
+	}
+}
+
+void FWorldSnapshotWriter::AppendFrame(const TArray<TPair<FString, FWorldSnapshotRecord>>& Records)
+{
+	if (!LogWriter)
+	{
+		LogWriter.Reset(IFileManager::Get().CreateFileWriter(*Filename, FILEWRITE_Append | FILEWRITE_AllowRead));
+
+		if (!LogWriter)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Couldn't open the world snapshot log %s."), *Filename);
+			return;
+		}
+
+		if (LogWriter->Tell() == 0)
+		{
+			FWorldSnapshotLog::WriteHeader(*LogWriter);
+		}
+	}
+
+	TArray<uint8> Frame;
+	FMemoryWriter FrameWriter(Frame);
+	FWorldSnapshotLog::WriteFrame(FrameWriter, Records);
+
+	int32 FrameSize = Frame.Num();
+	*LogWriter << FrameSize;
+	LogWriter->Serialize(Frame.GetData(), Frame.Num());
+	LogWriter->Flush();
+
+	BytesSinceCompaction += sizeof(int32) + Frame.Num();
+}
+
+void FWorldSnapshotWriter::Compact()
+{
+	const TArray<TPair<FString, FWorldSnapshotRecord>> Records = LiveRecords.Array();
+
+	TArray<uint8> Frame;
+	FMemoryWriter FrameWriter(Frame);
+	FWorldSnapshotLog::WriteFrame(FrameWriter, Records);
+
+	//Written next to the log and moved over it, a crash in the middle leaves the old log.
+	const FString TempFilename = Filename + TEXT(".tmp");
+	bool bWritten = false;
+
+	if (TUniquePtr<FArchive> TempWriter = TUniquePtr<FArchive>(IFileManager::Get().CreateFileWriter(*TempFilename)))
+	{
+		int32 FrameSize = Frame.Num();
+
+		FWorldSnapshotLog::WriteHeader(*TempWriter);
+		*TempWriter << FrameSize;
+		TempWriter->Serialize(Frame.GetData(), Frame.Num());
+
+		bWritten = TempWriter->Close();
+	}
+
+	//The next append opens the new log.
+	LogWriter.Reset();
+
+	BytesSinceCompaction = 0;
+
+	if (!bWritten || !IFileManager::Get().Move(*Filename, *TempFilename, true, true))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Couldn't compact the world snapshot log %s, it keeps growing until the next try."), *Filename);
+		return;
+	}
+
+	CompactedBytes = sizeof(int32) + Frame.Num();
+}
+
+#pragma endregion
+
+#pragma region Subsystem
+
+USurvivalWorldSnapshotSubsystem::USurvivalWorldSnapshotSubsystem()
+{
+	SnapshotTime = 0.f;
+	bFirstSnapshotTaken = false;
+}
+
+bool USurvivalWorldSnapshotSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && !IsRunningClientOnly() && (IsRunningDedicatedServer() || FParse::Param(FCommandLine::Get(), TEXT("WorldSnapshots")));
+}
+
+void USurvivalWorldSnapshotSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (CVarSurvivalWorldSnapshot.GetValueOnGameThread() == 0)
+	{
+		return;
+	}
+
+	UWorld* World = GetWorld();
+
+	FString MapName = FPackageName::GetShortName(World->GetOutermost());
+	MapName.RemoveFromStart(World->StreamingLevelsPrefix);
+
+	FString Directory = FPaths::ProjectSavedDir() / TEXT("WorldSnapshots");
+	FParse::Value(FCommandLine::Get(), TEXT("WorldSnapshotDir="), Directory);
+
+	IFileManager::Get().MakeDirectory(*Directory, true);
+
+	const FString Filename = Directory / MapName + TEXT(".snap");
+
+	const double StartTime = FPlatformTime::Seconds();
+	int32 NumFrames = 0;
+
+	const bool bLogRead = FWorldSnapshotLog::ReadLog(Filename, RestoredRecords, NumFrames);
+
+	if (bLogRead)
+	{
+		UE_LOG(LogTemp, Log, TEXT("Read %d world snapshot records from %d frames of %s in %.2f ms."), RestoredRecords.Num(), NumFrames, *Filename, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	}
+
+	TMap<FString, FWorldSnapshotRecord> LiveRecords = RestoredRecords;
+	Writer = MakeShared<FWorldSnapshotWriter, ESPMode::ThreadSafe>(Filename, MoveTemp(LiveRecords));
+
+	//Starts the log again from what we just read, in this version and without the frames we replayed or a frame a crash cut.
+	if (bLogRead)
+	{
+		Writer->RequestCompaction();
+	}
+
+	ActorsInitializedHandle = FWorldDelegates::OnWorldInitializedActors.AddUObject(this, &USurvivalWorldSnapshotSubsystem::OnWorldInitializedActors);
+}
+
+void USurvivalWorldSnapshotSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldInitializedActors.Remove(ActorsInitializedHandle);
+
+	//What changed since the last snapshot, the map is closing normally.
+	if (Writer.IsValid())
+	{
+		TakeSnapshot();
+
+		Writer->Flush();
+		Writer.Reset();
+	}
+
+	Super::Deinitialize();
+}
+
+void USurvivalWorldSnapshotSubsystem::Tick(float DeltaTime)
+{
+	SnapshotTime += DeltaTime;
+
+	if (SnapshotTime >= FMath::Max(CVarSurvivalWorldSnapshotInterval.GetValueOnGameThread(), 1.f))
+	{
+		SnapshotTime = 0.f;
+		TakeSnapshot();
+	}
+}
+
+bool USurvivalWorldSnapshotSubsystem::IsTickable() const
+{
+	return Writer.IsValid() && CVarSurvivalWorldSnapshot.GetValueOnGameThread() != 0 && !HasAnyFlags(RF_ClassDefaultObject);
+}
+
+TStatId USurvivalWorldSnapshotSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USurvivalWorldSnapshotSubsystem, STATGROUP_Tickables);
+}
+
+bool USurvivalWorldSnapshotSubsystem::RestoreActor(AActor* Actor)
+{
+	if (!Writer.IsValid() || !Actor || Actor->GetLocalRole() != ROLE_Authority)
+	{
+		return false;
+	}
+
+	const FString Key = Actor->GetPathName(GetWorld());
+
+	if (AItemSpawn* Spawner = Cast<AItemSpawn>(Actor))
+	{
+		bool bRestored = false;
+
+		//The pickups it had are already back in the world.
+		if (TArray<TWeakObjectPtr<APickup>>* Pickups = RestoredSpawnerPickups.Find(Key))
+		{
+			for (const TWeakObjectPtr<APickup>& Pickup : *Pickups)
+			{
+				if (Pickup.IsValid())
+				{
+					Spawner->AdoptPickup(Pickup.Get());
+					bRestored = true;
+				}
+			}
+		}
+
+		const FWorldSnapshotRecord* Record = RestoredRecords.Find(Key);
+
+		if (Record)
+		{
+			SeenKeys.Add(Key);
+		}
+
+		//Respawns that were due while the server was down happen right away.
+		if (!bRestored && Record && Record->Type == EWorldSnapshotRecord::WS_ItemSpawn && Record->RespawnTime > 0)
+		{
+			Spawner->RestoreRespawnTimer(FMath::Max<float>(Record->RespawnTime - FDateTime::UtcNow().ToUnixTimestamp(), 0.1f));
+			bRestored = true;
+		}
+
+		return bRestored;
+	}
+
+	//Anything else spawned at runtime is restored by OnWorldInitializedActors.
+	if (!Actor->bNetStartup)
+	{
+		return false;
+	}
+
+	const FWorldSnapshotRecord* Record = RestoredRecords.Find(Key);
+
+	if (!Record)
+	{
+		return false;
+	}
+
+	SeenKeys.Add(Key);
+
+	if (Record->Type == EWorldSnapshotRecord::WS_Removed)
+	{
+		Actor->Destroy();
+		return true;
+	}
+
+	if (ALootableActor* Lootable = Cast<ALootableActor>(Actor))
+	{
+		if (Record->Type == EWorldSnapshotRecord::WS_Container)
+		{
+			ApplyContainer(Lootable, *Record, ResolvedClasses);
+			return true;
+		}
+	}
+	else if (APickup* Pickup = Cast<APickup>(Actor))
+	{
+		if (Record->Type == EWorldSnapshotRecord::WS_Pickup && Record->ItemClasses.Num() > 0 && Record->Quantities.Num() > 0)
+		{
+			UClass* ItemClass = ResolveClass(Record->ItemClasses[0], ResolvedClasses);
+
+			if (ItemClass && ItemClass->IsChildOf(UItem::StaticClass()))
+			{
+				Pickup->InitializePickup(ItemClass, Record->Quantities[0]);
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void USurvivalWorldSnapshotSubsystem::TrackActor(AActor* Actor)
+{
+	if (!Writer.IsValid() || !Actor || Actor->IsPendingKill() || Actor->GetLocalRole() != ROLE_Authority || TrackedKeys.Contains(Actor))
+	{
+		return;
+	}
+
+	FString Key;
+	bool bNewActor = false;
+
+	if (Actor->bNetStartup)
+	{
+		Key = Actor->GetPathName(GetWorld());
+	}
+	else if (!RestoredActorKeys.RemoveAndCopyValue(Actor, Key))
+	{
+		//Of what's spawned at runtime, only pickups and loot piles are kept.
+		if (!Actor->IsA<APickup>() && !Actor->IsA<ALootPile>())
+		{
+			return;
+		}
+
+		Key = FString::Printf(TEXT("%s_%s"), Actor->IsA<APickup>() ? TEXT("Pickup") : TEXT("LootPile"), *FGuid::NewGuid().ToString());
+		bNewActor = true;
+	}
+
+	TrackedKeys.Add(Actor, Key);
+	SeenKeys.Add(Key);
+
+	Actor->OnDestroyed.AddUniqueDynamic(this, &USurvivalWorldSnapshotSubsystem::OnTrackedActorDestroyed);
+
+	if (bNewActor)
+	{
+		DirtyActors.Add(Actor);
+	}
+}
+
+void USurvivalWorldSnapshotSubsystem::SetPickupSpawner(APickup* Pickup, AItemSpawn* Spawner)
+{
+	if (Writer.IsValid() && Pickup && Spawner)
+	{
+		PickupSpawners.Add(Pickup, Spawner->GetPathName(GetWorld()));
+		MarkActorDirty(Pickup);
+	}
+}
+
+void USurvivalWorldSnapshotSubsystem::MarkActorDirty(AActor* Actor)
+{
+	UWorld* World = Actor ? Actor->GetWorld() : nullptr;
+	USurvivalWorldSnapshotSubsystem* Snapshots = World ? World->GetSubsystem<USurvivalWorldSnapshotSubsystem>() : nullptr;
+
+	if (Snapshots && Snapshots->TrackedKeys.Contains(Actor))
+	{
+		Snapshots->DirtyActors.Add(Actor);
+	}
+}
+
+void USurvivalWorldSnapshotSubsystem::TakeSnapshot()
+{
+	if (!Writer.IsValid())
+	{
+		return;
+	}
+
+	SURVIVAL_SCOPE_CYCLE_COUNTER(WorldSnapshot);
+
+	TArray<TPair<FString, FWorldSnapshotRecord>> Records = MoveTemp(PendingRemovals);
+	PendingRemovals.Reset();
+
+	Records.Reserve(Records.Num() + DirtyActors.Num());
+
+	for (const TWeakObjectPtr<AActor>& Actor : DirtyActors)
+	{
+		const FString* Key = TrackedKeys.Find(Actor);
+		FWorldSnapshotRecord Record;
+
+		if (Key && Actor.IsValid() && CaptureRecord(Actor.Get(), Record))
+		{
+			Records.Emplace(*Key, MoveTemp(Record));
+		}
+	}
+
+	DirtyActors.Reset();
+
+	//Every actor had its chance to claim its record by now. What's left isn't in the map anymore.
+	if (!bFirstSnapshotTaken)
+	{
+		for (const TPair<FString, FWorldSnapshotRecord>& Record : RestoredRecords)
+		{
+			if (!SeenKeys.Contains(Record.Key))
+			{
+				Records.Emplace(Record.Key, FWorldSnapshotRecord());
+			}
+		}
+
+		RestoredRecords.Empty();
+		RestoredActorKeys.Empty();
+		RestoredSpawnerPickups.Empty();
+		ResolvedClasses.Empty();
+		SeenKeys.Empty();
+
+		bFirstSnapshotTaken = true;
+	}
+
+	if (Records.Num() > 0)
+	{
+		UE_LOG(LogTemp, Verbose, TEXT("World snapshot of %d changed actors."), Records.Num());
+
+		Writer->Write(MoveTemp(Records));
+	}
+}
+
+void USurvivalWorldSnapshotSubsystem::CaptureContainer(const ALootableActor* Lootable, FWorldSnapshotRecord& OutRecord)
+{
+	OutRecord.Type = EWorldSnapshotRecord::WS_Container;
+
+	if (!Lootable->Inventory)
+	{
+		return;
+	}
+
+	for (const UItem* Item : Lootable->Inventory->GetItems())
+	{
+		if (Item)
+		{
+			OutRecord.ItemClasses.Add(Item->GetClass()->GetPathName());
+			OutRecord.Quantities.Add(Item->GetQuantity());
+		}
+	}
+}
+
+void USurvivalWorldSnapshotSubsystem::ApplyContainer(ALootableActor* Lootable, const FWorldSnapshotRecord& Record, TMap<FString, UClass*>& ClassCache)
+{
+	UInventoryComponent* Inventory = Lootable->Inventory;
+
+	if (!Inventory)
+	{
+		return;
+	}
+
+	for (UItem* Item : Inventory->GetItems())
+	{
+		Inventory->RemoveItem(Item);
+	}
+
+	for (int32 i = 0; i < Record.ItemClasses.Num() && i < Record.Quantities.Num(); ++i)
+	{
+		UClass* ItemClass = ResolveClass(Record.ItemClasses[i], ClassCache);
+
+		if (ItemClass && ItemClass->IsChildOf(UItem::StaticClass()) && Record.Quantities[i] > 0)
+		{
+			Inventory->TryAddItemFromClass(ItemClass, Record.Quantities[i]);
+		}
+	}
+}
+
+void USurvivalWorldSnapshotSubsystem::OnWorldInitializedActors(const UWorld::FActorsInitializedParams& Params)
+{
+	if (Params.World != GetWorld() || !Writer.IsValid())
+	{
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	int32 NumSpawned = 0;
+
+	//Pickups and loot piles dropped or spawned at runtime aren't in the map, they are spawned again before anything begins play.
+	for (const TPair<FString, FWorldSnapshotRecord>& Record : RestoredRecords)
+	{
+		const FWorldSnapshotRecord& Value = Record.Value;
+
+		if (Value.Type == EWorldSnapshotRecord::WS_Container && !Value.ActorClass.IsEmpty())
+		{
+			UClass* LootableClass = ResolveClass(Value.ActorClass, ResolvedClasses);
+
+			if (!LootableClass || !LootableClass->IsChildOf(ALootableActor::StaticClass()))
+			{
+				continue;
+			}
+
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.bNoFail = true;
+			SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+			if (ALootableActor* Lootable = GetWorld()->SpawnActor<ALootableActor>(LootableClass, Value.Transform, SpawnParams))
+			{
+				ApplyContainer(Lootable, Value, ResolvedClasses);
+
+				RestoredActorKeys.Add(Lootable, Record.Key);
+				SeenKeys.Add(Record.Key);
+
+				++NumSpawned;
+			}
+
+			continue;
+		}
+
+		if (Value.Type != EWorldSnapshotRecord::WS_Pickup || Value.ActorClass.IsEmpty() || Value.ItemClasses.Num() == 0 || Value.Quantities.Num() == 0)
+		{
+			continue;
+		}
+
+		UClass* PickupClass = ResolveClass(Value.ActorClass, ResolvedClasses);
+		UClass* ItemClass = ResolveClass(Value.ItemClasses[0], ResolvedClasses);
+
+		if (!PickupClass || !PickupClass->IsChildOf(APickup::StaticClass()) || !ItemClass || !ItemClass->IsChildOf(UItem::StaticClass()))
+		{
+			continue;
+		}
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.bNoFail = true;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		APickup* Pickup = GetWorld()->SpawnActor<APickup>(PickupClass, Value.Transform, SpawnParams);
+
+		if (!Pickup)
+		{
+			continue;
+		}
+
+		Pickup->InitializePickup(ItemClass, Value.Quantities[0]);
+
+		RestoredActorKeys.Add(Pickup, Record.Key);
+		SeenKeys.Add(Record.Key);
+
+		if (!Value.SpawnerKey.IsEmpty())
+		{
+			PickupSpawners.Add(Pickup, Value.SpawnerKey);
+			RestoredSpawnerPickups.FindOrAdd(Value.SpawnerKey).Add(Pickup);
+		}
+
+		++NumSpawned;
+	}
+
+	if (NumSpawned > 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("Spawned %d pickups and loot piles from the world snapshot in %.2f ms."), NumSpawned, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	}
+}
+
+void USurvivalWorldSnapshotSubsystem::OnTrackedActorDestroyed(AActor* DestroyedActor)
+{
+	FString Key;
+
+	if (!TrackedKeys.RemoveAndCopyValue(DestroyedActor, Key))
+	{
+		return;
+	}
+
+	DirtyActors.Remove(DestroyedActor);
+	PickupSpawners.Remove(DestroyedActor);
+
+	//Actors of the map are in the map again after a restart, they have to be removed. Runtime ones just aren't spawned.
+	FWorldSnapshotRecord Record;
+	Record.Type = DestroyedActor->bNetStartup ? EWorldSnapshotRecord::WS_Removed : EWorldSnapshotRecord::WS_Forget;
+
+	PendingRemovals.Emplace(Key, MoveTemp(Record));
+}
+
+bool USurvivalWorldSnapshotSubsystem::CaptureRecord(AActor* Actor, FWorldSnapshotRecord& OutRecord) const
+{
+	if (const ALootableActor* Lootable = Cast<ALootableActor>(Actor))
+	{
+		CaptureContainer(Lootable, OutRecord);
+
+		if (!Lootable->bNetStartup)
+		{
+			OutRecord.ActorClass = Lootable->GetClass()->GetPathName();
+			OutRecord.Transform = Lootable->GetActorTransform();
+		}
+
+		return true;
+	}
+
+	if (const APickup* Pickup = Cast<APickup>(Actor))
+	{
+		//Not initialized yet, the pickup is dirty again when it is.
+		const UItem* Item = Pickup->GetItem();
+
+		if (!Item)
+		{
+			return false;
+		}
+
+		OutRecord.Type = EWorldSnapshotRecord::WS_Pickup;
+		OutRecord.ItemClasses.Add(Item->GetClass()->GetPathName());
+		OutRecord.Quantities.Add(Item->GetQuantity());
+
+		if (!Pickup->bNetStartup)
+		{
+			OutRecord.ActorClass = Pickup->GetClass()->GetPathName();
+			OutRecord.Transform = Pickup->GetActorTransform();
+
+			if (const FString* SpawnerKey = PickupSpawners.Find(Actor))
+			{
+				OutRecord.SpawnerKey = *SpawnerKey;
+			}
+		}
+
+		return true;
+	}
+
+	if (const AItemSpawn* Spawner = Cast<AItemSpawn>(Actor))
+	{
+		const float RespawnTimeRemaining = Spawner->GetRespawnTimeRemaining();
+
+		OutRecord.Type = EWorldSnapshotRecord::WS_ItemSpawn;
+		OutRecord.RespawnTime = RespawnTimeRemaining >= 0.f ? FDateTime::UtcNow().ToUnixTimestamp() + FMath::CeilToInt(RespawnTimeRemaining) : 0;
+
+		return true;
+	}
+
+	return false;
+}
+
+UClass* USurvivalWorldSnapshotSubsystem::ResolveClass(const FString& ClassPath, TMap<FString, UClass*>& ClassCache)
+{
+	if (UClass** CachedClass = ClassCache.Find(ClassPath))
+	{
+		return *CachedClass;
+	}
+
+	UClass* Class = FSoftClassPath(ClassPath).TryLoadClass<UObject>();
+
+	if (!Class)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Class %s of the world snapshot doesn't exist anymore, what used it isn't restored."), *ClassPath);
+	}
+
+	ClassCache.Add(ClassPath, Class);
+	return Class;
+}
+
+#pragma endregion
@@ -0,0 +1,205 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "Engine/World.h"
+#include "SurvivalWorldSnapshotSubsystem.generated.h"
+
+/*What a snapshot keeps of an actor. WS = World Snapshot.*/
+enum class EWorldSnapshotRecord : uint8
+{
+	/*The actor is gone and there is nothing to restore, the record is dropped from the log.*/
+	WS_Forget,
+	/*An actor placed in the map was destroyed, it's destroyed again on restore.*/
+	WS_Removed,
+	/*The items of a lootable actor. Loot piles spawned at runtime also keep their class and transform.*/
+	WS_Container,
+	/*The item of a pickup. Pickups spawned at runtime also keep their class, transform and item spawn.*/
+	WS_Pickup,
+	/*When an item spawn that had all its pickups taken spawns new ones.*/
+	WS_ItemSpawn
+};
+
+struct SURVIVALGAME_API FWorldSnapshotRecord
+{
+	EWorldSnapshotRecord Type = EWorldSnapshotRecord::WS_Forget;
+
+	/*Items of a container, or the one item of a pickup: class paths and quantities.*/
+	TArray<FString> ItemClasses;
+	TArray<int32> Quantities;
+
+	/*Pickups and loot piles spawned at runtime only, placed actors are already in the map.*/
+	FString ActorClass;
+	FTransform Transform;
+	FString SpawnerKey;
+
+	/*Unix time of the respawn of an item spawn, 0 if it isn't waiting for one.*/
+	int64 RespawnTime = 0;
+};
+
+/*The format of the world snapshot log, an append-only file per map.
+File: Magic, Version and then frames until the end of the file. A frame is its size and the records of one snapshot,
+only the actors that changed since the one before. Item classes are written once per frame in a table.
+Replaying the frames in order gives the state of the world. A frame cut by a crash is ignored.*/
+class SURVIVALGAME_API FWorldSnapshotLog
+{
+public:
+
+	static const uint32 Magic = 0x53575653; //SVWS
+	/*2: containers spawned at runtime keep their class and transform, like pickups.*/
+	static const uint32 Version = 2;
+
+	static void WriteHeader(FArchive& Ar);
+	static void WriteFrame(FArchive& Ar, const TArray<TPair<FString, FWorldSnapshotRecord>>& Records);
+
+	/*False if the frame is broken.*/
+	static bool ReadFrame(FArchive& Ar, TArray<TPair<FString, FWorldSnapshotRecord>>& OutRecords, const uint32 FileVersion = Version);
+
+	/*Replays the whole log into the live records. False if there is no log or it isn't one.*/
+	static bool ReadLog(const FString& Filename, TMap<FString, FWorldSnapshotRecord>& OutRecords, int32& OutNumFrames);
+
+	/*Applies a frame on top of the live records.*/
+	static void ApplyFrame(TArray<TPair<FString, FWorldSnapshotRecord>>& Records, TMap<FString, FWorldSnapshotRecord>& LiveRecords);
+};
+
+/*Appends the snapshots to the log on the thread pool, one at a time and in the order they were taken.
+It keeps the live records too, and once more was appended since the last compaction than the compaction wrote, it rewrites
+the log with only the live records. The log stays under about twice the size of the world state.*/
+class SURVIVALGAME_API FWorldSnapshotWriter : public TSharedFromThis<FWorldSnapshotWriter, ESPMode::ThreadSafe>
+{
+public:
+
+	FWorldSnapshotWriter(const FString& InFilename, TMap<FString, FWorldSnapshotRecord>&& InLiveRecords);
+
+	void Write(TArray<TPair<FString, FWorldSnapshotRecord>>&& Records);
+
+	/*Rewrites the log with only the live records, next time the writer runs.*/
+	void RequestCompaction();
+
+	/*Blocks until everything queued is written.*/
+	void Flush();
+
+private:
+
+	void StartWriter();
+	void WriteQueued();
+
+	/*Writer thread only.*/
+	void AppendFrame(const TArray<TPair<FString, FWorldSnapshotRecord>>& Records);
+	void Compact();
+
+	FString Filename;
+
+	FCriticalSection QueueLock;
+	TArray<TArray<TPair<FString, FWorldSnapshotRecord>>> Queued;
+	bool bCompactionRequested;
+	bool bWriterRunning;
+
+	/*Only the writer touches these.*/
+	TMap<FString, FWorldSnapshotRecord> LiveRecords;
+	TUniquePtr<FArchive> LogWriter;
+	int64 BytesSinceCompaction;
+	int64 CompactedBytes;
+};
+
+/*Keeps the loot of the world across server restarts and crashes: the items in lootable actors, the pickups on the ground
+(placed in the map, dropped by players or spawned by item spawns), the loot piles of dropped items and the respawn timers
+of the item spawns.
+
+Every Survival.WorldSnapshot.Interval seconds, the actors that changed since the last snapshot are recorded and the writer
+appends them to Saved/WorldSnapshots/<Map>.snap (or in -WorldSnapshotDir=<path>) off the game thread.
+When the map loads, the log is read before any actor begins play: the pickups and loot piles spawned at runtime are spawned again
+once the actors are initialized, and lootable actors, placed pickups and item spawns take their state back in BeginPlay
+instead of rolling new loot. All of it happens while the map loads, before the server takes any connection.
+
+Runs on dedicated servers, or anywhere with -WorldSnapshots. Survival.WorldSnapshot 0 turns it off.*/
+UCLASS()
+class SURVIVALGAME_API USurvivalWorldSnapshotSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	USurvivalWorldSnapshotSubsystem();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual TStatId GetStatId() const override;
+
+	/*[Server] Gives the actor the state it had in the last snapshot. Called first thing in BeginPlay, returns false if the
+	actor wasn't in it and has to set itself up as usual.*/
+	bool RestoreActor(AActor* Actor);
+
+	/*[Server] Starts recording the changes of the actor. Called at the end of BeginPlay, so the loot it rolls isn't a change.*/
+	void TrackActor(AActor* Actor);
+
+	/*The pickup was spawned by this item spawn, it's given back to it on restore.*/
+	void SetPickupSpawner(class APickup* Pickup, class AItemSpawn* Spawner);
+
+	/*The actor has to be in the next snapshot. Does nothing if the actor isn't tracked.*/
+	static void MarkActorDirty(AActor* Actor);
+
+	/*Records everything that changed since the last snapshot.*/
+	UFUNCTION(BlueprintCallable, Category = "World Snapshot")
+	void TakeSnapshot();
+
+	static void CaptureContainer(const class ALootableActor* Lootable, FWorldSnapshotRecord& OutRecord);
+
+	/*Replaces the items of the lootable actor with the ones of the record. ClassCache keeps the classes already resolved.*/
+	static void ApplyContainer(class ALootableActor* Lootable, const FWorldSnapshotRecord& Record, TMap<FString, UClass*>& ClassCache);
+
+protected:
+
+	TSharedPtr<FWorldSnapshotWriter, ESPMode::ThreadSafe> Writer;
+
+	/*The state read from the log, until the first snapshot.*/
+	TMap<FString, FWorldSnapshotRecord> RestoredRecords;
+
+	/*The key of every tracked actor: its path for actors placed in the map, a guid for pickups and loot piles spawned at runtime.*/
+	TMap<TWeakObjectPtr<AActor>, FString> TrackedKeys;
+
+	/*Every key restored or tracked since the map loaded. Restored records nobody claimed are dropped from the log.*/
+	TSet<FString> SeenKeys;
+
+	TSet<TWeakObjectPtr<AActor>> DirtyActors;
+
+	/*Tracked actors destroyed since the last snapshot.*/
+	TArray<TPair<FString, FWorldSnapshotRecord>> PendingRemovals;
+
+	/*The item spawn of each pickup that has one.*/
+	TMap<TWeakObjectPtr<AActor>, FString> PickupSpawners;
+
+	/*Pickups and loot piles spawned again on restore with their key, and the pickups by item spawn.*/
+	TMap<TWeakObjectPtr<AActor>, FString> RestoredActorKeys;
+	TMap<FString, TArray<TWeakObjectPtr<class APickup>>> RestoredSpawnerPickups;
+
+	UPROPERTY(Transient)
+	TMap<FString, UClass*> ResolvedClasses;
+
+	FDelegateHandle ActorsInitializedHandle;
+
+	float SnapshotTime;
+
+	bool bFirstSnapshotTaken;
+
+	void OnWorldInitializedActors(const UWorld::FActorsInitializedParams& Params);
+
+	UFUNCTION()
+	void OnTrackedActorDestroyed(AActor* DestroyedActor);
+
+	bool CaptureRecord(AActor* Actor, FWorldSnapshotRecord& OutRecord) const;
+
+	static UClass* ResolveClass(const FString& ClassPath, TMap<FString, UClass*>& ClassCache);
+};
@@ -30,11 +30,11 @@ void UEquippableItem::Use(class ASurvivalCharacter* Character)
 {
 	if (Character && Character->GetLocalRole() == ROLE_Authority)
 	{
-		//If the character contains that item in their slots, and is not equipped.
-		if (Character->GetEquippedItems().Contains(Slot) && !bEquipped)
-		{			
-			UEquippableItem* AlreadyEquippedItem = *Character->GetEquippedItems().Find(Slot); //We find that item inside the characters Items			
-			AlreadyEquippedItem->SetEquipped(false); //And change that item state
+		//If the character has another item in this slot, and this one is not equipped.
+		UEquippableItem* AlreadyEquippedItem = Character->GetEquippedItem(Slot);
+		if (AlreadyEquippedItem && !bEquipped)
+		{
+			AlreadyEquippedItem->SetEquipped(false); //Change that item state
 		}
 
 		//If the item is equipped, it will unEquip.
@@ -75,7 +75,7 @@ void UEquippableItem::AddedToInventory(class UInventoryComponent* Inventory)
 		if (Character && !Character->IsLooting())
 		{
 			//If we take an item that we can equip, and don't have an item equipped at its slot, them auto equip it.
-			if (!Character->GetEquippedItems().Contains(Slot))
+			if (!Character->GetEquippedItem(Slot))
 			{
 				SetEquipped(true);
 			}
@@ -96,13 +96,17 @@ void UEquippableItem::EquipStatusChanged()
 	{
 		UseActionText = bEquipped ? LOCTEXT("UnequipText", "UnEquip") : LOCTEXT("EquipText", "Equip");
 		 
-		if (bEquipped)
-		{
-			Equip(Character);
-		}
-		else
+		//Only the server changes the slots. Clients get them from the character's replicated EquippedItems.
+		if (Character->HasAuthority())
 		{
-			UnEquip(Character);
+			if (bEquipped)
+			{
+				Equip(Character);
+			}
+			else
+			{
+				UnEquip(Character);
+			}
 		}
 
 		//Tell the UI to Update
@@ -23,7 +23,8 @@ enum class EEquippableSlot : uint8
 	EIS_Hands			UMETA(DisplayName = "Hands"),
 	EIS_Backpack		UMETA(DisplayName = "Backpack"),
 	EIS_PrimaryWeapon	UMETA(DisplayName = "Primary Weapon"),
-	EIS_Throwable		UMETA(DisplayName = "Throwable Item")
+	EIS_Throwable		UMETA(DisplayName = "Throwable Item"),
+	EIS_MAX				UMETA(Hidden)
 };
 
 
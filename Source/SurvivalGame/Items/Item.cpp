@@ -7,10 +7,30 @@
 
 #include "Item.h"
 #include "Components/InventoryComponent.h"
+#include "Framework/SurvivalWorldSnapshotSubsystem.h"
 #include "Net/UnrealNetwork.h"
 
 #define  LOCTEXT_NAMESPACE "Item"
 
+bool FItemStack::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	UObject* Class = ItemClass.Get();
+	bOutSuccess = Map ? Map->SerializeObject(Ar, UClass::StaticClass(), Class) : false;
+
+	//Most stacks are a few items, packed they take a byte.
+	uint32 PackedQuantity = FMath::Max(Quantity, 0);
+	Ar.SerializeIntPacked(PackedQuantity);
+
+	if (Ar.IsLoading())
+	{
+		UClass* LoadedClass = Cast<UClass>(Class);
+		ItemClass = LoadedClass && LoadedClass->IsChildOf(UItem::StaticClass()) ? LoadedClass : nullptr;
+		Quantity = PackedQuantity;
+	}
+
+	return true;
+}
+
 void UItem::GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
@@ -56,6 +76,28 @@ UItem::UItem()
 	Quantity		= 1;
 	MaxStackSize	= 2;
 	RepKey			= 0;
+	DefinitionId	= INDEX_NONE;
+}
+
+void UItem::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	//Items created while a package loads can be on the async loading thread, those read their own defaults.
+	if (!HasAnyFlags(RF_ClassDefaultObject) && IsInGameThread())
+	{
+		DefinitionId = FItemDefinitionRegistry::Get().FindId(GetClass());
+	}
+}
+
+FItemDefinition UItem::GetDefinition() const
+{
+	if (const FItemDefinition* Definition = FItemDefinitionRegistry::Get().GetDefinition(DefinitionId))
+	{
+		return *Definition;
+	}
+
+	return FItemDefinitionRegistry::MakeDefinition(this);
 }
 
 void UItem::OnRep_Quantity()
@@ -97,6 +139,9 @@ void UItem::MarkDirtyForReplication()
 	if (OwningInventory)
 	{
 		++OwningInventory->ReplicatedItemsKey;
+
+		//Containers keep their items across server restarts.
+		USurvivalWorldSnapshotSubsystem::MarkActorDirty(OwningInventory->GetOwner());
 	}
 }
 
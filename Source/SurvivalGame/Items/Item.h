@@ -8,6 +8,7 @@
 
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
+#include "Items/ItemDefinitionRegistry.h"
 #include "Item.generated.h"
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnItemModified);
@@ -22,6 +23,36 @@ enum class EItemRarity : uint8
 	IR_Legendary	UMETA(DisplayName = "Legendary")
 };
 
+/*An item as plain data, its class and how many of it. Replicated instead of an UItem subobject where the clients don't need
+the behavior of the item, it saves the subobject header and the item's own properties.
+The class is an object reference, so it's sent as a NetGUID the connection already knows after the first item of that class.*/
+USTRUCT(BlueprintType)
+struct SURVIVALGAME_API FItemStack
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY(BlueprintReadOnly, Category = "Item")
+	TSubclassOf<class UItem> ItemClass;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Item")
+	int32 Quantity = 0;
+
+	bool IsValid() const { return ItemClass && Quantity > 0; }
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FItemStack> : public TStructOpsTypeTraitsBase2<FItemStack>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
 /*Item master class. 
 Every item inherits from here and it can we set it to whatever we want.*/
 UCLASS(Blueprintable, EditInlineNew, DefaultToInstanced)
@@ -38,6 +69,8 @@ protected:
 
 	virtual class UWorld* GetWorld() const override;
 
+	virtual void PostInitProperties() override;
+
 #if WITH_EDITOR
 	
 	/*Allows designers to change properties only inside UnrealEngine Editor.
@@ -105,6 +138,9 @@ public:
 	UPROPERTY()
 	int32 RepKey;
 
+	/*Id of the class in the FItemDefinitionRegistry, INDEX_NONE if it isn't in it.*/
+	int32 DefinitionId;
+
 	UPROPERTY(BlueprintAssignable)
 	FOnItemModified OnItemModified;
 
@@ -125,6 +161,9 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Item")
 	FORCEINLINE float GetStackWeight() const { return Quantity * Weight; };
 
+	/*Weight and stack data of the class. From the item definition registry when it's loaded, from the item itself otherwise.*/
+	FItemDefinition GetDefinition() const;
+
 	/*There are items that we don't show in the inventory sometimes. Like if we equip something, we still have that item but we don't want to show it on inventory. */
 	UFUNCTION(BlueprintPure, Category = "Item")
 	virtual bool ShouldShowInInventory() const;
@@ -0,0 +1,252 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "ItemDefinitionRegistry.h"
+
+#include "Algo/BinarySearch.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Hash/CityHash.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#include "Items/Item.h"
+
+struct FItemDefinitionFileHeader
+{
+	uint32 Magic;
+	uint32 Version;
+	uint32 NumItems;
+	uint32 Reserved;
+
+	/*CityHash64 of the class hashes and the definitions.*/
+	uint64 ContentHash;
+};
+
+static_assert(sizeof(FItemDefinitionFileHeader) == 24, "The class hashes after the header have to stay 8 byte aligned.");
+
+FItemDefinitionRegistry& FItemDefinitionRegistry::Get()
+{
+	static FItemDefinitionRegistry Registry;
+	return Registry;
+}
+
+FItemDefinitionRegistry::FItemDefinitionRegistry()
+	: NumItems(0)
+	, ContentHash(0)
+	, ClassHashes(nullptr)
+	, Definitions(nullptr)
+{
+}
+
+FItemDefinitionRegistry::~FItemDefinitionRegistry()
+{
+	Unload();
+}
+
+FString FItemDefinitionRegistry::GetDefaultFilename()
+{
+	return FPaths::ProjectContentDir() / TEXT("ItemRegistry") / TEXT("ItemDefinitions.bin");
+}
+
+bool FItemDefinitionRegistry::Load(const FString& Filename)
+{
+	Unload();
+
+	const uint8* Data = nullptr;
+	int64 DataSize = 0;
+
+	MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+
+	if (MappedFile)
+	{
+		MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+	}
+
+	if (MappedRegion)
+	{
+		Data = MappedRegion->GetMappedPtr();
+		DataSize = MappedRegion->GetMappedSize();
+	}
+	else
+	{
+		//In a pak file or on a platform that can't map files.
+		MappedFile.Reset();
+
+		if (!FFileHelper::LoadFileToArray(FileData, *Filename, FILEREAD_Silent))
+		{
+			return false;
+		}
+
+		Data = FileData.GetData();
+		DataSize = FileData.Num();
+	}
+
+	FItemDefinitionFileHeader Header;
+	FMemory::Memzero(Header);
+
+	if (DataSize >= (int64)sizeof(Header))
+	{
+		FMemory::Memcpy(&Header, Data, sizeof(Header));
+	}
+
+	const int64 ExpectedSize = sizeof(Header) + (int64)Header.NumItems * (sizeof(uint64) + sizeof(FItemDefinition));
+
+	if (Header.Magic != Magic || Header.Version != Version || Header.NumItems > MAX_int32 || DataSize < ExpectedSize)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s isn't an item definition registry of this build, items read their class defaults."), *Filename);
+
+		Unload();
+		return false;
+	}
+
+	//A file cut short or changed by hand, the ids could point at the wrong definitions.
+	const uint64 DataHash = CityHash64((const char*)(Data + sizeof(Header)), ExpectedSize - sizeof(Header));
+
+	if (DataHash != Header.ContentHash)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s doesn't match its content hash, items read their class defaults."), *Filename);
+
+		Unload();
+		return false;
+	}
+
+	NumItems = Header.NumItems;
+	ContentHash = Header.ContentHash;
+	ClassHashes = (const uint64*)(Data + sizeof(Header));
+	Definitions = (const FItemDefinition*)(Data + sizeof(Header) + NumItems * sizeof(uint64));
+
+	return true;
+}
+
+void FItemDefinitionRegistry::Unload()
+{
+	NumItems = 0;
+	ContentHash = 0;
+	ClassHashes = nullptr;
+	Definitions = nullptr;
+
+	ClassIds.Empty();
+
+	//The region has to go before the file it maps.
+	MappedRegion.Reset();
+	MappedFile.Reset();
+	FileData.Empty();
+}
+
+int32 FItemDefinitionRegistry::FindId(const UClass* ItemClass)
+{
+	if (!ItemClass || NumItems == 0)
+	{
+		return INDEX_NONE;
+	}
+
+	if (const int32* CachedId = ClassIds.Find(ItemClass))
+	{
+		return *CachedId;
+	}
+
+	const uint64 Hash = HashClassPath(ItemClass->GetPathName());
+	const int32 Index = Algo::LowerBound(TArrayView<const uint64>(ClassHashes, NumItems), Hash);
+	int32 Id = Index < NumItems && ClassHashes[Index] == Hash ? Index : INDEX_NONE;
+
+#if !UE_BUILD_SHIPPING
+	//Someone changed the defaults of the class after the table was generated. Once per class, the id is cached.
+	if (Id != INDEX_NONE)
+	{
+		const FItemDefinition ClassDefinition = MakeDefinition(ItemClass->GetDefaultObject<UItem>());
+
+		if (FMemory::Memcmp(&ClassDefinition, &Definitions[Id], sizeof(FItemDefinition)) != 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("The item definition registry is out of date for %s, it reads its class defaults. Cook again or run -run=SurvivalItemRegistry."), *ItemClass->GetPathName());
+			Id = INDEX_NONE;
+		}
+	}
+#endif
+
+	ClassIds.Add(ItemClass, Id);
+	return Id;
+}
+
+FItemDefinition FItemDefinitionRegistry::GetDefinition(TSubclassOf<UItem> ItemClass)
+{
+	if (const FItemDefinition* Definition = GetDefinition(FindId(ItemClass)))
+	{
+		return *Definition;
+	}
+
+	return MakeDefinition(ItemClass ? ItemClass->GetDefaultObject<UItem>() : GetDefault<UItem>());
+}
+
+FItemDefinition FItemDefinitionRegistry::MakeDefinition(const UItem* ItemDefaults)
+{
+	FItemDefinition Definition;
+	FMemory::Memzero(Definition);
+
+	Definition.Weight = ItemDefaults->Weight;
+	Definition.MaxStackSize = ItemDefaults->MaxStackSize;
+	Definition.DefaultQuantity = ItemDefaults->GetQuantity();
+	Definition.Rarity = (uint8)ItemDefaults->Rarity;
+	Definition.bStackable = ItemDefaults->bStackable ? 1 : 0;
+
+	return Definition;
+}
+
+void FItemDefinitionRegistry::Generate(const TArray<UClass*>& ItemClasses, TArray<uint8>& OutData)
+{
+	TArray<TPair<uint64, FItemDefinition>> Entries;
+	TSet<uint64> Hashes;
+
+	for (UClass* ItemClass : ItemClasses)
+	{
+		if (!ItemClass || !ItemClass->IsChildOf(UItem::StaticClass()))
+		{
+			continue;
+		}
+
+		const uint64 Hash = HashClassPath(ItemClass->GetPathName());
+
+		if (Hashes.Contains(Hash))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s has the same hash as another item class, it reads its class defaults."), *ItemClass->GetPathName());
+			continue;
+		}
+
+		Hashes.Add(Hash);
+		Entries.Emplace(Hash, MakeDefinition(ItemClass->GetDefaultObject<UItem>()));
+	}
+
+	Entries.Sort([](const TPair<uint64, FItemDefinition>& A, const TPair<uint64, FItemDefinition>& B) { return A.Key < B.Key; });
+
+	FItemDefinitionFileHeader Header;
+	Header.Magic = Magic;
+	Header.Version = Version;
+	Header.NumItems = Entries.Num();
+	Header.Reserved = 0;
+
+	OutData.SetNumZeroed(sizeof(Header) + Entries.Num() * (sizeof(uint64) + sizeof(FItemDefinition)));
+
+	uint8* HashData = OutData.GetData() + sizeof(Header);
+	uint8* DefinitionData = HashData + Entries.Num() * sizeof(uint64);
+
+	for (int32 i = 0; i < Entries.Num(); ++i)
+	{
+		FMemory::Memcpy(HashData + i * sizeof(uint64), &Entries[i].Key, sizeof(uint64));
+		FMemory::Memcpy(DefinitionData + i * sizeof(FItemDefinition), &Entries[i].Value, sizeof(FItemDefinition));
+	}
+
+	//The header goes last, it has the hash of everything after it.
+	Header.ContentHash = CityHash64((const char*)HashData, OutData.Num() - sizeof(Header));
+	FMemory::Memcpy(OutData.GetData(), &Header, sizeof(Header));
+}
+
+uint64 FItemDefinitionRegistry::HashClassPath(const FString& ClassPath)
+{
+	//UTF-8, so the hash doesn't depend on the size of TCHAR on the platform.
+	const FTCHARToUTF8 Utf8ClassPath(*ClassPath);
+	return CityHash64(Utf8ClassPath.Get(), Utf8ClassPath.Length());
+}
@@ -0,0 +1,99 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/SubclassOf.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+class UItem;
+
+/*The defaults of an item class the inventory and loot code need. 16 bytes, so four of them fit in a cache line.
+Display texts, meshes and thumbnails stay on the class defaults, only the UI and error messages read them.*/
+struct FItemDefinition
+{
+	float Weight;
+	int32 MaxStackSize;
+	int32 DefaultQuantity;
+	uint8 Rarity;
+	uint8 bStackable;
+	uint8 Padding[2];
+};
+
+static_assert(sizeof(FItemDefinition) == 16, "FItemDefinition is written to disk as is, keep it 16 bytes.");
+
+/*A table of FItemDefinition for every UItem class, generated from the class defaults when the project is cooked (or by
+-run=SurvivalItemRegistry) and memory-mapped when the game module starts. The id of an item class is its index in the table.
+
+File: Magic, Version, NumItems, the 64 bit hash of everything after the header, then the 64 bit hashes of the class paths
+sorted (the index of a hash is the id of the class), then the definitions in the same order. Written little endian, like
+every platform we ship on. A file whose content doesn't match its hash isn't loaded.
+
+Item classes that aren't in the table (a new Blueprint and nobody regenerated it) read their own defaults, like before.
+Outside of shipping builds every entry is checked against the class defaults the first time the class is looked up, and
+read from the defaults if they changed since the table was generated.
+Not loaded in the editor, where designers change the defaults all the time, unless it's started with -ItemRegistry.*/
+class SURVIVALGAME_API FItemDefinitionRegistry
+{
+public:
+
+	static const uint32 Magic = 0x44495653; //SVID
+	static const uint32 Version = 2;
+
+	static FItemDefinitionRegistry& Get();
+
+	~FItemDefinitionRegistry();
+
+	/*Content/ItemRegistry/ItemDefinitions.bin, staged as a loose file so it can be mapped.*/
+	static FString GetDefaultFilename();
+
+	/*Maps the file, or reads it if the platform can't map it. Replaces what was loaded before.*/
+	bool Load(const FString& Filename);
+	void Unload();
+
+	bool IsLoaded() const { return NumItems > 0; }
+	int32 GetNumItems() const { return NumItems; }
+
+	/*The hash of the table that is loaded, to tell two of them apart in the logs.*/
+	uint64 GetContentHash() const { return ContentHash; }
+
+	/*INDEX_NONE if the class isn't in the table. Game thread only, the ids are cached by class.*/
+	int32 FindId(const UClass* ItemClass);
+
+	FORCEINLINE const FItemDefinition* GetDefinition(const int32 Id) const
+	{
+		return Id >= 0 && Id < NumItems ? &Definitions[Id] : nullptr;
+	}
+
+	/*The definition of the class from the table, or from its defaults if it isn't in it.*/
+	FItemDefinition GetDefinition(TSubclassOf<UItem> ItemClass);
+
+	static FItemDefinition MakeDefinition(const UItem* ItemDefaults);
+
+	/*Builds the file for these classes.*/
+	static void Generate(const TArray<UClass*>& ItemClasses, TArray<uint8>& OutData);
+
+	static uint64 HashClassPath(const FString& ClassPath);
+
+private:
+
+	FItemDefinitionRegistry();
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	/*The file when it couldn't be mapped.*/
+	TArray<uint8> FileData;
+
+	int32 NumItems;
+	uint64 ContentHash;
+	const uint64* ClassHashes;
+	const FItemDefinition* Definitions;
+
+	TMap<const UClass*, int32> ClassIds;
+};
@@ -0,0 +1,385 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "SurvivalBotController.h"
+
+#include "EngineUtils.h"
+#include "GameFramework/GameModeBase.h"
+
+#include "Player/SurvivalCharacter.h"
+#include "Components/InteractionComponent.h"
+#include "Components/InventoryComponent.h"
+#include "Items/WeaponItem.h"
+#include "Items/ThrowableItem.h"
+#include "Weapons/Weapon.h"
+#include "World/Pickup.h"
+
+ASurvivalBotController::ASurvivalBotController()
+{
+	Behavior = EBotBehavior::BB_Wanderer;
+
+	DecisionInterval	= 0.5f;
+	SearchRadius		= 5000.f;
+	FireHoldTime		= 1.f;
+	RespawnDelay		= 5.f;
+	DropItemChance		= 0.1f;
+
+	ForwardInput = 0.f;
+	RightInput = 0.f;
+
+	//Bots count as players: they have a player state, a name and they can be killed like anyone else.
+	bWantsPlayerState = true;
+}
+
+void ASurvivalBotController::OnPossess(APawn* InPawn)
+{
+	Super::OnPossess(InPawn);
+
+	GetWorldTimerManager().ClearTimer(TimerHandle_Respawn);
+	GetWorldTimerManager().SetTimer(TimerHandle_Decide, this, &ASurvivalBotController::Decide, DecisionInterval, true, FMath::FRandRange(0.f, DecisionInterval));
+}
+
+void ASurvivalBotController::OnUnPossess()
+{
+	ReleaseInputs();
+	GetWorldTimerManager().ClearTimer(TimerHandle_Decide);
+
+	Super::OnUnPossess();
+}
+
+void ASurvivalBotController::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	//Same as holding the movement keys, every frame.
+	if (ASurvivalCharacter* BotCharacter = GetSurvivalCharacter())
+	{
+		if (BotCharacter->IsAlive())
+		{
+			BotCharacter->MoveFoward(ForwardInput);
+			BotCharacter->MoveRight(RightInput);
+		}
+	}
+}
+
+ASurvivalCharacter* ASurvivalBotController::GetSurvivalCharacter() const
+{
+	return Cast<ASurvivalCharacter>(GetPawn());
+}
+
+void ASurvivalBotController::Decide()
+{
+	ASurvivalCharacter* BotCharacter = GetSurvivalCharacter();
+
+	if (!BotCharacter)
+	{
+		return;
+	}
+
+	if (!BotCharacter->IsAlive())
+	{
+		ReleaseInputs();
+
+		if (!GetWorldTimerManager().IsTimerActive(TimerHandle_Respawn))
+		{
+			GetWorldTimerManager().SetTimer(TimerHandle_Respawn, this, &ASurvivalBotController::Respawn, RespawnDelay, false);
+		}
+		return;
+	}
+
+	EquipFromInventory(BotCharacter);
+
+	switch (Behavior)
+	{
+	case EBotBehavior::BB_Fighter:
+		Fight(BotCharacter);
+		break;
+	case EBotBehavior::BB_Looter:
+		Loot(BotCharacter);
+		break;
+	case EBotBehavior::BB_Grenadier:
+		ThrowGrenade(BotCharacter);
+		break;
+	default:
+		Wander(BotCharacter);
+		break;
+	}
+}
+
+void ASurvivalBotController::Wander(ASurvivalCharacter* BotCharacter)
+{
+	ClearFocus(EAIFocusPriority::Gameplay);
+
+	//Turn a little bit from time to time, like someone walking around.
+	if (FMath::FRand() < 0.3f)
+	{
+		FRotator NewRotation = GetControlRotation();
+		NewRotation.Yaw += FMath::FRandRange(-90.f, 90.f);
+		NewRotation.Pitch = 0.f;
+		SetControlRotation(NewRotation);
+	}
+
+	ForwardInput = 1.f;
+	RightInput = FMath::FRand() < 0.2f ? FMath::FRandRange(-1.f, 1.f) : 0.f;
+
+	if (FMath::FRand() < 0.3f && BotCharacter->CanSprint())
+	{
+		BotCharacter->StartSprinting();
+	}
+	else
+	{
+		BotCharacter->StopSprinting();
+	}
+}
+
+void ASurvivalBotController::Fight(ASurvivalCharacter* BotCharacter)
+{
+	ASurvivalCharacter* Enemy = FindClosestEnemy(BotCharacter);
+
+	if (!Enemy)
+	{
+		BotCharacter->StopAiming();
+		Wander(BotCharacter);
+		return;
+	}
+
+	SetFocus(Enemy);
+	BotCharacter->StopSprinting();
+
+	const float EnemyDistance = FVector::Dist(BotCharacter->GetActorLocation(), Enemy->GetActorLocation());
+
+	//Without a weapon we have to get close enough to punch.
+	if (!BotCharacter->GetEquippedWeapon() && EnemyDistance > BotCharacter->GetMeleeAttackDistance())
+	{
+		ForwardInput = 1.f;
+		RightInput = 0.f;
+		return;
+	}
+
+	//Strafe while we shoot.
+	ForwardInput = 0.f;
+	RightInput = FMath::RandBool() ? 1.f : -1.f;
+
+	BotCharacter->StartAiming();
+	BotCharacter->StartFire();
+
+	GetWorldTimerManager().SetTimer(TimerHandle_StopFire, this, &ASurvivalBotController::StopFire, FireHoldTime, false);
+}
+
+void ASurvivalBotController::Loot(ASurvivalCharacter* BotCharacter)
+{
+	//Drop something from time to time, so other looters have something to pick up.
+	if (FMath::FRand() < DropItemChance && BotCharacter->GetPlayerInventory())
+	{
+		const TArray<UItem*> Items = BotCharacter->GetPlayerInventory()->GetItems();
+
+		if (Items.Num() > 0)
+		{
+			BotCharacter->DropItem(Items[FMath::RandRange(0, Items.Num() - 1)], 1);
+		}
+	}
+
+	//Still holding the interact key, the interaction takes time.
+	if (GetWorldTimerManager().IsTimerActive(TimerHandle_StopInteract))
+	{
+		ForwardInput = 0.f;
+		RightInput = 0.f;
+		return;
+	}
+
+	APickup* Pickup = FindClosestPickup(BotCharacter);
+
+	if (!Pickup)
+	{
+		Wander(BotCharacter);
+		return;
+	}
+
+	SetFocus(Pickup);
+	BotCharacter->StopSprinting();
+
+	//The character checks what we are looking at on its own, we only have to press the interact key when it finds something.
+	if (UInteractionComponent* Interactable = BotCharacter->GetInteractable())
+	{
+		ForwardInput = 0.f;
+		RightInput = 0.f;
+
+		BotCharacter->BeginInteract();
+
+		if (FMath::IsNearlyZero(Interactable->InteractionTime))
+		{
+			BotCharacter->EndInteract();
+		}
+		else
+		{
+			//Held a little longer than the interaction takes, so the character finishes it before we let go.
+			GetWorldTimerManager().SetTimer(TimerHandle_StopInteract, this, &ASurvivalBotController::StopInteract, Interactable->InteractionTime + 0.1f, false);
+		}
+	}
+	else
+	{
+		ForwardInput = 1.f;
+		RightInput = 0.f;
+	}
+}
+
+void ASurvivalBotController::ThrowGrenade(ASurvivalCharacter* BotCharacter)
+{
+	if (!BotCharacter->CanUseThrowable())
+	{
+		Wander(BotCharacter);
+		return;
+	}
+
+	//Throw at the closest player if there is one, or just anywhere forward.
+	if (ASurvivalCharacter* Enemy = FindClosestEnemy(BotCharacter))
+	{
+		SetFocus(Enemy);
+	}
+	else
+	{
+		ClearFocus(EAIFocusPriority::Gameplay);
+	}
+
+	ForwardInput = 0.f;
+	RightInput = 0.f;
+
+	BotCharacter->UseThrowable();
+}
+
+void ASurvivalBotController::EquipFromInventory(ASurvivalCharacter* BotCharacter)
+{
+	if (!BotCharacter->GetPlayerInventory())
+	{
+		return;
+	}
+
+	bool bNeedsWeapon = BotCharacter->GetEquippedWeapon() == nullptr;
+	bool bNeedsThrowable = BotCharacter->GetThrowable() == nullptr;
+
+	if (!bNeedsWeapon && !bNeedsThrowable)
+	{
+		return;
+	}
+
+	for (UItem* Item : BotCharacter->GetPlayerInventory()->GetItems())
+	{
+		UEquippableItem* Equippable = Cast<UEquippableItem>(Item);
+
+		if (!Equippable || Equippable->IsEquipped())
+		{
+			continue;
+		}
+
+		//Using an equippable item equips it, same as clicking it in the inventory. Only the first one of each, the next would replace it.
+		if (bNeedsWeapon && Equippable->IsA<UWeaponItem>())
+		{
+			BotCharacter->UseItem(Equippable);
+			bNeedsWeapon = false;
+		}
+		else if (bNeedsThrowable && Equippable->IsA<UThrowableItem>())
+		{
+			BotCharacter->UseItem(Equippable);
+			bNeedsThrowable = false;
+		}
+
+		if (!bNeedsWeapon && !bNeedsThrowable)
+		{
+			break;
+		}
+	}
+}
+
+void ASurvivalBotController::StopFire()
+{
+	if (ASurvivalCharacter* BotCharacter = GetSurvivalCharacter())
+	{
+		BotCharacter->StopFire();
+	}
+}
+
+void ASurvivalBotController::StopInteract()
+{
+	if (ASurvivalCharacter* BotCharacter = GetSurvivalCharacter())
+	{
+		BotCharacter->EndInteract();
+	}
+}
+
+void ASurvivalBotController::ReleaseInputs()
+{
+	ForwardInput = 0.f;
+	RightInput = 0.f;
+
+	GetWorldTimerManager().ClearTimer(TimerHandle_StopFire);
+	GetWorldTimerManager().ClearTimer(TimerHandle_StopInteract);
+	ClearFocus(EAIFocusPriority::Gameplay);
+
+	if (ASurvivalCharacter* BotCharacter = GetSurvivalCharacter())
+	{
+		BotCharacter->StopFire();
+		BotCharacter->StopAiming();
+		BotCharacter->StopSprinting();
+		BotCharacter->EndInteract();
+	}
+}
+
+void ASurvivalBotController::Respawn()
+{
+	//Same as a player pressing respawn on the death screen: the body stays to be looted, and we get a new character.
+	UnPossess();
+
+	if (AGameModeBase* GameMode = GetWorld()->GetAuthGameMode())
+	{
+		GameMode->RestartPlayer(this);
+	}
+}
+
+ASurvivalCharacter* ASurvivalBotController::FindClosestEnemy(const ASurvivalCharacter* BotCharacter) const
+{
+	ASurvivalCharacter* ClosestEnemy = nullptr;
+	float ClosestDistanceSquared = FMath::Square(SearchRadius);
+
+	for (TActorIterator<ASurvivalCharacter> It(GetWorld()); It; ++It)
+	{
+		ASurvivalCharacter* Other = *It;
+
+		if (Other == BotCharacter || !Other->IsAlive())
+		{
+			continue;
+		}
+
+		const float DistanceSquared = FVector::DistSquared(BotCharacter->GetActorLocation(), Other->GetActorLocation());
+
+		if (DistanceSquared < ClosestDistanceSquared)
+		{
+			ClosestDistanceSquared = DistanceSquared;
+			ClosestEnemy = Other;
+		}
+	}
+
+	return ClosestEnemy;
+}
+
+APickup* ASurvivalBotController::FindClosestPickup(const ASurvivalCharacter* BotCharacter) const
+{
+	APickup* ClosestPickup = nullptr;
+	float ClosestDistanceSquared = FMath::Square(SearchRadius);
+
+	for (TActorIterator<APickup> It(GetWorld()); It; ++It)
+	{
+		const float DistanceSquared = FVector::DistSquared(BotCharacter->GetActorLocation(), It->GetActorLocation());
+
+		if (DistanceSquared < ClosestDistanceSquared)
+		{
+			ClosestDistanceSquared = DistanceSquared;
+			ClosestPickup = *It;
+		}
+	}
+
+	return ClosestPickup;
+}
@@ -0,0 +1,103 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIController.h"
+#include "SurvivalBotController.generated.h"
+
+//What a bot spends its time doing. BB = Bot Behavior.
+UENUM(BlueprintType)
+enum class EBotBehavior : uint8
+{
+	BB_Wanderer			UMETA(DisplayName = "Wanderer"),
+	BB_Fighter			UMETA(DisplayName = "Fighter"),
+	BB_Looter			UMETA(DisplayName = "Looter"),
+	BB_Grenadier		UMETA(DisplayName = "Grenadier"),
+	BB_MAX				UMETA(Hidden)
+};
+
+/*A server side bot used to load test the dedicated server.
+It doesn't have any AI logic of its own: every few moments it decides what to do, and then it calls the same functions the
+player input calls on the character (move, sprint, aim, fire, throw, interact, drop), so the server runs the real gameplay code.*/
+UCLASS()
+class SURVIVALGAME_API ASurvivalBotController : public AAIController
+{
+	GENERATED_BODY()
+
+public:
+
+	ASurvivalBotController();
+
+	virtual void Tick(float DeltaTime) override;
+
+	FORCEINLINE EBotBehavior GetBehavior() const { return Behavior; }
+	void SetBehavior(const EBotBehavior NewBehavior) { Behavior = NewBehavior; }
+
+protected:
+
+	virtual void OnPossess(APawn* InPawn) override;
+	virtual void OnUnPossess() override;
+
+	UPROPERTY(EditAnywhere, Category = "Bot")
+	EBotBehavior Behavior;
+
+	/*How often the bot decides what to do next. Every bot starts at a random moment so they don't all think in the same frame.*/
+	UPROPERTY(EditDefaultsOnly, Category = "Bot")
+	float DecisionInterval;
+
+	/*How far the bot looks for players to fight and pickups to loot.*/
+	UPROPERTY(EditDefaultsOnly, Category = "Bot")
+	float SearchRadius;
+
+	/*How long the bot holds the fire button.*/
+	UPROPERTY(EditDefaultsOnly, Category = "Bot")
+	float FireHoldTime;
+
+	/*Seconds after dying until the bot spawns again.*/
+	UPROPERTY(EditDefaultsOnly, Category = "Bot")
+	float RespawnDelay;
+
+	/*Chance of dropping an item of the inventory every time a looter decides.*/
+	UPROPERTY(EditDefaultsOnly, Category = "Bot", meta = (ClampMin = 0.0, ClampMax = 1.0))
+	float DropItemChance;
+
+	FTimerHandle TimerHandle_Decide;
+	FTimerHandle TimerHandle_StopFire;
+	FTimerHandle TimerHandle_StopInteract;
+	FTimerHandle TimerHandle_Respawn;
+
+	/*The same values the movement axes would have if a player were pressing the keys.*/
+	float ForwardInput;
+	float RightInput;
+
+	class ASurvivalCharacter* GetSurvivalCharacter() const;
+
+	/*Decides what to do until the next decision.*/
+	void Decide();
+
+	void Wander(class ASurvivalCharacter* BotCharacter);
+	void Fight(class ASurvivalCharacter* BotCharacter);
+	void Loot(class ASurvivalCharacter* BotCharacter);
+	void ThrowGrenade(class ASurvivalCharacter* BotCharacter);
+
+	/*Equips the first weapon and throwable of the inventory, if we don't have them equipped already.*/
+	void EquipFromInventory(class ASurvivalCharacter* BotCharacter);
+
+	void StopFire();
+
+	/*Releases the interact key, once an interaction that takes time is done.*/
+	void StopInteract();
+
+	/*Releases every button the bot could be holding.*/
+	void ReleaseInputs();
+
+	void Respawn();
+
+	class ASurvivalCharacter* FindClosestEnemy(const class ASurvivalCharacter* BotCharacter) const;
+	class APickup* FindClosestPickup(const class ASurvivalCharacter* BotCharacter) const;
+};
@@ -11,6 +11,7 @@
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "GameFramework/PlayerState.h"
+#include "GameFramework/GameStateBase.h"
 #include "GameFramework/DamageType.h"
 
 #include "Components/CapsuleComponent.h"
@@ -26,12 +27,19 @@
 #include "Weapons/SurvivalDamageTypes.h"
 #include "Weapons/Weapon.h"
 #include "Weapons/ThrowableWeapon.h"
+#include "Weapons/ThrowableProjectileManager.h"
 
 #include "World/Pickup.h"
+#include "World/LootPile.h"
 
 #include "Net/UnrealNetwork.h"
 #include "Player/SurvivalPlayerController.h"
+#include "Framework/SurvivalTelemetrySubsystem.h"
+#include "Framework/SurvivalServerJournalSubsystem.h"
+#include "Framework/SurvivalPlayerSaveSubsystem.h"
+#include "Framework/SurvivalGroundLootSubsystem.h"
 #include "Camera/CameraComponent.h"
+#include "Engine/GameInstance.h"
 #include "Materials/MaterialInstance.h"
 #include "Kismet/GameplayStatics.h"
 
@@ -73,6 +81,8 @@ ASurvivalCharacter::ASurvivalCharacter()
 	PlayerInventory->SetCapacity(20);
 	PlayerInventory->SetWeightCapacity(80.f);
 
+	LootPileClass = ALootPile::StaticClass();
+
 	LootPlayerInteraction = CreateDefaultSubobject<UInteractionComponent>("PlayerInteraction");
 	LootPlayerInteraction->InteractableActionText	= LOCTEXT("LootPlayerText", "Loot");
 	LootPlayerInteraction->InteractableNameText		= LOCTEXT("LootPlayerName", "Player");
@@ -80,6 +90,8 @@ ASurvivalCharacter::ASurvivalCharacter()
 	LootPlayerInteraction->SetActive(false, true);
 	LootPlayerInteraction->bAutoActivate = false;
 
+	EquippedItems.SetNumZeroed((int32)EEquippableSlot::EIS_MAX);
+
 	InteractionCheckFrequency	= 0.f;
 	InterationCheckDistance		= 1000.f;
 
@@ -90,6 +102,10 @@ ASurvivalCharacter::ASurvivalCharacter()
 	WalkSpeed = GetCharacterMovement()->MaxWalkSpeed;
 
 	bIsAiming = false;
+	bStripServerCosmetics = true;
+
+	MaxThrowableOriginError = 150.f;
+	LastThrowablePredictionKey = 0;
 
 	GetCharacterMovement()->NavAgentProps.bCanCrouch = true;
 	GetMesh()->SetOwnerNoSee(true);
@@ -99,6 +115,13 @@ ASurvivalCharacter::ASurvivalCharacter()
 	bAlwaysRelevant = true;
 }
 
+void ASurvivalCharacter::ProcessEvent(UFunction* Function, void* Parameters)
+{
+	USurvivalServerJournalSubsystem::FScopedServerRPC JournalScope(this, Function, Parameters);
+
+	Super::ProcessEvent(Function, Parameters);
+}
+
 void ASurvivalCharacter::BeginPlay()
 {
 	Super::BeginPlay();
@@ -116,6 +139,26 @@ void ASurvivalCharacter::BeginPlay()
 	{
 		NakedMeshes.Add(PlayerMesh.Key, PlayerMesh.Value->SkeletalMesh);
 	}
+
+	if (ShouldStripCosmetics())
+	{
+		StripServerCosmetics();
+	}
+}
+
+void ASurvivalCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	//The server is stopping. A player leaving is saved by their controller, destroying us already took our player state.
+	//Dead characters have nothing left to save.
+	if (GetLocalRole() == ROLE_Authority && IsAlive() && EndPlayReason != EEndPlayReason::Destroyed)
+	{
+		if (USurvivalPlayerSaveSubsystem* PlayerSaves = GetGameInstance() ? GetGameInstance()->GetSubsystem<USurvivalPlayerSaveSubsystem>() : nullptr)
+		{
+			PlayerSaves->SavePlayer(this);
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void ASurvivalCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
@@ -155,6 +198,7 @@ void ASurvivalCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& O
 	DOREPLIFETIME(ASurvivalCharacter, bSprinting);
 	DOREPLIFETIME(ASurvivalCharacter, Killer);
 	DOREPLIFETIME(ASurvivalCharacter, EquippedWeapon);
+	DOREPLIFETIME(ASurvivalCharacter, EquippedItems);
 
 	DOREPLIFETIME_CONDITION(ASurvivalCharacter, LootSource, COND_OwnerOnly);
 	DOREPLIFETIME_CONDITION(ASurvivalCharacter, Health,		COND_OwnerOnly); //Only the owner needs to know about the health. But the server can be authoritative.
@@ -202,13 +246,25 @@ void ASurvivalCharacter::Restart()
 	{
 		PC->ShowInGameUI(); //Called every time the player restarts. 
 	}
+
+	//Gives back what the player had when they left, the first time they spawn after a login.
+	if (GetLocalRole() == ROLE_Authority)
+	{
+		if (USurvivalPlayerSaveSubsystem* PlayerSaves = GetGameInstance() ? GetGameInstance()->GetSubsystem<USurvivalPlayerSaveSubsystem>() : nullptr)
+		{
+			PlayerSaves->RestorePlayer(this);
+		}
+	}
 }
 
 float ASurvivalCharacter::TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
-	Super::TakeDamage(Damage, DamageEvent, EventInstigator, DamageCauser);
+	const float SuperDamage = Super::TakeDamage(Damage, DamageEvent, EventInstigator, DamageCauser);
+
+	//Only explosions take what Super returns, the damage scaled by the distance to the explosion. Everything else is dealt as it comes, like always.
+	const float ActualDamage = DamageEvent.IsOfType(FRadialDamageEvent::ClassID) ? SuperDamage : Damage;
 
-	const float DamageDealt = ModifyHealth(-Damage);
+	const float DamageDealt = ModifyHealth(-ActualDamage);
 
 	if (Health <= 0.f)
 	{
@@ -220,6 +276,12 @@ float ASurvivalCharacter::TakeDamage(float Damage, struct FDamageEvent const& Da
 		{
 			Suicide(DamageEvent, DamageCauser);
 		}
+
+		//Everything stays on the body for others to loot, the player comes back with nothing.
+		if (USurvivalPlayerSaveSubsystem* PlayerSaves = GetGameInstance() ? GetGameInstance()->GetSubsystem<USurvivalPlayerSaveSubsystem>() : nullptr)
+		{
+			PlayerSaves->ClearPlayer(this);
+		}
 	}
 
 	return DamageDealt;
@@ -236,6 +298,31 @@ void ASurvivalCharacter::SetActorHiddenInGame(bool bNewHidden)
 	}
 }
 
+void ASurvivalCharacter::StripServerCosmetics()
+{
+	for (auto& PlayerMesh : PlayerMeshes)
+	{
+		USkeletalMeshComponent* MeshComponent = PlayerMesh.Value;
+
+		//The head is our main mesh. It runs the animation, the ragdoll and holds the physics asset for hits, so we never touch it.
+		if (!MeshComponent || MeshComponent == GetMesh())
+		{
+			continue;
+		}
+
+		//The head already drives the bones and physics bodies of the meshes that follow its pose, they don't need their own tick.
+		MeshComponent->SetComponentTickEnabled(false);
+
+		//Slots without a naked mesh (helmet, vest, backpack) are pure cosmetics. Release them so they don't update bones or keep any state.
+		if (!MeshComponent->SkeletalMesh)
+		{
+			MeshComponent->bNoSkeletonUpdate = true;
+			MeshComponent->SetMasterPoseComponent(nullptr);
+			MeshComponent->UnregisterComponent();
+		}
+	}
+}
+
 #pragma region Loot
 
 void ASurvivalCharacter::SetLootSource(class UInventoryComponent* NewLootSource)
@@ -280,6 +367,8 @@ void ASurvivalCharacter::BeginLootingPlayer(class ASurvivalCharacter* Character)
 
 void ASurvivalCharacter::ServerSetLootSource_Implementation(class UInventoryComponent* NewLootSource)
 {
+	SURVIVAL_COUNT_RPC(ServerSetLootSource);
+
 	SetLootSource(NewLootSource);
 }
 
@@ -340,6 +429,8 @@ void ASurvivalCharacter::LootItem(class UItem* ItemToGive)
 
 void ASurvivalCharacter::ServerLootItem_Implementation(class UItem* ItemToLoot)
 {
+	SURVIVAL_COUNT_RPC(ServerLootItem);
+
 	LootItem(ItemToLoot);
 }
 
@@ -349,6 +440,8 @@ void ASurvivalCharacter::ServerLootItem_Implementation(class UItem* ItemToLoot)
 
 void ASurvivalCharacter::PerformInteractionCheck()
 {
+	SURVIVAL_SCOPE_CYCLE_COUNTER(PerformInteractionCheck);
+
 	if (GetController() == nullptr)
 	{
 		return;
@@ -489,11 +582,15 @@ void ASurvivalCharacter::EndInteract()
 
 void ASurvivalCharacter::ServerBeginInteract_Implementation()
 {
+	SURVIVAL_COUNT_RPC(ServerBeginInteract);
+
 	BeginInteract();
 }
 
 void ASurvivalCharacter::ServerEndInteract_Implementation()
 {
+	SURVIVAL_COUNT_RPC(ServerEndInteract);
+
 	EndInteract();
 }
 
@@ -550,6 +647,8 @@ void ASurvivalCharacter::UseItem(class UItem* Item)
 
 void ASurvivalCharacter::ServerUseItem_Implementation(class UItem* Item)
 {
+	SURVIVAL_COUNT_RPC(ServerUseItem);
+
 	UseItem(Item);
 }
 
@@ -568,30 +667,25 @@ void ASurvivalCharacter::DropItem(class UItem* Item, const int32 Quantity)
 			const int32 ItemQuantity = Item->GetQuantity(); //Store the quantity of the item.
 			const int32 DroppedQuantity = PlayerInventory->ConsumeItem(Item, Quantity); //How much we have drop.
 
-			FActorSpawnParameters SpawnParams;
-			SpawnParams.Owner = this;
-			SpawnParams.bNoFail = true; //Always spawn the item. 
-
-			//If we somehow drop an item inside of a wall, Unreal is gonna try to correct that item so is not inside of the wall.
-			SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
-
 			FVector SpawnLocation = GetActorLocation();
 			//Adjust the z by half of the height. Like the actor location is the center of the player, subtract the half of the capsule and we have the feet.
 			SpawnLocation.Z -= GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
 
 			FTransform SpawnTransform(GetActorRotation(), SpawnLocation);
 
-			ensure(PickupClass);
-
-			APickup* Pickup = GetWorld()->SpawnActor<APickup>(PickupClass, SpawnTransform, SpawnParams);
-
-			Pickup->InitializePickup(Item->GetClass(), DroppedQuantity); //Give the pickup the item to represent and the amount.
+			//Spawns the pickup, or merges the item with what was already dropped here.
+			if (USurvivalGroundLootSubsystem* GroundLoot = GetWorld()->GetSubsystem<USurvivalGroundLootSubsystem>())
+			{
+				GroundLoot->DropItem(this, Item->GetClass(), DroppedQuantity, SpawnTransform, PickupClass, LootPileClass);
+			}
 		}
 	}
 }
 
 void ASurvivalCharacter::ServerDropItem_Implementation(class UItem* Item, const int32 Quantity)
 {
+	SURVIVAL_COUNT_RPC(ServerDropItem);
+
 	DropItem(Item, Quantity);
 }
 
@@ -601,31 +695,59 @@ void ASurvivalCharacter::ServerDropItem_Implementation(class UItem* Item, const
 
 bool ASurvivalCharacter::EquipItem(class UEquippableItem* Item)
 {
-	EquippedItems.Add(Item->Slot, Item);
+	EquippedItems[(int32)Item->Slot] = Item;
 	OnEquippedItemsChanged.Broadcast(Item->Slot, Item);
 	return true;
 }
 
 bool ASurvivalCharacter::UnEquipItem(class UEquippableItem* Item)
 {
-	if (Item)
+	if (Item && Item == GetEquippedItem(Item->Slot))
 	{
-		if (EquippedItems.Contains(Item->Slot))
-		{
-			if (Item == *EquippedItems.Find(Item->Slot))
-			{
-				EquippedItems.Remove(Item->Slot);
-				OnEquippedItemsChanged.Broadcast(Item->Slot, nullptr);
-				return true;
-			}
-		}
+		EquippedItems[(int32)Item->Slot] = nullptr;
+		OnEquippedItemsChanged.Broadcast(Item->Slot, nullptr);
+		return true;
 	}
 
 	return false;
 }
 
+void ASurvivalCharacter::OnRep_EquippedItems(const TArray<UEquippableItem*>& OldEquippedItems)
+{
+	for (int32 SlotIndex = 0; SlotIndex < EquippedItems.Num(); ++SlotIndex)
+	{
+		UEquippableItem* OldItem = OldEquippedItems.IsValidIndex(SlotIndex) ? OldEquippedItems[SlotIndex] : nullptr;
+		UEquippableItem* NewItem = EquippedItems[SlotIndex];
+
+		if (OldItem == NewItem)
+		{
+			continue;
+		}
+
+		const EEquippableSlot Slot = (EEquippableSlot)SlotIndex;
+
+		//Weapons and throwables have nothing to show here, the weapon actor is replicated by itself.
+		if (UGearItem* Gear = Cast<UGearItem>(NewItem))
+		{
+			EquipGear(Gear);
+		}
+		else if (Cast<UGearItem>(OldItem))
+		{
+			UnEquipGear(Slot);
+		}
+
+		OnEquippedItemsChanged.Broadcast(Slot, NewItem);
+	}
+}
+
 void ASurvivalCharacter::EquipGear(class UGearItem* Gear)
 {
+	//The server only needs to know that the gear is equipped, not how it looks.
+	if (ShouldStripCosmetics())
+	{
+		return;
+	}
+
 	//Which one of the skeletalMeshComponents, is this gear for?
 	if (USkeletalMeshComponent* GearMesh = *PlayerMeshes.Find(Gear->Slot))
 	{
@@ -636,6 +758,11 @@ void ASurvivalCharacter::EquipGear(class UGearItem* Gear)
 
 void ASurvivalCharacter::UnEquipGear(const EEquippableSlot Slot)
 {
+	if (ShouldStripCosmetics())
+	{
+		return;
+	}
+
 	if (USkeletalMeshComponent* EquippableMesh = *PlayerMeshes.Find(Slot)) //Find this mesh
 	{
 		if (USkeletalMesh* BodyMesh = *NakedMeshes.Find(Slot)) //Find the naked mesh version of that slot
@@ -707,6 +834,11 @@ void ASurvivalCharacter::OnRep_EquippedWeapon()
 	}
 }
 
+bool ASurvivalCharacter::ShouldStripCosmetics() const
+{
+	return bStripServerCosmetics && GetNetMode() == NM_DedicatedServer;
+}
+
 class USkeletalMeshComponent* ASurvivalCharacter::GetSlotSkeletalMeshComponent(const EEquippableSlot Slot)
 {
 	if (PlayerMeshes.Contains(Slot))
@@ -716,13 +848,55 @@ class USkeletalMeshComponent* ASurvivalCharacter::GetSlotSkeletalMeshComponent(c
 	return nullptr;
 }
 
+TMap<EEquippableSlot, UEquippableItem*> ASurvivalCharacter::GetEquippedItems() const
+{
+	TMap<EEquippableSlot, UEquippableItem*> EquippedItemsMap;
+
+	for (int32 SlotIndex = 0; SlotIndex < EquippedItems.Num(); ++SlotIndex)
+	{
+		if (EquippedItems[SlotIndex])
+		{
+			EquippedItemsMap.Add((EEquippableSlot)SlotIndex, EquippedItems[SlotIndex]);
+		}
+	}
+
+	return EquippedItemsMap;
+}
+
 #pragma endregion
 
 #pragma region Trow Items
 
-void ASurvivalCharacter::ServerUseThrowable_Implementation()
+void ASurvivalCharacter::ServerUseThrowable_Implementation(const FVector& Origin, const FVector& Direction, const uint8 PredictionKey)
 {
-	UseThrowable();
+	SURVIVAL_COUNT_RPC(ServerUseThrowable);
+
+	if (CanUseThrowable())
+	{
+		if (UThrowableItem* Throwable = GetThrowable())
+		{
+			FVector ServerOrigin;
+			FVector ServerDirection;
+			GetThrowableLaunch(ServerOrigin, ServerDirection);
+
+			//Trust the client throw only if it's close to where we think it is, so the trajectory matches the one it predicted.
+			const bool bAcceptClientLaunch = FVector::DistSquared(Origin, ServerOrigin) <= FMath::Square(MaxThrowableOriginError) && !Direction.IsNearlyZero();
+
+			//The client threw this half a round trip ago, so the server throwable has to catch up that time.
+			float CatchUpTime = 0.f;
+			if (APlayerState* PS = GetPlayerState())
+			{
+				CatchUpTime = PS->ExactPing * 0.0005f;
+			}
+
+			SpawnThrowable(bAcceptClientLaunch ? Origin : ServerOrigin, bAcceptClientLaunch ? Direction.GetSafeNormal() : ServerDirection, PredictionKey, CatchUpTime);
+
+			if (PlayerInventory)
+			{
+				PlayerInventory->ConsumeItem(Throwable, 1);
+			}
+		}
+	}
 }
 
 void ASurvivalCharacter::MulticastPlayThrowableTossFX_Implementation(UAnimMontage* MontageToPlay)
@@ -736,14 +910,7 @@ void ASurvivalCharacter::MulticastPlayThrowableTossFX_Implementation(UAnimMontag
 
 class UThrowableItem* ASurvivalCharacter::GetThrowable() const
 {
-	UThrowableItem* EquippedThrowable = nullptr;
-
-	if (EquippedItems.Contains(EEquippableSlot::EIS_Throwable))
-	{
-		EquippedThrowable = Cast<UThrowableItem>(*EquippedItems.Find(EEquippableSlot::EIS_Throwable));
-	}
-
-	return EquippedThrowable;
+	return Cast<UThrowableItem>(GetEquippedItem(EEquippableSlot::EIS_Throwable));
 }
 
 void ASurvivalCharacter::UseThrowable()
@@ -752,9 +919,13 @@ void ASurvivalCharacter::UseThrowable()
 	{
 		if (UThrowableItem* Throwable = GetThrowable())
 		{
+			FVector Origin;
+			FVector Direction;
+			GetThrowableLaunch(Origin, Direction);
+
 			if (GetLocalRole() == ROLE_Authority)
 			{
-				SpawnThrowable();
+				SpawnThrowable(Origin, Direction, 0, 0.f);
 
 				if (PlayerInventory)
 				{
@@ -763,21 +934,30 @@ void ASurvivalCharacter::UseThrowable()
 			}
 			else
 			{
+				//Zero means not predicted.
+				if (++LastThrowablePredictionKey == 0)
+				{
+					++LastThrowablePredictionKey;
+				}
+
+				//Spawn our copy right away. The server one will take its place when it arrives.
+				SpawnPredictedThrowable(Origin, Direction, LastThrowablePredictionKey);
+
 				if (Throwable->GetQuantity() <= 1)
 				{
-					EquippedItems.Remove(EEquippableSlot::EIS_Throwable);
+					EquippedItems[(int32)EEquippableSlot::EIS_Throwable] = nullptr;
 					OnEquippedItemsChanged.Broadcast(EEquippableSlot::EIS_Throwable, nullptr);
 				}
 
 				//Locally play grenade throw instantly - by the time server spawns the grenade in the throw animation should roughly sync up with the spawning of the grenade
 				PlayAnimMontage(Throwable->ThrowableTossAnimation);
-				ServerUseThrowable();
+				ServerUseThrowable(Origin, Direction, LastThrowablePredictionKey);
 			}
 		}
 	}
 }
 
-void ASurvivalCharacter::SpawnThrowable()
+void ASurvivalCharacter::SpawnThrowable(const FVector& Origin, const FVector& Direction, const uint8 PredictionKey, const float CatchUpTime)
 {
 	if (GetLocalRole() == ROLE_Authority)
 	{
@@ -785,28 +965,80 @@ void ASurvivalCharacter::SpawnThrowable()
 		{
 			if (CurrentThrowable->ThrowableClass)
 			{
-				FActorSpawnParameters SpawnParams;
-				SpawnParams.Owner = SpawnParams.Instigator = this;
-				SpawnParams.bNoFail = true;
-				SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+				FThrowableLaunchState LaunchState;
+				LaunchState.Origin = Origin;
+				LaunchState.Direction = Direction;
+				LaunchState.PredictionKey = PredictionKey;
+				LaunchState.LaunchTime = GetWorld()->GetTimeSeconds() - CatchUpTime;
 
-				FVector EyesLoc;
-				FRotator EyesRot;
-
-				GetController()->GetPlayerViewPoint(EyesLoc, EyesRot);
+				if (UThrowableProjectileManager* ProjectileManager = GetWorld()->GetSubsystem<UThrowableProjectileManager>())
+				{
+					if (ProjectileManager->AcquireThrowable(CurrentThrowable->ThrowableClass, this, LaunchState, CatchUpTime, false))
+					{
+						MulticastPlayThrowableTossFX(CurrentThrowable->ThrowableTossAnimation);
+					}
+				}
+			}
+		}
+	}
+}
 
-				//Spawn item slightly in front of our face so it doesn't collide with our player.
-				EyesLoc = (EyesRot.Vector() * 20.f) + EyesLoc;
+void ASurvivalCharacter::SpawnPredictedThrowable(const FVector& Origin, const FVector& Direction, const uint8 PredictionKey)
+{
+	if (UThrowableItem* CurrentThrowable = GetThrowable())
+	{
+		if (CurrentThrowable->ThrowableClass)
+		{
+			FThrowableLaunchState LaunchState;
+			LaunchState.Origin = Origin;
+			LaunchState.Direction = Direction;
+			LaunchState.PredictionKey = PredictionKey;
 
-				if (AThrowableWeapon* ThrowableWeapon = GetWorld()->SpawnActor<AThrowableWeapon>(CurrentThrowable->ThrowableClass, FTransform(EyesRot, EyesLoc), SpawnParams))
+			if (UThrowableProjectileManager* ProjectileManager = GetWorld()->GetSubsystem<UThrowableProjectileManager>())
+			{
+				if (AThrowableWeapon* ThrowableWeapon = ProjectileManager->AcquireThrowable(CurrentThrowable->ThrowableClass, this, LaunchState, 0.f, true))
 				{
-					MulticastPlayThrowableTossFX(CurrentThrowable->ThrowableTossAnimation);
+					PredictedThrowables.Add(PredictionKey, ThrowableWeapon);
 				}
 			}
 		}
 	}
 }
 
+AThrowableWeapon* ASurvivalCharacter::ConsumePredictedThrowable(const uint8 PredictionKey)
+{
+	AThrowableWeapon* PredictedThrowable = nullptr;
+	PredictedThrowables.RemoveAndCopyValue(PredictionKey, PredictedThrowable);
+
+	//It may have timed out already, and even be flying again as another throw.
+	if (IsValid(PredictedThrowable) && !PredictedThrowable->IsPooled() && PredictedThrowable->GetLaunchState().PredictionKey == PredictionKey)
+	{
+		return PredictedThrowable;
+	}
+
+	return nullptr;
+}
+
+void ASurvivalCharacter::GetThrowableLaunch(FVector& OutOrigin, FVector& OutDirection) const
+{
+	FVector EyesLoc;
+	FRotator EyesRot;
+
+	if (GetController())
+	{
+		GetController()->GetPlayerViewPoint(EyesLoc, EyesRot);
+	}
+	else
+	{
+		GetActorEyesViewPoint(EyesLoc, EyesRot);
+	}
+
+	OutDirection = EyesRot.Vector();
+
+	//Spawn item slightly in front of our face so it doesn't collide with our player.
+	OutOrigin = (OutDirection * 20.f) + EyesLoc;
+}
+
 bool ASurvivalCharacter::CanUseThrowable() const
 {
 	return GetThrowable() != nullptr && GetThrowable()->ThrowableClass != nullptr;
@@ -896,6 +1128,8 @@ void ASurvivalCharacter::BeginMeleeAttack()
 
 void ASurvivalCharacter::ServerProcessMeleeHit_Implementation(const FHitResult& MeleeHit)
 {
+	SURVIVAL_COUNT_RPC(ServerProcessMeleeHit);
+
 	if (GetWorld()->TimeSince(LastMeleeAttackTime) > MeleeAttackMontage->GetPlayLength() && (GetActorLocation() - MeleeHit.ImpactPoint).Size() <= MeleeAttackDistance)
 	{
 		MulticastPlayMeleeFX(); //Tell everyone else in the game to play my punch animation so they can see me.
@@ -950,13 +1184,16 @@ void ASurvivalCharacter::OnRep_Killer()
 	//Activate LootInteraciontComponent so other players can loot from us.
 	LootPlayerInteraction->Activate();
 
-	TArray<UEquippableItem*> EquippedInvItems;
-	EquippedItems.GenerateValueArray(EquippedInvItems);
+	//Copy the slots first, since unequipping an item clears its slot.
+	const TArray<UEquippableItem*> EquippedInvItems = EquippedItems;
 
 	//UnEquip all equipped items so other players can loot.
 	for (auto& Equippable : EquippedInvItems)
 	{
-		Equippable->SetEquipped(false);
+		if (Equippable)
+		{
+			Equippable->SetEquipped(false);
+		}
 	}
 
 	//Only for ourself, this will not be replicated to anybody else.
@@ -1011,6 +1248,8 @@ void ASurvivalCharacter::SetSprinting(const bool bNewSprinting)
 
 void ASurvivalCharacter::ServerSetSprinting_Implementation(const bool bNewSprinting)
 {
+	SURVIVAL_COUNT_RPC(ServerSetSprinting);
+
 	SetSprinting(bNewSprinting);
 }
 
@@ -1088,6 +1327,8 @@ void ASurvivalCharacter::SetAiming(const bool bNewAiming)
 
 void ASurvivalCharacter::ServerSetAiming_Implementation(const bool bNewAiming)
 {
+	SURVIVAL_COUNT_RPC(ServerSetAiming);
+
 	SetAiming(bNewAiming);
 }
 
@@ -8,6 +8,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "Items/EquippableItem.h"
 #include "SurvivalCharacter.generated.h"
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnEquippedItemsChanged, const EEquippableSlot, Slot, const UEquippableItem*, Item);
@@ -38,7 +39,7 @@ struct FInteractionData
 	bool bInteractHeld;
 };
 
-UCLASS()
+UCLASS(Config = Game)
 class SURVIVALGAME_API ASurvivalCharacter : public ACharacter
 {
 	GENERATED_BODY()
@@ -47,6 +48,9 @@ public:
 
 	ASurvivalCharacter();
 
+	/*Journals the Server RPCs we receive (movement included) before running them, see USurvivalServerJournalSubsystem.*/
+	virtual void ProcessEvent(UFunction* Function, void* Parameters) override;
+
 	/*The mesh to have equipped if we don't have an item equipped.*/
 	UPROPERTY(BlueprintReadOnly, Category = Mesh)
 	TMap<EEquippableSlot, USkeletalMesh*> NakedMeshes;
@@ -90,15 +94,24 @@ public:
 	UPROPERTY(EditAnywhere, Category = "Components")
 	class USkeletalMeshComponent* BackpackMesh;
 
+	/*If true, a dedicated server won't swap gear meshes and materials, and the gear meshes stop ticking. Nobody renders them on the server.
+	Set in DefaultGame.ini, [/Script/SurvivalGame.SurvivalCharacter].*/
+	UPROPERTY(Config, EditDefaultsOnly, Category = Mesh)
+	bool bStripServerCosmetics;
+
 protected:
 	
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 	virtual void Tick(float DeltaTime) override;
 	virtual void Restart() override;
 	virtual float TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser) override;
 	virtual void SetActorHiddenInGame(bool bNewHidden) override;
 
+	/*[Dedicated Server] Stops the gear meshes from ticking. Slots without a naked mesh are released completely.*/
+	void StripServerCosmetics();
+
 public:
 
 	/*Takes an inventory and starts to loot from that.*/
@@ -181,6 +194,10 @@ public:
 	UPROPERTY(EditDefaultsOnly, Category = "Items")
 	TSubclassOf<class APickup> PickupClass;
 
+	/*What items dropped next to each other are merged into.*/
+	UPROPERTY(EditDefaultsOnly, Category = "Items")
+	TSubclassOf<class ALootPile> LootPileClass;
+
 	/* True if we're interacting with an item that has an interaction time (for example a lamp that takes 2 seconds to turn on) */
 	bool IsInteracting() const;
 
@@ -209,15 +226,17 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "Items")
 	FOnEquippedItemsChanged OnEquippedItemsChanged;
 
-	/*Add the item to EquippedItems map and executes OnEquippedItemsChanged delegate.*/
+	/*Add the item to its EquippedItems slot and executes OnEquippedItemsChanged delegate.*/
 	bool EquipItem(class UEquippableItem* Item);
-	/*Remove the item to EquippedItems map and executes OnEquippedItemsChanged delegate.*/
+	/*Remove the item from its EquippedItems slot and executes OnEquippedItemsChanged delegate.*/
 	bool UnEquipItem(class UEquippableItem* Item);
 
 	/*Sets the new Mesh and Material when equip a gear.*/
 	void EquipGear(class UGearItem* Gear);
 	/*Removes the Mesh and Material in this particular slot. Return the mesh value to naked or null.*/
 	void UnEquipGear(const EEquippableSlot Slot);	
+	/*Returns true if this is a dedicated server and we don't want to do any cosmetic work on the gear meshes.*/
+	bool ShouldStripCosmetics() const;
 	/*Spawns and equips the weapon that we are taking or choosing from our inventory.*/
 	void EquipWeapon(class UWeaponItem* WeaponItem);
 	/*Removes the weapon and sets EquippedWeapon to a nullptr.*/
@@ -231,39 +250,71 @@ public:
 	UFUNCTION(BlueprintPure)
 	class USkeletalMeshComponent* GetSlotSkeletalMeshComponent(const EEquippableSlot Slot);
 
-	/*Returns all the items that we have equipped.*/
+	/*Returns all the items that we have equipped, by slot. Built from the slot array, the equipment widgets look items up in it.*/
 	UFUNCTION(BlueprintPure)
-	FORCEINLINE TMap<EEquippableSlot, UEquippableItem*> GetEquippedItems() const { return EquippedItems; }
+	TMap<EEquippableSlot, UEquippableItem*> GetEquippedItems() const;
+
+	/*Returns all the slots, indexed by EEquippableSlot. Empty slots are null.*/
+	FORCEINLINE const TArray<UEquippableItem*>& GetEquippedItemSlots() const { return EquippedItems; }
+
+	/*Returns the item that we have equipped in this slot, or null.*/
+	UFUNCTION(BlueprintPure)
+	FORCEINLINE UEquippableItem* GetEquippedItem(const EEquippableSlot Slot) const { return EquippedItems.IsValidIndex((int32)Slot) ? EquippedItems[(int32)Slot] : nullptr; }
 
 	/*Returns the weapon that we have equipped.*/
 	UFUNCTION(BlueprintCallable, Category = "Weapons")
 	FORCEINLINE class AWeapon* GetEquippedWeapon() const { return EquippedWeapon; }
 
+	FORCEINLINE class UInventoryComponent* GetPlayerInventory() const { return PlayerInventory; }
+
+	/*[Owning Client] Returns the throwable we predicted with this key and forgets about it, so the server one can take its place.*/
+	class AThrowableWeapon* ConsumePredictedThrowable(const uint8 PredictionKey);
+
+	/*Return the item that we have already equipped to throw.*/
+	class UThrowableItem* GetThrowable() const;
+	
+	/*Called when you press the throw key.*/
+	void UseThrowable();
+
+	bool CanUseThrowable() const;
+
 protected:
 
-	/*Just calls UseThrowable on the server.*/
+	/*Throws on the server from where the client threw it, if it's close enough to where the server thinks we are.*/
 	UFUNCTION(Server, Reliable)
-	void ServerUseThrowable();
+	void ServerUseThrowable(const FVector& Origin, const FVector& Direction, const uint8 PredictionKey);
 
 	/*Replicates the throw animation montage to other player.*/
 	UFUNCTION(NetMulticast, Unreliable)
 	void MulticastPlayThrowableTossFX(class UAnimMontage* MontageToPlay);
 
-	/*Return the item that we have already equipped to throw.*/
-	class UThrowableItem* GetThrowable() const;
-	
-	/*Called when you press the throw key.*/
-	void UseThrowable();
 	/*Spawn item in the game world.*/
-	void SpawnThrowable();
+	void SpawnThrowable(const FVector& Origin, const FVector& Direction, const uint8 PredictionKey, const float CatchUpTime);
+	/*[Owning Client] Spawns our local copy of the throwable, so we don't have to wait for the server to see it.*/
+	void SpawnPredictedThrowable(const FVector& Origin, const FVector& Direction, const uint8 PredictionKey);
+	/*Where and to which direction we throw from, slightly in front of our face so it doesn't collide with our player.*/
+	void GetThrowableLaunch(FVector& OutOrigin, FVector& OutDirection) const;
 
-	bool CanUseThrowable() const;
+	/*If the client threw from further than this from where the server thinks it is, the server uses its own view point.*/
+	UPROPERTY(EditDefaultsOnly, Category = "Items")
+	float MaxThrowableOriginError;
+
+	/*[Owning Client] The throwables we spawned and the server hasn't confirmed yet.*/
+	UPROPERTY(Transient)
+	TMap<uint8, class AThrowableWeapon*> PredictedThrowables;
+
+	/*[Owning Client] The key of the last predicted throwable. Zero means not predicted, so we skip it.*/
+	uint8 LastThrowablePredictionKey;
 	
 protected:
 	
-	//Allows for efficient access of equipped items by the slot.
-	UPROPERTY(VisibleAnywhere, Category = "Items")
-	TMap<EEquippableSlot, UEquippableItem*> EquippedItems;
+	/*One entry per EEquippableSlot, so we can access the equipped items by the slot. Replicated to everyone so they can see our gear.*/
+	UPROPERTY(VisibleAnywhere, ReplicatedUsing = OnRep_EquippedItems, Category = "Items")
+	TArray<UEquippableItem*> EquippedItems;
+
+	/*Applies the gear of every slot that changed in this update, so joining or respawning only does one pass.*/
+	UFUNCTION()
+	void OnRep_EquippedItems(const TArray<UEquippableItem*>& OldEquippedItems);
 
 	UPROPERTY(ReplicatedUsing = OnRep_Health, BlueprintReadOnly, Category = "Health")
 	float Health;
@@ -276,6 +327,8 @@ public:
 	/*Modify the players health by either a negative or positive amount. Return the amount of health actually removed.*/
 	float ModifyHealth(const float Delta);
 
+	FORCEINLINE float GetHealth() const { return Health; }
+
 	UFUNCTION()
 	void OnRep_Health(float OldHealth);
 
@@ -296,10 +349,17 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = Melee)
 	class UAnimMontage* MeleeAttackMontage;
 
+public:
+
 	/*If it has a weapon it will tell to that weapon to shoot. Otherwise it will call BeginMeleeAttack.*/
 	void StartFire();
 	/*If it has a weapon, it will tell to that weapon to stop shooting.*/
 	void StopFire();
+
+	FORCEINLINE float GetMeleeAttackDistance() const { return MeleeAttackDistance; }
+
+protected:
+
 	/*Handles all the logic about attack attack and collision channels.*/
 	void BeginMeleeAttack();
 
@@ -373,10 +433,15 @@ protected:
 	/*Returns true if we have an equipped weapon.*/
 	bool CanAim() const;
 
+public:
+
 	/*If CanAim(), calls SetAiming with a true value.*/
 	void StartAiming();
 	/*Calls SetAiming with a false value.*/
 	void StopAiming();
+
+protected:
+
 	/*Sets bIsAiming value.*/
 	void SetAiming(const bool bNewAiming);
 
@@ -7,6 +7,11 @@
 
 #include "SurvivalPlayerController.h"
 #include "SurvivalCharacter.h"
+#include "Framework/SurvivalTelemetrySubsystem.h"
+#include "Framework/SurvivalServerJournalSubsystem.h"
+#include "Framework/SurvivalPlayerSaveSubsystem.h"
+
+#include "Engine/GameInstance.h"
 
 ASurvivalPlayerController::ASurvivalPlayerController()
 {
@@ -23,6 +28,26 @@ void ASurvivalPlayerController::SetupInputComponent()
 	InputComponent->BindAction("Reload", IE_Pressed, this, &ASurvivalPlayerController::StartReload);
 }
 
+void ASurvivalPlayerController::ProcessEvent(UFunction* Function, void* Parameters)
+{
+	USurvivalServerJournalSubsystem::FScopedServerRPC JournalScope(this, Function, Parameters);
+
+	Super::ProcessEvent(Function, Parameters);
+}
+
+void ASurvivalPlayerController::PawnLeavingGame()
+{
+	//Destroying the character detaches it from us and clears its player state before it ends play, it can't save itself.
+	USurvivalPlayerSaveSubsystem* PlayerSaves = GetGameInstance() ? GetGameInstance()->GetSubsystem<USurvivalPlayerSaveSubsystem>() : nullptr;
+
+	if (PlayerSaves)
+	{
+		PlayerSaves->SavePlayer(Cast<ASurvivalCharacter>(GetPawn()), PlayerState);
+	}
+
+	Super::PawnLeavingGame();
+}
+
 void ASurvivalPlayerController::ClientShowNotification_Implementation(const FText& Message)
 {
 	ShowNotification(Message);
@@ -45,6 +70,8 @@ void ASurvivalPlayerController::Respawn()
 
 void ASurvivalPlayerController::ServerRespawn_Implementation()
 {
+	SURVIVAL_COUNT_RPC(ServerRespawn);
+
 	Respawn();
 }
 
@@ -22,6 +22,12 @@ public:
 
 	virtual void SetupInputComponent() override;
 
+	/*Journals the Server RPCs we receive before running them, see USurvivalServerJournalSubsystem.*/
+	virtual void ProcessEvent(UFunction* Function, void* Parameters) override;
+
+	/*Saves the character of a player who is leaving before it's destroyed, while we still have their player state.*/
+	virtual void PawnLeavingGame() override;
+
 	/*Call this instead of ShowNotification if on the server.*/
 	UFUNCTION(Client, Reliable, BlueprintCallable)
 	void ClientShowNotification(const FText& Message);
@@ -7,4 +7,101 @@
 #include "SurvivalGame.h"
 #include "Modules/ModuleManager.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, SurvivalGame, "SurvivalGame" );
+#include "Items/ItemDefinitionRegistry.h"
+
+#if WITH_EDITOR
+#include "Misc/CoreDelegates.h"
+#include "Framework/SurvivalItemRegistryCommandlet.h"
+#endif
+
+class FSurvivalGameModule : public FDefaultGameModuleImpl
+{
+public:
+
+	virtual void StartupModule() override
+	{
+#if WITH_EDITOR
+		//The table is staged with the cooked content, so it's generated from the content being cooked. After the engine
+		//is up, the Blueprint item classes have to be loaded to read their defaults.
+		if (IsRunningCook())
+		{
+			PostEngineInitHandle = FCoreDelegates::OnPostEngineInit.AddLambda([]()
+			{
+				USurvivalItemRegistryCommandlet::GenerateRegistry(FItemDefinitionRegistry::GetDefaultFilename());
+			});
+		}
+#endif
+
+		//The editor reads the class defaults, designers change them all the time.
+		if (GIsEditor && !FParse::Param(FCommandLine::Get(), TEXT("ItemRegistry")))
+		{
+			return;
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+
+		if (FItemDefinitionRegistry::Get().Load(FItemDefinitionRegistry::GetDefaultFilename()))
+		{
+			UE_LOG(LogTemp, Log, TEXT("Loaded %d item definitions (%016llx) in %.3f ms."), FItemDefinitionRegistry::Get().GetNumItems(),
+				FItemDefinitionRegistry::Get().GetContentHash(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Log, TEXT("No item definition registry, items read their class defaults. It's generated when the project is cooked."));
+		}
+	}
+
+	virtual void ShutdownModule() override
+	{
+#if WITH_EDITOR
+		FCoreDelegates::OnPostEngineInit.Remove(PostEngineInitHandle);
+#endif
+
+		FItemDefinitionRegistry::Get().Unload();
+	}
+
+private:
+
+#if WITH_EDITOR
+	FDelegateHandle PostEngineInitHandle;
+
+	static bool IsRunningCook()
+	{
+		FString Commandlet;
+		return IsRunningCommandlet() && FParse::Value(FCommandLine::Get(), TEXT("-run="), Commandlet) && Commandlet.StartsWith(TEXT("Cook"));
+	}
+#endif
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FSurvivalGameModule, SurvivalGame, "SurvivalGame" );
+
+DEFINE_STAT(STAT_PerformInteractionCheck);
+DEFINE_STAT(STAT_TryAddItem);
+DEFINE_STAT(STAT_InventoryReplicateSubobjects);
+DEFINE_STAT(STAT_PickupReplicateSubobjects);
+DEFINE_STAT(STAT_ServerNotifyHit);
+DEFINE_STAT(STAT_HandleFiring);
+DEFINE_STAT(STAT_SpawnItem);
+DEFINE_STAT(STAT_LootRoll);
+DEFINE_STAT(STAT_VoiceInterestUpdate);
+DEFINE_STAT(STAT_PlayerSaveCapture);
+DEFINE_STAT(STAT_PlayerSaveRestore);
+DEFINE_STAT(STAT_WorldSnapshot);
+DEFINE_STAT(STAT_GroundLootDrop);
+DEFINE_STAT(STAT_ProcessExplosions);
+DEFINE_STAT(STAT_ExplosionOverlaps);
+DEFINE_STAT(STAT_ExplosionOcclusion);
+DEFINE_STAT(STAT_ExplosionDamage);
+DEFINE_STAT(STAT_SimulateThrowables);
+DEFINE_STAT(STAT_SyncThrowableTransforms);
+
+DEFINE_STAT(STAT_ServerRPCs);
+DEFINE_STAT(STAT_ReplicatedSubobjectBits);
+DEFINE_STAT(STAT_NumExplosionsProcessed);
+DEFINE_STAT(STAT_NumExplosionTargets);
+
+DEFINE_STAT(STAT_NumPendingExplosions);
+DEFINE_STAT(STAT_NumActiveThrowables);
+DEFINE_STAT(STAT_NumPooledThrowables);
+
+CSV_DEFINE_CATEGORY_MODULE(SURVIVALGAME_API, SurvivalGame, true);
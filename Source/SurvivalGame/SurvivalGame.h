@@ -7,5 +7,46 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
 
-#define COLLISION_WEAPON ECC_GameTraceChannel1
\ No newline at end of file
+#define COLLISION_WEAPON ECC_GameTraceChannel1
+
+/*Game code stats. Use "stat Survival" in game, or the SurvivalGame category of a CSV capture (csvprofile start).*/
+DECLARE_STATS_GROUP(TEXT("Survival"), STATGROUP_Survival, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Interaction Check"), STAT_PerformInteractionCheck, STATGROUP_Survival, SURVIVALGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Try Add Item"), STAT_TryAddItem, STATGROUP_Survival, SURVIVALGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Inventory Replicate Subobjects"), STAT_InventoryReplicateSubobjects, STATGROUP_Survival, SURVIVALGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Pickup Replicate Subobjects"), STAT_PickupReplicateSubobjects, STATGROUP_Survival, SURVIVALGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Server Notify Hit"), STAT_ServerNotifyHit, STATGROUP_Survival, SURVIVALGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Handle Firing"), STAT_HandleFiring, STATGROUP_Survival, SURVIVALGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Spawn Item"), STAT_SpawnItem, STATGROUP_Survival, SURVIVALGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Loot Roll"), STAT_LootRoll, STATGROUP_Survival, SURVIVALGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Voice Interest Update"), STAT_VoiceInterestUpdate, STATGROUP_Survival, SURVIVALGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Player Save Capture"), STAT_PlayerSaveCapture, STATGROUP_Survival, SURVIVALGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Player Save Restore"), STAT_PlayerSaveRestore, STATGROUP_Survival, SURVIVALGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("World Snapshot"), STAT_WorldSnapshot, STATGROUP_Survival, SURVIVALGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Ground Loot Drop"), STAT_GroundLootDrop, STATGROUP_Survival, SURVIVALGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Process Explosions"), STAT_ProcessExplosions, STATGROUP_Survival, SURVIVALGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Explosion Overlaps"), STAT_ExplosionOverlaps, STATGROUP_Survival, SURVIVALGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Explosion Occlusion Traces"), STAT_ExplosionOcclusion, STATGROUP_Survival, SURVIVALGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Explosion Damage"), STAT_ExplosionDamage, STATGROUP_Survival, SURVIVALGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Simulate Throwables"), STAT_SimulateThrowables, STATGROUP_Survival, SURVIVALGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Sync Throwable Transforms"), STAT_SyncThrowableTransforms, STATGROUP_Survival, SURVIVALGAME_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Server RPCs"), STAT_ServerRPCs, STATGROUP_Survival, SURVIVALGAME_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Replicated Subobject Bits"), STAT_ReplicatedSubobjectBits, STATGROUP_Survival, SURVIVALGAME_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Explosions Processed"), STAT_NumExplosionsProcessed, STATGROUP_Survival, SURVIVALGAME_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Explosion Targets"), STAT_NumExplosionTargets, STATGROUP_Survival, SURVIVALGAME_API);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Pending Explosions"), STAT_NumPendingExplosions, STATGROUP_Survival, SURVIVALGAME_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Active Throwables"), STAT_NumActiveThrowables, STATGROUP_Survival, SURVIVALGAME_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Pooled Throwables"), STAT_NumPooledThrowables, STATGROUP_Survival, SURVIVALGAME_API);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(SURVIVALGAME_API, SurvivalGame);
+
+/*Times the scope in the stats system and in the CSV profiler. Name must match a STAT_Name declared above.*/
+#define SURVIVAL_SCOPE_CYCLE_COUNTER(Name) \
+	SCOPE_CYCLE_COUNTER(STAT_##Name); \
+	CSV_SCOPED_TIMING_STAT(SurvivalGame, Name)
@@ -0,0 +1,245 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "ExplosionSubsystem.h"
+
+#include "Engine/World.h"
+#include "Engine/EngineTypes.h"
+#include "Components/PrimitiveComponent.h"
+#include "GameFramework/Controller.h"
+
+#include "SurvivalGame.h"
+#include "Player/SurvivalCharacter.h"
+
+/*Something an explosion may damage, if nothing is blocking it.*/
+struct FExplosionTarget
+{
+	int32 ExplosionIndex;
+
+	TWeakObjectPtr<AActor> Actor;
+
+	TWeakObjectPtr<UPrimitiveComponent> Component;
+
+	/*The hit we send with the damage event, the engine uses it to apply the falloff.*/
+	FHitResult Hit;
+};
+
+AThrowableWeapon* FPendingExplosion::GetDamageCauser() const
+{
+	AThrowableWeapon* Throwable = DamageCauser.Get();
+	return Throwable && Throwable->GetLaunchState().LaunchId == LaunchId ? Throwable : nullptr;
+}
+
+UExplosionSubsystem::UExplosionSubsystem()
+{
+	MaxExplosionsPerFrame = 16;
+}
+
+bool UExplosionSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	//Editor preview worlds never explode anything.
+	UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld();
+}
+
+void UExplosionSubsystem::Deinitialize()
+{
+	PendingExplosions.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UExplosionSubsystem::IsTickable() const
+{
+	return PendingExplosions.Num() > 0 && !HasAnyFlags(RF_ClassDefaultObject);
+}
+
+TStatId UExplosionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UExplosionSubsystem, STATGROUP_Tickables);
+}
+
+void UExplosionSubsystem::Tick(float DeltaTime)
+{
+	ProcessExplosions(FMath::Min(PendingExplosions.Num(), FMath::Max(1, MaxExplosionsPerFrame)));
+}
+
+void UExplosionSubsystem::QueueExplosion(AThrowableWeapon* DamageCauser, AController* InstigatorController, const FVector& Origin, const FThrowableExplosionConfig& Config)
+{
+	if (DamageCauser && Config.OuterRadius > 0.f)
+	{
+		FPendingExplosion& Explosion = PendingExplosions.AddDefaulted_GetRef();
+		Explosion.DamageCauser = DamageCauser;
+		Explosion.LaunchId = DamageCauser->GetLaunchState().LaunchId;
+		Explosion.InstigatorController = InstigatorController;
+		Explosion.Origin = Origin;
+		Explosion.Config = Config;
+
+		INC_DWORD_STAT(STAT_NumPendingExplosions);
+	}
+}
+
+void UExplosionSubsystem::FlushExplosions()
+{
+	ProcessExplosions(PendingExplosions.Num());
+}
+
+void UExplosionSubsystem::ProcessExplosions(const int32 NumExplosions)
+{
+	SURVIVAL_SCOPE_CYCLE_COUNTER(ProcessExplosions);
+
+	UWorld* World = GetWorld();
+	if (!World || NumExplosions <= 0)
+	{
+		return;
+	}
+
+	TArray<FExplosionTarget> Targets;
+
+	//1. Broad phase: a single overlap per explosion against everything it could damage.
+	{
+		SURVIVAL_SCOPE_CYCLE_COUNTER(ExplosionOverlaps);
+
+		FCollisionObjectQueryParams ObjectParams;
+		ObjectParams.AddObjectTypesToQuery(ECC_Pawn);
+		ObjectParams.AddObjectTypesToQuery(ECC_Destructible);
+
+		TArray<FOverlapResult> Overlaps;
+		TArray<AActor*, TInlineAllocator<16>> ActorsInRange;
+
+		for (int32 ExplosionIndex = 0; ExplosionIndex < NumExplosions; ++ExplosionIndex)
+		{
+			const FPendingExplosion& Explosion = PendingExplosions[ExplosionIndex];
+			AThrowableWeapon* DamageCauser = Explosion.GetDamageCauser();
+
+			if (!DamageCauser)
+			{
+				continue;
+			}
+
+			FCollisionQueryParams OverlapParams(SCENE_QUERY_STAT(ExplosionOverlap), false, DamageCauser);
+
+			Overlaps.Reset();
+			World->OverlapMultiByObjectType(Overlaps, Explosion.Origin, FQuat::Identity, ObjectParams, FCollisionShape::MakeSphere(Explosion.Config.OuterRadius), OverlapParams);
+
+			ActorsInRange.Reset();
+
+			for (const FOverlapResult& Overlap : Overlaps)
+			{
+				AActor* OverlapActor = Overlap.GetActor();
+				UPrimitiveComponent* OverlapComponent = Overlap.GetComponent();
+
+				if (!OverlapActor || !OverlapComponent || !OverlapActor->CanBeDamaged() || ActorsInRange.Contains(OverlapActor))
+				{
+					continue;
+				}
+
+				//Dead players stay in the world to be looted, they can't be killed again.
+				if (ASurvivalCharacter* Character = Cast<ASurvivalCharacter>(OverlapActor))
+				{
+					if (!Character->IsAlive())
+					{
+						continue;
+					}
+				}
+
+				//Each actor is damaged once per explosion, even if more than one of its components are in range.
+				ActorsInRange.Add(OverlapActor);
+
+				FExplosionTarget& Target = Targets.AddDefaulted_GetRef();
+				Target.ExplosionIndex = ExplosionIndex;
+				Target.Actor = OverlapActor;
+				Target.Component = OverlapComponent;
+			}
+		}
+
+		INC_DWORD_STAT_BY(STAT_NumExplosionTargets, Targets.Num());
+	}
+
+	//2. A line trace from each explosion to each of its targets, once all the overlaps are done. Targets behind a wall are removed.
+	{
+		SURVIVAL_SCOPE_CYCLE_COUNTER(ExplosionOcclusion);
+
+		for (int32 TargetIndex = Targets.Num() - 1; TargetIndex >= 0; --TargetIndex)
+		{
+			FExplosionTarget& Target = Targets[TargetIndex];
+			const FPendingExplosion& Explosion = PendingExplosions[Target.ExplosionIndex];
+			UPrimitiveComponent* TargetComponent = Target.Component.Get();
+
+			if (!TargetComponent)
+			{
+				Targets.RemoveAtSwap(TargetIndex, 1, false);
+				continue;
+			}
+
+			const FVector TraceEnd = TargetComponent->Bounds.Origin;
+
+			FCollisionQueryParams TraceParams(SCENE_QUERY_STAT(ExplosionOcclusion), false, Explosion.DamageCauser.Get());
+
+			FHitResult Hit;
+			const bool bBlockingHit = World->LineTraceSingleByChannel(Hit, Explosion.Origin, TraceEnd, ECC_Visibility, TraceParams);
+
+			//Any part of the target counts, the trace may hit the mesh of a character instead of its capsule.
+			if (bBlockingHit && Hit.GetActor() != Target.Actor.Get())
+			{
+				Targets.RemoveAtSwap(TargetIndex, 1, false);
+				continue;
+			}
+
+			if (bBlockingHit)
+			{
+				Target.Hit = Hit;
+			}
+			else
+			{
+				//Nothing in the way, but the target doesn't block visibility either. Same fake hit the engine uses for radial damage.
+				const FVector FakeHitLocation = TargetComponent->GetComponentLocation();
+				const FVector FakeHitNormal = (Explosion.Origin - FakeHitLocation).GetSafeNormal();
+				Target.Hit = FHitResult(Target.Actor.Get(), TargetComponent, FakeHitLocation, FakeHitNormal);
+			}
+		}
+	}
+
+	//3. Damage. The engine scales it by the distance to the hit, using the falloff of the explosion.
+	{
+		SURVIVAL_SCOPE_CYCLE_COUNTER(ExplosionDamage);
+
+		for (const FExplosionTarget& Target : Targets)
+		{
+			const FPendingExplosion& Explosion = PendingExplosions[Target.ExplosionIndex];
+
+			//A previous explosion may have destroyed the target, or the throwable.
+			AActor* TargetActor = Target.Actor.Get();
+			AActor* DamageCauser = Explosion.GetDamageCauser();
+			if (!TargetActor || !DamageCauser)
+			{
+				continue;
+			}
+
+			if (ASurvivalCharacter* Character = Cast<ASurvivalCharacter>(TargetActor))
+			{
+				if (!Character->IsAlive())
+				{
+					continue;
+				}
+			}
+
+			FRadialDamageEvent DamageEvent;
+			DamageEvent.DamageTypeClass = Explosion.Config.DamageType ? Explosion.Config.DamageType : TSubclassOf<UDamageType>(UExplosiveDamage::StaticClass());
+			DamageEvent.Origin = Explosion.Origin;
+			DamageEvent.Params = FRadialDamageParams(Explosion.Config.BaseDamage, Explosion.Config.MinimumDamage, Explosion.Config.InnerRadius, Explosion.Config.OuterRadius, Explosion.Config.DamageFalloff);
+			DamageEvent.ComponentHits.Add(Target.Hit);
+
+			TargetActor->TakeDamage(Explosion.Config.BaseDamage, DamageEvent, Explosion.InstigatorController.Get(), DamageCauser);
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_NumExplosionsProcessed, NumExplosions);
+	DEC_DWORD_STAT_BY(STAT_NumPendingExplosions, NumExplosions);
+
+	PendingExplosions.RemoveAt(0, NumExplosions, false);
+}
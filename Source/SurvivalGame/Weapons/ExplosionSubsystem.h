@@ -0,0 +1,76 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "Weapons/ThrowableWeapon.h"
+#include "ExplosionSubsystem.generated.h"
+
+/*An explosion waiting to deal its damage.*/
+struct FPendingExplosion
+{
+	/*The throwable that exploded. It's the damage causer, so it has to be alive when we deal the damage.*/
+	TWeakObjectPtr<AThrowableWeapon> DamageCauser;
+
+	/*The launch of the throwable that exploded. Pooled throwables are thrown again, by then it isn't this explosion's causer anymore.*/
+	uint16 LaunchId;
+
+	/*The controller of the player that threw it, if it's still around.*/
+	TWeakObjectPtr<AController> InstigatorController;
+
+	FVector Origin;
+
+	FThrowableExplosionConfig Config;
+
+	/*The throwable, if it's still alive and hasn't been thrown again since it exploded.*/
+	AThrowableWeapon* GetDamageCauser() const;
+};
+
+/*[Server] Deals the damage of every explosion in the world.
+Explosions are queued and processed together once per frame: one overlap per explosion to find what it can hit, then a line
+trace per target to check nothing is in the way, then the damage. The traces run one after another, the engine has no batched
+synchronous trace, but every explosion of the frame goes through each step before the next one starts.
+If too many explode in the same frame, the rest wait for the next one.*/
+UCLASS(Config = Game)
+class SURVIVALGAME_API UExplosionSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UExplosionSubsystem();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual TStatId GetStatId() const override;
+
+	/*Queues an explosion. It will deal its damage this frame, or the next ones if we're over budget.*/
+	void QueueExplosion(AThrowableWeapon* DamageCauser, AController* InstigatorController, const FVector& Origin, const FThrowableExplosionConfig& Config);
+
+	/*Processes every queued explosion now, ignoring the budget.*/
+	void FlushExplosions();
+
+	FORCEINLINE int32 GetNumPendingExplosions() const { return PendingExplosions.Num(); }
+
+protected:
+
+	/*The most explosions we process in a single frame.*/
+	UPROPERTY(Config)
+	int32 MaxExplosionsPerFrame;
+
+	/*Explosions waiting for their turn, the oldest first.*/
+	TArray<FPendingExplosion> PendingExplosions;
+
+	/*Deals the damage of the first NumExplosions queued explosions.*/
+	void ProcessExplosions(const int32 NumExplosions);
+};
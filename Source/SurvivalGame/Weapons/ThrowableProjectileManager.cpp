@@ -0,0 +1,447 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "ThrowableProjectileManager.h"
+
+#include "Engine/World.h"
+#include "Components/StaticMeshComponent.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+
+#include "SurvivalGame.h"
+
+/*Bounces a projectile can make in one step. The rest of the step is lost, like when the projectile movement component runs out of iterations.*/
+static const int32 MaxBouncesPerStep = 4;
+
+UThrowableProjectileManager::UThrowableProjectileManager()
+{
+	MaxPooledPerClass			= 32;
+	ServerTransformSyncInterval	= 0.25f;
+
+	LastLaunchId				= 0;
+	TimeSinceServerSync			= 0.f;
+	bIsSimulating				= false;
+}
+
+bool UThrowableProjectileManager::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld();
+}
+
+void UThrowableProjectileManager::Deinitialize()
+{
+	Projectiles.Empty();
+	Locations.Empty();
+	Velocities.Empty();
+	BounceCounts.Empty();
+	Params.Empty();
+	Pools.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UThrowableProjectileManager::IsTickable() const
+{
+	return Projectiles.Num() > 0 && !HasAnyFlags(RF_ClassDefaultObject);
+}
+
+TStatId UThrowableProjectileManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UThrowableProjectileManager, STATGROUP_Tickables);
+}
+
+void UThrowableProjectileManager::Tick(float DeltaTime)
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	{
+		SURVIVAL_SCOPE_CYCLE_COUNTER(SimulateThrowables);
+
+		bIsSimulating = true;
+
+		//Throwables thrown during the tick, by a bounce or an explosion, are added at the end and already caught up. They move from the next tick.
+		const int32 NumProjectiles = Projectiles.Num();
+
+		for (int32 Index = 0; Index < NumProjectiles; ++Index)
+		{
+			//Stopped earlier this tick by a bounce or an explosion.
+			if (Projectiles[Index])
+			{
+				SimulateProjectile(Index, DeltaTime, World);
+			}
+		}
+
+		bIsSimulating = false;
+
+		RemoveStoppedProjectiles();
+	}
+
+	//Clients render the throwables, so the actors follow the simulation every frame.
+	bool bSyncTransforms = World->GetNetMode() != NM_DedicatedServer;
+
+	if (!bSyncTransforms)
+	{
+		TimeSinceServerSync += DeltaTime;
+
+		if (TimeSinceServerSync >= ServerTransformSyncInterval)
+		{
+			TimeSinceServerSync = 0.f;
+			bSyncTransforms = true;
+		}
+	}
+
+	if (bSyncTransforms)
+	{
+		SURVIVAL_SCOPE_CYCLE_COUNTER(SyncThrowableTransforms);
+
+		for (int32 Index = 0; Index < Projectiles.Num(); ++Index)
+		{
+			SyncTransformAt(Index);
+		}
+	}
+}
+
+AThrowableWeapon* UThrowableProjectileManager::AcquireThrowable(TSubclassOf<AThrowableWeapon> ThrowableClass, APawn* Thrower, FThrowableLaunchState LaunchState, const float CatchUpTime, const bool bPredicted)
+{
+	UWorld* World = GetWorld();
+	if (!World || !ThrowableClass)
+	{
+		return nullptr;
+	}
+
+	if (!bPredicted)
+	{
+		//Zero is the launch id a throwable has before its first throw.
+		if (++LastLaunchId == 0)
+		{
+			++LastLaunchId;
+		}
+
+		LaunchState.LaunchId = LastLaunchId;
+	}
+
+	const FTransform SpawnTransform(LaunchState.Direction.Rotation(), LaunchState.Origin);
+
+	FThrowablePool& Pool = Pools.FindOrAdd(ThrowableClass);
+	TArray<AThrowableWeapon*>& PooledThrowables = bPredicted ? Pool.PredictedThrowables : Pool.Throwables;
+
+	while (PooledThrowables.Num() > 0)
+	{
+		AThrowableWeapon* Throwable = PooledThrowables.Pop(false);
+		DEC_DWORD_STAT(STAT_NumPooledThrowables);
+
+		if (!IsValid(Throwable))
+		{
+			continue;
+		}
+
+		Throwable->bPooled = false;
+		Throwable->SetOwner(Thrower);
+		Throwable->SetInstigator(Thrower);
+		Throwable->SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::TeleportPhysics);
+		Throwable->ResetThrowable();
+		Throwable->InitializeLaunch(LaunchState, CatchUpTime);
+
+		if (Throwable->GetIsReplicated())
+		{
+			Throwable->SetNetDormancy(DORM_Awake);
+			Throwable->ForceNetUpdate();
+		}
+
+		Throwable->StartThrow();
+
+		return Throwable;
+	}
+
+	//Nothing in the pool, spawn a new one. It will be thrown in its BeginPlay.
+	const ESpawnActorCollisionHandlingMethod CollisionHandling = bPredicted ? ESpawnActorCollisionHandlingMethod::AlwaysSpawn : ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	if (AThrowableWeapon* Throwable = World->SpawnActorDeferred<AThrowableWeapon>(ThrowableClass, SpawnTransform, Thrower, Thrower, CollisionHandling))
+	{
+		if (bPredicted)
+		{
+			//Only we see this one, it's never replicated.
+			Throwable->SetReplicates(false);
+			Throwable->SetPredicted(true);
+		}
+
+		Throwable->InitializeLaunch(LaunchState, CatchUpTime);
+		Throwable->FinishSpawning(SpawnTransform);
+
+		return Throwable;
+	}
+
+	return nullptr;
+}
+
+void UThrowableProjectileManager::ReleaseThrowable(AThrowableWeapon* Throwable)
+{
+	if (!IsValid(Throwable) || Throwable->bPooled)
+	{
+		return;
+	}
+
+	FThrowablePool& Pool = Pools.FindOrAdd(Throwable->GetClass());
+	TArray<AThrowableWeapon*>& PooledThrowables = Throwable->IsPredicted() ? Pool.PredictedThrowables : Pool.Throwables;
+
+	if (PooledThrowables.Num() >= MaxPooledPerClass)
+	{
+		Throwable->Destroy();
+		return;
+	}
+
+	Throwable->ResetThrowable();
+	Throwable->bPooled = true;
+	Throwable->SetActorHiddenInGame(true);
+	Throwable->ThrowableMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+	//Clients keep their copy, hidden, until we throw it again.
+	if (Throwable->GetIsReplicated() && Throwable->GetLocalRole() == ROLE_Authority)
+	{
+		Throwable->FlushNetDormancy();
+		Throwable->SetNetDormancy(DORM_DormantAll);
+	}
+
+	PooledThrowables.Add(Throwable);
+	INC_DWORD_STAT(STAT_NumPooledThrowables);
+}
+
+void UThrowableProjectileManager::StartSimulating(AThrowableWeapon* Throwable, const FVector& Location, const FVector& Velocity)
+{
+	if (!Throwable)
+	{
+		return;
+	}
+
+	UProjectileMovementComponent* Movement = Throwable->ThrowableMovement;
+
+	FThrowableProjectileParams ProjectileParams;
+	ProjectileParams.GravityZ					= Movement->GetGravityZ();
+	ProjectileParams.Bounciness					= Movement->Bounciness;
+	ProjectileParams.Friction					= Movement->Friction;
+	ProjectileParams.StopSpeedSquared			= FMath::Square(Movement->BounceVelocityStopSimulatingThreshold);
+	ProjectileParams.MaxSpeed					= Movement->MaxSpeed;
+	ProjectileParams.CollisionRadius			= Throwable->CollisionRadius;
+	ProjectileParams.bShouldBounce				= Movement->bShouldBounce;
+	ProjectileParams.bRotationFollowsVelocity	= Movement->bRotationFollowsVelocity;
+	ProjectileParams.CollisionChannel			= Throwable->ThrowableMesh->GetCollisionObjectType();
+	ProjectileParams.ResponseParams				= FCollisionResponseParams(Throwable->ThrowableMesh->GetCollisionResponseToChannels());
+
+	if (Throwable->ProjectileIndex != INDEX_NONE)
+	{
+		//Already flying, just launch it again from here.
+		const int32 Index = Throwable->ProjectileIndex;
+		Locations[Index] = Location;
+		Velocities[Index] = Velocity;
+		BounceCounts[Index] = 0;
+		Params[Index] = ProjectileParams;
+		return;
+	}
+
+	Throwable->ProjectileIndex = Projectiles.Add(Throwable);
+	Locations.Add(Location);
+	Velocities.Add(Velocity);
+	BounceCounts.Add(0);
+	Params.Add(ProjectileParams);
+
+	INC_DWORD_STAT(STAT_NumActiveThrowables);
+}
+
+void UThrowableProjectileManager::StopSimulating(AThrowableWeapon* Throwable)
+{
+	if (!Throwable || Throwable->ProjectileIndex == INDEX_NONE || !Projectiles.IsValidIndex(Throwable->ProjectileIndex))
+	{
+		return;
+	}
+
+	const int32 Index = Throwable->ProjectileIndex;
+
+	//Leave the actor where the simulation left it.
+	SyncTransformAt(Index);
+
+	Throwable->ProjectileIndex = INDEX_NONE;
+
+	if (bIsSimulating)
+	{
+		//We are going through the arrays, remove it when we finish.
+		Projectiles[Index] = nullptr;
+	}
+	else
+	{
+		RemoveProjectileAt(Index);
+	}
+}
+
+void UThrowableProjectileManager::AdvanceProjectile(AThrowableWeapon* Throwable, const float DeltaTime)
+{
+	if (Throwable && Throwable->ProjectileIndex != INDEX_NONE)
+	{
+		if (UWorld* World = GetWorld())
+		{
+			SimulateProjectile(Throwable->ProjectileIndex, DeltaTime, World);
+		}
+	}
+}
+
+void UThrowableProjectileManager::SyncTransform(AThrowableWeapon* Throwable)
+{
+	if (Throwable && Throwable->ProjectileIndex != INDEX_NONE)
+	{
+		SyncTransformAt(Throwable->ProjectileIndex);
+	}
+}
+
+FVector UThrowableProjectileManager::GetProjectileLocation(const AThrowableWeapon* Throwable) const
+{
+	if (Throwable && Locations.IsValidIndex(Throwable->ProjectileIndex))
+	{
+		return Locations[Throwable->ProjectileIndex];
+	}
+
+	return Throwable ? Throwable->GetActorLocation() : FVector::ZeroVector;
+}
+
+bool UThrowableProjectileManager::SimulateProjectile(const int32 Index, const float DeltaTime, UWorld* World)
+{
+	AThrowableWeapon* Throwable = Projectiles[Index];
+
+	float RemainingTime = DeltaTime;
+
+	//Like the projectile movement component, the time left after a bounce is spent moving away from it.
+	for (int32 Iteration = 0; Iteration < MaxBouncesPerStep && RemainingTime > KINDA_SMALL_NUMBER; ++Iteration)
+	{
+		//Only good until a bounce handler throws another projectile and the array grows.
+		const FThrowableProjectileParams& ProjectileParams = Params[Index];
+
+		const FVector OldVelocity = Velocities[Index];
+		const FVector Gravity(0.f, 0.f, ProjectileParams.GravityZ);
+
+		FVector NewVelocity = OldVelocity + (Gravity * RemainingTime);
+
+		if (ProjectileParams.MaxSpeed > 0.f)
+		{
+			NewVelocity = NewVelocity.GetClampedToMaxSize(ProjectileParams.MaxSpeed);
+		}
+
+		const FVector Start = Locations[Index];
+		const FVector End = Start + ((OldVelocity + NewVelocity) * 0.5f * RemainingTime);
+
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ThrowableSweep), false, Throwable);
+
+		FHitResult Hit;
+		const bool bHit = World->SweepSingleByChannel(Hit, Start, End, FQuat::Identity, ProjectileParams.CollisionChannel, FCollisionShape::MakeSphere(ProjectileParams.CollisionRadius), QueryParams, ProjectileParams.ResponseParams);
+
+		if (!bHit)
+		{
+			Locations[Index] = End;
+			Velocities[Index] = NewVelocity;
+			return true;
+		}
+
+		//How fast it was going when it hit.
+		const float TimeToHit = RemainingTime * Hit.Time;
+		RemainingTime -= TimeToHit;
+
+		FVector HitVelocity = OldVelocity + (Gravity * TimeToHit);
+
+		if (ProjectileParams.MaxSpeed > 0.f)
+		{
+			HitVelocity = HitVelocity.GetClampedToMaxSize(ProjectileParams.MaxSpeed);
+		}
+
+		Locations[Index] = Hit.Location;
+
+		bool bStopped = !ProjectileParams.bShouldBounce;
+
+		if (ProjectileParams.bShouldBounce)
+		{
+			//Same bounce as the projectile movement component: the normal part is scaled by the bounciness, the rest by the friction.
+			const FVector Normal = Hit.Normal;
+			const FVector NormalVelocity = (HitVelocity | Normal) * Normal;
+			const FVector TangentVelocity = HitVelocity - NormalVelocity;
+
+			Velocities[Index] = (TangentVelocity * FMath::Clamp(1.f - ProjectileParams.Friction, 0.f, 1.f)) - (NormalVelocity * ProjectileParams.Bounciness);
+			BounceCounts[Index] = (uint8)FMath::Min<int32>(BounceCounts[Index] + 1, MAX_uint8);
+
+			const float StopSpeedSquared = ProjectileParams.StopSpeedSquared;
+
+			//The actor has to be where it bounced for anyone listening.
+			SyncTransformAt(Index);
+
+			Throwable->ThrowableMovement->OnProjectileBounce.Broadcast(Hit, HitVelocity);
+
+			//The bounce may have made it explode.
+			if (Throwable->ProjectileIndex != Index)
+			{
+				return false;
+			}
+
+			bStopped = Velocities[Index].SizeSquared() < StopSpeedSquared && Hit.Normal.Z > KINDA_SMALL_NUMBER;
+		}
+
+		if (bStopped)
+		{
+			Velocities[Index] = FVector::ZeroVector;
+
+			StopSimulating(Throwable);
+
+			Throwable->ThrowableMovement->OnProjectileStop.Broadcast(Hit);
+
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void UThrowableProjectileManager::RemoveStoppedProjectiles()
+{
+	for (int32 Index = Projectiles.Num() - 1; Index >= 0; --Index)
+	{
+		if (!Projectiles[Index])
+		{
+			RemoveProjectileAt(Index);
+		}
+	}
+}
+
+void UThrowableProjectileManager::RemoveProjectileAt(const int32 Index)
+{
+	Projectiles.RemoveAtSwap(Index, 1, false);
+	Locations.RemoveAtSwap(Index, 1, false);
+	Velocities.RemoveAtSwap(Index, 1, false);
+	BounceCounts.RemoveAtSwap(Index, 1, false);
+	Params.RemoveAtSwap(Index, 1, false);
+
+	//The last projectile took this index.
+	if (Projectiles.IsValidIndex(Index) && Projectiles[Index])
+	{
+		Projectiles[Index]->ProjectileIndex = Index;
+	}
+
+	DEC_DWORD_STAT(STAT_NumActiveThrowables);
+}
+
+void UThrowableProjectileManager::SyncTransformAt(const int32 Index)
+{
+	if (AThrowableWeapon* Throwable = Projectiles[Index])
+	{
+		if (Params[Index].bRotationFollowsVelocity && !Velocities[Index].IsNearlyZero())
+		{
+			Throwable->SetActorLocationAndRotation(Locations[Index], Velocities[Index].Rotation(), false, nullptr, ETeleportType::TeleportPhysics);
+		}
+		else
+		{
+			Throwable->SetActorLocation(Locations[Index], false, nullptr, ETeleportType::TeleportPhysics);
+		}
+	}
+}
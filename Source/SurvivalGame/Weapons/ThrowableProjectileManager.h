@@ -0,0 +1,128 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "Weapons/ThrowableWeapon.h"
+#include "ThrowableProjectileManager.generated.h"
+
+/*The throwables of a class that are waiting to be thrown again.*/
+USTRUCT()
+struct FThrowablePool
+{
+	GENERATED_BODY()
+
+	/*Server throwables, replicated. They are dormant while they wait.*/
+	UPROPERTY()
+	TArray<AThrowableWeapon*> Throwables;
+
+	/*Predicted copies of the owning client. Never replicated.*/
+	UPROPERTY()
+	TArray<AThrowableWeapon*> PredictedThrowables;
+};
+
+/*Settings of a flying throwable that never change during the flight. Copied from its movement component when it's launched.*/
+struct FThrowableProjectileParams
+{
+	float GravityZ;
+	float Bounciness;
+	float Friction;
+	float StopSpeedSquared;
+	float MaxSpeed;
+	float CollisionRadius;
+	bool bShouldBounce;
+	bool bRotationFollowsVelocity;
+	ECollisionChannel CollisionChannel;
+	FCollisionResponseParams ResponseParams;
+};
+
+/*Pools the throwables of every class, and moves all the flying ones in a single tick.
+The state of the flying throwables is kept in parallel arrays, so the simulation goes through them one after the other.
+Clients move the actors every frame to render them. The dedicated server only moves them once in a while for relevancy,
+and when they bounce or stop.*/
+UCLASS(Config = Game)
+class SURVIVALGAME_API UThrowableProjectileManager : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UThrowableProjectileManager();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual TStatId GetStatId() const override;
+
+	/*Takes a throwable of this class from the pool, or spawns a new one if the pool is empty, and throws it.
+	@param bPredicted true for the local copy of the owning client.*/
+	AThrowableWeapon* AcquireThrowable(TSubclassOf<AThrowableWeapon> ThrowableClass, APawn* Thrower, FThrowableLaunchState LaunchState, const float CatchUpTime, const bool bPredicted);
+
+	/*Stops and hides the throwable, and keeps it until someone throws this class again.*/
+	void ReleaseThrowable(AThrowableWeapon* Throwable);
+
+	/*Adds the throwable to the simulation.*/
+	void StartSimulating(AThrowableWeapon* Throwable, const FVector& Location, const FVector& Velocity);
+
+	/*Removes the throwable from the simulation. It stays where it is.*/
+	void StopSimulating(AThrowableWeapon* Throwable);
+
+	/*Moves a single throwable ahead. Used to catch up with the time the throw took to reach us.*/
+	void AdvanceProjectile(AThrowableWeapon* Throwable, const float DeltaTime);
+
+	/*Moves the actor to where the simulation says it is.*/
+	void SyncTransform(AThrowableWeapon* Throwable);
+
+	FVector GetProjectileLocation(const AThrowableWeapon* Throwable) const;
+
+	FORCEINLINE int32 GetNumActiveProjectiles() const { return Projectiles.Num(); }
+
+protected:
+
+	/*The most throwables of a class we keep in the pool. The rest are destroyed.*/
+	UPROPERTY(Config)
+	int32 MaxPooledPerClass;
+
+	/*How often the dedicated server moves the actors to where the simulation is. They aren't rendered there, it's only for relevancy.*/
+	UPROPERTY(Config)
+	float ServerTransformSyncInterval;
+
+	UPROPERTY(Transient)
+	TMap<UClass*, FThrowablePool> Pools;
+
+	/*The flying throwables. Every array below has one entry per throwable, in the same order.*/
+	UPROPERTY(Transient)
+	TArray<AThrowableWeapon*> Projectiles;
+
+	TArray<FVector> Locations;
+	TArray<FVector> Velocities;
+	TArray<uint8> BounceCounts;
+	TArray<FThrowableProjectileParams> Params;
+
+	/*Next id for the launch state, so clients see every throw of a pooled throwable as a new one.*/
+	uint16 LastLaunchId;
+
+	float TimeSinceServerSync;
+
+	/*True while we go through the arrays. Throwables stopped during the tick are removed when it ends, the ones added wait for the next one.*/
+	bool bIsSimulating;
+
+	/*Moves the projectile at this index, bouncing for the rest of the step when it hits something. Returns false if it stopped.*/
+	bool SimulateProjectile(const int32 Index, const float DeltaTime, UWorld* World);
+
+	/*Removes the projectiles that were stopped while we were simulating.*/
+	void RemoveStoppedProjectiles();
+
+	void RemoveProjectileAt(const int32 Index);
+
+	void SyncTransformAt(const int32 Index);
+};
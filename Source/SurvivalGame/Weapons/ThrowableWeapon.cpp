@@ -9,17 +9,387 @@
 
 #include "Components/StaticMeshComponent.h"
 #include "GameFramework/ProjectileMovementComponent.h"
+#include "GameFramework/GameStateBase.h"
+#include "Net/UnrealNetwork.h"
+#include "Kismet/GameplayStatics.h"
+#include "Particles/ParticleSystem.h"
+#include "Sound/SoundBase.h"
+
+#include "Player/SurvivalCharacter.h"
+#include "Weapons/ExplosionSubsystem.h"
+#include "Weapons/ThrowableProjectileManager.h"
 
 AThrowableWeapon::AThrowableWeapon()
 {
 	ThrowableMesh = CreateDefaultSubobject<UStaticMeshComponent>("ThrowableMesh");
 	SetRootComponent(ThrowableMesh);
 
+	//The projectile manager moves every throwable in a single tick, so the component never ticks on its own.
 	ThrowableMovement = CreateDefaultSubobject<UProjectileMovementComponent>("ThrowableMovement");
 	ThrowableMovement->InitialSpeed = 1000.f;
+	ThrowableMovement->bAutoActivate = false;
+	ThrowableMovement->PrimaryComponentTick.bCanEverTick = false;
+
+	CollisionRadius			= 5.f;
+
+	MaxServerCatchUpTime	= 0.2f;
+	MaxClientCatchUpTime	= 1.f;
+	CatchUpTickInterval		= 1.f / 60.f;
+	ReconcileBlendTime		= 0.15f;
+	MaxReconcileDistance	= 200.f;
+	PredictionTimeout		= 1.f;
+
+	bPredicted				= false;
+	bPooled					= false;
+	ProjectileIndex			= INDEX_NONE;
+	AppliedLaunchId			= 0;
+	PendingCatchUpTime		= 0.f;
+	ReconcilingThrowable	= nullptr;
+	ReconcileOffset			= FVector::ZeroVector;
+	ReconcileTimeRemaining	= 0.f;
 
+	ExplodedLifeSpan		= 2.f;
+	bExploded				= false;
+
+	//We only tick while blending the predicted copy.
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+
+	//Every machine simulates the flight from the launch state, so there is no need to replicate movement.
 	SetReplicates(true);
-	SetReplicateMovement(true);
+	SetReplicateMovement(false);
+}
+
+void AThrowableWeapon::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AThrowableWeapon, LaunchState);
+	DOREPLIFETIME(AThrowableWeapon, ExplosionLocation);
+	DOREPLIFETIME(AThrowableWeapon, bExploded);
+}
+
+void AThrowableWeapon::InitializeLaunch(const FThrowableLaunchState& NewLaunchState, const float CatchUpTime)
+{
+	LaunchState = NewLaunchState;
+	PendingCatchUpTime = CatchUpTime;
+}
+
+void AThrowableWeapon::BeginPlay()
+{
+	Super::BeginPlay();
+
+	StartThrow();
+}
+
+void AThrowableWeapon::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UThrowableProjectileManager* ProjectileManager = GetProjectileManager())
+	{
+		ProjectileManager->StopSimulating(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AThrowableWeapon::OnRep_LaunchState()
+{
+	//The first launch is done in BeginPlay. After that, a new launch id means the server threw this pooled throwable again.
+	if (HasActorBegunPlay() && LaunchState.LaunchId != AppliedLaunchId)
+	{
+		ResetThrowable();
+		StartThrow();
+	}
+}
+
+void AThrowableWeapon::StartThrow()
+{
+	AppliedLaunchId = LaunchState.LaunchId;
+
+	if (bPredicted)
+	{
+		Launch(0.f);
+		GetWorldTimerManager().SetTimer(TimerHandle_Release, this, &AThrowableWeapon::ReleaseToPool, PredictionTimeout, false);
+	}
+	else if (GetLocalRole() == ROLE_Authority)
+	{
+		const float CatchUpTime = FMath::Clamp(PendingCatchUpTime, 0.f, MaxServerCatchUpTime);
+
+		if (ExplosionConfig.bExplodes)
+		{
+			//Bound before the launch, so we also explode if we hit something while catching up.
+			if (ExplosionConfig.bExplodeOnImpact)
+			{
+				ThrowableMovement->OnProjectileBounce.AddUniqueDynamic(this, &AThrowableWeapon::OnThrowableImpact);
+				ThrowableMovement->OnProjectileStop.AddUniqueDynamic(this, &AThrowableWeapon::OnThrowableStop);
+			}
+
+			//The fuse started when the client threw it, not when we got the throw.
+			if (ExplosionConfig.FuseTime > 0.f)
+			{
+				const float FuseTimeRemaining = ExplosionConfig.FuseTime - CatchUpTime;
+
+				if (FuseTimeRemaining > 0.f)
+				{
+					GetWorldTimerManager().SetTimer(TimerHandle_Fuse, this, &AThrowableWeapon::Detonate, FuseTimeRemaining, false);
+				}
+				else
+				{
+					Detonate();
+					return;
+				}
+			}
+		}
+
+		Launch(CatchUpTime);
+	}
+	else
+	{
+		//The launch state arrives with the throw, so we already know how far behind the server we are.
+		Launch(FMath::Clamp(GetServerWorldTimeSeconds() - LaunchState.LaunchTime, 0.f, MaxClientCatchUpTime));
+
+		//If we threw this, take the place of the throwable we predicted.
+		ASurvivalCharacter* Thrower = Cast<ASurvivalCharacter>(GetOwner());
+		if (Thrower && Thrower->IsLocallyControlled() && LaunchState.PredictionKey != 0)
+		{
+			if (AThrowableWeapon* PredictedThrowable = Thrower->ConsumePredictedThrowable(LaunchState.PredictionKey))
+			{
+				//It may have exploded already before reaching us.
+				if (bExploded)
+				{
+					PredictedThrowable->ReleaseToPool();
+				}
+				else
+				{
+					ReconcileWith(PredictedThrowable);
+				}
+			}
+		}
+	}
+}
+
+void AThrowableWeapon::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (ReconcilingThrowable)
+	{
+		ReconcileTimeRemaining -= DeltaSeconds;
+
+		if (ReconcileTimeRemaining <= 0.f || ReconcilingThrowable->IsPendingKill())
+		{
+			FinishReconcile();
+		}
+		else
+		{
+			//Move the predicted copy from where it was onto our trajectory.
+			const float Alpha = ReconcileTimeRemaining / ReconcileBlendTime;
+			ReconcilingThrowable->SetActorLocationAndRotation(GetActorLocation() + (ReconcileOffset * Alpha), GetActorRotation());
+		}
+	}
+}
+
+void AThrowableWeapon::Launch(const float CatchUpTime)
+{
+	const FVector LaunchDirection = LaunchState.Direction.GetSafeNormal();
+
+	SetActorLocationAndRotation(LaunchState.Origin, LaunchDirection.Rotation(), false, nullptr, ETeleportType::TeleportPhysics);
+
+	if (UThrowableProjectileManager* ProjectileManager = GetProjectileManager())
+	{
+		ProjectileManager->StartSimulating(this, LaunchState.Origin, LaunchDirection * ThrowableMovement->InitialSpeed);
+	}
+
+	CatchUp(CatchUpTime);
+}
+
+void AThrowableWeapon::CatchUp(float CatchUpTime)
+{
+	UThrowableProjectileManager* ProjectileManager = GetProjectileManager();
+
+	if (ProjectileManager && CatchUpTime > KINDA_SMALL_NUMBER)
+	{
+		while (CatchUpTime > KINDA_SMALL_NUMBER && ProjectileIndex != INDEX_NONE && !bExploded)
+		{
+			const float StepTime = FMath::Min(CatchUpTime, CatchUpTickInterval);
+			ProjectileManager->AdvanceProjectile(this, StepTime);
+			CatchUpTime -= StepTime;
+		}
+
+		//Wherever we ended up, the actor has to be there.
+		ProjectileManager->SyncTransform(this);
+	}
+}
+
+void AThrowableWeapon::ResetThrowable()
+{
+	GetWorldTimerManager().ClearTimer(TimerHandle_Fuse);
+	GetWorldTimerManager().ClearTimer(TimerHandle_Release);
+
+	if (UThrowableProjectileManager* ProjectileManager = GetProjectileManager())
+	{
+		ProjectileManager->StopSimulating(this);
+	}
+
+	if (ReconcilingThrowable)
+	{
+		ReconcilingThrowable->ReleaseToPool();
+		ReconcilingThrowable = nullptr;
+	}
+
+	SetActorTickEnabled(false);
+	SetActorHiddenInGame(false);
+	ThrowableMesh->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+
+	bExploded = false;
+	PendingCatchUpTime = 0.f;
+	ReconcileTimeRemaining = 0.f;
+}
+
+void AThrowableWeapon::ReleaseToPool()
+{
+	if (UThrowableProjectileManager* ProjectileManager = GetProjectileManager())
+	{
+		ProjectileManager->ReleaseThrowable(this);
+	}
+	else
+	{
+		Destroy();
+	}
+}
+
+void AThrowableWeapon::ReconcileWith(AThrowableWeapon* PredictedThrowable)
+{
+	const FVector PredictedLocation = PredictedThrowable->GetActorLocation();
+
+	//Too far to blend, the server corrected our throw. Just swap them.
+	if (FVector::DistSquared(PredictedLocation, GetActorLocation()) > FMath::Square(MaxReconcileDistance) || ReconcileBlendTime <= 0.f)
+	{
+		PredictedThrowable->ReleaseToPool();
+		return;
+	}
+
+	//The predicted copy stops simulating and follows us until it lands on our trajectory.
+	if (UThrowableProjectileManager* ProjectileManager = GetProjectileManager())
+	{
+		ProjectileManager->StopSimulating(PredictedThrowable);
+	}
+
+	GetWorldTimerManager().ClearTimer(PredictedThrowable->TimerHandle_Release);
+
+	ReconcilingThrowable = PredictedThrowable;
+	ReconcileOffset = PredictedLocation - GetActorLocation();
+	ReconcileTimeRemaining = ReconcileBlendTime;
+
+	SetActorHiddenInGame(true);
+	SetActorTickEnabled(true);
+}
+
+void AThrowableWeapon::FinishReconcile()
+{
+	if (ReconcilingThrowable)
+	{
+		ReconcilingThrowable->ReleaseToPool();
+		ReconcilingThrowable = nullptr;
+	}
+
+	SetActorHiddenInGame(false);
+	SetActorTickEnabled(false);
 }
 
+FVector AThrowableWeapon::GetThrowableLocation() const
+{
+	if (UThrowableProjectileManager* ProjectileManager = GetProjectileManager())
+	{
+		if (ProjectileIndex != INDEX_NONE)
+		{
+			return ProjectileManager->GetProjectileLocation(this);
+		}
+	}
+
+	return GetActorLocation();
+}
+
+void AThrowableWeapon::Detonate()
+{
+	if (GetLocalRole() == ROLE_Authority && !bExploded && !bPredicted)
+	{
+		GetWorldTimerManager().ClearTimer(TimerHandle_Fuse);
+
+		bExploded = true;
+		ExplosionLocation = GetThrowableLocation();
 
+		if (UExplosionSubsystem* ExplosionSubsystem = GetWorld()->GetSubsystem<UExplosionSubsystem>())
+		{
+			ExplosionSubsystem->QueueExplosion(this, GetInstigatorController(), ExplosionLocation, ExplosionConfig);
+		}
+
+		//Listen server needs to see the explosion too.
+		SimulateExplosion();
+
+		//We are the damage causer, so we can't go back to the pool until the explosion deals its damage.
+		GetWorldTimerManager().SetTimer(TimerHandle_Release, this, &AThrowableWeapon::ReleaseToPool, ExplodedLifeSpan, false);
+		ForceNetUpdate();
+	}
+}
+
+void AThrowableWeapon::OnRep_Exploded()
+{
+	if (bExploded)
+	{
+		//If we were still blending our predicted copy, it has to go now.
+		FinishReconcile();
+		SimulateExplosion();
+	}
+}
+
+void AThrowableWeapon::OnThrowableImpact(const FHitResult& ImpactResult, const FVector& ImpactVelocity)
+{
+	Detonate();
+}
+
+void AThrowableWeapon::OnThrowableStop(const FHitResult& ImpactResult)
+{
+	Detonate();
+}
+
+void AThrowableWeapon::SimulateExplosion()
+{
+	if (UThrowableProjectileManager* ProjectileManager = GetProjectileManager())
+	{
+		ProjectileManager->StopSimulating(this);
+	}
+
+	SetActorLocation(ExplosionLocation, false, nullptr, ETeleportType::TeleportPhysics);
+	ThrowableMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	SetActorHiddenInGame(true);
+
+	if (GetNetMode() != NM_DedicatedServer)
+	{
+		if (ExplosionConfig.ExplosionParticles)
+		{
+			UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ExplosionConfig.ExplosionParticles, ExplosionLocation);
+		}
+
+		if (ExplosionConfig.ExplosionSound)
+		{
+			UGameplayStatics::PlaySoundAtLocation(this, ExplosionConfig.ExplosionSound, ExplosionLocation);
+		}
+	}
+}
+
+UThrowableProjectileManager* AThrowableWeapon::GetProjectileManager() const
+{
+	UWorld* World = GetWorld();
+	return World ? World->GetSubsystem<UThrowableProjectileManager>() : nullptr;
+}
+
+float AThrowableWeapon::GetServerWorldTimeSeconds() const
+{
+	if (AGameStateBase* GameState = GetWorld()->GetGameState())
+	{
+		return GameState->GetServerWorldTimeSeconds();
+	}
+
+	return GetWorld()->GetTimeSeconds();
+}
@@ -8,24 +8,268 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "Weapons/SurvivalDamageTypes.h"
 #include "ThrowableWeapon.generated.h"
 
-/*A weapon we can throw.*/
+/*How and how hard a throwable explodes.*/
+USTRUCT(BlueprintType)
+struct FThrowableExplosionConfig
+{
+	GENERATED_BODY()
+
+	FThrowableExplosionConfig()
+	{
+		bExplodes = true;
+		FuseTime = 3.f;
+		bExplodeOnImpact = false;
+		BaseDamage = 100.f;
+		MinimumDamage = 10.f;
+		InnerRadius = 200.f;
+		OuterRadius = 600.f;
+		DamageFalloff = 1.f;
+		DamageType = UExplosiveDamage::StaticClass();
+		ExplosionParticles = nullptr;
+		ExplosionSound = nullptr;
+	}
+
+	/*False for throwables that don't explode at all.*/
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Explosion")
+	bool bExplodes;
+
+	/*Seconds from the throw until it explodes. Zero means no fuse.*/
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Explosion")
+	float FuseTime;
+
+	/*If true, it explodes the first time it hits something.*/
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Explosion")
+	bool bExplodeOnImpact;
+
+	/*Damage inside the inner radius.*/
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Explosion")
+	float BaseDamage;
+
+	/*Damage at the edge of the outer radius.*/
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Explosion")
+	float MinimumDamage;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Explosion")
+	float InnerRadius;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Explosion")
+	float OuterRadius;
+
+	/*Exponent of the falloff between the inner and the outer radius. 1 is linear.*/
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Explosion")
+	float DamageFalloff;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Explosion")
+	TSubclassOf<UDamageType> DamageType;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Explosion")
+	class UParticleSystem* ExplosionParticles;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Explosion")
+	class USoundBase* ExplosionSound;
+};
+
+/*Everything a machine needs to simulate the same flight of a throwable. Sent once per throw, instead of replicating the movement every net update.*/
+USTRUCT()
+struct FThrowableLaunchState
+{
+	GENERATED_BODY()
+
+	FThrowableLaunchState()
+	{
+		Origin = FVector::ZeroVector;
+		Direction = FVector::ForwardVector;
+		LaunchTime = 0.f;
+		PredictionKey = 0;
+		LaunchId = 0;
+	}
+
+	/*Where the throwable was launched from. Full precision, so every machine starts from the exact same point.*/
+	UPROPERTY()
+	FVector Origin;
+
+	/*The direction the throwable was launched to. The speed comes from the movement component.*/
+	UPROPERTY()
+	FVector Direction;
+
+	/*Server world time of the launch.*/
+	UPROPERTY()
+	float LaunchTime;
+
+	/*The key of the throwable the owning client predicted. Zero if nobody predicted it.*/
+	UPROPERTY()
+	uint8 PredictionKey;
+
+	/*Changes every time a pooled throwable is thrown again, so clients know they have to launch it again.*/
+	UPROPERTY()
+	uint16 LaunchId;
+};
+
+/*A weapon we can throw.
+The owning client spawns a predicted copy as soon as it throws, and the server spawns the real one. Both simulate the same
+trajectory from the launch state, and when the server one arrives on the owning client it takes the place of the predicted copy.
+Throwables are pooled and their flight is simulated by the UThrowableProjectileManager. The movement component only holds the settings.*/
 UCLASS()
 class SURVIVALGAME_API AThrowableWeapon : public AActor
 {
 	GENERATED_BODY()
-	
-public:	
+
+	friend class UThrowableProjectileManager;
+
+public:
 
 	AThrowableWeapon();
 
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void Tick(float DeltaSeconds) override;
+
+	/*Sets the launch state. Must be called before the actor finishes spawning, or before a pooled throwable is launched again.
+	@param CatchUpTime how much of the flight we have to simulate right away, to make up for the latency of the thrower.*/
+	void InitializeLaunch(const FThrowableLaunchState& NewLaunchState, const float CatchUpTime);
+
+	/*[Owning Client] Marks this throwable as the local copy that we show until the server one arrives.*/
+	void SetPredicted(const bool bNewPredicted) { bPredicted = bNewPredicted; }
+
+	FORCEINLINE bool IsPredicted() const { return bPredicted; }
+	FORCEINLINE bool HasExploded() const { return bExploded; }
+	FORCEINLINE bool IsPooled() const { return bPooled; }
+	FORCEINLINE const FThrowableLaunchState& GetLaunchState() const { return LaunchState; }
+
+	/*Where the throwable is in its flight. The actor itself may be behind on the server, we don't move it every frame there.*/
+	FVector GetThrowableLocation() const;
+
+	/*[Server] Explodes now. The damage is dealt by the explosion subsystem.*/
+	void Detonate();
+
 protected:
 
 	UPROPERTY(EditDefaultsOnly, Category = "Components")
 	class UStaticMeshComponent* ThrowableMesh;
 
+	/*Speed, gravity scale and bounciness of the throwable. It doesn't tick, the projectile manager does the simulation.*/
 	UPROPERTY(EditDefaultsOnly, Category = "Components")
 	class UProjectileMovementComponent* ThrowableMovement;
 
+	/*Radius of the sphere we sweep when the throwable moves.*/
+	UPROPERTY(EditDefaultsOnly, Category = "Movement")
+	float CollisionRadius;
+
+	/*Replicated with every throw. Clients simulate the rest of the flight on their own.*/
+	UPROPERTY(ReplicatedUsing = OnRep_LaunchState)
+	FThrowableLaunchState LaunchState;
+
+	UFUNCTION()
+	void OnRep_LaunchState();
+
+	/*The most time the server will simulate ahead to make up for the thrower's ping.*/
+	UPROPERTY(EditDefaultsOnly, Category = "Prediction")
+	float MaxServerCatchUpTime;
+
+	/*The most time a client will simulate ahead when the server throwable arrives late.*/
+	UPROPERTY(EditDefaultsOnly, Category = "Prediction")
+	float MaxClientCatchUpTime;
+
+	/*The size of each step when we simulate ahead. Smaller is closer to a normal frame, but more expensive.*/
+	UPROPERTY(EditDefaultsOnly, Category = "Prediction")
+	float CatchUpTickInterval;
+
+	/*How long the predicted copy blends into the server throwable.*/
+	UPROPERTY(EditDefaultsOnly, Category = "Prediction")
+	float ReconcileBlendTime;
+
+	/*If the predicted copy is further than this from the server throwable we don't blend, we just swap them.*/
+	UPROPERTY(EditDefaultsOnly, Category = "Prediction")
+	float MaxReconcileDistance;
+
+	/*If the server doesn't confirm our throw before this time, the predicted copy is removed.*/
+	UPROPERTY(EditDefaultsOnly, Category = "Prediction")
+	float PredictionTimeout;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Explosion")
+	FThrowableExplosionConfig ExplosionConfig;
+
+	/*How long we keep the throwable around after it explodes, so it can deal the damage and clients can play the FX.*/
+	UPROPERTY(EditDefaultsOnly, Category = "Explosion")
+	float ExplodedLifeSpan;
+
+	/*Where the server throwable exploded.*/
+	UPROPERTY(Transient, Replicated)
+	FVector_NetQuantize ExplosionLocation;
+
+	UPROPERTY(Transient, ReplicatedUsing = OnRep_Exploded)
+	bool bExploded;
+
+	UFUNCTION()
+	void OnRep_Exploded();
+
+	FTimerHandle TimerHandle_Fuse;
+
+	/*Gives the throwable back to the pool once it has exploded, or once the predicted copy times out.*/
+	FTimerHandle TimerHandle_Release;
+
+	/*True if this is the local copy of the owning client and not the server throwable.*/
+	bool bPredicted;
+
+	/*True while the throwable is waiting in the pool.*/
+	bool bPooled;
+
+	/*Where this throwable is in the projectile manager arrays. INDEX_NONE if it's not flying.*/
+	int32 ProjectileIndex;
+
+	/*The launch we already simulated. Clients compare it with the replicated one to know if we were thrown again.*/
+	uint16 AppliedLaunchId;
+
+	/*How much of the flight to simulate when we launch.*/
+	float PendingCatchUpTime;
+
+	/*[Owning Client] The predicted copy we are blending into this throwable.*/
+	UPROPERTY(Transient)
+	AThrowableWeapon* ReconcilingThrowable;
+
+	/*Where the predicted copy was relative to us when we took its place.*/
+	FVector ReconcileOffset;
+
+	/*Time left to finish blending the predicted copy.*/
+	float ReconcileTimeRemaining;
+
+	/*Starts the flight of this throw: the first one after BeginPlay, or a pooled throwable that we throw again.*/
+	void StartThrow();
+
+	/*Puts the throwable at the launch origin with the launch velocity, and simulates the time we are behind.*/
+	void Launch(const float CatchUpTime);
+
+	/*Steps the simulation the same way a normal frame would, until we get to the present.*/
+	void CatchUp(float CatchUpTime);
+
+	/*Leaves the throwable as it was when it was spawned, so it can go back to the pool.*/
+	void ResetThrowable();
+
+	/*Gives this throwable back to the pool.*/
+	void ReleaseToPool();
+
+	/*[Owning Client] The server throwable takes the place of our predicted copy.*/
+	void ReconcileWith(AThrowableWeapon* PredictedThrowable);
+
+	/*[Owning Client] Removes the predicted copy and shows the server throwable.*/
+	void FinishReconcile();
+
+	/*[Server] Explodes if this throwable explodes on impact.*/
+	UFUNCTION()
+	void OnThrowableImpact(const FHitResult& ImpactResult, const FVector& ImpactVelocity);
+
+	UFUNCTION()
+	void OnThrowableStop(const FHitResult& ImpactResult);
+
+	/*Stops and hides the throwable, and plays the explosion FX where it exploded.*/
+	void SimulateExplosion();
+
+	class UThrowableProjectileManager* GetProjectileManager() const;
+
+	/*Server world time on any machine.*/
+	float GetServerWorldTimeSeconds() const;
 };
@@ -29,6 +29,9 @@
 
 #include "DrawDebugHelpers.h"
 
+#include "Framework/SurvivalTelemetrySubsystem.h"
+#include "Framework/SurvivalServerJournalSubsystem.h"
+
 AWeapon::AWeapon()
 {
 	WeaponMesh = CreateDefaultSubobject<USkeletalMeshComponent>("WeaponMesh");
@@ -77,6 +80,13 @@ void AWeapon::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeP
 	DOREPLIFETIME_CONDITION(AWeapon, Item, COND_InitialOnly); //Only needs to be replicated once.
 }
 
+void AWeapon::ProcessEvent(UFunction* Function, void* Parameters)
+{
+	USurvivalServerJournalSubsystem::FScopedServerRPC JournalScope(this, Function, Parameters);
+
+	Super::ProcessEvent(Function, Parameters);
+}
+
 void AWeapon::PostInitializeComponents()
 {
 	Super::PostInitializeComponents();
@@ -385,21 +395,29 @@ void AWeapon::ClientStartReload_Implementation()
 
 void AWeapon::ServerStartFire_Implementation()
 {
+	SURVIVAL_COUNT_RPC(ServerStartFire);
+
 	StartFire();
 }
 
 void AWeapon::ServerStopFire_Implementation()
 {
+	SURVIVAL_COUNT_RPC(ServerStopFire);
+
 	StopFire();
 }
 
 void AWeapon::ServerStartReload_Implementation()
 {
+	SURVIVAL_COUNT_RPC(ServerStartReload);
+
 	StartReload();
 }
 
 void AWeapon::ServerStopReload_Implementation()
 {
+	SURVIVAL_COUNT_RPC(ServerStopReload);
+
 	StopReload();
 }
 
@@ -546,10 +564,11 @@ void AWeapon::FireShot()
 	if (ASurvivalCharacter* OwnerCharacter = Cast<ASurvivalCharacter>(GetOwner()))
 	{
 		/**Firing logic: Local client does a weapon trace, sends trace to server, spawns FX.
-		If hit actor is movable, server does a Bounding Box check, and then spawns FX for all clients.*/
-		if (GetNetMode() != NM_DedicatedServer && OwnerCharacter && OwnerCharacter->IsLocallyControlled())
+		If hit actor is movable, server does a Bounding Box check, and then spawns FX for all clients.
+		Bots are locally controlled on the server, so they trace right there.*/
+		if (OwnerCharacter && OwnerCharacter->IsLocallyControlled())
 		{
-			if (ASurvivalPlayerController* OwnerController = Cast<ASurvivalPlayerController>(OwnerCharacter->GetController()))
+			if (AController* OwnerController = OwnerCharacter->GetController())
 			{
 				FVector AimLoc;
 				FRotator AimRot;
@@ -572,6 +591,8 @@ void AWeapon::FireShot()
 
 void AWeapon::ServerHandleFiring_Implementation()
 {
+	SURVIVAL_COUNT_RPC(ServerHandleFiring);
+
 	const bool bShouldUpdateAmmo = (CurrentAmmoInClip > 0 && CanFire());
 
 	HandleFiring();
@@ -603,6 +624,7 @@ void AWeapon::HandleReFiring()
 
 void AWeapon::HandleFiring()
 {
+	SURVIVAL_SCOPE_CYCLE_COUNTER(HandleFiring);
 
 	if ((CurrentAmmoInClip > 0) && CanFire())
 	{
@@ -940,6 +962,9 @@ void AWeapon::ProcessInstantHit(const FHitResult& Impact, const FVector& Origin,
 
 void AWeapon::ServerNotifyHit_Implementation(const FHitResult& Impact, FVector_NetQuantizeNormal ShootDir)
 {
+	SURVIVAL_COUNT_RPC(ServerNotifyHit);
+	SURVIVAL_SCOPE_CYCLE_COUNTER(ServerNotifyHit);
+
 	//If we have an instigator, calculate dot between the view and the shot.
 
 	if (GetInstigator() && (Impact.GetActor() || Impact.bBlockingHit))
@@ -966,25 +991,8 @@ void AWeapon::ServerNotifyHit_Implementation(const FHitResult& Impact, FVector_N
 			}
 			else
 			{
-				//Get the component bounding box.
-				const FBox HitBox = Impact.GetActor()->GetComponentsBoundingBox();
-
-				//Calculate the box extent, and increase by a leeway.
-				FVector BoxExtent = 0.5 * (HitBox.Max - HitBox.Min);
-				BoxExtent *= HitScanConfig.ClientSideHitLeeway;
-
-				//Avoid precision errors with really thin objects
-				BoxExtent.X = FMath::Max(20.0f, BoxExtent.X);
-				BoxExtent.Y = FMath::Max(20.0f, BoxExtent.Y);
-				BoxExtent.Z = FMath::Max(20.0f, BoxExtent.Z);
-
-				//Get the box center
-				const FVector BoxCenter = (HitBox.Min + HitBox.Max) * 0.5;
-
 				//If we are within client tolerance
-				if (FMath::Abs(Impact.Location.Z - BoxCenter.Z) < BoxExtent.Z &&
-					FMath::Abs(Impact.Location.X - BoxCenter.X) < BoxExtent.X &&
-					FMath::Abs(Impact.Location.Y - BoxCenter.Y) < BoxExtent.Y)
+				if (IsClientHitWithinTolerance(Impact))
 				{
 					ProcessInstantHit_Confirmed(Impact, Origin, ShootDir);
 				}
@@ -1005,6 +1013,33 @@ void AWeapon::ServerNotifyHit_Implementation(const FHitResult& Impact, FVector_N
 	}
 }
 
+bool AWeapon::IsClientHitWithinTolerance(const FHitResult& Impact) const
+{
+	if (!Impact.GetActor())
+	{
+		return false;
+	}
+
+	//Get the component bounding box.
+	const FBox HitBox = Impact.GetActor()->GetComponentsBoundingBox();
+
+	//Calculate the box extent, and increase by a leeway.
+	FVector BoxExtent = 0.5 * (HitBox.Max - HitBox.Min);
+	BoxExtent *= HitScanConfig.ClientSideHitLeeway;
+
+	//Avoid precision errors with really thin objects
+	BoxExtent.X = FMath::Max(20.0f, BoxExtent.X);
+	BoxExtent.Y = FMath::Max(20.0f, BoxExtent.Y);
+	BoxExtent.Z = FMath::Max(20.0f, BoxExtent.Z);
+
+	//Get the box center
+	const FVector BoxCenter = (HitBox.Min + HitBox.Max) * 0.5;
+
+	return FMath::Abs(Impact.Location.Z - BoxCenter.Z) < BoxExtent.Z &&
+		FMath::Abs(Impact.Location.X - BoxCenter.X) < BoxExtent.X &&
+		FMath::Abs(Impact.Location.Y - BoxCenter.Y) < BoxExtent.Y;
+}
+
 void AWeapon::ProcessInstantHit_Confirmed(const FHitResult& Impact, const FVector& Origin, const FVector& ShootDir)
 {
 	if (GetLocalRole() == ROLE_Authority)
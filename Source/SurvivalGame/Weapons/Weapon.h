@@ -127,6 +127,9 @@ public:
 	virtual void BeginPlay() override;
 	virtual void Destroyed() override;
 
+	/*Journals the Server RPCs we receive (fire, reload and hits) before running them, see USurvivalServerJournalSubsystem.*/
+	virtual void ProcessEvent(UFunction* Function, void* Parameters) override;
+
 protected:
 
 	/* Consume a Bullet from the ammo clip.*/
@@ -183,6 +186,8 @@ protected:
 	UFUNCTION(BlueprintPure, Category = "Weapon")
 	int32 GetCurrentAmmo() const;
 
+public:
+
 	/*Get current ammo amount (clip).*/
 	UFUNCTION(BlueprintPure, Category = "Weapon")
 	int32 GetCurrentAmmoInClip() const;
@@ -190,6 +195,11 @@ protected:
 	/*Get clip size.*/
 	int32 GetAmmoPerClip() const;
 
+	/*[Server] Sets the ammo inside the clip, no more than it holds. Used to give a returning player the ammo they left with.*/
+	FORCEINLINE void SetCurrentAmmoInClip(const int32 Ammo) { CurrentAmmoInClip = FMath::Clamp(Ammo, 0, WeaponConfig.AmmoPerClip); }
+
+protected:
+
 	/*Get weapon mesh (needs pawn owner to determine variant).*/
 	UFUNCTION(BlueprintPure, Category = "Weapon")
 	USkeletalMeshComponent* GetWeaponMesh() const;
@@ -516,6 +526,9 @@ public:
 	UFUNCTION(Reliable, Server)
 	void ServerNotifyHit(const FHitResult& Impact, FVector_NetQuantizeNormal ShootDir);
 
+	/*True if the impact a client sent us is close enough to the bounding box of the actor it hit.*/
+	bool IsClientHitWithinTolerance(const FHitResult& Impact) const;
+
 	/*Continue processing the instant hit, as if it has been confirmed by the server.*/
 	void ProcessInstantHit_Confirmed(const FHitResult& Impact, const FVector& Origin, const FVector& ShootDir);
 
@@ -9,6 +9,9 @@
 #include "World/Pickup.h"
 #include "Items/Item.h"
 
+#include "SurvivalGame.h"
+#include "Framework/SurvivalWorldSnapshotSubsystem.h"
+
 AItemSpawn::AItemSpawn()
 {
 	PrimaryActorTick.bCanEverTick = false;
@@ -23,12 +26,47 @@ void AItemSpawn::BeginPlay()
 
 	if (GetLocalRole() == ROLE_Authority)
 	{
-		SpawnItem();
+		USurvivalWorldSnapshotSubsystem* Snapshots = GetWorld()->GetSubsystem<USurvivalWorldSnapshotSubsystem>();
+
+		//After a restart we get back the pickups we had or the respawn we were waiting for.
+		if (!Snapshots || !Snapshots->RestoreActor(this))
+		{
+			SpawnItem();
+		}
+
+		if (Snapshots)
+		{
+			Snapshots->TrackActor(this);
+		}
+	}
+}
+
+float AItemSpawn::GetRespawnTimeRemaining() const
+{
+	return GetWorldTimerManager().IsTimerActive(TimerHandle_RespawnItem) ? GetWorldTimerManager().GetTimerRemaining(TimerHandle_RespawnItem) : -1.f;
+}
+
+void AItemSpawn::RestoreRespawnTimer(const float Delay)
+{
+	if (GetLocalRole() == ROLE_Authority)
+	{
+		GetWorldTimerManager().SetTimer(TimerHandle_RespawnItem, this, &AItemSpawn::SpawnItem, Delay, false);
+	}
+}
+
+void AItemSpawn::AdoptPickup(APickup* Pickup)
+{
+	if (GetLocalRole() == ROLE_Authority && Pickup)
+	{
+		Pickup->OnDestroyed.AddUniqueDynamic(this, &AItemSpawn::OnItemTaken);
+		SpawnedPickups.AddUnique(Pickup);
 	}
 }
 
 void AItemSpawn::SpawnItem()
 {
+	SURVIVAL_SCOPE_CYCLE_COUNTER(SpawnItem);
+
 	if (GetLocalRole() == ROLE_Authority && LootTable)
 	{
 		TArray<FLootTableRow*> SpawnItems;
@@ -62,7 +100,7 @@ void AItemSpawn::SpawnItem()
 				SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
 
 				//Spawn quantity.
-				const int32 ItemQuantity = ItemClass->GetDefaultObject<UItem>()->GetQuantity();
+				const int32 ItemQuantity = FItemDefinitionRegistry::Get().GetDefinition(ItemClass).DefaultQuantity;
 
 				FTransform SpawnTransform = GetActorTransform();
 				SpawnTransform.AddToTranslation(LocationOffset); //Add an offset to the spawnPosition.
@@ -73,6 +111,11 @@ void AItemSpawn::SpawnItem()
 
 				SpawnedPickups.Add(Pickup);
 
+				if (USurvivalWorldSnapshotSubsystem* Snapshots = GetWorld()->GetSubsystem<USurvivalWorldSnapshotSubsystem>())
+				{
+					Snapshots->SetPickupSpawner(Pickup, this);
+				}
+
 				//Increment the angle to make a nice circle effect between all the spawned items.
 				Angle += (PI * 2.f) / LootRow->Items.Num();
 			}
@@ -90,6 +133,7 @@ void AItemSpawn::OnItemTaken(AActor* DestroyedActor)
 		if (SpawnedPickups.Num() <= 0)
 		{
 			GetWorldTimerManager().SetTimer(TimerHandle_RespawnItem, this, &AItemSpawn::SpawnItem, FMath::RandRange(RespawnRange.GetMin(), RespawnRange.GetMax()), false);
+			USurvivalWorldSnapshotSubsystem::MarkActorDirty(this);
 		}
 	}
 }
@@ -50,6 +50,15 @@ public:
 	UPROPERTY(EditDefaultsOnly, Category = "Loot")
 	FIntPoint RespawnRange;
 
+	/*Seconds until new pickups spawn, -1 if some are still in the world.*/
+	float GetRespawnTimeRemaining() const;
+
+	/*[Server] Used by the world snapshot when the server restarts. New pickups spawn after the delay instead of right away.*/
+	void RestoreRespawnTimer(const float Delay);
+
+	/*[Server] Used by the world snapshot when the server restarts. The pickup was spawned by us before, it counts as ours again.*/
+	void AdoptPickup(class APickup* Pickup);
+
 protected:
 
 	FTimerHandle TimerHandle_RespawnItem;
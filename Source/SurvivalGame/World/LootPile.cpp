@@ -0,0 +1,82 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+
+#include "LootPile.h"
+
+#include "Components/InteractionComponent.h"
+#include "Components/InventoryComponent.h"
+#include "Components/StaticMeshComponent.h"
+
+#include "Items/Item.h"
+
+#define LOCTEXT_NAMESPACE "LootPile"
+
+ALootPile::ALootPile()
+{
+	LootContainerMesh->SetCollisionResponseToChannel(ECC_Pawn, ECR_Ignore); //Like pickups, players walk over it
+
+	LootInteraction->InteractableNameText = LOCTEXT("LootPileName", "Dropped Items");
+	LootInteraction->InteractionDistance = 200.f;
+
+	//More than a full player inventory, so a player that drops everything leaves one pile.
+	Inventory->SetCapacity(24);
+	Inventory->SetWeightCapacity(200.f);
+
+	LootTable = nullptr;
+}
+
+int32 ALootPile::AddItem(TSubclassOf<UItem> ItemClass, const int32 Quantity)
+{
+	if (GetLocalRole() != ROLE_Authority || !ItemClass || Quantity <= 0)
+	{
+		return 0;
+	}
+
+	const FItemAddResult AddResult = Inventory->TryAddItemFromClass(ItemClass, Quantity);
+
+	//Adding doesn't broadcast OnInventoryUpdated on the server.
+	RefreshMesh();
+
+	return AddResult.ActualAmountGiven;
+}
+
+void ALootPile::BeginPlay()
+{
+	Super::BeginPlay();
+
+	Inventory->OnInventoryUpdated.AddDynamic(this, &ALootPile::OnItemsChanged);
+
+	RefreshMesh();
+}
+
+void ALootPile::OnItemsChanged()
+{
+	RefreshMesh();
+
+	if (GetLocalRole() == ROLE_Authority && !IsPendingKill() && Inventory->GetItems().Num() == 0)
+	{
+		Destroy();
+	}
+}
+
+void ALootPile::RefreshMesh()
+{
+	for (const UItem* Item : Inventory->GetItems())
+	{
+		if (Item && Item->PickupMesh)
+		{
+			if (LootContainerMesh->GetStaticMesh() != Item->PickupMesh)
+			{
+				LootContainerMesh->SetStaticMesh(Item->PickupMesh);
+			}
+
+			return;
+		}
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,37 @@
+//+---------------------------------------------------------+
+//| Project   : Network Survival Game						|
+//| UE Version: UE 4.25										|
+//| Author    : github.com/LordWake					 		|
+//+---------------------------------------------------------+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "World/LootableActor.h"
+#include "LootPile.generated.h"
+
+/*Items players dropped next to each other, looted like a chest. Made by the ground loot subsystem, so a player that dumps
+the whole inventory leaves one actor to replicate and draw instead of a pickup per item.
+Shows the pickup mesh of its first item and is destroyed once it's empty.*/
+UCLASS()
+class SURVIVALGAME_API ALootPile : public ALootableActor
+{
+	GENERATED_BODY()
+
+public:
+
+	ALootPile();
+
+	/*[Server] Adds as much of the item as fits, stacking on the items of the same class. Returns how many were added.*/
+	int32 AddItem(TSubclassOf<class UItem> ItemClass, const int32 Quantity);
+
+protected:
+
+	virtual void BeginPlay() override;
+
+	/*Takes the mesh of the first item, and on the server destroys the pile when the last item is taken.*/
+	UFUNCTION()
+	void OnItemsChanged();
+
+	void RefreshMesh();
+};
@@ -18,6 +18,9 @@
 
 #include "Player/SurvivalCharacter.h"
 
+#include "SurvivalGame.h"
+#include "Framework/SurvivalWorldSnapshotSubsystem.h"
+
 #define LOCTEXT_NAMESPACE "LootableActor"
 
 ALootableActor::ALootableActor()
@@ -44,41 +47,68 @@ void ALootableActor::BeginPlay()
 	Super::BeginPlay();
 	LootInteraction->OnInteract.AddDynamic(this, &ALootableActor::OnInteract);
 
-	//If we are the server and we have a LootTable to find.
-	if (GetLocalRole() == ROLE_Authority && LootTable)
+	if (GetLocalRole() == ROLE_Authority)
 	{
-		TArray<FLootTableRow*> SpawnItems;
-		LootTable->GetAllRows("", SpawnItems); //Get all of the rows of that table.
+		USurvivalWorldSnapshotSubsystem* Snapshots = GetWorld()->GetSubsystem<USurvivalWorldSnapshotSubsystem>();
 
-		int32 Rolls = FMath::RandRange(LootRolls.GetMin(), LootRolls.GetMax()); //Get a random number between the min and max of the loot rows. 
+		//A restarted server gives the container the loot it had, only new containers roll theirs.
+		if ((!Snapshots || !Snapshots->RestoreActor(this)) && LootTable)
+		{
+			RollLoot();
+		}
 
-		//Loop over that "many times" we have in the random number before
-		for (int32 i = 0; i < Rolls; ++i)
+		if (Snapshots)
 		{
-			const FLootTableRow* LootRow = SpawnItems[FMath::RandRange(0, SpawnItems.Num() - 1)]; //Get the table row.
+			Snapshots->TrackActor(this);
+		}
+	}
+}
 
-			ensure(LootRow);
+void ALootableActor::RollLoot()
+{
+	SURVIVAL_SCOPE_CYCLE_COUNTER(LootRoll);
 
-			float ProbabilityRoll = FMath::FRandRange(0.f, 1.f); //Random number between 0 a 1. Based on this number, it will decide if give or not the item.
+	if (!LootTable)
+	{
+		return;
+	}
 
-			while (ProbabilityRoll > LootRow->Probability)
-			{
-				LootRow = SpawnItems[FMath::RandRange(0, SpawnItems.Num() - 1)];
-				ProbabilityRoll = FMath::FRandRange(0.f, 1.f);
-			}
+	TArray<FLootTableRow*> SpawnItems;
+	LootTable->GetAllRows("", SpawnItems); //Get all of the rows of that table.
 
+	if (SpawnItems.Num() == 0)
+	{
+		return;
+	}
+
+	int32 Rolls = FMath::RandRange(LootRolls.GetMin(), LootRolls.GetMax()); //Get a random number between the min and max of the loot rows. 
+
+	//Loop over that "many times" we have in the random number before
+	for (int32 i = 0; i < Rolls; ++i)
+	{
+		const FLootTableRow* LootRow = SpawnItems[FMath::RandRange(0, SpawnItems.Num() - 1)]; //Get the table row.
+
+		ensure(LootRow);
+
+		float ProbabilityRoll = FMath::FRandRange(0.f, 1.f); //Random number between 0 a 1. Based on this number, it will decide if give or not the item.
 
-			if (LootRow && LootRow->Items.Num())
+		while (ProbabilityRoll > LootRow->Probability)
+		{
+			LootRow = SpawnItems[FMath::RandRange(0, SpawnItems.Num() - 1)];
+			ProbabilityRoll = FMath::FRandRange(0.f, 1.f);
+		}
+
+
+		if (LootRow && LootRow->Items.Num())
+		{
+			for (auto& ItemClass : LootRow->Items)
 			{
-				for (auto& ItemClass : LootRow->Items)
+				if (ItemClass)
 				{
-					if (ItemClass)
-					{
-						//If the Item is valid, we get the default quantity of that item
-						const int32 Quantity = Cast<UItem>(ItemClass->GetDefaultObject())->GetQuantity();
-						//And add it to the inventory of this actor. Like for example, a chest.
-						Inventory->TryAddItemFromClass(ItemClass, Quantity);
-					}
+					//If the Item is valid, we get the default quantity of that item
+					const int32 Quantity = FItemDefinitionRegistry::Get().GetDefinition(ItemClass).DefaultQuantity;
+					//And add it to the inventory of this actor. Like for example, a chest.
+					Inventory->TryAddItemFromClass(ItemClass, Quantity);
 				}
 			}
 		}
@@ -93,4 +123,4 @@ void ALootableActor::OnInteract(class ASurvivalCharacter* Character)
 	}
 }
 
-#undef LOCTEXT_NAMESPACE
+#undef LOCTEXT_NAMESPACE
\ No newline at end of file
@@ -37,6 +37,9 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Components")
 	FIntPoint LootRolls;
 
+	/*Rolls the loot table and adds what we got to the inventory. Done by the server on BeginPlay.*/
+	void RollLoot();
+
 protected:
 	
 	virtual void BeginPlay() override;
@@ -9,6 +9,11 @@
 
 #include "Net/UnrealNetwork.h"
 #include "Engine/ActorChannel.h"
+#include "Net/DataBunch.h"
+
+#include "SurvivalGame.h"
+#include "Framework/SurvivalTelemetrySubsystem.h"
+#include "Framework/SurvivalWorldSnapshotSubsystem.h"
 
 #include "Player/SurvivalCharacter.h"
 
@@ -43,12 +48,48 @@ void APickup::InitializePickup(const TSubclassOf<class UItem> ItemClass, const i
 		Item = NewObject<UItem>(this, ItemClass);
 		Item->SetQuantity(Quantity);
 
-		OnRep_Item(); //So clients can update the item
-		Item->MarkDirtyForReplication();
+		ItemStack.ItemClass = ItemClass;
+		ItemStack.Quantity = Item->GetQuantity(); //Clients build the item from this
+
+		RefreshItem();
+
+		USurvivalWorldSnapshotSubsystem::MarkActorDirty(this);
+	}
+}
+
+void APickup::SetPickupQuantity(const int32 Quantity)
+{
+	if (GetLocalRole() == ROLE_Authority && Item)
+	{
+		Item->SetQuantity(Quantity);
+		ItemStack.Quantity = Item->GetQuantity();
+
+		USurvivalWorldSnapshotSubsystem::MarkActorDirty(this);
 	}
 }
 
-void APickup::OnRep_Item()
+void APickup::OnRep_ItemStack()
+{
+	if (!ItemStack.IsValid())
+	{
+		Item = nullptr;
+	}
+	else
+	{
+		//A local item nobody replicates, it only has to show the right name and quantity.
+		if (!Item || Item->GetClass() != ItemStack.ItemClass)
+		{
+			Item = NewObject<UItem>(this, ItemStack.ItemClass);
+			Item->World = GetWorld();
+		}
+
+		Item->Quantity = ItemStack.Quantity;
+	}
+
+	RefreshItem();
+}
+
+void APickup::RefreshItem()
 {
 	if (Item)
 	{
@@ -58,7 +99,7 @@ void APickup::OnRep_Item()
 		InteractionComponent->InteractableNameText = Item->ItemDisplayName;
 
 		//Clients bind to this delegate in order to refresh the interaction widget if item quantity changes.
-		Item->OnItemModified.AddDynamic(this, &APickup::OnItemModified);
+		Item->OnItemModified.AddUniqueDynamic(this, &APickup::OnItemModified);
 	}
 
 	//If any replicated properties on the item are changed, we refresh the widget
@@ -76,11 +117,19 @@ void APickup::OnItemModified()
 void APickup::BeginPlay()
 {
 	Super::BeginPlay();
+
+	USurvivalWorldSnapshotSubsystem* Snapshots = GetLocalRole() == ROLE_Authority ? GetWorld()->GetSubsystem<USurvivalWorldSnapshotSubsystem>() : nullptr;
 	
 	//bNetStartup is true if the pickup is placed/spawned on the level, and false if someone drop it.
-	if (GetLocalRole() == ROLE_Authority && ItemTemplate && bNetStartup)
+	if (GetLocalRole() == ROLE_Authority && bNetStartup)
 	{
-		InitializePickup(ItemTemplate->GetClass(), ItemTemplate->GetQuantity());
+		//A restarted server gives the pickup what was left of it, or removes it if it was taken.
+		const bool bRestored = Snapshots && Snapshots->RestoreActor(this);
+
+		if (!bRestored && ItemTemplate)
+		{
+			InitializePickup(ItemTemplate->GetClass(), ItemTemplate->GetQuantity());
+		}
 	}
 
 	/*If pickup was spawned at runtime, ensure that it matches the rotation of the ground that it was dropped on
@@ -90,9 +139,9 @@ void APickup::BeginPlay()
 		AlignWithGround();
 	}
 
-	if (Item)
+	if (Snapshots)
 	{
-		Item->MarkDirtyForReplication();
+		Snapshots->TrackActor(this);
 	}
 }
 
@@ -100,20 +149,20 @@ void APickup::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeP
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(APickup, Item);
+	DOREPLIFETIME(APickup, ItemStack);
 }
 
 bool APickup::ReplicateSubobjects(class UActorChannel* Channel, class FOutBunch* Bunch, FReplicationFlags* RepFlags)
 {
-	bool bWroteSomething = Super::ReplicateSubobjects(Channel, Bunch, RepFlags);
+	SURVIVAL_SCOPE_CYCLE_COUNTER(PickupReplicateSubobjects);
+
+	const int64 StartBits = Bunch->GetNumBits();
+
+	//The item isn't a subobject anymore, it goes in the ItemStack.
+	const bool bWroteSomething = Super::ReplicateSubobjects(Channel, Bunch, RepFlags);
+
+	USurvivalTelemetrySubsystem::CountReplicatedBits(this, Bunch->GetNumBits() - StartBits);
 
-	//Does the item needs to be replicate?
-	if (Item && Channel->KeyNeedsToReplicate(Item->GetUniqueID(), Item->RepKey))
-	{
-		//Replicate it 
-		bWroteSomething |= Channel->ReplicateSubobject(Item, *Bunch, *RepFlags);
-	}			
-	
 	return bWroteSomething;
 }
 
@@ -154,7 +203,7 @@ void APickup::OnTakePickup(class ASurvivalCharacter* Taker)
 			if (AddResult.ActualAmountGiven < Item->GetQuantity())
 			{
 				//Do not destroy the pickup, just increase the item amount.
-				Item->SetQuantity(Item->GetQuantity() - AddResult.ActualAmountGiven);
+				SetPickupQuantity(Item->GetQuantity() - AddResult.ActualAmountGiven);
 			}
 
 			//If we did take all of the items
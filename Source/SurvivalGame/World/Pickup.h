@@ -8,6 +8,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "Items/Item.h"
 #include "Pickup.generated.h"
 
 /*An actor represented in the world that holds an item.*/
@@ -27,18 +28,31 @@ public:
 	UFUNCTION(BlueprintImplementableEvent)
 	void AlignWithGround();
 
+	FORCEINLINE class UItem* GetItem() const { return Item; }
+
+	/*[Server] Changes how many of the item the pickup holds. When part of it is taken, and when a drop stacks on it.*/
+	void SetPickupQuantity(const int32 Quantity);
+
 	/* This is used as a template to create the pickup when spawned in. */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Instanced)
 	class UItem* ItemTemplate;
 
 protected:
 	
-	/*The item that will be added to the inventory when this pickup is taken. */
-	UPROPERTY(BlueprintReadWrite, VisibleAnywhere, ReplicatedUsing = OnRep_Item)
+	/*The item that will be added to the inventory when this pickup is taken.
+	Not replicated, clients build their own from the ItemStack.*/
+	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
 	class UItem* Item;
 
+	/*The class and quantity of the item, all the clients need to show the pickup.*/
+	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, ReplicatedUsing = OnRep_ItemStack)
+	FItemStack ItemStack;
+
 	UFUNCTION()
-	void OnRep_Item();
+	void OnRep_ItemStack();
+
+	/*Updates the mesh and the interaction widget with the item.*/
+	void RefreshItem();
 
 	/*If some property on the item is modified, we bind this to OnItemModified and refresh the UI if the item gets modified.*/
 	UFUNCTION()